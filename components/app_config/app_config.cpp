@@ -6,6 +6,41 @@
 
 static const char* TAG = "AppConfig";
 
+// ---------------------------------------------------
+// Display profiles
+// ---------------------------------------------------
+static const DisplayProfileSpec display_profiles[] = {
+    //  id              label                              depth dither MHz blank refresh
+    { "balanced",     "Balanced (6-bit, dithered)",         6, true,   8, 2,  60 },
+    { "low-ram",      "Low RAM (4-bit, dithered)",          4, true,   8, 1,  60 },
+    { "high-refresh", "High refresh (5-bit, 15 MHz)",       5, true,  15, 1, 120 },
+    { "max-color",    "Max color (8-bit)",                  8, true,   8, 2,  30 },
+};
+static_assert(sizeof(display_profiles) / sizeof(display_profiles[0]) == (size_t)DisplayProfile::COUNT,
+              "one spec per DisplayProfile");
+
+const DisplayProfileSpec& display_profile_spec(DisplayProfile profile) {
+    size_t i = (size_t)profile;
+    if (i >= (size_t)DisplayProfile::COUNT) i = 0;
+    return display_profiles[i];
+}
+
+bool display_profile_from_id(const char* id, DisplayProfile& out) {
+    for (size_t i = 0; i < (size_t)DisplayProfile::COUNT; i++) {
+        if (strcmp(id, display_profiles[i].id) == 0) {
+            out = (DisplayProfile)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool audio_config_valid(const AudioConfig& cfg) {
+    bool window = cfg.window == 256 || cfg.window == 512 || cfg.window == 1024 || cfg.window == 2048;
+    bool overlap = cfg.overlap_pct == 0 || cfg.overlap_pct == 50 || cfg.overlap_pct == 75;
+    return window && overlap && cfg.pipeline <= 2 && cfg.gate <= 1;
+}
+
 // Singleton instance
 AppConfig& AppConfig::instance() {
     static AppConfig inst;
@@ -27,6 +62,13 @@ void AppConfig::begin() {
              timeConfig.valid ? "yes" : "no");
     ESP_LOGI(TAG, "Flight update interval: %lu seconds", flightConfig.update_interval);
     ESP_LOGI(TAG, "Brightness: %d", brightness);
+    ESP_LOGI(TAG, "Display: %dx%d (%d x %dx%d modules, %d row(s)), profile %s: %d-bit color%s, %d MHz",
+             displayConfig.width(), displayConfig.height(), displayConfig.chain_length,
+             displayConfig.panel_width, displayConfig.panel_height, displayConfig.tile_rows,
+             display_profile_spec(displayConfig.profile).id,
+             displayConfig.color_depth, displayConfig.dither ? " + dithering" : "",
+             displayConfig.clock_mhz);
+    ESP_LOGI(TAG, "Audio: %d-sample window, %d%% overlap", audioConfig.window, audioConfig.overlap_pct);
 }
 
 // ---------------------------------------------------
@@ -119,6 +161,45 @@ void AppConfig::loadFromNVS() {
         ESP_LOGI(TAG, "Loaded brightness from NVS");
     }
 
+    // Load panel geometry (all keys or none)
+    DisplayConfig dc;
+    uint8_t serp;
+    if (nvs_get_u16(handle, "panel_w", &dc.panel_width) == ESP_OK &&
+        nvs_get_u16(handle, "panel_h", &dc.panel_height) == ESP_OK &&
+        nvs_get_u8(handle, "panel_chain", &dc.chain_length) == ESP_OK &&
+        nvs_get_u8(handle, "panel_rows", &dc.tile_rows) == ESP_OK &&
+        nvs_get_u8(handle, "panel_serp", &serp) == ESP_OK &&
+        nvs_get_i8(handle, "panel_pin_e", &dc.pin_e) == ESP_OK) {
+        dc.serpentine = serp != 0;
+        if (dc.tile_rows > 0 && dc.chain_length % dc.tile_rows == 0) {
+            displayConfig = dc;
+            ESP_LOGI(TAG, "Loaded display geometry from NVS");
+        } else {
+            ESP_LOGW(TAG, "Ignoring invalid display geometry in NVS");
+        }
+    }
+
+    // Driver settings come from the profile, independent of the geometry
+    uint8_t profile;
+    if (nvs_get_u8(handle, "panel_profile", &profile) == ESP_OK &&
+        profile < (uint8_t)DisplayProfile::COUNT) {
+        displayConfig.applyProfile((DisplayProfile)profile);
+    }
+
+    // Load audio analysis (both keys or none)
+    AudioConfig ac;
+    if (nvs_get_u16(handle, "audio_win", &ac.window) == ESP_OK &&
+        nvs_get_u8(handle, "audio_ovl", &ac.overlap_pct) == ESP_OK) {
+        nvs_get_u8(handle, "audio_pipe", &ac.pipeline);     // optional, newer than the others
+        nvs_get_u8(handle, "audio_gate", &ac.gate);         // ... as is this
+        if (audio_config_valid(ac)) {
+            audioConfig = ac;
+            ESP_LOGI(TAG, "Loaded audio config from NVS");
+        } else {
+            ESP_LOGW(TAG, "Ignoring invalid audio config in NVS");
+        }
+    }
+
     // Load OpenSky authentication
     size_t username_len = sizeof(openSkyAuth.username);
     size_t password_len = sizeof(openSkyAuth.password);
@@ -332,6 +413,128 @@ void AppConfig::saveBrightnessToNVS() {
     ESP_LOGI(TAG, "Brightness saved to NVS");
 }
 
+DisplayConfig AppConfig::getDisplayConfig() {
+    return displayConfig;
+}
+
+bool AppConfig::setDisplayConfig(const DisplayConfig& cfg) {
+    if (cfg.panel_width == 0 || cfg.panel_height == 0 || cfg.chain_length == 0 ||
+        cfg.tile_rows == 0 || cfg.chain_length % cfg.tile_rows != 0) {
+        ESP_LOGE(TAG, "Invalid display geometry: %dx%d x%d in %d row(s)",
+                 cfg.panel_width, cfg.panel_height, cfg.chain_length, cfg.tile_rows);
+        return false;
+    }
+
+    // Only the profile is stored, so driver settings must be exactly its own
+    if ((size_t)cfg.profile >= (size_t)DisplayProfile::COUNT) {
+        ESP_LOGE(TAG, "Invalid display profile: %d", (int)cfg.profile);
+        return false;
+    }
+    DisplayConfig driver;
+    driver.applyProfile(cfg.profile);
+    if (cfg.color_depth != driver.color_depth || cfg.dither != driver.dither ||
+        cfg.clock_mhz != driver.clock_mhz || cfg.latch_blanking != driver.latch_blanking ||
+        cfg.min_refresh_hz != driver.min_refresh_hz) {
+        ESP_LOGE(TAG, "Driver settings do not match the %s profile; use setDisplayProfile()",
+                 display_profile_spec(cfg.profile).id);
+        return false;
+    }
+
+    if (cfg.panel_height > 32 && cfg.pin_e < 0) {
+        ESP_LOGW(TAG, "%d-row modules need the E address pin configured", cfg.panel_height);
+    }
+
+    displayConfig = cfg;
+    saveDisplayConfigToNVS();
+
+    ESP_LOGI(TAG, "Display geometry set to %dx%d (applies after restart)", cfg.width(), cfg.height());
+    return true;
+}
+
+bool AppConfig::setDisplayProfile(DisplayProfile profile) {
+    if ((size_t)profile >= (size_t)DisplayProfile::COUNT) {
+        ESP_LOGE(TAG, "Invalid display profile: %d", (int)profile);
+        return false;
+    }
+
+    displayConfig.applyProfile(profile);
+    saveDisplayConfigToNVS();
+
+    ESP_LOGI(TAG, "Display profile set to %s", display_profile_spec(profile).id);
+    return true;
+}
+
+DisplayStatus AppConfig::getDisplayStatus() {
+    return displayStatus;
+}
+
+void AppConfig::setDisplayStatus(const DisplayStatus& status) {
+    displayStatus = status;
+}
+
+void AppConfig::saveDisplayConfigToNVS() {
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open("app_config", NVS_READWRITE, &handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS for writing display config");
+        return;
+    }
+
+    nvs_set_u16(handle, "panel_w", displayConfig.panel_width);
+    nvs_set_u16(handle, "panel_h", displayConfig.panel_height);
+    nvs_set_u8(handle, "panel_chain", displayConfig.chain_length);
+    nvs_set_u8(handle, "panel_rows", displayConfig.tile_rows);
+    nvs_set_u8(handle, "panel_serp", displayConfig.serpentine ? 1 : 0);
+    nvs_set_i8(handle, "panel_pin_e", displayConfig.pin_e);
+    nvs_set_u8(handle, "panel_profile", (uint8_t)displayConfig.profile);
+    nvs_commit(handle);
+    nvs_close(handle);
+
+    ESP_LOGI(TAG, "Display config saved to NVS");
+}
+
+// ---------------------------------------------------
+// Audio Methods
+// ---------------------------------------------------
+AudioConfig AppConfig::getAudioConfig() {
+    return audioConfig;
+}
+
+bool AppConfig::setAudioConfig(const AudioConfig& cfg) {
+    if (!audio_config_valid(cfg)) {
+        ESP_LOGE(TAG, "Invalid audio config: %d-sample window, %d%% overlap, pipeline %d, gate %d",
+                 cfg.window, cfg.overlap_pct, cfg.pipeline, cfg.gate);
+        return false;
+    }
+
+    audioConfig = cfg;
+    saveAudioConfigToNVS();
+
+    ESP_LOGI(TAG, "Audio set to %d-sample window, %d%% overlap, pipeline %d, gate %d",
+             cfg.window, cfg.overlap_pct, cfg.pipeline, cfg.gate);
+    return true;
+}
+
+void AppConfig::saveAudioConfigToNVS() {
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open("app_config", NVS_READWRITE, &handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS for writing audio config");
+        return;
+    }
+
+    nvs_set_u16(handle, "audio_win", audioConfig.window);
+    nvs_set_u8(handle, "audio_ovl", audioConfig.overlap_pct);
+    nvs_set_u8(handle, "audio_pipe", audioConfig.pipeline);
+    nvs_set_u8(handle, "audio_gate", audioConfig.gate);
+    nvs_commit(handle);
+    nvs_close(handle);
+
+    ESP_LOGI(TAG, "Audio config saved to NVS");
+}
+
 // ---------------------------------------------------
 // OpenSky Authentication Methods
 // ---------------------------------------------------
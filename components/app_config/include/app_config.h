@@ -29,6 +29,85 @@ struct OpenSkyAuthConfig {
     bool authenticated = false;
 };
 
+// Named trade-offs between color depth, refresh rate and DMA memory. A
+// profile fills in the driver fields of DisplayConfig; the geometry is
+// left alone, so switching profiles never needs a restart.
+enum class DisplayProfile : uint8_t {
+    BALANCED = 0,       // 6-bit dithered at 8 MHz (the default)
+    LOW_RAM,            // 4-bit dithered: least DMA memory
+    HIGH_REFRESH,       // 5-bit dithered at 15 MHz: flicker-free on camera
+    MAX_COLOR,          // 8-bit: smoothest gradients, lowest refresh
+    COUNT
+};
+
+struct DisplayProfileSpec {
+    const char* id;             // NVS / web form value
+    const char* label;
+    uint8_t color_depth;
+    bool dither;
+    uint8_t clock_mhz;          // HUB75 shift clock: 8, 10, 15 or 20
+    uint8_t latch_blanking;     // blank clocks around each latch (ghosting vs refresh)
+    uint8_t min_refresh_hz;     // driver shortens the low bit planes to hold this
+};
+
+const DisplayProfileSpec& display_profile_spec(DisplayProfile profile);
+bool display_profile_from_id(const char* id, DisplayProfile& out);
+
+// Physical panel geometry. chain_length modules of panel_width x panel_height
+// are wired on one HUB75 chain and stacked into tile_rows rows, giving a
+// (panel_width * chain_length / tile_rows) x (panel_height * tile_rows) canvas.
+struct DisplayConfig {
+    uint16_t panel_width = 64;       // resolution of a single module
+    uint16_t panel_height = 32;
+    uint8_t chain_length = 1;        // modules on the chain
+    uint8_t tile_rows = 1;           // rows the chain is folded into (must divide chain_length)
+    bool serpentine = true;          // odd rows run right-to-left, modules mounted upside-down
+    int8_t pin_e = -1;               // E address line, required for 64-row (1/32 scan) modules
+    uint8_t color_depth = 6;         // bit planes the DMA engine drives (4..8)
+    bool dither = true;              // temporal dithering fills in levels between bit planes
+    uint8_t clock_mhz = 8;
+    uint8_t latch_blanking = 2;
+    uint8_t min_refresh_hz = 60;
+    DisplayProfile profile = DisplayProfile::BALANCED;
+
+    void applyProfile(DisplayProfile p) {
+        const DisplayProfileSpec& spec = display_profile_spec(p);
+        profile = p;
+        color_depth = spec.color_depth;
+        dither = spec.dither;
+        clock_mhz = spec.clock_mhz;
+        latch_blanking = spec.latch_blanking;
+        min_refresh_hz = spec.min_refresh_hz;
+    }
+
+    int width() const { return panel_width * chain_length / tile_rows; }
+    int height() const { return panel_height * tile_rows; }
+};
+
+// What the display driver actually allocated and runs at, filled in by
+// LEDMatrix after each (re)initialization. Not persisted.
+struct DisplayStatus {
+    DisplayProfile profile = DisplayProfile::BALANCED;
+    uint32_t dma_bytes = 0;         // DMA-capable heap taken by the driver
+    uint16_t refresh_hz = 0;        // whole-panel refreshes per second
+    uint8_t color_depth = 0;
+    uint8_t lsb_msb_transition = 0; // planes shown at reduced BCM weight to reach refresh_hz
+    bool dither = false;
+    bool valid = false;
+};
+
+// Microphone spectrum analysis: an FFT over the newest `window` samples,
+// repeated every hop. Overlap trades CPU for update rate at a given
+// frequency resolution; the hop, not the frame rate, paces the spectra.
+struct AudioConfig {
+    uint16_t window = 1024;          // samples per FFT: 256, 512, 1024 or 2048
+    uint8_t overlap_pct = 75;        // 0, 50 or 75
+    uint8_t pipeline = 0;            // 0 = the build's (AUDIO_FIXED_POINT), 1 = float, 2 = Q15 fixed point
+    uint8_t gate = 1;                // 1 = no FFT in silence, the spectrum screen idles; 0 = always analyse
+
+    int hop() const { return window * (100 - overlap_pct) / 100; }
+};
+
 class AppConfig {
 public:
     static AppConfig& instance();
@@ -61,6 +140,15 @@ public:
     // Display
     uint8_t getBrightness();
     void setBrightness(uint8_t value);
+    DisplayConfig getDisplayConfig();
+    bool setDisplayConfig(const DisplayConfig& cfg);  // Geometry takes effect on next boot; driver fields must match cfg.profile
+    bool setDisplayProfile(DisplayProfile profile);   // Applied at runtime by the main loop
+    DisplayStatus getDisplayStatus();
+    void setDisplayStatus(const DisplayStatus& status);
+
+    // Audio
+    AudioConfig getAudioConfig();
+    bool setAudioConfig(const AudioConfig& cfg);      // Picked up by the spectrum screen
 
     // Validation
     bool isFullyConfigured();  // Returns true if location AND timezone set
@@ -72,6 +160,8 @@ private:
     void saveTimezoneToNVS();
     void saveFlightConfigToNVS();
     void saveBrightnessToNVS();
+    void saveDisplayConfigToNVS();
+    void saveAudioConfigToNVS();
     void saveOpenSkyAuthToNVS();
 
     LocationConfig location;
@@ -79,4 +169,7 @@ private:
     FlightConfig flightConfig;
     OpenSkyAuthConfig openSkyAuth;
     uint8_t brightness = 128;
+    DisplayConfig displayConfig;
+    DisplayStatus displayStatus;
+    AudioConfig audioConfig;
 };
@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""
+Encodes a pre-rendered animation for the anim flash partition.
+
+    anim_encode.py clip.png -o clip.lma                  animated PNG or GIF
+    anim_encode.py frames/*.png --fps 30 -o clip.lma     one still per frame
+
+Frames are quantized to RGB565 and stored as runs against the previous
+frame (unchanged pixels are skipped), with a full keyframe every
+--keyframe seconds so playback can seek and recover. The file format is
+described in components/display/include/anim_player.h.
+
+--tolerance N treats a pixel as unchanged while every RGB565 channel is
+within N steps of what the decoder shows; differences are measured
+against the decoded frame, so the error never accumulates beyond N.
+--reference writes the decoded frames as raw little-endian RGB565, which
+`led_matrix_sim anim --reference` compares the C++ decoder against.
+
+Flash it with
+    parttool.py write_partition --partition-name anim --input clip.lma
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+import zlib
+
+# Reuses asset_gen's image loaders; keep the source tree free of .pyc files
+sys.dont_write_bytecode = True
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from asset_gen import (AssetError, RLE_COPY, RLE_FILL, RLE_MAX_LENGTH, RLE_OP_SHIFT, RLE_SKIP,
+                       MIN_FILL, load_gif, load_png, rgb565)
+
+ANIM_MAGIC = 0x31414D4C         # "LMA1"
+ANIM_VERSION = 1
+ANIM_KEYFRAME = 1
+ANIM_SKIP_COPY = 3
+ANIM_COPY_BITS = 4
+ANIM_MAX_SKIP_COPY = ((1 << (RLE_OP_SHIFT - ANIM_COPY_BITS)) - 1, (1 << ANIM_COPY_BITS) - 1)
+HEADER = struct.Struct("<IHHHHIIIIHH")
+MERGE_GAP = 1                   # unchanged pixels cheaper to copy than to skip
+
+
+def load_frames(paths):
+    """(width, height, frames of RGB565 ints, frame_ms) from the inputs."""
+    if len(paths) == 1:
+        ext = os.path.splitext(paths[0])[1].lower()
+        loader = {".png": load_png, ".gif": load_gif}.get(ext)
+        if loader is None:
+            raise AssetError("unsupported file type")
+        width, height, frames, frame_ms = loader(paths[0])
+    else:
+        width = height = None
+        frames, frame_ms = [], 0
+        for path in sorted(paths):
+            w, h, still, _ = load_png(path)
+            if width is None:
+                width, height = w, h
+            elif (w, h) != (width, height):
+                raise AssetError("%s is %dx%d, expected %dx%d" % (path, w, h, width, height))
+            frames.append(still[0])
+
+    # Transparent pixels are black on the panel
+    quantized = [[rgb565(r, g, b) if a >= 128 else 0 for r, g, b, a in f] for f in frames]
+    return width, height, quantized, frame_ms
+
+
+def _close(a, b, tolerance):
+    return (abs((a >> 11) - (b >> 11)) <= tolerance and
+            abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F)) <= tolerance and
+            abs((a & 0x1F) - (b & 0x1F)) <= tolerance)
+
+
+def encode_frame(target, shown, keyframe, tolerance):
+    """Words for one frame; updates `shown` to what the decoder will show."""
+    count = len(target)
+    if keyframe:
+        shown[:] = [0] * count
+
+    # Pixels that need writing
+    if tolerance == 0:
+        changed = [t != s for t, s in zip(target, shown)]
+    else:
+        changed = [t != s and not _close(t, s, tolerance) for t, s in zip(target, shown)]
+
+    # Short unchanged gaps between changes cost less inside a copy run
+    i = 0
+    while i < count:
+        if changed[i]:
+            i += 1
+            continue
+        j = i
+        while j < count and not changed[j]:
+            j += 1
+        if 0 < i and j < count and j - i <= MERGE_GAP:
+            for k in range(i, j):
+                changed[k] = True
+        i = j
+
+    words = [ANIM_KEYFRAME if keyframe else 0]
+    literal = []
+    skip = [0]              # unchanged pixels not yet written out
+
+    def flush_skip():
+        while skip[0]:
+            n = min(skip[0], RLE_MAX_LENGTH)
+            words.append((RLE_SKIP << RLE_OP_SHIFT) | n)
+            skip[0] -= n
+
+    def flush_literal():
+        if not literal:
+            return
+        # A short copy after a short skip shares its header word
+        if 0 < skip[0] <= ANIM_MAX_SKIP_COPY[0] and len(literal) <= ANIM_MAX_SKIP_COPY[1]:
+            words.append((ANIM_SKIP_COPY << RLE_OP_SHIFT) | (skip[0] << ANIM_COPY_BITS) | len(literal))
+            words.extend(literal)
+            skip[0] = 0
+            del literal[:]
+            return
+        flush_skip()
+        while literal:
+            chunk = literal[:RLE_MAX_LENGTH]
+            del literal[:RLE_MAX_LENGTH]
+            words.append((RLE_COPY << RLE_OP_SHIFT) | len(chunk))
+            words.extend(chunk)
+
+    i = 0
+    while i < count:
+        if not changed[i]:
+            flush_literal()
+            skip[0] += 1
+            i += 1
+            continue
+        j = i
+        while j < count and changed[j] and target[j] == target[i] and j - i < RLE_MAX_LENGTH:
+            j += 1
+        if j - i >= MIN_FILL:
+            flush_literal()
+            flush_skip()
+            words.append((RLE_FILL << RLE_OP_SHIFT) | (j - i))
+            words.append(target[i])
+        else:
+            literal.extend(target[i:j])
+        shown[i:j] = target[i:j]
+        i = j
+    flush_literal()
+    # Trailing unchanged pixels need no run
+    return words
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("inputs", nargs="+")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--fps", type=float, help="default: the input's frame delay, else 60")
+    parser.add_argument("--keyframe", type=float, default=2.0, help="seconds between keyframes")
+    parser.add_argument("--tolerance", type=int, default=0, help="RGB565 steps treated as unchanged")
+    parser.add_argument("--reference", help="also write the decoded frames as raw RGB565")
+    args = parser.parse_args()
+
+    started = time.time()
+    try:
+        width, height, frames, frame_ms = load_frames(args.inputs)
+    except (AssetError, OSError, zlib.error, KeyError, IndexError) as e:
+        sys.exit("anim_encode: %s" % e)
+
+    fps = args.fps or (1000.0 / frame_ms if frame_ms else 60.0)
+    frame_us = int(round(1e6 / fps))
+    key_interval = max(1, int(round(args.keyframe * fps)))
+
+    shown = [0] * (width * height)
+    encoded = []
+    reference = open(args.reference, "wb") if args.reference else None
+    for n, target in enumerate(frames):
+        encoded.append(encode_frame(target, shown, n % key_interval == 0, args.tolerance))
+        if reference:
+            reference.write(struct.pack("<%dH" % len(shown), *shown))
+    if reference:
+        reference.close()
+
+    table_bytes = (len(encoded) + 1) * 4
+    offsets, at = [], HEADER.size + table_bytes
+    for words in encoded:
+        offsets.append(at)
+        at += len(words) * 2
+    offsets.append(at)
+
+    body = struct.pack("<%dI" % len(offsets), *offsets)
+    body += b"".join(struct.pack("<%dH" % len(w), *w) for w in encoded)
+    header = HEADER.pack(ANIM_MAGIC, ANIM_VERSION, HEADER.size, width, height, len(encoded),
+                         frame_us, HEADER.size + len(body), zlib.crc32(body) & 0xFFFFFFFF,
+                         key_interval, 0)
+    with open(args.output, "wb") as f:
+        f.write(header + body)
+
+    total = HEADER.size + len(body)
+    seconds = len(encoded) / fps
+    raw = width * height * 2 * len(encoded)
+    keys = sum(1 for w in encoded if w[0] & ANIM_KEYFRAME)
+    print("%s: %dx%d, %d frames (%d keyframes) at %.2f FPS, %.1f s" %
+          (args.output, width, height, len(encoded), keys, fps, seconds))
+    print("  %d bytes (%.1f%% of raw RGB565), %.0f bytes/frame, %.0f KB per minute" %
+          (total, 100.0 * total / raw, total / len(encoded), total / seconds * 60 / 1024))
+    print("  encoded in %.1f s" % (time.time() - started))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,476 @@
+#!/usr/bin/env python3
+"""
+Converts PNG, APNG and GIF sprites into run-length encoded RGB565 C++ data.
+
+    asset_gen.py --header assets.h sprites/*.png sprites/*.gif
+
+The header holds one `inline constexpr RleSprite ASSET_<NAME>` per file
+(all frames of an animated GIF or PNG in one sprite) and the ASSET_SPRITE_TABLE
+list assets.cpp builds the registry from. Pixels with alpha below 50% (or a GIF's
+transparent index) become transparent runs. The run format is described
+in include/rle_sprite.h.
+
+Only the Python standard library is used, so the ESP-IDF Python
+environment can run it as part of the build.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+RLE_SKIP, RLE_FILL, RLE_COPY = 0, 1, 2
+RLE_OP_SHIFT = 14
+RLE_MAX_LENGTH = (1 << RLE_OP_SHIFT) - 1
+MIN_FILL = 3            # shorter repeats are cheaper inside a COPY run
+
+
+class AssetError(Exception):
+    pass
+
+
+# -----------------------------------------------------
+# PNG and APNG (non-interlaced, 8-bit channels or 1/2/4/8-bit palette/gray)
+# -----------------------------------------------------
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def _png_pixels(data, width, height, depth, color, palette, trns):
+    """(r, g, b, a) pixels of one deflated image in the IHDR's format."""
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color]
+    bits = depth * channels
+    stride = (width * bits + 7) // 8
+    bpp = max(1, bits // 8)
+    raw = zlib.decompress(data)
+
+    rows = []
+    prev = bytearray(stride)
+    for y in range(height):
+        base = y * (stride + 1)
+        ftype = raw[base]
+        line = bytearray(raw[base + 1:base + 1 + stride])
+        if ftype != 0:
+            for i in range(stride):
+                a = line[i - bpp] if i >= bpp else 0
+                b = prev[i]
+                c = prev[i - bpp] if i >= bpp else 0
+                if ftype == 1:
+                    line[i] = (line[i] + a) & 0xFF
+                elif ftype == 2:
+                    line[i] = (line[i] + b) & 0xFF
+                elif ftype == 3:
+                    line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+                elif ftype == 4:
+                    line[i] = (line[i] + _paeth(a, b, c)) & 0xFF
+        rows.append(line)
+        prev = line
+
+    pixels = []
+    for line in rows:
+        if color == 2:
+            pixels.extend(zip(line[0::3], line[1::3], line[2::3], [255] * width))
+            continue
+        if color == 6:
+            pixels.extend(zip(line[0::4], line[1::4], line[2::4], line[3::4]))
+            continue
+        for x in range(width):
+            if depth < 8:
+                per = 8 // depth
+                v = (line[x // per] >> ((per - 1 - x % per) * depth)) & ((1 << depth) - 1)
+            else:
+                v = None
+            if color == 3:
+                idx = v if v is not None else line[x]
+                r, g, b = palette[idx]
+                a = trns[idx] if trns is not None and idx < len(trns) else 255
+            elif color == 0:
+                g = v * 255 // ((1 << depth) - 1) if v is not None else line[x]
+                r = b = g
+                a = 255
+            else:
+                r = g = b = line[x * 2]
+                a = line[x * 2 + 1]
+            pixels.append((r, g, b, a))
+    return pixels
+
+
+def _over(dst, src):
+    """Straight-alpha `src` over `dst`."""
+    sa = src[3]
+    if sa == 255 or dst[3] == 0:
+        return src
+    if sa == 0:
+        return dst
+    da = dst[3] * (255 - sa) // 255
+    out_a = sa + da
+    return tuple((src[i] * sa + dst[i] * da) // out_a for i in range(3)) + (out_a,)
+
+
+def load_png(path):
+    """Still PNG, or every frame of an animated PNG composited in order."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise AssetError("not a PNG file")
+
+    pos = 8
+    idat = b""
+    palette, trns = None, None
+    controls = []           # (fcTL fields, image data) per APNG frame
+    current = None
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"PLTE":
+            palette = [tuple(body[i:i + 3]) for i in range(0, len(body), 3)]
+        elif kind == b"tRNS":
+            trns = body
+        elif kind == b"fcTL":
+            current = [struct.unpack(">IIIIIHHBB", body[:26]), b""]
+            controls.append(current)
+        elif kind == b"IDAT":
+            idat += body
+            if current is not None:
+                current[1] += body
+        elif kind == b"fdAT":
+            if current is None:
+                raise AssetError("fdAT before fcTL")
+            current[1] += body[4:]
+        elif kind == b"IEND":
+            break
+
+    if interlace:
+        raise AssetError("interlaced PNGs are not supported")
+    if depth != 8 and color not in (0, 3):
+        raise AssetError("only 8-bit RGB/RGBA/gray+alpha PNGs are supported")
+
+    if not controls:
+        return width, height, [_png_pixels(idat, width, height, depth, color, palette, trns)], 0
+
+    # APNG: each frame is a region drawn over the canvas, then disposed
+    transparent = (0, 0, 0, 0)
+    canvas = [transparent] * (width * height)
+    frames, delays = [], []
+    for i, ((_, fw, fh, fx, fy, num, den, dispose, blend), image) in enumerate(controls):
+        if not image:
+            raise AssetError("APNG frame %d has no image data" % i)
+        if fx + fw > width or fy + fh > height:
+            raise AssetError("APNG frame %d lies outside the canvas" % i)
+        region = _png_pixels(image, fw, fh, depth, color, palette, trns)
+
+        previous = list(canvas)
+        for y in range(fh):
+            row = (fy + y) * width + fx
+            for x in range(fw):
+                src = region[y * fw + x]
+                canvas[row + x] = src if blend == 0 else _over(canvas[row + x], src)
+
+        frames.append(list(canvas))
+        delays.append(num * 1000.0 / (den or 100))
+
+        if dispose == 1 or (dispose == 2 and i == 0):
+            for y in range(fy, fy + fh):
+                canvas[y * width + fx:y * width + fx + fw] = [transparent] * fw
+        elif dispose == 2:
+            canvas = previous
+
+    frame_ms = delays[0] if len(frames) > 1 else 0
+    return width, height, frames, frame_ms
+
+
+# -----------------------------------------------------
+# GIF (all frames composited onto the logical screen)
+# -----------------------------------------------------
+def _lzw_decode(data, min_code_size, pixel_count):
+    clear = 1 << min_code_size
+    end = clear + 1
+    size = min_code_size + 1
+    table = [bytes([i]) for i in range(clear)] + [b"", b""]
+    out = bytearray()
+    prev = None
+    bitbuf = bitcount = pos = 0
+
+    while len(out) < pixel_count:
+        while bitcount < size and pos < len(data):
+            bitbuf |= data[pos] << bitcount
+            bitcount += 8
+            pos += 1
+        if bitcount < size:
+            break
+        code = bitbuf & ((1 << size) - 1)
+        bitbuf >>= size
+        bitcount -= size
+
+        if code == clear:
+            size = min_code_size + 1
+            table = table[:clear + 2]
+            prev = None
+            continue
+        if code == end:
+            break
+
+        if code < len(table):
+            entry = table[code]
+            if prev is not None:
+                table.append(prev + entry[:1])
+        elif prev is not None:
+            entry = prev + prev[:1]
+            table.append(entry)
+        else:
+            raise AssetError("corrupt GIF data")
+        out += entry
+        prev = entry
+        if len(table) == (1 << size) and size < 12:
+            size += 1
+
+    return out[:pixel_count]
+
+
+def _sub_blocks(data, pos):
+    out = bytearray()
+    while True:
+        n = data[pos]
+        pos += 1
+        if n == 0:
+            return bytes(out), pos
+        out += data[pos:pos + n]
+        pos += n
+
+
+def load_gif(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:6] not in (b"GIF87a", b"GIF89a"):
+        raise AssetError("not a GIF file")
+
+    width, height, flags = struct.unpack("<HHB", data[6:11])
+    pos = 13
+    global_palette = None
+    if flags & 0x80:
+        n = 2 << (flags & 7)
+        global_palette = [tuple(data[pos + i * 3:pos + i * 3 + 3]) for i in range(n)]
+        pos += n * 3
+
+    transparent = (0, 0, 0, 0)
+    canvas = [transparent] * (width * height)
+    frames, delays = [], []
+    gce_transparent, gce_delay, gce_disposal = None, 0, 0
+
+    while pos < len(data):
+        block = data[pos]
+        pos += 1
+        if block == 0x3B:
+            break
+        if block == 0x21:
+            label = data[pos]
+            body, pos = _sub_blocks(data, pos + 1)
+            if label == 0xF9 and len(body) >= 4:
+                packed, delay, tindex = struct.unpack("<BHB", body[:4])
+                gce_disposal = (packed >> 2) & 7
+                gce_transparent = tindex if packed & 1 else None
+                gce_delay = delay * 10
+            continue
+        if block != 0x2C:
+            raise AssetError("unexpected GIF block 0x%02x" % block)
+
+        fx, fy, fw, fh, fflags = struct.unpack("<HHHHB", data[pos:pos + 9])
+        pos += 9
+        palette = global_palette
+        if fflags & 0x80:
+            n = 2 << (fflags & 7)
+            palette = [tuple(data[pos + i * 3:pos + i * 3 + 3]) for i in range(n)]
+            pos += n * 3
+        if palette is None:
+            raise AssetError("GIF frame without a palette")
+
+        min_code_size = data[pos]
+        lzw, pos = _sub_blocks(data, pos + 1)
+        indices = _lzw_decode(lzw, min_code_size, fw * fh)
+
+        if fflags & 0x40:
+            # De-interlace: rows were stored in passes 0/8, 4/8, 2/4, 1/2
+            order = []
+            for start, step in ((0, 8), (4, 8), (2, 4), (1, 2)):
+                order.extend(range(start, fh, step))
+            rows = [indices[i * fw:(i + 1) * fw] for i in range(fh)]
+            fixed = [None] * fh
+            for i, y in enumerate(order):
+                fixed[y] = rows[i]
+            indices = b"".join(bytes(r) for r in fixed)
+
+        previous = list(canvas)
+        for y in range(fh):
+            for x in range(fw):
+                idx = indices[y * fw + x]
+                if idx == gce_transparent:
+                    continue
+                cx, cy = fx + x, fy + y
+                if cx < width and cy < height:
+                    r, g, b = palette[idx]
+                    canvas[cy * width + cx] = (r, g, b, 255)
+
+        frames.append(list(canvas))
+        delays.append(gce_delay)
+
+        # Disposal applies before the next frame is drawn
+        if gce_disposal == 2:
+            for y in range(fy, min(fy + fh, height)):
+                for x in range(fx, min(fx + fw, width)):
+                    canvas[y * width + x] = transparent
+        elif gce_disposal == 3:
+            canvas = previous
+        gce_transparent, gce_delay, gce_disposal = None, 0, 0
+
+    if not frames:
+        raise AssetError("GIF has no frames")
+    frame_ms = delays[0] if len(frames) > 1 else 0
+    return width, height, frames, frame_ms
+
+
+# -----------------------------------------------------
+# Encoding
+# -----------------------------------------------------
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def encode_row(row):
+    """Runs for one row of (r, g, b, a) pixels."""
+    words = []
+    px = [None if a < 128 else rgb565(r, g, b) for r, g, b, a in row]
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:RLE_MAX_LENGTH]
+            del literal[:RLE_MAX_LENGTH]
+            words.append((RLE_COPY << RLE_OP_SHIFT) | len(chunk))
+            words.extend(chunk)
+
+    i = 0
+    while i < len(px):
+        j = i
+        while j < len(px) and px[j] == px[i] and j - i < RLE_MAX_LENGTH:
+            j += 1
+        run = j - i
+        if px[i] is None:
+            flush_literal()
+            words.append((RLE_SKIP << RLE_OP_SHIFT) | run)
+        elif run >= MIN_FILL:
+            flush_literal()
+            words.append((RLE_FILL << RLE_OP_SHIFT) | run)
+            words.append(px[i])
+        else:
+            literal.extend(px[i:j])
+        i = j
+    flush_literal()
+    return words
+
+
+def encode_frame(width, height, pixels):
+    words = []
+    for y in range(height):
+        words.extend(encode_row(pixels[y * width:(y + 1) * width]))
+    return words
+
+
+def identifier(path):
+    name = os.path.splitext(os.path.basename(path))[0]
+    ident = re.sub(r"[^0-9A-Za-z]+", "_", name).strip("_").upper()
+    if not ident or ident[0].isdigit():
+        ident = "_" + ident
+    return name, ident
+
+
+def convert(path):
+    ext = os.path.splitext(path)[1].lower()
+    loader = {".png": load_png, ".gif": load_gif}.get(ext)
+    if loader is None:
+        raise AssetError("unsupported file type")
+    width, height, frames, frame_ms = loader(path)
+    if width > RLE_MAX_LENGTH:
+        raise AssetError("wider than %d pixels" % RLE_MAX_LENGTH)
+
+    rle, offsets = [], []
+    for pixels in frames:
+        offsets.append(len(rle))
+        rle.extend(encode_frame(width, height, pixels))
+    offsets.append(len(rle))
+    return width, height, len(frames), frame_ms, rle, offsets
+
+
+def c_array(values, fmt, per_line):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(fmt % v for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("--header", required=True)
+    parser.add_argument("files", nargs="*")
+    args = parser.parse_args()
+
+    sprites = []
+    for path in sorted(args.files, key=lambda p: os.path.basename(p)):
+        try:
+            sprites.append((path,) + identifier(path) + convert(path))
+        except (AssetError, OSError, zlib.error, KeyError, IndexError) as e:
+            sys.exit("asset_gen: %s: %s" % (path, e))
+
+    header = [
+        "#pragma once",
+        "",
+        "// Generated by asset_gen.py from components/assets/sprites; do not edit.",
+        "",
+        "#include \"rle_sprite.h\"",
+        "",
+    ]
+    report = ["%-16s %7s %6s %9s %9s %6s" % ("sprite", "size", "frames", "raw B", "flash B", "ratio")]
+
+    for path, name, ident, w, h, count, frame_ms, rle, offsets in sprites:
+        header.append("// %s: %dx%d, %d frame(s)" % (os.path.basename(path), w, h, count))
+        header.append("inline constexpr uint16_t ASSET_%s_RLE[] = {" % ident)
+        header.append(c_array(rle, "0x%04X", 12))
+        header.append("};")
+        header.append("inline constexpr uint32_t ASSET_%s_FRAMES[] = {" % ident)
+        header.append(c_array(offsets, "%d", 12))
+        header.append("};")
+        header.append("inline constexpr RleSprite ASSET_%s = {\"%s\", %d, %d, %d, %d, ASSET_%s_RLE, ASSET_%s_FRAMES};"
+                      % (ident, name, w, h, count, int(round(frame_ms)), ident, ident))
+        header.append("")
+
+        raw = w * h * count * 2
+        flash = len(rle) * 2 + len(offsets) * 4
+        report.append("%-16s %7s %6d %9d %9d %5.0f%%" % (name, "%dx%d" % (w, h), count, raw, flash,
+                                                        100.0 * flash / raw if raw else 0.0))
+
+    header.append("/*")
+    header.extend(report)
+    header.append("*/")
+
+    # Registry contents for assets.cpp
+    header.append("#define ASSET_SPRITE_TABLE %s" % (", ".join("&ASSET_" + sp[2] for sp in sprites) or "nullptr"))
+    header.append("#define ASSET_SPRITE_TABLE_SIZE %d" % len(sprites))
+    header.append("")
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.header)), exist_ok=True)
+    with open(args.header, "w") as f:
+        f.write("\n".join(header) + "\n")
+
+    print("\n".join(report))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,15 @@
+#include "assets.h"
+#include <string.h>
+
+// assets.h is generated into the build tree from sprites/ (see CMakeLists.txt)
+
+const RleSprite* const ASSET_SPRITES[] = {ASSET_SPRITE_TABLE};
+const int ASSET_SPRITE_COUNT = ASSET_SPRITE_TABLE_SIZE;
+
+const RleSprite* asset_find(const char* name)
+{
+    for (int i = 0; i < ASSET_SPRITE_COUNT; ++i)
+        if (ASSET_SPRITES[i] && strcmp(ASSET_SPRITES[i]->name, name) == 0)
+            return ASSET_SPRITES[i];
+    return nullptr;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Run-length encoded RGB565 sprite, generated at build time from the PNG
+// and GIF files in components/assets/sprites (see asset_gen.py).
+//
+// Each frame is a sequence of 16-bit words, row by row; runs never cross
+// a row. A run starts with a header word: the top two bits are the
+// operation, the low 14 bits its length in pixels.
+//
+//   RLE_SKIP  len transparent pixels (source alpha below 50%)
+//   RLE_FILL  len pixels of the color in the next word
+//   RLE_COPY  len colors follow, one word each
+//
+// LEDMatrix::drawSprite() decodes straight into the frame buffer.
+
+enum RleOp : uint16_t {
+    RLE_SKIP = 0,
+    RLE_FILL = 1,
+    RLE_COPY = 2,
+};
+
+static const int RLE_OP_SHIFT = 14;
+static const uint16_t RLE_LENGTH_MASK = (1 << RLE_OP_SHIFT) - 1;
+
+struct RleSprite {
+    const char* name;
+    uint16_t width;
+    uint16_t height;
+    uint16_t frameCount;
+    uint16_t frameMs;           // per frame for animations (GIF delay), 0 for stills
+    const uint16_t* rle;        // every frame's runs back to back
+    const uint32_t* frames;     // frameCount + 1 word offsets into rle
+
+    // Frame showing `ms` into a looping animation
+    constexpr int frameAt(uint32_t ms) const
+    {
+        return frameMs ? (int)((ms / frameMs) % frameCount) : 0;
+    }
+
+    // Bytes the sprite takes in flash (runs + frame table)
+    constexpr size_t flashBytes() const
+    {
+        return frames[frameCount] * sizeof(uint16_t) + (frameCount + 1) * sizeof(uint32_t);
+    }
+
+    // The same frames stored as plain RGB565
+    constexpr size_t rawBytes() const
+    {
+        return (size_t)width * height * frameCount * sizeof(uint16_t);
+    }
+};
+
+// Every generated sprite, in file name order
+extern const RleSprite* const ASSET_SPRITES[];
+extern const int ASSET_SPRITE_COUNT;
+
+// nullptr when there is no sprite of that name (file name without extension)
+const RleSprite* asset_find(const char* name);
@@ -0,0 +1,59 @@
+#include "anim_partition.h"
+#include "anim_player.h"
+#include "esp_partition.h"
+#include <esp_log.h>
+
+static const char* TAG = "AnimPartition";
+
+// Data subtype of the partition; 0x40-0xFE are free for applications
+static const esp_partition_subtype_t ANIM_PARTITION_SUBTYPE = (esp_partition_subtype_t)0x40;
+
+AnimPartition& AnimPartition::instance()
+{
+    static AnimPartition inst;
+    return inst;
+}
+
+bool AnimPartition::map()
+{
+    if (_data) return true;
+
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ANIM_PARTITION_SUBTYPE, "anim");
+    if (!part) {
+        ESP_LOGI(TAG, "No anim partition");
+        return false;
+    }
+
+    // Read the header to map only what the animation occupies (64 KB MMU pages)
+    AnimHeader header;
+    if (esp_partition_read(part, 0, &header, sizeof(header)) != ESP_OK ||
+        header.magic != ANIM_MAGIC || header.fileBytes < sizeof(header) ||
+        header.fileBytes > part->size) {
+        ESP_LOGI(TAG, "anim partition holds no animation");
+        return false;
+    }
+
+    const void* ptr = nullptr;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(part, 0, header.fileBytes, ESP_PARTITION_MMAP_DATA, &ptr, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Could not map %u bytes: %s", (unsigned)header.fileBytes, esp_err_to_name(err));
+        return false;
+    }
+
+    _data = (const uint8_t*)ptr;
+    _size = header.fileBytes;
+    _handle = handle;
+    ESP_LOGI(TAG, "Mapped %u bytes: %ux%u, %u frames", (unsigned)_size,
+             header.width, header.height, (unsigned)header.frameCount);
+    return true;
+}
+
+void AnimPartition::unmap()
+{
+    if (!_data) return;
+    esp_partition_munmap(_handle);
+    _data = nullptr;
+    _size = 0;
+}
@@ -0,0 +1,220 @@
+#include "anim_player.h"
+#include <string.h>
+
+// -----------------------------------------------------
+// CRC-32 (reflected, polynomial 0xEDB88320, as zlib)
+// -----------------------------------------------------
+uint32_t anim_crc32(const uint8_t* data, size_t size, uint32_t crc)
+{
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        ready = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// -----------------------------------------------------
+// Opening: everything the decoder later relies on is checked here once
+// -----------------------------------------------------
+bool AnimPlayer::open(const uint8_t* data, size_t size)
+{
+    close();
+
+    const AnimHeader* h = (const AnimHeader*)data;
+    if (!data || size < sizeof(AnimHeader) || h->magic != ANIM_MAGIC) {
+        _error = "no animation (bad magic)";
+        return false;
+    }
+    if (h->version != ANIM_VERSION || h->headerBytes != sizeof(AnimHeader)) {
+        _error = "unsupported animation version";
+        return false;
+    }
+    if (h->width == 0 || h->height == 0 || h->frameCount == 0 || h->frameUs == 0) {
+        _error = "empty animation";
+        return false;
+    }
+
+    const size_t tableBytes = ((size_t)h->frameCount + 1) * sizeof(uint32_t);
+    if (h->fileBytes > size || h->fileBytes < sizeof(AnimHeader) + tableBytes) {
+        _error = "animation is truncated";
+        return false;
+    }
+    if (anim_crc32(data + sizeof(AnimHeader), h->fileBytes - sizeof(AnimHeader)) != h->crc32) {
+        _error = "animation CRC mismatch";
+        return false;
+    }
+
+    // Frames are whole 16-bit words inside the file, in order, each at
+    // least a flags word
+    const uint32_t* offsets = (const uint32_t*)(data + sizeof(AnimHeader));
+    uint32_t previous = sizeof(AnimHeader) + tableBytes;
+    for (uint32_t i = 0; i <= h->frameCount; ++i) {
+        uint32_t at = offsets[i];
+        bool ok = (at & 1) == 0 && at <= h->fileBytes &&
+                  (i == 0 ? at >= previous : at >= previous + sizeof(uint16_t));
+        if (!ok) {
+            _error = "animation frame table is corrupt";
+            return false;
+        }
+        previous = at;
+    }
+    if (!(*(const uint16_t*)(data + offsets[0]) & ANIM_KEYFRAME)) {
+        _error = "animation does not start with a keyframe";
+        return false;
+    }
+
+    _data = data;
+    _header = h;
+    _offsets = offsets;
+    _frame = -1;
+    _error = nullptr;
+    return true;
+}
+
+void AnimPlayer::close()
+{
+    _data = nullptr;
+    _header = nullptr;
+    _offsets = nullptr;
+    _frame = -1;
+    _error = "not opened";
+}
+
+size_t AnimPlayer::frameBytes(int index) const
+{
+    if (!valid() || index < 0 || index >= frameCount()) return 0;
+    return _offsets[index + 1] - _offsets[index];
+}
+
+bool AnimPlayer::isKeyframe(int index) const
+{
+    if (!valid() || index < 0 || index >= frameCount()) return false;
+    return *(const uint16_t*)(_data + _offsets[index]) & ANIM_KEYFRAME;
+}
+
+int AnimPlayer::keyframeAtOrBefore(int index) const
+{
+    while (index > 0 && !isKeyframe(index)) --index;
+    return index;
+}
+
+// -----------------------------------------------------
+// Playback
+// -----------------------------------------------------
+int AnimPlayer::seek(int index, FrameBuffer& fb)
+{
+    if (!valid() || index < 0 || index >= frameCount() || index == _frame) return 0;
+
+    // Deltas from the frame on screen, unless the keyframe is closer
+    const int key = keyframeAtOrBefore(index);
+    const int from = (_frame >= key && _frame < index) ? _frame + 1 : key;
+
+    for (int i = from; i <= index; ++i) {
+        if (!decode(i, fb)) {
+            _frame = -1;
+            return i - from;
+        }
+    }
+    _frame = index;
+    return index - from + 1;
+}
+
+bool AnimPlayer::decode(int index, FrameBuffer& fb)
+{
+    const int w = _header->width;
+    const int h = _header->height;
+    if (!fb.valid() || fb.width() < w || fb.height() < h) {
+        _error = "animation is larger than the panel";
+        return false;
+    }
+
+    const size_t stride = (size_t)fb.width() * 3;
+    uint8_t* origin = fb.pixels() + (size_t)((fb.height() - h) / 2) * stride + (size_t)((fb.width() - w) / 2) * 3;
+
+    const uint16_t* word = (const uint16_t*)(_data + _offsets[index]);
+    const uint16_t* end = (const uint16_t*)(_data + _offsets[index + 1]);
+
+    if (*word++ & ANIM_KEYFRAME) {
+        for (int y = 0; y < h; ++y)
+            memset(origin + y * stride, 0, (size_t)w * 3);
+    }
+
+    const uint32_t total = (uint32_t)w * h;
+    uint32_t pos = 0;
+    bool ok = true;
+    while (word < end) {
+        int op = *word >> RLE_OP_SHIFT;
+        uint32_t len = *word & RLE_LENGTH_MASK;
+        if (op == ANIM_SKIP_COPY) {
+            uint32_t skip = (*word >> ANIM_COPY_BITS) & ANIM_SKIP_MASK;
+            if (skip > total - pos) {
+                ok = false;
+                break;
+            }
+            pos += skip;
+            len = *word & ANIM_COPY_MASK;
+            op = RLE_COPY;
+        }
+        ++word;
+        if (len > total - pos) {
+            ok = false;
+            break;
+        }
+
+        if (op == RLE_SKIP) {
+            pos += len;
+            continue;
+        }
+
+        uint8_t r = 0, g = 0, b = 0;
+        if (op == RLE_FILL) {
+            if (word >= end) {
+                ok = false;
+                break;
+            }
+            FrameBuffer::unpack565(*word++, r, g, b);
+        } else if (op != RLE_COPY || len > (uint32_t)(end - word)) {
+            ok = false;
+            break;
+        }
+
+        // The run may wrap onto following rows
+        int x = pos % w;
+        int y = pos / w;
+        pos += len;
+        while (len > 0) {
+            uint32_t n = (uint32_t)(w - x) < len ? (uint32_t)(w - x) : len;
+            uint8_t* dst = origin + y * stride + (size_t)x * 3;
+            if (op == RLE_FILL) {
+                for (uint32_t i = 0; i < n; ++i, dst += 3) {
+                    dst[0] = r;
+                    dst[1] = g;
+                    dst[2] = b;
+                }
+            } else {
+                for (uint32_t i = 0; i < n; ++i, dst += 3)
+                    FrameBuffer::unpack565(*word++, dst[0], dst[1], dst[2]);
+            }
+            len -= n;
+            x = 0;
+            ++y;
+        }
+    }
+
+    if (!ok) {
+        _error = "animation frame is corrupt";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,186 @@
+#include "compositor.h"
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------
+// Blend kernels
+// -----------------------------------------------------
+void blend_rgb888_scalar(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t bytes, uint16_t alpha)
+{
+    const uint32_t inv = 256 - alpha;
+    for (size_t i = 0; i < bytes; ++i)
+        dst[i] = (uint8_t)((a[i] * inv + b[i] * alpha) >> 8);
+}
+
+// Even and odd bytes are split into 16-bit lanes so one 32-bit multiply
+// scales two channels. a * (256 - alpha) + b * alpha <= 255 * 256, so a
+// lane never carries into its neighbor and the result matches the
+// scalar kernel bit for bit.
+void blend_rgb888(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t bytes, uint16_t alpha)
+{
+    if (alpha == 0) {
+        if (dst != a) memmove(dst, a, bytes);
+        return;
+    }
+    if (alpha >= 256) {
+        if (dst != b) memmove(dst, b, bytes);
+        return;
+    }
+
+    const uint32_t inv = 256 - alpha;
+    const uint32_t MASK = 0x00FF00FF;
+
+    size_t words = bytes / 4;
+    for (size_t i = 0; i < words; ++i) {
+        uint32_t wa, wb;
+        memcpy(&wa, a + i * 4, 4);
+        memcpy(&wb, b + i * 4, 4);
+
+        uint32_t even = ((wa & MASK) * inv + (wb & MASK) * alpha) >> 8;
+        uint32_t odd = ((wa >> 8) & MASK) * inv + ((wb >> 8) & MASK) * alpha;
+        uint32_t out = (even & MASK) | (odd & ~MASK);
+
+        memcpy(dst + i * 4, &out, 4);
+    }
+
+    size_t done = words * 4;
+    blend_rgb888_scalar(dst + done, a + done, b + done, bytes - done, alpha);
+}
+
+// -----------------------------------------------------
+// Transitions
+// -----------------------------------------------------
+Compositor::~Compositor()
+{
+    cancel();
+}
+
+bool Compositor::begin(const FrameBuffer& outgoing, Transition type, float seconds, int direction)
+{
+    cancel();
+    if (type == Transition::NONE || seconds <= 0.0f || !outgoing.valid()) return false;
+
+    _from = (uint8_t*)malloc(outgoing.sizeBytes());
+    if (!_from) return false;
+
+    memcpy(_from, outgoing.pixels(), outgoing.sizeBytes());
+    _width = outgoing.width();
+    _height = outgoing.height();
+    _type = type;
+    _duration = seconds;
+    _elapsed = 0.0f;
+    _direction = direction < 0 ? -1 : 1;
+    return true;
+}
+
+void Compositor::cancel()
+{
+    free(_from);
+    _from = nullptr;
+}
+
+void Compositor::update(float dt)
+{
+    if (!_from) return;
+
+    _elapsed += dt;
+    if (_elapsed >= _duration)
+        cancel();
+}
+
+void Compositor::apply(FrameBuffer& incoming) const
+{
+    if (!_from || !incoming.valid() || incoming.width() != _width || incoming.height() != _height)
+        return;
+
+    // Smoothstep: slow start and finish, the motion reads better than linear
+    float t = _elapsed / _duration;
+    if (t > 1.0f) t = 1.0f;
+    t = t * t * (3.0f - 2.0f * t);
+
+    uint8_t* out = incoming.pixels();
+    const size_t stride = (size_t)_width * 3;
+
+    switch (_type) {
+        case Transition::CROSSFADE:
+            blend_rgb888(out, _from, out, incoming.sizeBytes(), (uint16_t)(t * 256.0f));
+            break;
+
+        case Transition::SLIDE: {
+            // `shift` columns of the incoming frame are on screen
+            const int shift = (int)(t * _width);
+            const size_t keep = (size_t)(_width - shift) * 3;
+            for (int y = 0; y < _height; ++y) {
+                uint8_t* row = out + y * stride;
+                const uint8_t* from = _from + y * stride;
+                if (_direction > 0) {
+                    // Incoming enters from the right, outgoing leaves left
+                    memmove(row + keep, row, (size_t)shift * 3);
+                    memcpy(row, from + (size_t)shift * 3, keep);
+                } else {
+                    memmove(row, row + keep, (size_t)shift * 3);
+                    memcpy(row + (size_t)shift * 3, from, keep);
+                }
+            }
+            break;
+        }
+
+        case Transition::WIPE: {
+            const int edge = (int)(t * _width);
+            const size_t covered = (size_t)edge * 3;
+            for (int y = 0; y < _height; ++y) {
+                uint8_t* row = out + y * stride;
+                const uint8_t* from = _from + y * stride;
+                if (_direction > 0)
+                    memcpy(row + covered, from + covered, stride - covered);
+                else
+                    memcpy(row, from, stride - covered);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// -----------------------------------------------------
+// Static layer
+// -----------------------------------------------------
+bool StaticLayer::ready(int width, int height) const
+{
+    return _ready && _layer && _layer->width() == width && _layer->height() == height;
+}
+
+FrameBuffer* StaticLayer::redraw(int width, int height)
+{
+    if (_layer && (_layer->width() != width || _layer->height() != height))
+        release();
+
+    if (!_layer) {
+        _layer = new FrameBuffer(width, height);
+        if (!_layer->valid()) {
+            release();
+            return nullptr;
+        }
+    }
+
+    _layer->clear();
+    _ready = true;
+    return _layer;
+}
+
+void StaticLayer::release()
+{
+    delete _layer;
+    _layer = nullptr;
+    _ready = false;
+}
+
+void StaticLayer::restore(FrameBuffer& fb) const
+{
+    if (_ready && _layer && fb.sizeBytes() == _layer->sizeBytes())
+        memcpy(fb.pixels(), _layer->pixels(), fb.sizeBytes());
+    else
+        fb.clear();
+}
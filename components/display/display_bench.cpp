@@ -0,0 +1,261 @@
+#include "display_bench.h"
+#include "led_matrix.h"
+#include "screen_manager.h"
+#include "hub75_budget.h"
+#include "compositor.h"
+#include "anim_partition.h"
+#include "anim_player.h"
+#include "esp_heap_caps.h"
+#include <esp_timer.h>
+#include <esp_log.h>
+
+static const char* TAG = "DisplayBench";
+
+static const int BENCH_FRAMES = 120;
+static const float BENCH_DT = 1.0f / 60.0f;
+
+// Blit cost when every pixel changes (worst case) and when nothing does
+static void bench_blit(LEDMatrix& matrix)
+{
+    FrameBuffer* fb = matrix.gfx();
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_FRAMES; ++i) {
+        fb->fillScreen((i & 1) ? 0xFFFF : 0x0841);
+        matrix.show();
+    }
+    int64_t fullUs = (esp_timer_get_time() - start) / BENCH_FRAMES;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_FRAMES; ++i) {
+        matrix.show();
+    }
+    int64_t idleUs = (esp_timer_get_time() - start) / BENCH_FRAMES;
+
+    ESP_LOGI(TAG, "Blit %dx%d: full frame %lld us, unchanged frame %lld us",
+             matrix.width(), matrix.height(), fullUs, idleUs);
+
+    matrix.clear();
+    matrix.show();
+}
+
+// What each bit depth would cost in DMA memory and refresh rate here
+static void bench_depths(LEDMatrix& matrix)
+{
+    const DisplayConfig& dc = matrix.config();
+
+    for (int depth = 4; depth <= 8; ++depth) {
+        ESP_LOGI(TAG, "%d-bit: DMA %u bytes, ~%.0f Hz refresh%s", depth,
+                 (unsigned)hub75_dma_bytes(dc.panel_width, dc.panel_height, dc.chain_length, depth),
+                 hub75_refresh_hz(dc.panel_width, dc.panel_height, dc.chain_length, depth),
+                 depth == dc.color_depth ? "  <- active" : "");
+    }
+}
+
+// Switch through every profile at runtime: DMA memory the driver really
+// took, its refresh rate, and how long the switch itself blanks the panel
+static void bench_profiles(LEDMatrix& matrix)
+{
+    const DisplayConfig original = matrix.config();
+    DisplayConfig dc = original;
+
+    for (int p = 0; p < (int)DisplayProfile::COUNT; ++p) {
+        dc.applyProfile((DisplayProfile)p);
+
+        int64_t start = esp_timer_get_time();
+        bool ok = matrix.reconfigure(dc);
+        int64_t switchUs = esp_timer_get_time() - start;
+
+        const DisplayStatus& st = matrix.status();
+        ESP_LOGI(TAG, "Profile %-12s %s: %d-bit @ %d MHz, DMA %lu bytes (model %u), %u Hz, switch %lld us",
+                 display_profile_spec(dc.profile).id, ok ? "ok" : "FAILED",
+                 st.color_depth, dc.clock_mhz, (unsigned long)st.dma_bytes,
+                 (unsigned)hub75_dma_bytes(dc.panel_width, dc.panel_height, dc.chain_length,
+                                           dc.color_depth, dc.latch_blanking),
+                 (unsigned)st.refresh_hz, switchUs);
+    }
+
+    matrix.reconfigure(original);
+}
+
+// Crossfade kernel over a full frame: word-wide vs byte-at-a-time, plus
+// what a whole transition frame costs on top of the incoming render
+static void bench_blend(LEDMatrix& matrix)
+{
+    FrameBuffer* fb = matrix.gfx();
+    FrameBuffer other(matrix.width(), matrix.height());
+    if (!other.valid()) return;
+
+    other.fillScreen(FrameBuffer::color565(200, 40, 90));
+    fb->fillScreen(FrameBuffer::color565(10, 220, 160));
+    const size_t bytes = fb->sizeBytes();
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_FRAMES; ++i)
+        blend_rgb888_scalar(fb->pixels(), other.pixels(), fb->pixels(), bytes, (uint16_t)(i * 2 + 1));
+    int64_t scalarUs = (esp_timer_get_time() - start) / BENCH_FRAMES;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_FRAMES; ++i)
+        blend_rgb888(fb->pixels(), other.pixels(), fb->pixels(), bytes, (uint16_t)(i * 2 + 1));
+    int64_t swarUs = (esp_timer_get_time() - start) / BENCH_FRAMES;
+
+    const Transition kinds[] = {Transition::CROSSFADE, Transition::SLIDE, Transition::WIPE};
+    const char* names[] = {"crossfade", "slide", "wipe"};
+    for (int k = 0; k < 3; ++k) {
+        Compositor compositor;
+        compositor.begin(other, kinds[k], BENCH_FRAMES * BENCH_DT * 2);
+
+        start = esp_timer_get_time();
+        for (int i = 0; i < BENCH_FRAMES; ++i) {
+            compositor.update(BENCH_DT);
+            compositor.apply(*fb);
+        }
+        int64_t applyUs = (esp_timer_get_time() - start) / BENCH_FRAMES;
+        ESP_LOGI(TAG, "Transition %-9s: %lld us per frame", names[k], applyUs);
+    }
+
+    ESP_LOGI(TAG, "Blend %u bytes: scalar %lld us, word-wide %lld us (%.1fx)",
+             (unsigned)bytes, scalarUs, swarUs, swarUs > 0 ? (float)scalarUs / swarUs : 0.0f);
+
+    matrix.clear();
+}
+
+// Each generated sprite: flash footprint and the cost of one blit, runs
+// read from flash through the cache as screens draw them
+static void bench_sprites(LEDMatrix& matrix)
+{
+    size_t totalFlash = 0;
+    for (int i = 0; i < ASSET_SPRITE_COUNT; ++i) {
+        const RleSprite& s = *ASSET_SPRITES[i];
+        const int x = (matrix.width() - s.width) / 2;
+        const int y = (matrix.height() - s.height) / 2;
+
+        int64_t start = esp_timer_get_time();
+        for (int n = 0; n < BENCH_FRAMES; ++n)
+            matrix.drawSprite(s, x, y, n % s.frameCount);
+        float blitUs = (float)(esp_timer_get_time() - start) / BENCH_FRAMES;
+
+        ESP_LOGI(TAG, "Sprite %-12s %2dx%-2d x%d: %5u bytes flash (%u raw), %.1f us per blit",
+                 s.name, s.width, s.height, s.frameCount, (unsigned)s.flashBytes(),
+                 (unsigned)s.rawBytes(), blitUs);
+        totalFlash += s.flashBytes();
+    }
+    ESP_LOGI(TAG, "Sprites: %d, %u bytes flash", ASSET_SPRITE_COUNT, (unsigned)totalFlash);
+
+    matrix.clear();
+}
+
+// The animation in the anim partition, decoded from the flash mapping:
+// every frame once in order, as playback does, plus the keyframes alone
+static void bench_animation(LEDMatrix& matrix)
+{
+    AnimPartition& part = AnimPartition::instance();
+    AnimPlayer player;
+    if (!part.map() || !player.open(part.data(), part.size())) {
+        ESP_LOGI(TAG, "Animation: none in the anim partition");
+        return;
+    }
+
+    FrameBuffer* fb = matrix.gfx();
+    int64_t totalUs = 0, worstUs = 0, keyUs = 0;
+    int keys = 0;
+    for (int i = 0; i < player.frameCount(); ++i) {
+        int64_t t0 = esp_timer_get_time();
+        player.seek(i, *fb);
+        int64_t us = esp_timer_get_time() - t0;
+        totalUs += us;
+        if (us > worstUs) worstUs = us;
+        if (player.isKeyframe(i)) {
+            keyUs += us;
+            keys++;
+        }
+    }
+
+    const int frames = player.frameCount();
+    const float seconds = frames * player.frameSeconds();
+    const int64_t meanUs = totalUs / frames;
+    const float budgetUs = player.frameSeconds() * 1e6f;
+    ESP_LOGI(TAG, "Animation %dx%d, %d frames (%d keyframes), %u bytes = %u KB per minute",
+             player.width(), player.height(), frames, keys, (unsigned)player.fileBytes(),
+             (unsigned)(player.fileBytes() / seconds * 60.0f / 1024.0f));
+    ESP_LOGI(TAG, "Animation decode: mean %lld us, worst %lld us, keyframe %lld us (%.1f%% of a frame)",
+             meanUs, worstUs, keys ? keyUs / keys : 0, 100.0f * meanUs / budgetUs);
+
+    matrix.clear();
+}
+
+void display_bench_run_all(LEDMatrix& matrix, ScreenManager& manager)
+{
+    ESP_LOGI(TAG, "=== Display benchmark: %dx%d canvas (%d pixels), %d module(s) ===",
+             matrix.width(), matrix.height(), matrix.width() * matrix.height(),
+             matrix.config().chain_length);
+
+    bench_depths(matrix);
+    bench_profiles(matrix);
+    bench_blit(matrix);
+    bench_blend(matrix);
+    bench_sprites(matrix);
+    bench_animation(matrix);
+
+    // Preparation is triggered by hand below so its cost is measured apart
+    // from the switch it keeps the work away from
+    manager.setPreloading(false);
+    manager.resetHeapLowWater();
+    const size_t freeBefore = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    // Visit every screen once, ending back where we started
+    for (size_t s = 0; s < manager.screenCount(); ++s) {
+        int64_t renderUs = 0;
+        int64_t blitUs = 0;
+
+        for (int i = 0; i < BENCH_FRAMES; ++i) {
+            int64_t t0 = esp_timer_get_time();
+            manager.update(BENCH_DT);
+            manager.render();
+            int64_t t1 = esp_timer_get_time();
+            matrix.show();
+            int64_t t2 = esp_timer_get_time();
+
+            renderUs += t1 - t0;
+            blitUs += t2 - t1;
+        }
+
+        renderUs /= BENCH_FRAMES;
+        blitUs /= BENCH_FRAMES;
+        int64_t frameUs = renderUs + blitUs;
+
+        ESP_LOGI(TAG, "Screen %u: update+render %lld us, blit %lld us, %.1f FPS max (budget 16667 us)",
+                 (unsigned)s, renderUs, blitUs, frameUs > 0 ? 1e6f / frameUs : 0.0f);
+
+        // Time to first frame: as after a button press, with the next
+        // screen prepared in the background beforehand
+        const char* next = manager.screenName(manager.predictedIndex());
+        int64_t t0 = esp_timer_get_time();
+        manager.prepareNext();
+        int64_t t1 = esp_timer_get_time();
+        manager.nextScreen();
+        manager.update(BENCH_DT);
+        manager.render();
+        matrix.show();
+        int64_t t2 = esp_timer_get_time();
+
+        ESP_LOGI(TAG, "Switch to %s: prepare %lld us (ahead of the press), first frame %lld us",
+                 next, t1 - t0, t2 - t1);
+    }
+
+    manager.setPreloading(true);
+
+    // Heap per screen, with every screen built and after the inactive
+    // ones have released their buffers
+    for (size_t s = 0; s < manager.screenCount(); ++s) {
+        ScreenManager::MemoryInfo mi = manager.memoryInfo((int)s);
+        ESP_LOGI(TAG, "Memory %-10s: %u bytes (budget %u)%s", mi.name, (unsigned)mi.measured,
+                 (unsigned)mi.budget, mi.measured > mi.budget + ScreenManager::ALLOCATOR_SLACK ? "  OVER" : "");
+    }
+    const size_t allBuilt = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    const size_t freed = manager.releaseInactive();
+    ESP_LOGI(TAG, "Heap free: %u before the lap, %u lowest, %u with all screens built, %u steady (%u released)",
+             (unsigned)freeBefore, (unsigned)manager.heapLowWater(), (unsigned)allBuilt,
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT), (unsigned)freed);
+}
@@ -0,0 +1,85 @@
+#include "frame_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+FrameBuffer::FrameBuffer(int width, int height)
+    : Adafruit_GFX(width, height)
+{
+    _pixels = (uint8_t*)calloc((size_t)width * height, 3);
+}
+
+FrameBuffer::~FrameBuffer()
+{
+    free(_pixels);
+}
+
+// -----------------------------------------------------
+// Pixel access
+// -----------------------------------------------------
+void FrameBuffer::drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (!_pixels || x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return;
+
+    uint8_t* p = _pixels + ((size_t)y * WIDTH + x) * 3;
+    p[0] = r;
+    p[1] = g;
+    p[2] = b;
+}
+
+void FrameBuffer::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    uint8_t r, g, b;
+    unpack565(color, r, g, b);
+    drawPixelRGB888(x, y, r, g, b);
+}
+
+void FrameBuffer::clear()
+{
+    if (_pixels)
+        memset(_pixels, 0, sizeBytes());
+}
+
+// -----------------------------------------------------
+// Fills - avoid the per-pixel virtual call in Adafruit_GFX
+// -----------------------------------------------------
+void FrameBuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (!_pixels) return;
+
+    // Clip to the canvas
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > WIDTH)  w = WIDTH - x;
+    if (y + h > HEIGHT) h = HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    uint8_t r, g, b;
+    unpack565(color, r, g, b);
+
+    for (int row = y; row < y + h; ++row) {
+        uint8_t* p = _pixels + ((size_t)row * WIDTH + x) * 3;
+        for (int i = 0; i < w; ++i) {
+            *p++ = r;
+            *p++ = g;
+            *p++ = b;
+        }
+    }
+}
+
+void FrameBuffer::fillScreen(uint16_t color)
+{
+    if (color == 0)
+        clear();
+    else
+        fillRect(0, 0, WIDTH, HEIGHT, color);
+}
+
+void FrameBuffer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+    fillRect(x, y, w, 1, color);
+}
+
+void FrameBuffer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+    fillRect(x, y, 1, h, color);
+}
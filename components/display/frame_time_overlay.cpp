@@ -0,0 +1,43 @@
+#include "frame_time_overlay.h"
+#include "led_matrix.h"
+#include "frame_profiler.h"
+
+static const int GRAPH_HEIGHT = 8;
+static const int GRAPH_MAX_WIDTH = 32;
+
+void frame_time_overlay_draw(LEDMatrix& matrix)
+{
+    FrameProfiler& profiler = FrameProfiler::instance();
+
+    int w = matrix.width() / 2;
+    if (w > GRAPH_MAX_WIDTH) w = GRAPH_MAX_WIDTH;
+
+    uint32_t samples[GRAPH_MAX_WIDTH];
+    int n = profiler.history(samples, w);
+
+    FrameBuffer* fb = matrix.gfx();
+    const int x0 = matrix.width() - w;
+    fb->fillRect(x0, 0, w, GRAPH_HEIGHT, 0);
+
+    // Budget line halfway up
+    const int budgetRow = GRAPH_HEIGHT / 2;
+    for (int x = x0; x < x0 + w; x += 2)
+        fb->drawPixelRGB888(x, GRAPH_HEIGHT - 1 - budgetRow, 40, 40, 40);
+
+    // Newest frame on the right edge
+    const uint32_t fullScale = FrameProfiler::BUDGET_US * 2;
+    for (int i = 0; i < n; ++i) {
+        uint32_t us = samples[i];
+        int bar = (us >= fullScale) ? GRAPH_HEIGHT
+                                    : (int)((us * GRAPH_HEIGHT + fullScale - 1) / fullScale);
+        if (bar < 1) bar = 1;
+
+        uint8_t r = 0, g = 160, b = 0;
+        if (us > fullScale)                       { r = 200; g = 0; }
+        else if (us > FrameProfiler::BUDGET_US)   { r = 200; g = 120; }
+
+        int x = x0 + w - n + i;
+        for (int row = 0; row < bar; ++row)
+            fb->drawPixelRGB888(x, GRAPH_HEIGHT - 1 - row, r, g, b);
+    }
+}
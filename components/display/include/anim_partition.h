@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The "anim" data partition (see partitions.csv), memory-mapped read-only
+// through the flash cache. Frames are decoded straight from the mapping.
+//
+// Write an animation made by anim_encode.py with
+//   parttool.py write_partition --partition-name anim --input clip.lma
+class AnimPartition {
+public:
+    static AnimPartition& instance();
+
+    // Maps the animation on first call. False when there is no partition
+    // or it does not start with an animation header.
+    bool map();
+    void unmap();
+
+    const uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    AnimPartition() = default;
+
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+    uint32_t _handle = 0;
+};
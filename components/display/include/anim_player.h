@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "frame_buffer.h"
+#include "rle_sprite.h"
+
+// Pre-rendered animation played straight from memory-mapped flash.
+//
+// File layout (little-endian, written by components/assets/anim_encode.py):
+//
+//   AnimHeader                         32 bytes
+//   uint32_t offsets[frameCount + 1]   byte offset of each frame from the
+//                                      start of the file; the last one is
+//                                      the end of the frame data
+//   frames                             16-bit words
+//
+// A frame is a flags word followed by runs in raster order over the whole
+// frame (runs may cross rows), each a header word op << 14 | length with
+// the ops of rle_sprite.h:
+//
+//   RLE_SKIP  pixels unchanged since the previous frame
+//   RLE_FILL  length pixels of the RGB565 color in the next word
+//   RLE_COPY  length RGB565 colors follow
+//
+// plus one op for what dominates moving sparks and edges, a short skip
+// straight into a short copy, in one header word:
+//
+//   ANIM_SKIP_COPY  3 << 14 | skip << 4 | count: skip unchanged pixels
+//                   (0..1023), then count (0..15) colors follow
+//
+// Pixels after the last run are unchanged. A keyframe (ANIM_KEYFRAME) is
+// drawn over black instead of the previous frame, so playback can start
+// or seek there; frame 0 is always one.
+//
+// The decoder never copies frame data to RAM: runs are read from the
+// mapping and written into the frame buffer, which holds the previous
+// frame. Anything else drawing into the frame buffer meanwhile shows
+// until the next keyframe, unless invalidate() is called.
+
+static const uint32_t ANIM_MAGIC = 0x31414D4C;     // "LMA1"
+static const uint16_t ANIM_VERSION = 1;
+static const uint16_t ANIM_KEYFRAME = 1 << 0;
+
+static const int ANIM_SKIP_COPY = 3;
+static const int ANIM_COPY_BITS = 4;
+static const uint16_t ANIM_COPY_MASK = (1 << ANIM_COPY_BITS) - 1;
+static const uint16_t ANIM_SKIP_MASK = (1 << (RLE_OP_SHIFT - ANIM_COPY_BITS)) - 1;
+
+struct AnimHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerBytes;       // sizeof(AnimHeader)
+    uint16_t width;
+    uint16_t height;
+    uint32_t frameCount;
+    uint32_t frameUs;           // display time of each frame
+    uint32_t fileBytes;         // header, offsets and frames
+    uint32_t crc32;             // of everything after the header (zlib CRC-32)
+    uint16_t keyInterval;       // frames between keyframes, informative
+    uint16_t reserved;
+};
+
+static_assert(sizeof(AnimHeader) == 32, "AnimHeader is a file format");
+
+// CRC-32 as computed by zlib / Python's zlib.crc32
+uint32_t anim_crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+class AnimPlayer {
+public:
+    // Checks the header, the CRC and the frame table; on failure error()
+    // says why and the player stays closed. `data` must stay mapped.
+    bool open(const uint8_t* data, size_t size);
+    void close();
+
+    bool valid() const { return _header != nullptr; }
+    const char* error() const { return _error; }
+
+    int width() const { return _header ? _header->width : 0; }
+    int height() const { return _header ? _header->height : 0; }
+    int frameCount() const { return _header ? (int)_header->frameCount : 0; }
+    float frameSeconds() const { return _header ? _header->frameUs * 1e-6f : 0.0f; }
+    size_t fileBytes() const { return _header ? _header->fileBytes : 0; }
+
+    size_t frameBytes(int index) const;
+    bool isKeyframe(int index) const;
+
+    // Frame currently in the frame buffer, -1 if unknown
+    int frame() const { return _frame; }
+
+    // Bring `fb` to frame `index` with the animation centered in it:
+    // from the frame already there when `index` follows it closely
+    // enough, otherwise from the nearest keyframe at or before it.
+    // Returns the number of frames decoded; 0 if already there or on error.
+    int seek(int index, FrameBuffer& fb);
+
+    // The frame buffer was drawn over; the next seek() starts at a keyframe
+    void invalidate() { _frame = -1; }
+
+private:
+    bool decode(int index, FrameBuffer& fb);
+    int keyframeAtOrBefore(int index) const;
+
+    const uint8_t* _data = nullptr;
+    const AnimHeader* _header = nullptr;
+    const uint32_t* _offsets = nullptr;
+    int _frame = -1;
+    const char* _error = "not opened";
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+
+// Shared color tables, generated at compile time and placed in flash.
+//
+//   wheel  - the classic 3-segment red/green/blue wheel the spectrum and
+//            fireworks effects have always used
+//   hue    - full-saturation HSV ramp, 256 steps per turn (1.4 deg/step)
+//   gamma  - gamma 2.2 correction for the panel's linear PWM, to 8 bits
+//            and to 12 bits (for dithering down to the panel's bit depth)
+//   fade   - perceptually even fade-out levels, index 255 = full brightness
+//   heat   - intensity ramp black -> blue -> magenta -> red -> yellow ->
+//            white, as RGB565 for the spectrogram's history
+//
+// Screens index these instead of converting per pixel or per frame.
+
+struct Rgb888 {
+    uint8_t r, g, b;
+};
+
+constexpr uint16_t rgb_to_565(Rgb888 c)
+{
+    return (uint16_t)(((c.r & 0xF8) << 8) | ((c.g & 0xFC) << 3) | (c.b >> 3));
+}
+
+// v * level / 255, exact at both ends, without a division
+constexpr uint8_t scale8(uint8_t v, uint8_t level)
+{
+    return (uint8_t)((v * (level + 1)) >> 8);
+}
+
+constexpr Rgb888 scale_rgb(Rgb888 c, uint8_t level)
+{
+    return { scale8(c.r, level), scale8(c.g, level), scale8(c.b, level) };
+}
+
+namespace color_detail {
+
+constexpr Rgb888 wheel(uint8_t pos)
+{
+    pos = 255 - pos;
+    if (pos < 85) return { (uint8_t)(255 - pos * 3), 0, (uint8_t)(pos * 3) };
+    if (pos < 170) {
+        pos -= 85;
+        return { 0, (uint8_t)(pos * 3), (uint8_t)(255 - pos * 3) };
+    }
+    pos -= 170;
+    return { (uint8_t)(pos * 3), (uint8_t)(255 - pos * 3), 0 };
+}
+
+// Six 42.67-step segments; ramp computed in 1/256ths to stay integral
+constexpr Rgb888 hue(int i)
+{
+    int h = i * 6;                  // 0..1535, segment = h / 256
+    int seg = h >> 8;
+    uint8_t up = (uint8_t)(h & 0xFF);
+    uint8_t down = (uint8_t)(255 - up);
+    switch (seg) {
+        case 0:  return { 255, up, 0 };
+        case 1:  return { down, 255, 0 };
+        case 2:  return { 0, 255, up };
+        case 3:  return { 0, down, 255 };
+        case 4:  return { up, 0, 255 };
+        default: return { 255, 0, down };
+    }
+}
+
+// x^(1/5) by Newton's method, x in (0, 1]
+constexpr double root5(double x)
+{
+    double y = 1.0;
+    for (int i = 0; i < 40; ++i) {
+        double y4 = y * y * y * y;
+        y = y - (y4 * y - x) / (5.0 * y4);
+    }
+    return y;
+}
+
+// x^2.2 = x^2 * x^0.2, scaled to 0..maxOut
+constexpr int gamma(int i, int maxOut)
+{
+    if (i == 0) return 0;
+    double x = i / 255.0;
+    return (int)(x * x * root5(x) * maxOut + 0.5);
+}
+
+// Five equal segments between six stops, interpolated in 51sts
+constexpr Rgb888 heat(int i)
+{
+    constexpr Rgb888 stops[6] = {
+        {0, 0, 0}, {0, 0, 160}, {160, 0, 160}, {255, 0, 0}, {255, 200, 0}, {255, 255, 255},
+    };
+    const int seg = i / 51;
+    if (seg >= 5) return stops[5];
+    const int t = i - seg * 51;
+    const Rgb888 a = stops[seg], b = stops[seg + 1];
+    return { (uint8_t)(a.r + (b.r - a.r) * t / 51), (uint8_t)(a.g + (b.g - a.g) * t / 51),
+             (uint8_t)(a.b + (b.b - a.b) * t / 51) };
+}
+
+template <typename T, typename F>
+constexpr std::array<T, 256> make_table(F f)
+{
+    std::array<T, 256> t{};
+    for (int i = 0; i < 256; ++i) t[i] = f(i);
+    return t;
+}
+
+}  // namespace color_detail
+
+inline constexpr std::array<Rgb888, 256> COLOR_WHEEL =
+    color_detail::make_table<Rgb888>([](int i) { return color_detail::wheel((uint8_t)i); });
+
+inline constexpr std::array<uint16_t, 256> COLOR_WHEEL_565 =
+    color_detail::make_table<uint16_t>([](int i) { return rgb_to_565(color_detail::wheel((uint8_t)i)); });
+
+inline constexpr std::array<Rgb888, 256> COLOR_HUE =
+    color_detail::make_table<Rgb888>([](int i) { return color_detail::hue(i); });
+
+inline constexpr std::array<uint8_t, 256> COLOR_GAMMA =
+    color_detail::make_table<uint8_t>([](int i) { return (uint8_t)color_detail::gamma(i, 255); });
+
+inline constexpr std::array<uint16_t, 256> COLOR_GAMMA12 =
+    color_detail::make_table<uint16_t>([](int i) { return (uint16_t)color_detail::gamma(i, 4095); });
+
+inline constexpr std::array<uint16_t, 256> COLOR_HEAT_565 =
+    color_detail::make_table<uint16_t>([](int i) { return rgb_to_565(color_detail::heat(i)); });
+
+// Gamma-shaped ramp: stepping the index linearly looks like an even fade
+inline constexpr std::array<uint8_t, 256> COLOR_FADE = COLOR_GAMMA;
+
+constexpr Rgb888 color_wheel(uint8_t pos) { return COLOR_WHEEL[pos]; }
+constexpr uint16_t color_wheel565(uint8_t pos) { return COLOR_WHEEL_565[pos]; }
+
+// Hue in 256ths of a turn (0 = red, 85 = green, 171 = blue)
+constexpr Rgb888 color_hue(uint8_t hue) { return COLOR_HUE[hue]; }
+constexpr uint8_t color_gamma(uint8_t v) { return COLOR_GAMMA[v]; }
+constexpr uint16_t color_heat565(uint8_t v) { return COLOR_HEAT_565[v]; }
+
+// Dims c along the perceptual fade curve; level 255 leaves it unchanged
+constexpr Rgb888 color_fade(Rgb888 c, uint8_t level) { return scale_rgb(c, COLOR_FADE[level]); }
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "frame_buffer.h"
+
+// Screen transitions composed on the CPU.
+//
+// When a transition starts, the outgoing frame is copied into an
+// off-screen layer. The incoming screen keeps rendering live into the
+// frame buffer, and apply() mixes the frozen layer into it in place:
+//
+//   CROSSFADE  per-pixel integer blend, alpha ramps 0 -> 256
+//   SLIDE      outgoing frame pushed out sideways by the incoming one
+//   WIPE       hard edge sweeping across, incoming behind it
+//
+// The layer is only allocated for the duration of a transition; if that
+// fails the switch is simply instant.
+//
+// StaticLayer is the per-screen counterpart: static content is drawn once
+// into an off-screen buffer, each frame starts from a copy of it, and the
+// screen only redraws what actually moves.
+
+enum class Transition : uint8_t {
+    NONE,
+    CROSSFADE,
+    SLIDE,
+    WIPE
+};
+
+// dst = a + (b - a) * alpha / 256 per byte, alpha 0..256. Buffers may have
+// any alignment; dst may alias a or b. Works on two bytes per 16-bit lane
+// of a 32-bit word at a time.
+void blend_rgb888(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t bytes, uint16_t alpha);
+
+// One byte at a time; the reference the benchmarks compare against
+void blend_rgb888_scalar(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t bytes, uint16_t alpha);
+
+class Compositor {
+public:
+    ~Compositor();
+
+    // Snapshot `outgoing` and start; direction +1 = incoming from the right
+    bool begin(const FrameBuffer& outgoing, Transition type, float seconds, int direction = 1);
+    void cancel();
+
+    bool active() const { return _from != nullptr; }
+    void update(float dt);
+
+    // Mix the snapshot into the freshly rendered incoming frame
+    void apply(FrameBuffer& incoming) const;
+
+private:
+    uint8_t* _from = nullptr;       // outgoing frame, same layout as the frame buffer
+    int _width = 0;
+    int _height = 0;
+    Transition _type = Transition::NONE;
+    float _duration = 0.0f;
+    float _elapsed = 0.0f;
+    int _direction = 1;
+};
+
+class StaticLayer {
+public:
+    ~StaticLayer() { release(); }
+
+    // True when the layer holds up-to-date content for this frame size
+    bool ready(int width, int height) const;
+
+    // Cleared canvas to redraw the static content into; nullptr when it
+    // cannot be allocated (restore() then just clears)
+    FrameBuffer* redraw(int width, int height);
+
+    void invalidate() { _ready = false; }
+    void release();
+
+    // Start a frame: copy the layer into `fb`, or clear it
+    void restore(FrameBuffer& fb) const;
+
+private:
+    FrameBuffer* _layer = nullptr;
+    bool _ready = false;
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+class LEDMatrix;
+class ScreenManager;
+
+// Time frame buffer blits and every screen's update+render at the current
+// panel geometry, logging microseconds per frame and the resulting FPS
+void display_bench_run_all(LEDMatrix& matrix, ScreenManager& manager);
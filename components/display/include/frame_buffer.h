@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include "Adafruit_GFX.h"
+
+// Off-screen RGB888 canvas that screens draw into.
+//
+// Exposes the Adafruit GFX API (text, fonts, lines) plus the
+// drawPixelRGB888()/color565() helpers screens already used on the DMA
+// panel. LEDMatrix::show() pushes it to the hardware, so drawing code
+// never depends on the panel geometry or chain layout.
+class FrameBuffer : public Adafruit_GFX {
+public:
+    FrameBuffer(int width, int height);
+    ~FrameBuffer() override;
+
+    FrameBuffer(const FrameBuffer&) = delete;
+    FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+    bool valid() const { return _pixels != nullptr; }
+
+    // Adafruit GFX overrides
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+
+    void drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b);
+    void clear();
+
+    // Direct access for blitters: 3 bytes per pixel, row-major, no padding
+    uint8_t* pixels() { return _pixels; }
+    const uint8_t* pixels() const { return _pixels; }
+    size_t sizeBytes() const { return (size_t)WIDTH * HEIGHT * 3; }
+
+    static uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+        return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    }
+
+    // Expand a 5/6-bit channel so full scale maps to 255
+    static void unpack565(uint16_t c, uint8_t& r, uint8_t& g, uint8_t& b) {
+        uint8_t r5 = (c >> 11) & 0x1F;
+        uint8_t g6 = (c >> 5) & 0x3F;
+        uint8_t b5 = c & 0x1F;
+        r = (r5 << 3) | (r5 >> 2);
+        g = (g6 << 2) | (g6 >> 4);
+        b = (b5 << 3) | (b5 >> 2);
+    }
+
+private:
+    uint8_t* _pixels = nullptr;
+};
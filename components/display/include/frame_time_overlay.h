@@ -0,0 +1,9 @@
+#pragma once
+
+class LEDMatrix;
+
+// Draws the profiler's recent frame times as a tiny bar graph in the
+// top-right corner: one column per frame, full height = two frame budgets,
+// green within budget, amber up to twice the budget, red beyond. A dim dot
+// row marks the budget line. Call after render(), before show().
+void frame_time_overlay_draw(LEDMatrix& matrix);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Back-of-envelope cost model for the HUB75 I2S/LCD DMA driver.
+//
+// The driver keeps one 16-bit word per column (plus latch blanking) for
+// every bit plane of every row pair, and shows plane b for 2^b slots of
+// binary-coded modulation. Each plane saved therefore halves the time per
+// refresh and drops 1/depth of the DMA memory.
+
+static const uint32_t HUB75_DEFAULT_CLOCK_HZ = 8000000;
+static const int HUB75_DEFAULT_LATCH_BLANKING = 2;
+
+constexpr size_t hub75_dma_bytes(int panelWidth, int panelHeight, int chain, int depth,
+                                 int latchBlanking = HUB75_DEFAULT_LATCH_BLANKING)
+{
+    return (size_t)(panelHeight / 2) * depth * (panelWidth * chain + latchBlanking) * sizeof(uint16_t);
+}
+
+// Whole-panel refreshes per second. Planes up to transitionBit are shown
+// once each instead of at their BCM weight (the driver's trick for holding
+// a minimum refresh rate); plane b above it is shown 2^(b - transitionBit)
+// times. transitionBit 0 is plain BCM: 2^depth - 1 slots per row.
+constexpr float hub75_refresh_hz(int panelWidth, int panelHeight, int chain, int depth,
+                                 uint32_t clockHz = HUB75_DEFAULT_CLOCK_HZ,
+                                 int latchBlanking = HUB75_DEFAULT_LATCH_BLANKING,
+                                 int transitionBit = 0)
+{
+    return clockHz / ((panelHeight / 2.0f) * (panelWidth * chain + latchBlanking) *
+                      (transitionBit + (1 << (depth - transitionBit)) - 1));
+}
+
+// Lowest transition bit that reaches minRefreshHz (depth - 1 if none does)
+constexpr int hub75_transition_bit(int panelWidth, int panelHeight, int chain, int depth,
+                                   uint32_t clockHz, int latchBlanking, int minRefreshHz)
+{
+    int bit = 0;
+    while (bit < depth - 1 &&
+           hub75_refresh_hz(panelWidth, panelHeight, chain, depth, clockHz, latchBlanking, bit) < minRefreshHz)
+        ++bit;
+    return bit;
+}
@@ -1,15 +1,31 @@
 #pragma once
 
 #include <stdint.h>
-#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "app_config.h"
+#include "frame_buffer.h"
+#include "rle_sprite.h"
+#include "temporal_dither.h"
 
+class MatrixPanel_I2S_DMA;
+
+// Screens draw into the frame buffer; show() hands it to the backend.
+// led_matrix.cpp holds the backend-independent parts, led_matrix_hub75.cpp
+// the I2S-DMA driver and host/led_matrix_sim.cpp the in-memory simulator.
 class LEDMatrix {
 public:
-    LEDMatrix(int width, int height, int chain = 1);
+    explicit LEDMatrix(const DisplayConfig& cfg);
+    ~LEDMatrix();
 
     void begin();
     void clear();
-    void show(); // optional: may not be needed w/ DMA
+
+    // Restart the driver with new color depth / clock / blanking (a display
+    // profile). The geometry must match; it still needs a restart. Call
+    // from the render loop, never while show() may run. Falls back to the
+    // previous settings if the new ones cannot be allocated.
+    bool reconfigure(const DisplayConfig& cfg);
+
+    void show(); // push the frame buffer to the panel (changed pixels only)
     void setBrightness(uint8_t b);
 
     // Drawing primitives
@@ -17,20 +33,51 @@ public:
     void drawPixelRGB(int x, int y, uint8_t r, uint8_t g, uint8_t b);
     void drawText(int x, int y, const char* text, uint32_t color);
 
+    // Decode one frame of a sprite straight into the frame buffer at
+    // (x, y), clipped to the canvas; transparent runs leave it untouched
+    void drawSprite(const RleSprite& sprite, int x, int y, int frame = 0);
+
     // Color helper
     uint16_t color565(uint8_t r, uint8_t g, uint8_t b);
 
-    // Provide access to low-level display
-    MatrixPanel_I2S_DMA* raw() { return _panel; }
+    // Canvas screens draw into (Adafruit GFX API)
+    FrameBuffer* gfx() { return &_fb; }
+
+    // Provide access to low-level display driver (nullptr in the host simulator)
+    MatrixPanel_I2S_DMA* panel() { return _panel; }
 
+    // Last frame pushed by show(), RGB888 in canvas coordinates. On the
+    // HUB75 backend these are the gamma-corrected, dithered driver values.
+    const uint8_t* shownPixels() const { return _shown; }
+
+    // The same frame as the driver's single chain receives it, after the
+    // tile mapping: (chain_length * panel_width) x panel_height, RGB888.
+    // Kept by the host simulator for tiled layouts; nullptr otherwise (on
+    // HUB75 it only exists in the driver's DMA buffers).
+    const uint8_t* chainPixels() const { return _chain; }
+
+    // Logical canvas size (all tiles combined)
     int width() const { return _width; }
     int height() const { return _height; }
+    const DisplayConfig& config() const { return _config; }
+
+    // DMA memory and refresh rate of the running driver
+    const DisplayStatus& status() const { return _status; }
 
 private:
+    void mapToChain(int x, int y, int& cx, int& cy) const;
+    bool startDriver();     // per backend: allocate, start DMA, fill _status
+    void stopDriver();
+
+    DisplayConfig _config;
     int _width;
     int _height;
-    int _chain;
 
-    HUB75_I2S_CFG _cfg;
+    FrameBuffer _fb;
+    uint8_t* _shown = nullptr;      // last frame pushed to the panel
+    uint8_t* _chain = nullptr;      // ... in chain order (host simulator, tiled layouts)
+    TemporalDither _dither;         // gamma + bit-depth reduction in show()
+    DisplayStatus _status;
+    uint8_t _brightness = 60;       // re-applied when the driver restarts
     MatrixPanel_I2S_DMA* _panel = nullptr;
 };
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include "frame_buffer.h"
+#include "color_lut.h"
+#include "xorshift.h"
+
+// Pooled point-particle engine.
+//
+// All particles live in one arena allocation laid out as separate arrays
+// (x, y, vx, vy, life, color) so update() streams through memory one field
+// at a time. Live particles are kept packed at the front: a dead particle
+// is replaced by the last live one, so there is no free list and no
+// per-frame allocation. Positions and velocities are Q24.8 fixed point,
+// life is Q16.16 seconds and integration uses the real frame dt.
+class ParticleSystem {
+public:
+    ParticleSystem() = default;
+    ~ParticleSystem();
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    // (Re)allocates the arena; existing particles are dropped
+    bool reserve(int capacity);
+    void release();
+    void clear() { _count = 0; }
+
+    int count() const { return _count; }
+    int capacity() const { return _capacity; }
+    size_t arenaBytes() const { return bytesFor(_capacity); }
+    static size_t bytesFor(int capacity) { return (size_t)capacity * BYTES_PER_PARTICLE; }
+
+    // 256 entries, e.g. COLOR_WHEEL; particles store an index into it.
+    // The table is referenced, not copied.
+    void setPalette(const Rgb888* palette) { _palette = palette; }
+    void setGravity(float pxPerSecond2);
+    // Particles fade out over their final `seconds` of life
+    void setFadeTime(float seconds);
+
+    struct Burst {
+        float x, y;                 // origin, px
+        int count;
+        float speedMin, speedMax;   // px/s, random direction
+        float lifeMin, lifeMax;     // s
+        uint8_t hue;                // palette index of the first particle
+        uint8_t hueSpread;          // random offset added to hue
+    };
+
+    // Returns how many particles were spawned (limited by free capacity)
+    int emit(const Burst& burst, XorShift32& rng);
+
+    void update(float dt);
+    void render(FrameBuffer& fb) const;
+
+private:
+    static const size_t BYTES_PER_PARTICLE = 5 * sizeof(int32_t) + sizeof(uint8_t);
+
+    uint8_t* _arena = nullptr;
+    int _capacity = 0;
+    int _count = 0;
+
+    int32_t* _x = nullptr;      // Q24.8 px
+    int32_t* _y = nullptr;
+    int32_t* _vx = nullptr;     // Q24.8 px/s
+    int32_t* _vy = nullptr;
+    int32_t* _life = nullptr;   // Q16.16 s
+    uint8_t* _color = nullptr;  // palette index
+
+    const Rgb888* _palette = COLOR_WHEEL.data();
+    int32_t _gravity = 0;       // Q24.8 px/s^2
+    int32_t _fadeLife = 1;      // Q16.16 s; full brightness above this
+    int32_t _fadeScale = 0;     // level (0..255) = life * _fadeScale >> 16
+};
@@ -1,23 +1,102 @@
 #pragma once
 
+#include <stddef.h>
 #include <vector>
 #include "base_screen.h"
+#include "compositor.h"
 #include "led_matrix.h"
 
 class ScreenManager {
 public:
+    // Builds a screen on first use
+    using ScreenFactory = BaseScreen* (*)();
+
+    // Allocator headers and rounding a measurement may exceed a budget by
+    static const size_t ALLOCATOR_SLACK = 256;
+
+    // What a screen costs in heap, for reports and for making room
+    struct MemoryInfo {
+        const char* name;
+        size_t budget;          // declared; 0 = none given
+        size_t measured;        // taken by construction and first use; 0 = not built yet
+        bool built;
+        bool holding;           // entered or prepared since its buffers were last released
+    };
+
     ScreenManager(LEDMatrix& matrix);
+    ~ScreenManager();
 
+    // `budgetBytes` is the most heap the screen takes once running,
+    // buffers included. Before a screen is built or prepared, buffers of
+    // inactive screens are released if the free heap would not cover it.
+    void addScreen(const char* name, ScreenFactory factory, size_t budgetBytes);
+    // Already built; never deleted by the manager
     void addScreen(BaseScreen* screen);
+
     void nextScreen();
     void previousScreen();
     BaseScreen* current();
+    int currentIndex() const { return _currentIndex; }
+    size_t screenCount() const { return _slots.size(); }
+    const char* screenName(int index) const;
+
+    // How nextScreen()/previousScreen() hand over; NONE switches instantly
+    void setTransition(Transition type, float seconds);
+    bool inTransition() const { return _compositor.active(); }
+
+    // The screen the button leads to next; prepared in the background
+    // once the current screen has settled (see update())
+    int predictedIndex() const;
+    void setPreloading(bool enabled) { _preloading = enabled; }
+    void prepareNext();
+
+    // Screens other than the current and predicted one release their
+    // buffers after this long; 0 = only when making room
+    void setReleaseAfter(float seconds) { _releaseAfter = seconds; }
+    // Releases every screen but the current one now; returns the heap freed
+    size_t releaseInactive();
+
+    MemoryInfo memoryInfo(int index) const;
+    // Lowest free heap seen since the last resetHeapLowWater()
+    size_t heapLowWater() const { return _heapLowWater; }
+    void resetHeapLowWater();
 
     void update(float dt);
     void render();
 
 private:
+    struct Slot {
+        const char* name;
+        ScreenFactory factory;      // nullptr for screens added built
+        size_t budget;
+        BaseScreen* screen;
+        size_t measured;
+        size_t freeBefore;          // heap before construction, until measured
+        float idle;                 // seconds since last current or prepared
+        bool measuring;
+        bool holding;
+    };
+
+    BaseScreen* build(int index);
+    void finishMeasure(int index);
+    void makeRoom(size_t bytes, int keep);
+    size_t releaseAllBut(int keep);
+    void release(int index);
+    void switchTo(int index, int direction);
+    void sampleHeap();
+
     LEDMatrix& _matrix;
-    std::vector<BaseScreen*> _screens;
+    std::vector<Slot> _slots;
     int _currentIndex = -1;
+
+    Compositor _compositor;
+    Transition _transition = Transition::NONE;
+    float _transitionSeconds = 0.0f;
+
+    bool _preloading = true;
+    bool _prepared = false;         // predicted screen prepared since the last switch
+    int _settleFrames = 0;
+
+    float _releaseAfter = 60.0f;
+    size_t _heapLowWater = (size_t)-1;
 };
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "color_lut.h"
+
+// Gamma correction plus frame-to-frame error diffusion for the blit.
+//
+// Each sub-pixel value is mapped through gamma 2.2 to a target brightness
+// in 1/256ths of a panel level, at the panel's bit depth. The integer
+// level is sent to the driver. The fraction is kept per sub-pixel and
+// added back on the next frame, so over a few frames every input averages
+// out to its exact target. This lets the panel run at 5-6 bit planes with
+// the shading of 8 or more. Very dim levels turn into a slow on/off
+// pattern, because a sub-pixel only lights once its error reaches a whole
+// level.
+class TemporalDither {
+public:
+    static const int MIN_DEPTH = 4;
+    static const int MAX_DEPTH = 8;
+
+    TemporalDither() = default;
+    ~TemporalDither();
+
+    TemporalDither(const TemporalDither&) = delete;
+    TemporalDither& operator=(const TemporalDither&) = delete;
+
+    // Without dithering the error buffer is not allocated and values are
+    // rounded to the nearest level instead
+    bool configure(int pixels, int depth, bool dither);
+    void release();
+
+    int depth() const { return _depth; }
+    bool dithering() const { return _error != nullptr; }
+
+    // Encodes one RGB888 pixel for the driver: gamma-corrected, and
+    // significant in the top depth() bits only
+    void encode(int pixel, const uint8_t* rgb, uint8_t* out)
+    {
+        if (_error) {
+            uint8_t* err = _error + pixel * 3;
+            out[0] = ditherChannel(rgb[0], err[0]);
+            out[1] = ditherChannel(rgb[1], err[1]);
+            out[2] = ditherChannel(rgb[2], err[2]);
+        } else {
+            out[0] = roundChannel(rgb[0]);
+            out[1] = roundChannel(rgb[1]);
+            out[2] = roundChannel(rgb[2]);
+        }
+    }
+
+private:
+    uint8_t ditherChannel(uint8_t v, uint8_t& err) const
+    {
+        uint32_t x = _target[v] + err;
+        err = (uint8_t)x;       // fraction carries to the next frame
+        return (uint8_t)((x >> 8) << _outShift);
+    }
+
+    uint8_t roundChannel(uint8_t v) const
+    {
+        return (uint8_t)(((_target[v] + 128u) >> 8) << _outShift);
+    }
+
+    uint16_t _target[256] = {};     // gamma-corrected level, 8.8 fixed point
+    uint8_t* _error = nullptr;      // fraction per sub-pixel, 1/256 level
+    int _depth = 8;
+    int _outShift = 0;              // 8 - depth
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include "Adafruit_GFX.h"
+#include "led_matrix.h"
+
+// Smooth horizontal ticker for text that does not fit its slot.
+//
+// The text is rasterized once into an 8-bit coverage strip whenever it
+// changes. Each frame the strip is sampled at a fractional (24.8 fixed-point)
+// offset and neighboring columns are blended, so motion is smooth at any
+// frame rate. Every ticker owns its own strip, so several can run on one
+// panel without re-rendering their text.
+class Ticker {
+public:
+    Ticker() = default;
+    ~Ticker();
+
+    Ticker(const Ticker&) = delete;
+    Ticker& operator=(const Ticker&) = delete;
+
+    // Slot on the panel: left edge, text baseline (same convention as
+    // setCursor() with a GFX font) and visible width in pixels
+    void setViewport(int x, int baselineY, int width);
+    void setFont(const GFXfont* font, uint8_t size = 1);
+    void setColor(uint8_t r, uint8_t g, uint8_t b);
+    void setSpeed(float pixelsPerSecond) { _speed = pixelsPerSecond; }
+    void setGap(int pixels);                 // blank space between repeats
+    void setPause(float seconds) { _pause = seconds; }  // dwell at start of each loop
+
+    // Re-rasterizes only when the text actually changes
+    void setText(const char* text);
+    void reset();
+
+    // True when the text is wider than the viewport and therefore moves
+    bool isScrolling() const { return _textWidth > _width; }
+
+    void update(float dt);
+    void render(LEDMatrix& matrix) const;
+
+private:
+    void rebuild();
+
+    char _text[64] = "";
+    const GFXfont* _font = nullptr;
+    uint8_t _size = 1;
+
+    int _x = 0;
+    int _baseline = 0;
+    int _width = 0;
+
+    uint8_t _r = 255, _g = 255, _b = 255;
+    float _speed = 12.0f;
+    float _pause = 1.0f;
+    int _gap = 12;
+
+    GFXcanvas8* _strip = nullptr;   // coverage, one byte per pixel
+    int _textWidth = 0;
+    int _top = 0;                   // strip top row relative to baseline
+
+    uint32_t _offset = 0;           // 24.8 fixed-point scroll position
+    float _remainder = 0.0f;        // sub-1/256 px carried between frames
+    float _dwell = 0.0f;
+};
@@ -1,64 +1,77 @@
 #include "led_matrix.h"
-#include "Arduino.h" // for print()
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 // -----------------------------------------------------
 // Constructor
 // -----------------------------------------------------
-LEDMatrix::LEDMatrix(int width, int height, int chain)
-    : _width(width), _height(height), _chain(chain),
-      _cfg(width, height, chain)
+LEDMatrix::LEDMatrix(const DisplayConfig& cfg)
+    : _config(cfg), _width(cfg.width()), _height(cfg.height()),
+      _fb(cfg.width(), cfg.height())
 {
-    // Apply your known-good pinout
-    _cfg.gpio.r1 = 2;
-    _cfg.gpio.g1 = 15;
-    _cfg.gpio.b1 = 4;
-
-    _cfg.gpio.r2 = 5;
-    _cfg.gpio.g2 = 6;
-    _cfg.gpio.b2 = 7;
-
-    _cfg.gpio.a  = 8;
-    _cfg.gpio.b  = 9;
-    _cfg.gpio.c  = 10;
-    _cfg.gpio.d  = 11;
-
-    _cfg.gpio.clk = 12;
-    _cfg.gpio.lat = 13;
-    _cfg.gpio.oe  = 14;
-
-    // You may add .e if using >32px tall panels
+    _shown = (uint8_t*)calloc((size_t)_width * _height, 3);
 }
 
 // -----------------------------------------------------
-// Initialize the HUB75 panel
+// Runtime profile switch: the frame buffer is kept, only the driver and
+// the dither state are rebuilt
 // -----------------------------------------------------
-void LEDMatrix::begin()
+bool LEDMatrix::reconfigure(const DisplayConfig& cfg)
 {
-    _panel = new MatrixPanel_I2S_DMA(_cfg);
-    _panel->begin();
-    _panel->setBrightness8(60);   // default brightness
-
-    printf("LEDMatrix: HUB75 DMA display started.\n");
+    if (cfg.panel_width != _config.panel_width || cfg.panel_height != _config.panel_height ||
+        cfg.chain_length != _config.chain_length || cfg.tile_rows != _config.tile_rows ||
+        cfg.serpentine != _config.serpentine || cfg.pin_e != _config.pin_e) {
+        printf("LEDMatrix: geometry changes need a restart\n");
+        return false;
+    }
+
+    DisplayConfig previous = _config;
+
+    stopDriver();
+    _config = cfg;
+    if (startDriver()) return true;
+
+    printf("LEDMatrix: ERROR could not start %d-bit @ %d MHz, restoring previous settings\n",
+           cfg.color_depth, cfg.clock_mhz);
+    stopDriver();
+    _config = previous;
+    if (!startDriver())
+        printf("LEDMatrix: ERROR driver restart failed, panel is dark\n");
+    return false;
 }
 
 // -----------------------------------------------------
 void LEDMatrix::clear()
 {
-    if (_panel)
-        _panel->fillScreen(0);
-}
-
-void LEDMatrix::show()
-{
-    // HUB75 DMA panels update continuously.
-    // If double-buffering is enabled later, handle it here.
+    _fb.clear();
 }
 
-void LEDMatrix::setBrightness(uint8_t b)
+// -----------------------------------------------------
+// Tiling: logical (x, y) -> coordinate on the driver's single chain.
+// Rows of modules are stacked top to bottom with the chain entering at
+// the top-left module; with serpentine wiring odd rows run right-to-left
+// and their modules are mounted upside-down.
+// -----------------------------------------------------
+void LEDMatrix::mapToChain(int x, int y, int& cx, int& cy) const
 {
-    if (_panel)
-        _panel->setBrightness8(b);
+    const int pw = _config.panel_width;
+    const int ph = _config.panel_height;
+    const int cols = _config.chain_length / _config.tile_rows;
+
+    int row = y / ph;
+    int col = x / pw;
+    int lx = x - col * pw;
+    int ly = y - row * ph;
+
+    if (_config.serpentine && (row & 1)) {
+        col = cols - 1 - col;
+        lx = pw - 1 - lx;
+        ly = ph - 1 - ly;
+    }
+
+    cx = (row * cols + col) * pw + lx;
+    cy = ly;
 }
 
 // -----------------------------------------------------
@@ -75,26 +88,79 @@ void LEDMatrix::drawPixel(int x, int y, uint32_t color)
 
 void LEDMatrix::drawPixelRGB(int x, int y, uint8_t r, uint8_t g, uint8_t b)
 {
-    if (_panel)
-        _panel->drawPixelRGB888(x, y, r, g, b);
+    _fb.drawPixelRGB888(x, y, r, g, b);
 }
 
 // -----------------------------------------------------
-// Text — uses Arduino print
+// Text — uses Adafruit GFX print
 // -----------------------------------------------------
 void LEDMatrix::drawText(int x, int y, const char* text, uint32_t color)
 {
-    if (!_panel) return;
-
     uint16_t col = color565(
         (color >> 16) & 0xFF,
         (color >> 8)  & 0xFF,
         (color & 0xFF)
     );
 
-    _panel->setCursor(x, y);
-    _panel->setTextColor(col);
-    _panel->print(text);
+    _fb.setCursor(x, y);
+    _fb.setTextColor(col);
+    _fb.print(text);
+}
+
+// -----------------------------------------------------
+// Sprites — RLE runs from flash decoded row by row. A FILL run is
+// expanded to RGB888 once; clipped pixels are skipped, not decoded.
+// -----------------------------------------------------
+void LEDMatrix::drawSprite(const RleSprite& sprite, int x, int y, int frame)
+{
+    if (frame < 0 || frame >= sprite.frameCount) return;
+    if (x >= _width || y >= _height || x + sprite.width <= 0 || y + sprite.height <= 0) return;
+
+    const uint16_t* run = sprite.rle + sprite.frames[frame];
+    const uint16_t* end = sprite.rle + sprite.frames[frame + 1];
+    uint8_t* pixels = _fb.pixels();
+
+    int row = 0;
+    int col = 0;
+    while (run < end && y + row < _height) {
+        const uint16_t header = *run++;
+        const int op = header >> RLE_OP_SHIFT;
+        const int len = header & RLE_LENGTH_MASK;
+        const int py = y + row;
+
+        // Visible part of this run: columns [from, to) of the sprite
+        int from = col;
+        int to = col + len;
+        if (x + from < 0) from = -x;
+        if (x + to > _width) to = _width - x;
+        const bool visible = py >= 0 && from < to;
+        uint8_t* dst = pixels + ((size_t)py * _width + x + from) * 3;
+
+        if (op == RLE_FILL) {
+            const uint16_t color = *run++;
+            if (visible) {
+                uint8_t r, g, b;
+                FrameBuffer::unpack565(color, r, g, b);
+                for (int i = from; i < to; ++i, dst += 3) {
+                    dst[0] = r;
+                    dst[1] = g;
+                    dst[2] = b;
+                }
+            }
+        } else if (op == RLE_COPY) {
+            if (visible) {
+                for (int i = from; i < to; ++i, dst += 3)
+                    FrameBuffer::unpack565(run[i - col], dst[0], dst[1], dst[2]);
+            }
+            run += len;
+        }
+
+        col += len;
+        if (col >= sprite.width) {
+            col = 0;
+            ++row;
+        }
+    }
 }
 
 // -----------------------------------------------------
@@ -102,5 +168,5 @@ void LEDMatrix::drawText(int x, int y, const char* text, uint32_t color)
 // -----------------------------------------------------
 uint16_t LEDMatrix::color565(uint8_t r, uint8_t g, uint8_t b)
 {
-    return _panel ? _panel->color565(r, g, b) : 0;
+    return FrameBuffer::color565(r, g, b);
 }
@@ -0,0 +1,188 @@
+#include "led_matrix.h"
+#include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "hub75_budget.h"
+#include "Arduino.h"
+#include "esp_heap_caps.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// HUB75 I2S-DMA backend: owns the driver and pushes the frame buffer to it.
+// The host simulator links its own implementation of these methods.
+
+LEDMatrix::~LEDMatrix()
+{
+    stopDriver();
+    free(_shown);
+}
+
+// -----------------------------------------------------
+// Initialize the HUB75 panel
+// -----------------------------------------------------
+void LEDMatrix::begin()
+{
+    if (!_fb.valid() || !_shown) {
+        printf("LEDMatrix: ERROR could not allocate %dx%d frame buffers\n", _width, _height);
+    }
+
+    if (!startDriver()) {
+        printf("LEDMatrix: ERROR HUB75 DMA driver failed to start\n");
+        return;
+    }
+
+    printf("LEDMatrix: HUB75 DMA display started (%dx%d, %d module(s) in %d row(s)).\n",
+           _width, _height, _config.chain_length, _config.tile_rows);
+}
+
+static HUB75_I2S_CFG::clk_speed clock_speed(uint8_t mhz)
+{
+    switch (mhz) {
+        case 20: return HUB75_I2S_CFG::HZ_20M;
+        case 15: return HUB75_I2S_CFG::HZ_15M;
+        case 10: return HUB75_I2S_CFG::HZ_10M;
+        default: return HUB75_I2S_CFG::HZ_8M;
+    }
+}
+
+bool LEDMatrix::startDriver()
+{
+    // The driver sees one long chain; tiling is resolved in show()
+    HUB75_I2S_CFG cfg(_config.panel_width, _config.panel_height, _config.chain_length);
+
+    // Apply your known-good pinout
+    cfg.gpio.r1 = 2;
+    cfg.gpio.g1 = 15;
+    cfg.gpio.b1 = 4;
+
+    cfg.gpio.r2 = 5;
+    cfg.gpio.g2 = 6;
+    cfg.gpio.b2 = 7;
+
+    cfg.gpio.a  = 8;
+    cfg.gpio.b  = 9;
+    cfg.gpio.c  = 10;
+    cfg.gpio.d  = 11;
+
+    cfg.gpio.clk = 12;
+    cfg.gpio.lat = 13;
+    cfg.gpio.oe  = 14;
+
+    // E line selects the second half of 1/32-scan (64-row) modules
+    if (_config.pin_e >= 0) {
+        cfg.gpio.e = _config.pin_e;
+    } else if (_config.panel_height > 32) {
+        printf("LEDMatrix: WARNING %d-row modules need the E pin configured\n", _config.panel_height);
+    }
+
+    // Profile: faster clock and less blanking raise the refresh rate; the
+    // driver shows low bit planes at reduced weight to hold min_refresh_rate
+    cfg.i2sspeed = clock_speed(_config.clock_mhz);
+    cfg.latch_blanking = _config.latch_blanking;
+    cfg.min_refresh_rate = _config.min_refresh_hz;
+
+    // Fewer bit planes = faster refresh and less DMA memory; show() applies
+    // gamma (the driver's own CIE table is disabled with NO_CIE1931) and
+    // dithers the frame buffer down to this depth
+    if (!_dither.configure(_width * _height, _config.color_depth, _config.dither)) {
+        printf("LEDMatrix: WARNING no memory for dithering, rounding instead\n");
+        _dither.configure(_width * _height, _config.color_depth, false);
+    }
+
+    // Measure what the driver really takes rather than trusting the model
+    size_t dmaFree = heap_caps_get_free_size(MALLOC_CAP_DMA);
+
+    _panel = new MatrixPanel_I2S_DMA(cfg);
+    _panel->setPixelColorDepthBits(_config.color_depth);
+    if (!_panel->begin()) {
+        delete _panel;
+        _panel = nullptr;
+        return false;
+    }
+    _panel->setBrightness8(_brightness);
+    size_t dmaLeft = heap_caps_get_free_size(MALLOC_CAP_DMA);
+
+    // The new bit-plane buffer is black; make show() redraw everything
+    if (_shown) memset(_shown, 0, (size_t)_width * _height * 3);
+
+    const int transition = hub75_transition_bit(_config.panel_width, _config.panel_height,
+                                                _config.chain_length, _config.color_depth,
+                                                _config.clock_mhz * 1000000u,
+                                                _config.latch_blanking, _config.min_refresh_hz);
+
+    _status.profile = _config.profile;
+    _status.dma_bytes = dmaFree > dmaLeft ? (uint32_t)(dmaFree - dmaLeft) : 0;
+    _status.refresh_hz = (uint16_t)hub75_refresh_hz(_config.panel_width, _config.panel_height,
+                                                    _config.chain_length, _config.color_depth,
+                                                    _config.clock_mhz * 1000000u,
+                                                    _config.latch_blanking, transition);
+    _status.color_depth = (uint8_t)_dither.depth();
+    _status.lsb_msb_transition = (uint8_t)transition;
+    _status.dither = _dither.dithering();
+    _status.valid = true;
+
+    printf("LEDMatrix: profile %s: %d-bit%s @ %d MHz, %lu bytes DMA (model %u), %u Hz refresh\n",
+           display_profile_spec(_config.profile).id, _status.color_depth,
+           _status.dither ? " dithered" : "", _config.clock_mhz,
+           (unsigned long)_status.dma_bytes,
+           (unsigned)hub75_dma_bytes(_config.panel_width, _config.panel_height, _config.chain_length,
+                                     _config.color_depth, _config.latch_blanking),
+           (unsigned)_status.refresh_hz);
+    return true;
+}
+
+void LEDMatrix::stopDriver()
+{
+    if (!_panel) return;
+
+    // Stop the DMA engine before its buffers go away
+    _panel->stopDMAoutput();
+    delete _panel;
+    _panel = nullptr;
+    _status.valid = false;
+}
+
+// -----------------------------------------------------
+// Blit
+// -----------------------------------------------------
+void LEDMatrix::show()
+{
+    if (!_panel || !_fb.valid() || !_shown) return;
+
+    // DMA panels refresh continuously from their own bit-plane buffer, so
+    // only pixels whose encoded value changed need to be re-encoded there.
+    // With dithering that includes every in-between level, every frame.
+    const uint8_t* src = _fb.pixels();
+    uint8_t* prev = _shown;
+    const bool tiled = _config.tile_rows > 1;
+    int pixel = 0;
+
+    for (int y = 0; y < _height; ++y) {
+        for (int x = 0; x < _width; ++x, ++pixel, src += 3, prev += 3) {
+            uint8_t out[3];
+            _dither.encode(pixel, src, out);
+
+            if (out[0] == prev[0] && out[1] == prev[1] && out[2] == prev[2])
+                continue;
+
+            prev[0] = out[0];
+            prev[1] = out[1];
+            prev[2] = out[2];
+
+            if (tiled) {
+                int cx, cy;
+                mapToChain(x, y, cx, cy);
+                _panel->drawPixelRGB888(cx, cy, out[0], out[1], out[2]);
+            } else {
+                _panel->drawPixelRGB888(x, y, out[0], out[1], out[2]);
+            }
+        }
+    }
+}
+
+void LEDMatrix::setBrightness(uint8_t b)
+{
+    _brightness = b;
+    if (_panel)
+        _panel->setBrightness8(b);
+}
+
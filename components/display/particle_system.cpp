@@ -0,0 +1,157 @@
+#include "particle_system.h"
+#include "fixed_math.h"
+#include <stdlib.h>
+
+// Longest step integrated at once; keeps fix_scale() in range and stops a
+// long stall (flight fetch, screen switch) from throwing particles off-panel
+static const float MAX_STEP = 0.1f;
+
+ParticleSystem::~ParticleSystem()
+{
+    release();
+}
+
+// -----------------------------------------------------
+// Arena
+// -----------------------------------------------------
+bool ParticleSystem::reserve(int capacity)
+{
+    release();
+    if (capacity <= 0) return true;
+
+    _arena = (uint8_t*)malloc((size_t)capacity * BYTES_PER_PARTICLE);
+    if (!_arena) return false;
+
+    // 32-bit fields first so every slice stays aligned
+    int32_t* fields = (int32_t*)_arena;
+    _x    = fields;
+    _y    = fields + capacity;
+    _vx   = fields + capacity * 2;
+    _vy   = fields + capacity * 3;
+    _life = fields + capacity * 4;
+    _color = (uint8_t*)(fields + capacity * 5);
+
+    _capacity = capacity;
+    _count = 0;
+    return true;
+}
+
+void ParticleSystem::release()
+{
+    free(_arena);
+    _arena = nullptr;
+    _x = _y = _vx = _vy = _life = nullptr;
+    _color = nullptr;
+    _capacity = 0;
+    _count = 0;
+}
+
+// -----------------------------------------------------
+// Configuration
+// -----------------------------------------------------
+void ParticleSystem::setGravity(float pxPerSecond2)
+{
+    _gravity = fix_from_float(pxPerSecond2);
+}
+
+void ParticleSystem::setFadeTime(float seconds)
+{
+    _fadeLife = fix_seconds(seconds);
+    if (_fadeLife < 1) _fadeLife = 1;
+    _fadeScale = (int32_t)((255LL << 16) / _fadeLife);
+}
+
+// -----------------------------------------------------
+// Spawning
+// -----------------------------------------------------
+int ParticleSystem::emit(const Burst& burst, XorShift32& rng)
+{
+    int n = burst.count;
+    if (n > _capacity - _count) n = _capacity - _count;
+
+    const int32_t x = fix_from_float(burst.x);
+    const int32_t y = fix_from_float(burst.y);
+    const int32_t speedMin = fix_from_float(burst.speedMin);
+    const int32_t speedMax = fix_from_float(burst.speedMax);
+    const int32_t lifeMin = fix_seconds(burst.lifeMin);
+    const int32_t lifeMax = fix_seconds(burst.lifeMax);
+
+    for (int k = 0; k < n; ++k) {
+        int i = _count++;
+
+        uint32_t r = rng.next();
+        uint8_t angle = r & 0xFF;
+        uint8_t hue = burst.hue + (burst.hueSpread ? (uint8_t)((r >> 8) % (burst.hueSpread + 1u)) : 0);
+        int32_t speed = rng.range(speedMin, speedMax);
+
+        _x[i] = x;
+        _y[i] = y;
+        _vx[i] = (int32_t)(((int64_t)speed * fix_cos(angle)) >> 14);
+        _vy[i] = (int32_t)(((int64_t)speed * fix_sin(angle)) >> 14);
+        _life[i] = rng.range(lifeMin, lifeMax);
+        _color[i] = hue;
+    }
+    return n;
+}
+
+// -----------------------------------------------------
+// Integration: one pass per field, then compaction
+// -----------------------------------------------------
+void ParticleSystem::update(float dt)
+{
+    if (_count == 0) return;
+    if (dt > MAX_STEP) dt = MAX_STEP;
+    if (dt < 0.0f) dt = 0.0f;
+
+    const int32_t t = fix_seconds(dt);
+    const int32_t dv = fix_scale(_gravity, t);
+    const int n = _count;
+
+    for (int i = 0; i < n; ++i) _x[i] += fix_scale(_vx[i], t);
+    for (int i = 0; i < n; ++i) _y[i] += fix_scale(_vy[i], t);
+    for (int i = 0; i < n; ++i) _vy[i] += dv;
+    for (int i = 0; i < n; ++i) _life[i] -= t;
+
+    // Swap-remove the dead so live particles stay packed
+    int i = 0;
+    while (i < _count) {
+        if (_life[i] > 0) {
+            ++i;
+            continue;
+        }
+        int last = --_count;
+        _x[i] = _x[last];
+        _y[i] = _y[last];
+        _vx[i] = _vx[last];
+        _vy[i] = _vy[last];
+        _life[i] = _life[last];
+        _color[i] = _color[last];
+    }
+}
+
+// -----------------------------------------------------
+// Drawing straight into the RGB888 frame buffer
+// -----------------------------------------------------
+void ParticleSystem::render(FrameBuffer& fb) const
+{
+    uint8_t* pixels = fb.pixels();
+    if (!pixels) return;
+
+    const unsigned w = fb.width();
+    const unsigned h = fb.height();
+
+    for (int i = 0; i < _count; ++i) {
+        // Unsigned compare rejects negative coordinates too
+        unsigned px = (unsigned)fix_to_int(_x[i]);
+        unsigned py = (unsigned)fix_to_int(_y[i]);
+        if (px >= w || py >= h) continue;
+
+        uint8_t level = (_life[i] >= _fadeLife) ? 255 : ((uint32_t)_life[i] * _fadeScale) >> 16;
+        Rgb888 c = scale_rgb(_palette[_color[i]], level);
+
+        uint8_t* dst = pixels + (py * w + px) * 3;
+        dst[0] = c.r;
+        dst[1] = c.g;
+        dst[2] = c.b;
+    }
+}
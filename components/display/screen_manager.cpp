@@ -1,64 +1,261 @@
 #include "screen_manager.h"
+#include "esp_heap_caps.h"
+#include <esp_log.h>
+
+static const char* TAG = "ScreenManager";
+
+// Frames the incoming screen runs undisturbed before the next one is
+// prepared, so preparation never lands on a switch or a transition
+static const int PREPARE_AFTER_FRAMES = 30;
+
+// Kept free on top of a screen's budget (TLS handshakes, HTTP buffers)
+static const size_t HEAP_HEADROOM = 24 * 1024;
+
+static size_t heap_free()
+{
+    return heap_caps_get_free_size(MALLOC_CAP_8BIT);
+}
 
 ScreenManager::ScreenManager(LEDMatrix& matrix)
     : _matrix(matrix)
 {
 }
 
-void ScreenManager::addScreen(BaseScreen* screen)
+ScreenManager::~ScreenManager()
+{
+    for (auto& slot : _slots)
+        if (slot.factory) delete slot.screen;
+}
+
+// -----------------------------------------------------
+// Registration and lazy construction
+// -----------------------------------------------------
+void ScreenManager::addScreen(const char* name, ScreenFactory factory, size_t budgetBytes)
 {
-    _screens.push_back(screen);
+    _slots.push_back(Slot{name, factory, budgetBytes, nullptr, 0, 0, 0.0f, false, false});
 
     // If this is the first screen, enter it
     if (_currentIndex == -1)
     {
         _currentIndex = 0;
-        _screens[0]->onEnter();
+        if (BaseScreen* s = build(0)) s->onEnter();
     }
 }
 
-void ScreenManager::nextScreen()
+void ScreenManager::addScreen(BaseScreen* screen)
+{
+    _slots.push_back(Slot{screen->name(), nullptr, 0, screen, 0, 0, 0.0f, false, false});
+
+    if (_currentIndex == -1)
+    {
+        _currentIndex = 0;
+        screen->onEnter();
+        _slots[0].holding = true;
+    }
+}
+
+BaseScreen* ScreenManager::build(int index)
 {
-    if (_screens.empty()) return;
+    Slot& slot = _slots[index];
+    slot.idle = 0.0f;
 
-    // Exit current
-    _screens[_currentIndex]->onExit();
+    if (!slot.holding && slot.budget > 0)
+        makeRoom(slot.budget, index);
+    slot.holding = true;
 
-    // Move index
-    _currentIndex = (_currentIndex + 1) % _screens.size();
+    if (slot.screen) return slot.screen;
+
+    // Measured once the first frame (or preparation) has allocated its buffers
+    slot.freeBefore = heap_free();
+    slot.measuring = true;
+    slot.screen = slot.factory();
+    if (!slot.screen)
+        ESP_LOGE(TAG, "Could not build %s", slot.name);
+    return slot.screen;
+}
+
+void ScreenManager::finishMeasure(int index)
+{
+    Slot& slot = _slots[index];
+    if (!slot.measuring) return;
+
+    slot.measuring = false;
+    size_t now = heap_free();
+    slot.measured = slot.freeBefore > now ? slot.freeBefore - now : 0;
+
+    if (slot.budget > 0 && slot.measured > slot.budget + ALLOCATOR_SLACK)
+        ESP_LOGW(TAG, "%s took %u bytes, over its %u byte budget",
+                 slot.name, (unsigned)slot.measured, (unsigned)slot.budget);
+    else
+        ESP_LOGI(TAG, "%s built: %u bytes (budget %u)",
+                 slot.name, (unsigned)slot.measured, (unsigned)slot.budget);
+}
+
+// -----------------------------------------------------
+// Reclaiming memory from screens that are not showing
+// -----------------------------------------------------
+void ScreenManager::release(int index)
+{
+    Slot& slot = _slots[index];
+    if (!slot.screen || !slot.holding) return;
+
+    slot.screen->release();
+    slot.holding = false;
+    if (index == predictedIndex()) _prepared = false;
+}
+
+void ScreenManager::makeRoom(size_t bytes, int keep)
+{
+    if (heap_free() >= bytes + HEAP_HEADROOM) return;
+
+    [[maybe_unused]] size_t freed = releaseAllBut(keep);
+    ESP_LOGI(TAG, "Released inactive screens for %s: %u bytes freed", _slots[keep].name, (unsigned)freed);
+}
+
+size_t ScreenManager::releaseInactive()
+{
+    return releaseAllBut(_currentIndex);
+}
+
+// Releases every screen but `keep` and the current one; returns the heap freed
+size_t ScreenManager::releaseAllBut(int keep)
+{
+    size_t before = heap_free();
+    for (int i = 0; i < (int)_slots.size(); ++i)
+        if (i != keep && i != _currentIndex) release(i);
 
-    // Enter new
-    _screens[_currentIndex]->onEnter();
+    size_t after = heap_free();
+    return after > before ? after - before : 0;
+}
+
+ScreenManager::MemoryInfo ScreenManager::memoryInfo(int index) const
+{
+    const Slot& slot = _slots[index];
+    return MemoryInfo{slot.name, slot.budget, slot.measured, slot.screen != nullptr, slot.holding};
+}
+
+void ScreenManager::sampleHeap()
+{
+    size_t now = heap_free();
+    if (now < _heapLowWater) _heapLowWater = now;
+}
+
+void ScreenManager::resetHeapLowWater()
+{
+    _heapLowWater = heap_free();
+}
+
+// -----------------------------------------------------
+// Switching
+// -----------------------------------------------------
+void ScreenManager::setTransition(Transition type, float seconds)
+{
+    _transition = type;
+    _transitionSeconds = seconds;
+    if (type == Transition::NONE)
+        _compositor.cancel();
+}
+
+void ScreenManager::nextScreen()
+{
+    if (_slots.empty()) return;
+    switchTo((_currentIndex + 1) % _slots.size(), 1);
 }
 
 void ScreenManager::previousScreen()
 {
-    if (_screens.empty()) return;
+    if (_slots.empty()) return;
+    switchTo(_currentIndex > 0 ? _currentIndex - 1 : (int)_slots.size() - 1, -1);
+}
 
-    _screens[_currentIndex]->onExit();
+void ScreenManager::switchTo(int index, int direction)
+{
+    // The frame buffer still holds the outgoing screen's last frame
+    _compositor.begin(*_matrix.gfx(), _transition, _transitionSeconds, direction);
 
-    _currentIndex--;
-    if (_currentIndex < 0)
-        _currentIndex = _screens.size() - 1;
+    // Enter before exiting, so a microphone both screens use stays open
+    BaseScreen* outgoing = current();
+    _slots[_currentIndex].idle = 0.0f;
 
-    _screens[_currentIndex]->onEnter();
+    _currentIndex = index;
+    if (BaseScreen* s = build(index)) s->onEnter();
+    if (outgoing) outgoing->onExit();
+
+    _prepared = false;
+    _settleFrames = 0;
 }
 
 BaseScreen* ScreenManager::current()
 {
-    if (_currentIndex >= 0 && _currentIndex < (int)_screens.size())
-        return _screens[_currentIndex];
+    if (_currentIndex >= 0 && _currentIndex < (int)_slots.size())
+        return _slots[_currentIndex].screen;
     return nullptr;
 }
 
+const char* ScreenManager::screenName(int index) const
+{
+    if (index >= 0 && index < (int)_slots.size())
+        return _slots[index].name;
+    return "-";
+}
+
+int ScreenManager::predictedIndex() const
+{
+    if (_slots.size() < 2) return -1;
+    return (_currentIndex + 1) % _slots.size();
+}
+
+void ScreenManager::prepareNext()
+{
+    if (_prepared) return;
+    _prepared = true;
+
+    int index = predictedIndex();
+    if (index < 0) return;
+
+    if (BaseScreen* s = build(index)) {
+        s->prepare(_matrix);
+        finishMeasure(index);
+    }
+}
+
+// -----------------------------------------------------
+// Frame
+// -----------------------------------------------------
 void ScreenManager::update(float dt)
 {
-    if (auto* s = current())
+    const bool transitioning = _compositor.active();
+    _compositor.update(dt);
+
+    if (auto* s = current()) {
+        if (transitioning && !_compositor.active())
+            s->onTransitionEnd();
         s->update(dt);
+    }
+
+    if (_preloading && !_prepared && !_compositor.active() && ++_settleFrames >= PREPARE_AFTER_FRAMES)
+        prepareNext();
+
+    if (_releaseAfter > 0.0f) {
+        const int next = predictedIndex();
+        for (int i = 0; i < (int)_slots.size(); ++i) {
+            Slot& slot = _slots[i];
+            if (i == _currentIndex || (i == next && _prepared) || !slot.holding) continue;
+            slot.idle += dt;
+            if (slot.idle >= _releaseAfter) release(i);
+        }
+    }
+
+    sampleHeap();
 }
 
 void ScreenManager::render()
 {
-    if (auto* s = current())
+    if (auto* s = current()) {
         s->render(_matrix);
+        finishMeasure(_currentIndex);
+    }
+
+    if (_compositor.active())
+        _compositor.apply(*_matrix.gfx());
 }
@@ -0,0 +1,83 @@
+#include "animation_screen.h"
+#include "anim_partition.h"
+#include "led_matrix.h"
+#include <Fonts/TomThumb.h>
+#include <esp_log.h>
+#include <math.h>
+
+static const char* TAG = "AnimationScreen";
+
+bool AnimationScreen::load()
+{
+    if (player.valid()) return true;
+
+    AnimPartition& part = AnimPartition::instance();
+    if (!part.map()) return false;
+
+    // Validates the whole clip (CRC) once, so do it ahead of the switch
+    if (!player.open(part.data(), part.size())) {
+        ESP_LOGE(TAG, "anim partition: %s", player.error());
+        return false;
+    }
+    ESP_LOGI(TAG, "%dx%d, %d frames at %.1f FPS, %u bytes", player.width(), player.height(),
+             player.frameCount(), 1.0f / player.frameSeconds(), (unsigned)player.fileBytes());
+    return true;
+}
+
+void AnimationScreen::prepare(LEDMatrix&)
+{
+    load();
+}
+
+void AnimationScreen::onEnter()
+{
+    load();
+    elapsed = 0.0f;
+    redraw = true;
+    reported = false;
+}
+
+void AnimationScreen::onTransitionEnd()
+{
+    // The compositor mixed the outgoing screen into our frames
+    redraw = true;
+}
+
+void AnimationScreen::update(float dt)
+{
+    if (!player.valid()) return;
+
+    elapsed += dt;
+    const float length = player.frameCount() * player.frameSeconds();
+    if (elapsed >= length)
+        elapsed = fmodf(elapsed, length);
+}
+
+void AnimationScreen::render(LEDMatrix& matrix)
+{
+    if (!player.valid()) {
+        matrix.clear();
+        auto* d = matrix.gfx();
+        d->setFont(&TomThumb);
+        d->setTextSize(1);
+        d->setTextColor(matrix.color565(128, 128, 128));
+        d->setCursor((matrix.width() - 64) / 2 + 2, (matrix.height() - 32) / 2 + 14);
+        d->print("No animation");
+        return;
+    }
+
+    if (redraw) {
+        matrix.clear();
+        player.invalidate();
+        redraw = false;
+    }
+
+    int frame = (int)(elapsed / player.frameSeconds());
+    if (frame >= player.frameCount()) frame = player.frameCount() - 1;
+
+    player.seek(frame, *matrix.gfx());
+    if (player.frame() != frame && !reported) {
+        ESP_LOGE(TAG, "Frame %d: %s", frame, player.error());
+        reported = true;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "base_screen.h"
+#include "anim_player.h"
+
+// Loops the pre-rendered animation in the anim flash partition (attract
+// mode). Frames are decoded from the mapping into the frame buffer on top
+// of the previous one, so the screen only redraws in full after something
+// else drew there.
+class AnimationScreen : public BaseScreen {
+public:
+    void onEnter() override;
+    void prepare(LEDMatrix& matrix) override;
+    void onTransitionEnd() override;
+    void update(float dt) override;
+    void render(LEDMatrix& matrix) override;
+    const char* name() const override { return "Animation"; }
+
+private:
+    bool load();
+
+    AnimPlayer player;
+    float elapsed = 0.0f;       // Playback position, wraps at the clip length
+    bool redraw = true;         // Frame buffer does not hold our last frame
+    bool reported = false;      // Decode error logged
+};
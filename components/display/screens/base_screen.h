@@ -8,12 +8,30 @@ public:
     // Called once when entering this screen
     virtual void onEnter() {}
 
-    // Called once when leaving this screen
+    // Called once when leaving this screen, after the incoming screen's
+    // onEnter(), so hardware both of them use is handed over, not restarted
     virtual void onExit() {}
 
+    // Called ahead of onEnter() while another screen is showing, when this
+    // one is predicted to come next: start slow hardware, pre-render static
+    // layers, fill caches. The screen may still never be entered.
+    virtual void prepare(LEDMatrix&) {}
+
+    // Called after the screen has been inactive for a while, or when
+    // another screen needs the memory: free large buffers. They are
+    // rebuilt by the next prepare() or the first render() after onEnter().
+    virtual void release() {}
+
+    // Called when the transition into this screen has finished; until then
+    // the outgoing frame was mixed into the frame buffer after render()
+    virtual void onTransitionEnd() {}
+
     // Called each frame (for animations)
     virtual void update(float dt) = 0;
 
     // Called each frame to draw content
     virtual void render(LEDMatrix& matrix) = 0;
+
+    // Short label for logs and the profiler
+    virtual const char* name() const = 0;
 };
@@ -2,6 +2,7 @@
 #include "led_matrix.h"
 #include "wifi_manager.h"
 #include "time_sync.h"
+#include "color_lut.h"
 #include <Fonts/TomThumb.h>
 #include <stdio.h>
 
@@ -78,87 +79,66 @@ void ClockScreen::update(float dt)
     }
 }
 
-// Helper function to convert HSV to RGB
-static void hsvToRgb(float h, float s, float v, uint8_t& r, uint8_t& g, uint8_t& b) {
-    float c = v * s;
-    float x = c * (1.0f - fabs(fmod(h / 60.0f, 2.0f) - 1.0f));
-    float m = v - c;
-
-    float r1, g1, b1;
-    if (h < 60) {
-        r1 = c; g1 = x; b1 = 0;
-    } else if (h < 120) {
-        r1 = x; g1 = c; b1 = 0;
-    } else if (h < 180) {
-        r1 = 0; g1 = c; b1 = x;
-    } else if (h < 240) {
-        r1 = 0; g1 = x; b1 = c;
-    } else if (h < 300) {
-        r1 = x; g1 = 0; b1 = c;
-    } else {
-        r1 = c; g1 = 0; b1 = x;
-    }
-
-    r = (uint8_t)((r1 + m) * 255);
-    g = (uint8_t)((g1 + m) * 255);
-    b = (uint8_t)((b1 + m) * 255);
-}
-
 void ClockScreen::render(LEDMatrix& matrix)
 {
     matrix.clear();
 
-    auto* d = matrix.raw();
+    // Layout is designed for 64x32; scale it by whole steps on larger
+    // panels and center whatever space is left over
+    int sx = matrix.width() / 64;
+    int sy = matrix.height() / 32;
+    int k = (sx < sy) ? sx : sy;
+    if (k < 1) k = 1;
+    const int ox = (matrix.width() - 64 * k) / 2;
+    const int oy = (matrix.height() - 32 * k) / 2;
+
+    auto* d = matrix.gfx();
     d->setFont(&TomThumb);
-    d->setTextSize(1);
+    d->setTextSize(k);
 
     if (state == NO_WIFI) {
-        d->setCursor(2, 10);
+        d->setCursor(ox + 2 * k, oy + 10 * k);
         d->setTextColor(matrix.color565(0, 255, 255));
         d->print("Connect WiFi");
-        d->setCursor(8, 18);
+        d->setCursor(ox + 8 * k, oy + 18 * k);
         d->print("for clock");
     }
     else if (state == SYNCING) {
-        d->setCursor(8, 12);
+        d->setCursor(ox + 8 * k, oy + 12 * k);
         d->setTextColor(matrix.color565(255, 255, 0));
         d->print("Syncing");
-        d->setCursor(8, 20);
+        d->setCursor(ox + 8 * k, oy + 20 * k);
         d->print("time...");
     }
     else { // READY
-        // Calculate rainbow color
-        uint8_t r, g, b;
-        hsvToRgb(colorHue, 1.0f, 1.0f, r, g, b);
-        uint16_t rainbowColor = matrix.color565(r, g, b);
+        // Rainbow color from the hue table (256 steps per turn)
+        Rgb888 rainbow = color_hue((uint8_t)(colorHue * (256.0f / 360.0f)));
+        uint16_t rainbowColor = rgb_to_565(rainbow);
 
         // Use larger text size for time
-        d->setTextSize(2);
+        d->setTextSize(2 * k);
 
         // Display hour (right-aligned to center)
-        d->setCursor(10, 12);
+        d->setCursor(ox + 10 * k, oy + 12 * k);
         d->setTextColor(rainbowColor);
         d->print(hourStr);
 
         // Display blinking colon
         if (colonVisible) {
-            d->setCursor(28, 12);
+            d->setCursor(ox + 28 * k, oy + 12 * k);
             d->setTextColor(rainbowColor);
             d->print(":");
         }
 
         // Display minutes
-        d->setCursor(34, 12);
+        d->setCursor(ox + 34 * k, oy + 12 * k);
         d->setTextColor(rainbowColor);
         d->print(minStr);
 
         // AM/PM indicator (smaller, bottom right with dimmer rainbow)
-        uint8_t dimR = r / 2;
-        uint8_t dimG = g / 2;
-        uint8_t dimB = b / 2;
-        d->setTextSize(1);
-        d->setCursor(50, 26);
-        d->setTextColor(matrix.color565(dimR, dimG, dimB));
+        d->setTextSize(k);
+        d->setCursor(ox + 50 * k, oy + 26 * k);
+        d->setTextColor(rgb_to_565(scale_rgb(rainbow, 127)));
         d->print(ampmStr);
     }
 }
@@ -7,6 +7,7 @@ public:
     void onEnter() override;
     void update(float dt) override;
     void render(LEDMatrix& matrix) override;
+    const char* name() const override { return "Clock"; }
 
 private:
     char hourStr[4] = "12";      // Hour part (up to 2 digits + null)
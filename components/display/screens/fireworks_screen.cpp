@@ -1,170 +1,92 @@
 #include "fireworks_screen.h"
 #include "led_matrix.h"
+#include "fixed_math.h"
+#include "color_lut.h"
 #include "esp_random.h"
+#include "microphone.h"
 #include <math.h>
 
-// Pulling your original constants
-#define PANEL_RES_X 64
-#define PANEL_RES_Y 32
-
-// ---------------- YOUR ORIGINAL FIREWORKS STRUCTS ----------------
-struct Particle {
-    float x, y;
-    float vx, vy;
-    float life;
-    uint16_t color;
-    bool active;
-};
-
-struct Firework {
-    float x, y;
-    float vy;
-    bool exploded;
-    bool active;
-    Particle particles[50];
-    float trailX[10];
-    float trailY[10];
-};
-
-static Firework fireworks[5];  // exactly as before
-
-// ---------------- ORIGINAL WHEEL() ----------------
-static uint16_t wheel(MatrixPanel_I2S_DMA* dma_display, uint8_t pos) {
-    pos = 255 - pos;
-    if (pos < 85) return dma_display->color565(255 - pos * 3, 0, pos * 3);
-    if (pos < 170) {
-        pos -= 85;
-        return dma_display->color565(0, pos * 3, 255 - pos * 3);
-    }
-    pos -= 170;
-    return dma_display->color565(pos * 3, 255 - pos * 3, 0);
+// Tuned on the original 64x32 panel at 60 FPS, expressed per second so
+// the motion no longer depends on the frame rate
+static const int BASE_ROCKETS = 5;
+static const int MAX_ROCKETS = 64;
+static const int PARTICLES_PER_BURST = 50;
+static const float BASE_LAUNCH_RATE = 15.0f;       // attempts/s on 64x32
+
+static const float ROCKET_GRAVITY = 126.0f;        // px/s^2
+static const float ROCKET_SPEED_MIN = 54.0f;       // px/s on a 32-row panel
+static const float ROCKET_SPEED_MAX = 90.0f;
+static const float ROCKET_BURST_VY = -9.0f;        // burst once slower than this
+static const float TRAIL_STEP = 1.0f / 60.0f;      // one trail point per step
+
+static const float SPARK_GRAVITY = 72.0f;
+static const float SPARK_SPEED_MIN = 24.0f;
+static const float SPARK_SPEED_MAX = 73.5f;
+static const float SPARK_LIFE_MIN = 0.27f;
+static const float SPARK_LIFE_MAX = 0.93f;
+static const float SPARK_FADE = 0.4f;
+
+static const Rgb888 TRAIL_COLOR = {255, 150, 80};
+
+// With music, rockets follow the beats and random launches thin out
+static const float MUSIC_HOLD_S = 2.0f;            // since the last beat
+static const float MUSIC_LAUNCH_SCALE = 0.25f;
+static const float STRONG_BEAT = 2.0f;             // a second rocket above this strength
+
+// -----------------------------------------------------
+// Sizing: rocket slots and particle pool scale with panel area
+// -----------------------------------------------------
+int FireworksScreen::rocketSlots(int w, int h)
+{
+    float area = (float)(w * h) / (64 * 32);
+    if (area < 1.0f) area = 1.0f;
+
+    int slots = (int)(BASE_ROCKETS * area);
+    return slots > MAX_ROCKETS ? MAX_ROCKETS : slots;
 }
 
-// ---------------- ORIGINAL SPAWN FUNCTION ----------------
-static void spawnFirework() 
+size_t FireworksScreen::memoryBudget(int w, int h)
 {
-    for (auto &fw : fireworks) {
-        if (!fw.active) {
-            fw.active = true;
-            fw.exploded = false;
+    const int slots = rocketSlots(w, h);
+    return sizeof(FireworksScreen) + slots * sizeof(Rocket) +
+           ParticleSystem::bytesFor(slots * PARTICLES_PER_BURST);
+}
 
-            fw.x = esp_random() % PANEL_RES_X;
-            fw.y = PANEL_RES_Y - 1;
-            fw.vy = -((esp_random() % 10) / 15.0f + 0.9f);
+void FireworksScreen::configure(int w, int h)
+{
+    width = w;
+    height = h;
 
-            for (int i = 0; i < 10; i++) {
-                fw.trailX[i] = fw.x;
-                fw.trailY[i] = fw.y;
-            }
+    float area = (float)(w * h) / (64 * 32);
+    if (area < 1.0f) area = 1.0f;
 
-            for (auto &p : fw.particles)
-                p.active = false;
+    const int slots = rocketSlots(w, h);
+    rockets.assign(slots, Rocket{});
+    launchRate = BASE_LAUNCH_RATE * area;
 
-            return;
-        }
-    }
+    particles.reserve(slots * PARTICLES_PER_BURST);
+    particles.setGravity(SPARK_GRAVITY);
+    particles.setFadeTime(SPARK_FADE);
+    particles.setPalette(COLOR_WHEEL.data());
 }
 
-// ---------------- ORIGINAL DRAW FUNCTION ----------------
-static void drawFireworks(MatrixPanel_I2S_DMA* dma_display, uint16_t frame)
+void FireworksScreen::launch()
 {
-    dma_display->fillScreen(0);
-
-    if ((esp_random() & 20) == 0)
-        spawnFirework();
-
-    for (auto &fw : fireworks) {
-        if (!fw.active) continue;
-
-        if (!fw.exploded) {
-
-            // ---- TRAIL ----
-            for (int i = 0; i < 10; i++) {
-                float fade = 1.0f - (i / 10.0f);
-                uint8_t blue = 80 * fade;
-
-                int tx = (int)fw.trailX[i];
-                int ty = (int)fw.trailY[i];
-
-                if (tx >= 0 && tx < PANEL_RES_X &&
-                    ty >= 0 && ty < PANEL_RES_Y)
-                {
-                    dma_display->drawPixelRGB888(
-                        tx, ty, 
-                        (uint8_t)(255 * fade),
-                        (uint8_t)(150 * fade),
-                        blue
-                    );
-                }
-            }
-
-            for (int i = 9; i > 0; i--) {
-                fw.trailX[i] = fw.trailX[i - 1];
-                fw.trailY[i] = fw.trailY[i - 1];
-            }
-            fw.trailX[0] = fw.x;
-            fw.trailY[0] = fw.y;
-
-            // ---- ROCKET ----
-            dma_display->drawPixelRGB888((int)fw.x, (int)fw.y, 255, 255, 255);
-
-            fw.y += fw.vy;
-            fw.vy += 0.035f;
-
-            if (fw.y < 8 || fw.vy > -0.15f)
-                fw.exploded = true;
-
-            if (fw.exploded) {
-                for (auto &p : fw.particles) {
-                    p.active = true;
-
-                    float angle = (esp_random() % 360) * 0.01745f;
-                    float speed = (esp_random() % 100) / 120.0f + 0.4f;
-
-                    p.x = fw.x;
-                    p.y = fw.y;
-                    p.vx = cosf(angle) * speed;
-                    p.vy = sinf(angle) * speed;
-
-                    p.life = (esp_random() % 20) / 10.0f + 0.8f;
-                    p.color = wheel(dma_display, frame + (esp_random() & 255));
-                }
-            }
-        } else {
-            bool alive = false;
-
-            for (auto &p : fw.particles) {
-                if (!p.active) continue;
-                alive = true;
-
-                float fade = p.life / 1.2f;
-                if (fade < 0) fade = 0;
-
-                uint8_t r = ((p.color >> 11) & 0x1F) * 8 * fade;
-                uint8_t g = ((p.color >> 5)  & 0x3F) * 4 * fade;
-                uint8_t b = (p.color & 0x1F) * 8 * fade;
-
-                int px = (int)p.x;
-                int py = (int)p.y;
-
-                if (px >= 0 && px < PANEL_RES_X &&
-                    py >= 0 && py < PANEL_RES_Y)
-                {
-                    dma_display->drawPixelRGB888(px, py, r, g, b);
-                }
-
-                p.x += p.vx;
-                p.y += p.vy;
-                p.vy += 0.02f;
-                p.life -= 0.05f;
-
-                if (p.life <= 0)
-                    p.active = false;
-            }
-
-            if (!alive)
-                fw.active = false;
-        }
+    for (auto& r : rockets) {
+        if (r.active) continue;
+
+        // Launch speed scales with sqrt(height) so the apex tracks panel size
+        float speed = ROCKET_SPEED_MIN + (ROCKET_SPEED_MAX - ROCKET_SPEED_MIN) * rng.below(10) / 9.0f;
+        speed *= sqrtf(height / 32.0f);
+
+        r.active = true;
+        r.x = fix_from_int(rng.below(width));
+        r.y = fix_from_int(height - 1);
+        r.vy = fix_from_float(-speed);
+        r.trailHead = 0;
+        r.trailCount = 0;
+        r.trailTimer = 0.0f;
+        return;
     }
 }
 
@@ -172,18 +94,123 @@ static void drawFireworks(MatrixPanel_I2S_DMA* dma_display, uint16_t frame)
 void FireworksScreen::onEnter()
 {
     // Reset fireworks when entering
-    for (auto &fw : fireworks)
-        fw.active = false;
+    for (auto& r : rockets)
+        r.active = false;
+    particles.clear();
 
-    frame = 0;
+    rng.setSeed(esp_random());
+    time = 0.0f;
+
+    if (!micHeld) mic_acquire();
+    micHeld = true;
+    beats.begin();
+}
+
+// Only our own reference: the next screen may be listening too
+void FireworksScreen::onExit()
+{
+    if (micHeld) mic_release();
+    micHeld = false;
+}
+
+// Size the rocket slots and particle pool before the switch
+void FireworksScreen::prepare(LEDMatrix& matrix)
+{
+    FrameBuffer* fb = matrix.gfx();
+    if (fb->width() != width || fb->height() != height)
+        configure(fb->width(), fb->height());
+}
+
+void FireworksScreen::release()
+{
+    std::vector<Rocket>().swap(rockets);
+    particles.release();
+    width = height = 0;         // configure() again on the next prepare or render
 }
 
 void FireworksScreen::update(float dt)
 {
-    frame++;
+    if (rockets.empty()) return;     // sized on the first render
+    if (dt > 0.1f) dt = 0.1f;
+
+    time += dt;
+
+    // On the beat, then the same launch odds per second at any frame rate
+    for (int n = beats.update(dt); n > 0; --n) {
+        launch();
+        if (beats.strength() > STRONG_BEAT) launch();
+    }
+    const float rate = beats.sinceBeatS() < MUSIC_HOLD_S ? launchRate * MUSIC_LAUNCH_SCALE : launchRate;
+    uint32_t chance = (uint32_t)(rate * dt * 65536.0f);
+    if (rng.below(65536) < chance)
+        launch();
+
+    const int32_t t = fix_seconds(dt);
+    const int32_t dv = fix_scale(fix_from_float(ROCKET_GRAVITY), t);
+    const int32_t burstVy = fix_from_float(ROCKET_BURST_VY);
+    const int32_t burstY = fix_from_int(height / 4);
+
+    for (auto& r : rockets) {
+        if (!r.active) continue;
+
+        // Trail points at a fixed rate, stored in a ring instead of shifted
+        r.trailTimer += dt;
+        while (r.trailTimer >= TRAIL_STEP) {
+            r.trailTimer -= TRAIL_STEP;
+            r.trailHead = (r.trailHead + 1) % TRAIL_LENGTH;
+            r.trailX[r.trailHead] = fix_to_int(r.x);
+            r.trailY[r.trailHead] = fix_to_int(r.y);
+            if (r.trailCount < TRAIL_LENGTH) r.trailCount++;
+        }
+
+        r.y += fix_scale(r.vy, t);
+        r.vy += dv;
+
+        // Burst in the top quarter (8 px on the original 32-row panel)
+        if (r.y < burstY || r.vy > burstVy) {
+            r.active = false;
+
+            ParticleSystem::Burst burst;
+            burst.x = r.x / (float)FIX_ONE;
+            burst.y = r.y / (float)FIX_ONE;
+            burst.count = PARTICLES_PER_BURST;
+            burst.speedMin = SPARK_SPEED_MIN;
+            burst.speedMax = SPARK_SPEED_MAX;
+            burst.lifeMin = SPARK_LIFE_MIN;
+            burst.lifeMax = SPARK_LIFE_MAX;
+            burst.hue = (uint8_t)(time * 60.0f);
+            burst.hueSpread = 255;
+            particles.emit(burst, rng);
+        }
+    }
+
+    particles.update(dt);
 }
 
 void FireworksScreen::render(LEDMatrix& matrix)
 {
-    drawFireworks(matrix.raw(), frame);
+    FrameBuffer* fb = matrix.gfx();
+    if (fb->width() != width || fb->height() != height)
+        configure(fb->width(), fb->height());
+
+    fb->fillScreen(0);
+    particles.render(*fb);
+
+    for (const auto& r : rockets) {
+        if (!r.active) continue;
+
+        // ---- TRAIL (newest first, fading out) ----
+        int idx = r.trailHead;
+        for (int i = 0; i < r.trailCount; ++i) {
+            Rgb888 c = scale_rgb(TRAIL_COLOR, 255 - i * 256 / TRAIL_LENGTH);
+            int tx = r.trailX[idx];
+            int ty = r.trailY[idx];
+            if (tx >= 0 && tx < width && ty >= 0 && ty < height)
+                fb->drawPixelRGB888(tx, ty, c.r, c.g, c.b);
+            idx = (idx + TRAIL_LENGTH - 1) % TRAIL_LENGTH;
+        }
+
+        // ---- ROCKET ----
+        fb->drawPixelRGB888(fix_to_int(r.x), fix_to_int(r.y), 255, 255, 255);
+    }
 }
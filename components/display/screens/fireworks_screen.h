@@ -1,13 +1,50 @@
 #pragma once
 
+#include <vector>
 #include "base_screen.h"
+#include "audio_capture.h"
+#include "particle_system.h"
+#include "xorshift.h"
 
 class FireworksScreen : public BaseScreen {
 public:
     void onEnter() override;
+    void onExit() override;
+    void prepare(LEDMatrix& matrix) override;
+    void release() override;
     void update(float dt) override;
     void render(LEDMatrix& matrix) override;
+    const char* name() const override { return "Fireworks"; }
+
+    // Heap taken on a panel of this size (rocket slots + particle pool)
+    static size_t memoryBudget(int width, int height);
 
 private:
-    uint16_t frame = 0;
+    static const int TRAIL_LENGTH = 10;
+
+    struct Rocket {
+        int32_t x, y;               // Q24.8 px
+        int32_t vy;                 // Q24.8 px/s
+        int16_t trailX[TRAIL_LENGTH];   // ring buffer, newest at trailHead
+        int16_t trailY[TRAIL_LENGTH];
+        uint8_t trailHead;
+        uint8_t trailCount;
+        float trailTimer;
+        bool active;
+    };
+
+    static int rocketSlots(int width, int height);
+    void configure(int width, int height);
+    void launch();
+
+    int width = 0;
+    int height = 0;
+    float launchRate = 0.0f;        // rockets per second while slots are free
+    float time = 0.0f;              // drives the palette rotation
+
+    std::vector<Rocket> rockets;
+    ParticleSystem particles;
+    XorShift32 rng;
+    BeatFollower beats;             // rockets go up on the beat when there is music
+    bool micHeld = false;           // we hold a reference to the microphone
 };
@@ -3,6 +3,7 @@
 #include "wifi_manager.h"
 #include "app_config.h"
 #include "flight_api.h"
+#include "assets.h"
 #include <Fonts/TomThumb.h>
 #include <stdio.h>
 #include <math.h>
@@ -20,10 +21,15 @@ static int calculateCenteredX(const char* text, int displayWidth) {
 
 void FlightScreen::onEnter()
 {
-    scrollOffset = 0.0f;
     updateTimer = 0.0f;
+    cycleTimer = 0.0f;
+    animTime = 0.0f;
     currentFlightIndex = 0;
 
+    countryTicker.setFont(&TomThumb);
+    countryTicker.setColor(100, 200, 255);
+    countryTicker.reset();
+
     // Determine initial state
     WiFiManager& wm = WiFiManager::instance();
     if (wm.getState() != WiFiState::CONNECTED) {
@@ -40,6 +46,8 @@ void FlightScreen::onEnter()
 void FlightScreen::update(float dt)
 {
     updateTimer += dt;
+    animTime += dt;
+    countryTicker.update(dt);
 
     // Check state every 0.5 seconds
     if (updateTimer >= 0.5f) {
@@ -70,7 +78,6 @@ void FlightScreen::update(float dt)
     // Cycle through flights when in READY state
     if (state == READY && updateTimer >= 0.25f) {
         // Auto-cycle to next flight every 3 seconds
-        static float cycleTimer = 0.0f;
         cycleTimer += dt;
         if (cycleTimer >= 3.0f) {
             cycleTimer = 0.0f;
@@ -86,37 +93,47 @@ void FlightScreen::render(LEDMatrix& matrix)
 {
     matrix.clear();
 
-    auto* d = matrix.raw();
+    // The layout is designed as a 64x32 card: centered vertically, with the
+    // right-hand column anchored to the right edge on wider panels
+    const int w = matrix.width();
+    const int ox = (w - 64) / 2;
+    const int oy = (matrix.height() - 32) / 2;
+    const int right = w - 22;       // x = 42 on a 64 px panel
+
+    auto* d = matrix.gfx();
     d->setFont(&TomThumb);
     d->setTextSize(1);
 
     if (state == NO_WIFI) {
-        d->setCursor(2, 10);
+        d->setCursor(ox + 2, oy + 10);
         d->setTextColor(matrix.color565(0, 255, 255));
         d->print("Connect WiFi");
-        d->setCursor(2, 18);
+        d->setCursor(ox + 2, oy + 18);
         d->print("for flights");
+        matrix.drawSprite(ASSET_WIFI, ox + 53, oy + 4);
     }
     else if (state == NO_LOCATION) {
-        d->setCursor(2, 10);
+        d->setCursor(ox + 2, oy + 10);
         d->setTextColor(matrix.color565(255, 165, 0));
         d->print("Configure");
-        d->setCursor(2, 18);
+        d->setCursor(ox + 2, oy + 18);
         d->print("location");
     }
     else if (state == LOADING) {
         if (showNoFlights) {
-            d->setCursor(8, 12);
+            d->setCursor(ox + 8, oy + 12);
             d->setTextColor(matrix.color565(128, 128, 128));
             d->print("No flights");
-            d->setCursor(12, 20);
+            d->setCursor(ox + 12, oy + 20);
             d->print("nearby");
         } else {
-            d->setCursor(2, 12);
+            d->setCursor(ox + 2, oy + 12);
             d->setTextColor(matrix.color565(255, 255, 0));
             d->print("Loading");
-            d->setCursor(2, 20);
+            d->setCursor(ox + 2, oy + 20);
             d->print("flights...");
+            const RleSprite& sweep = ASSET_RADAR_SWEEP;
+            matrix.drawSprite(sweep, ox + 45, oy + 8, sweep.frameAt((uint32_t)(animTime * 1000.0f)));
         }
     }
     else { // READY
@@ -139,24 +156,24 @@ void FlightScreen::render(LEDMatrix& matrix)
             d->setTextSize(1);
 
             // Display departure airport
-            d->setCursor(2, 8);
+            d->setCursor(2, oy + 8);
             d->setTextColor(matrix.color565(0, 255, 0));
             d->print(flight.departureAirport);
 
             // Display arrow
-            d->setCursor(26, 8);
+            d->setCursor(w / 2 - 6, oy + 8);
             d->setTextColor(matrix.color565(100, 200, 100));
             d->print("=>");
 
             // Display arrival airport
-            d->setCursor(38, 8);
+            d->setCursor(w / 2 + 6, oy + 8);
             d->setTextColor(matrix.color565(0, 255, 200));
             d->print(flight.arrivalAirport);
 
             // Display flight callsign (line 2) - centered
             d->setTextSize(2);
-            int callsignX = calculateCenteredX(flight.callsign, 64);
-            d->setCursor(callsignX, 11);
+            int callsignX = calculateCenteredX(flight.callsign, w);
+            d->setCursor(callsignX, oy + 11);
             d->setTextColor(matrix.color565(255, 255, 0));
             d->print(flight.callsign);
             d->setTextSize(1);
@@ -165,7 +182,7 @@ void FlightScreen::render(LEDMatrix& matrix)
             int altFeet = (int)(flight.altitude * 3.28084f);  // Convert meters to feet
             char altStr[16];
             snprintf(altStr, sizeof(altStr), "ALT:%dft", altFeet);
-            d->setCursor(2, 24);
+            d->setCursor(2, oy + 24);
             d->setTextColor(matrix.color565(100, 150, 255));
             d->print(altStr);
 
@@ -173,7 +190,7 @@ void FlightScreen::render(LEDMatrix& matrix)
             int speedKnots = (int)(flight.velocity * 1.94384f);  // Convert m/s to knots
             char speedStr[16];
             snprintf(speedStr, sizeof(speedStr), "%dkt", speedKnots);
-            d->setCursor(38, 24);
+            d->setCursor(right - 4, oy + 24);
             d->setTextColor(matrix.color565(255, 200, 0));
             d->print(speedStr);
 
@@ -182,20 +199,20 @@ void FlightScreen::render(LEDMatrix& matrix)
             d->setTextSize(2);
 
             // Draw flight callsign (line 1) - centered
-            int callsignX = calculateCenteredX(flight.callsign, 64);
-            d->setCursor(callsignX, 17);
+            int callsignX = calculateCenteredX(flight.callsign, w);
+            d->setCursor(callsignX, oy + 17);
             d->setTextColor(matrix.color565(0, 255, 0));
             d->print(flight.callsign);
 
             d->setTextSize(1);
-            // Country (line 2 left) + Flight count (line 2 right)
-            d->setCursor(2, 24);
-            d->setTextColor(matrix.color565(100, 200, 255));
-            d->print(flight.country);
+            // Country (line 2 left, scrolls if too long) + Flight count (line 2 right)
+            countryTicker.setViewport(2, oy + 24, right - 4);
+            countryTicker.setText(flight.country);
+            countryTicker.render(matrix);
 
             char countStr[16];
             snprintf(countStr, sizeof(countStr), "%d/%zu", currentFlightIndex + 1, flights.size());
-            d->setCursor(42, 24);
+            d->setCursor(right, oy + 24);
             d->setTextColor(matrix.color565(128, 128, 128));
             d->print(countStr);
 
@@ -203,7 +220,7 @@ void FlightScreen::render(LEDMatrix& matrix)
             int altMeters = (int)(flight.altitude);
             char altStr[16];
             snprintf(altStr, sizeof(altStr), "ALT:%dm", altMeters);
-            d->setCursor(2, 31);
+            d->setCursor(2, oy + 31);
             d->setTextColor(matrix.color565(100, 150, 255));
             d->print(altStr);
 
@@ -211,7 +228,7 @@ void FlightScreen::render(LEDMatrix& matrix)
             int speedKmh = (int)(flight.velocity * 3.6f);  // Convert m/s to km/h
             char speedStr[16];
             snprintf(speedStr, sizeof(speedStr), "%dkm", speedKmh);
-            d->setCursor(42, 31);
+            d->setCursor(right, oy + 31);
             d->setTextColor(matrix.color565(255, 200, 0));
             d->print(speedStr);
         }
@@ -220,7 +237,7 @@ void FlightScreen::render(LEDMatrix& matrix)
         if (hasAirports) {
             char countStr[16];
             snprintf(countStr, sizeof(countStr), "%d/%zu", currentFlightIndex + 1, flights.size());
-            d->setCursor(42, 2);
+            d->setCursor(right, oy + 2);
             d->setTextColor(matrix.color565(128, 128, 128));
             d->print(countStr);
         }
@@ -1,19 +1,22 @@
 #pragma once
 
 #include "base_screen.h"
+#include "ticker.h"
 
 class FlightScreen : public BaseScreen {
 public:
     void onEnter() override;
     void update(float dt) override;
     void render(LEDMatrix& matrix) override;
+    const char* name() const override { return "Flight"; }
 
 private:
-    float scrollOffset = 0.0f;      // Vertical scroll offset for flight list
-    float scrollSpeed = 10.0f;      // Pixels per second
     float updateTimer = 0.0f;       // Timer for updating display
+    float cycleTimer = 0.0f;        // Time on the current flight
+    float animTime = 0.0f;          // Drives the loading animation
     int currentFlightIndex = 0;     // Which flight we're showing (for cycling)
     bool showNoFlights = false;     // Whether to show "no flights" message
+    Ticker countryTicker;           // Scrolls origin country when it overflows its slot
 
     enum State {
         NO_WIFI,
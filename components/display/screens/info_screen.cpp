@@ -5,9 +5,20 @@
 #include <Fonts/TomThumb.h>
 #include "wifi_manager.h"
 
+void InfoScreen::onEnter()
+{
+    statusTicker.setFont(&TomThumb);
+    statusTicker.reset();
+}
+
+void InfoScreen::update(float dt)
+{
+    statusTicker.update(dt);
+}
+
 void InfoScreen::render(LEDMatrix& matrix)
 {
-    auto* d = matrix.raw();
+    auto* d = matrix.gfx();
 
     d->fillScreen(0);
 
@@ -20,7 +31,6 @@ void InfoScreen::render(LEDMatrix& matrix)
     uint16_t cyan  = matrix.color565(0, 255, 255);
     uint16_t white = matrix.color565(255, 255, 255);
     uint16_t green = matrix.color565(0, 255, 0);
-    uint16_t red   = matrix.color565(255, 0, 0);
 
     // ---- HEADER ----
     d->setCursor(0, 6);
@@ -43,29 +53,31 @@ void InfoScreen::render(LEDMatrix& matrix)
     WiFiManager& wm = WiFiManager::instance();
     WiFiState st = wm.getState();
 
-    d->setCursor(0, 30);
+    char statusStr[40];
 
     if (st == WiFiState::AP_MODE) {
-        d->setTextColor(cyan);
-        d->print("WiFi: AP Mode");
+        statusTicker.setColor(0, 255, 255);
+        snprintf(statusStr, sizeof(statusStr), "WiFi: AP Mode");
     }
     else if (st == WiFiState::CONNECTING) {
-        d->setTextColor(cyan);
-        d->print("WiFi: Connecting");
+        statusTicker.setColor(0, 255, 255);
+        snprintf(statusStr, sizeof(statusStr), "WiFi: Connecting");
     }
     else if (st == WiFiState::CONNECTED) {
-        d->setTextColor(green);
-        d->print("WiFi: OK ");
-
         // show IP next to it
-        d->print(wm.getIPAddress());
+        statusTicker.setColor(0, 255, 0);
+        snprintf(statusStr, sizeof(statusStr), "WiFi: OK %s", wm.getIPAddress());
     }
     else if (st == WiFiState::FAILED) {
-        d->setTextColor(red);
-        d->print("WiFi: Failed");
+        statusTicker.setColor(255, 0, 0);
+        snprintf(statusStr, sizeof(statusStr), "WiFi: Failed");
     }
     else { // DISCONNECTED
-        d->setTextColor(red);
-        d->print("WiFi: NoConn");
+        statusTicker.setColor(255, 0, 0);
+        snprintf(statusStr, sizeof(statusStr), "WiFi: NoConn");
     }
+
+    statusTicker.setViewport(0, 30, matrix.width());
+    statusTicker.setText(statusStr);
+    statusTicker.render(matrix);
 }
@@ -1,10 +1,15 @@
 #pragma once
 
 #include "base_screen.h"
+#include "ticker.h"
 
 class InfoScreen : public BaseScreen {
 public:
-    void onEnter() override {}
-    void update(float dt) override {}
+    void onEnter() override;
+    void update(float dt) override;
     void render(LEDMatrix& matrix) override;
+    const char* name() const override { return "Info"; }
+
+private:
+    Ticker statusTicker;    // WiFi line scrolls once the IP is appended
 };
@@ -0,0 +1,327 @@
+#include "radar_screen.h"
+#include "led_matrix.h"
+#include "app_config.h"
+#include "flight_api.h"
+#include "fixed_math.h"
+#include "color_lut.h"
+#include <Fonts/TomThumb.h>
+#include <algorithm>
+#include <array>
+
+static const int DIRECTIONS = 16;              // sprite rotations, 22.5 deg apart
+static const uint32_t MAX_DEAD_RECKON_MS = 90000;  // stop extrapolating stale fixes
+static const float MAX_ALTITUDE_HUE = 12000.0f;    // m at the top of the color ramp
+static const uint8_t ALTITUDE_HUE_RANGE = 180;     // red (ground) .. violet (cruise)
+
+static const Rgb888 HOME_COLOR = {255, 255, 255};
+static const uint16_t RING_COLOR = FrameBuffer::color565(0, 70, 30);
+
+// -----------------------------------------------------
+// Sprites: a nose-up shape rotated to every direction at compile time
+// -----------------------------------------------------
+namespace {
+
+struct Offset {
+    int8_t dx, dy;
+};
+
+// Nose up (y negative), centered on the aircraft's pixel
+constexpr Offset SMALL_SHAPE[] = {
+    {0, -1}, {0, 0}, {-1, 1}, {1, 1},
+};
+constexpr Offset LARGE_SHAPE[] = {
+    {0, -2}, {0, -1}, {0, 0}, {0, 1},
+    {-2, 0}, {-1, 0}, {1, 0}, {2, 0},
+    {-1, 2}, {0, 2}, {1, 2},
+};
+
+constexpr int8_t round_q14(int32_t v)
+{
+    return (int8_t)((v >= 0 ? v + 8192 : v - 8192) / 16384);
+}
+
+// Clockwise on screen (y down): x' = x cos - y sin, y' = x sin + y cos
+template <int N>
+constexpr std::array<std::array<Offset, N>, DIRECTIONS> rotate_all(const Offset (&shape)[N])
+{
+    std::array<std::array<Offset, N>, DIRECTIONS> out{};
+    for (int d = 0; d < DIRECTIONS; ++d) {
+        const uint8_t angle = (uint8_t)(d * 256 / DIRECTIONS);
+        const int32_t s = fix_sin(angle);
+        const int32_t c = fix_cos(angle);
+        for (int i = 0; i < N; ++i) {
+            out[d][i].dx = round_q14(shape[i].dx * c - shape[i].dy * s);
+            out[d][i].dy = round_q14(shape[i].dx * s + shape[i].dy * c);
+        }
+    }
+    return out;
+}
+
+constexpr auto SMALL_SPRITES = rotate_all(SMALL_SHAPE);
+constexpr auto LARGE_SPRITES = rotate_all(LARGE_SHAPE);
+
+inline void plot(uint8_t* pixels, int w, int h, int x, int y, Rgb888 c)
+{
+    if ((unsigned)x >= (unsigned)w || (unsigned)y >= (unsigned)h) return;
+    uint8_t* p = pixels + ((size_t)y * w + x) * 3;
+    p[0] = c.r;
+    p[1] = c.g;
+    p[2] = c.b;
+}
+
+}  // namespace
+
+// -----------------------------------------------------
+// Setup: zoom so the fetch bounding box fills the shorter panel side
+// -----------------------------------------------------
+void RadarScreen::configure(int w, int h)
+{
+    width = w;
+    height = h;
+    centerX = w / 2;
+    centerY = h / 2;
+    radius = std::min(w, h) / 2 - 1;
+
+    AppConfig& config = AppConfig::instance();
+    hasHome = config.hasLocation();
+
+    LocationConfig home = config.getLocation();
+    FlightConfig fc = config.getFlightConfig();
+
+    // Half the fetch box height (the box is centered on home)
+    float halfSpan = (fc.lat_max - fc.lat_min) / 2.0f;
+    if (halfSpan <= 0.0f || halfSpan > 10.0f) halfSpan = fc.bbox_size / 2.0f;
+    float rangeMeters = halfSpan * UDEG_PER_DEG * (float)LocalProjection::M_PER_UDEG_LAT;
+
+    projection.setOrigin(home.latitude, home.longitude, rangeMeters / (radius > 0 ? radius : 1));
+    background.invalidate();
+
+    // Trails are in pixels of the old projection
+    for (auto& t : tracks) {
+        t.trailCount = 0;
+        advance(t);
+    }
+}
+
+// Current position from the last fix, and a new trail point when it
+// has moved onto a different pixel
+void RadarScreen::advance(Track& t)
+{
+    uint32_t age = clockMs - t.fixMs;
+    if (age > MAX_DEAD_RECKON_MS) age = MAX_DEAD_RECKON_MS;
+
+    int32_t lat = t.lat + (int32_t)((int64_t)t.vlat * age / 1000);
+    int32_t lon = t.lon + (int32_t)((int64_t)t.vlon * age / 1000);
+
+    int32_t px, py;
+    projection.project(lat, lon, px, py);
+
+    // Off-panel aircraft are parked at a far-away sentinel
+    int x = centerX + fix_to_int(px);
+    int y = centerY + fix_to_int(py);
+    if (x < -1000 || x > 1000 || y < -1000 || y > 1000) x = y = -1000;
+    t.x = (int16_t)x;
+    t.y = (int16_t)y;
+    pushTrail(t, t.x, t.y);
+}
+
+void RadarScreen::pushTrail(Track& t, int16_t x, int16_t y)
+{
+    if (t.trailCount > 0 && t.trailX[t.trailHead] == x && t.trailY[t.trailHead] == y) return;
+
+    t.trailHead = (t.trailHead + 1) % TRAIL_LENGTH;
+    t.trailX[t.trailHead] = x;
+    t.trailY[t.trailHead] = y;
+    if (t.trailCount < TRAIL_LENGTH) t.trailCount++;
+}
+
+// -----------------------------------------------------
+// Merge a new fetch: update known aircraft, add new ones, drop the rest
+// -----------------------------------------------------
+void RadarScreen::syncFlights()
+{
+    const FlightAPI& api = FlightAPI::instance();
+    generation = api.getFetchGeneration();
+
+    for (auto& t : tracks)
+        t.seen = false;
+
+    const size_t known = tracks.size();
+    auto byId = [](const Track& t, uint32_t id) { return t.icao24 < id; };
+
+    for (const Flight& f : api.getFlights()) {
+        if (!f.valid || f.icao24 == 0) continue;
+
+        // Only the sorted prefix is searched; new tracks are appended after it
+        auto end = tracks.begin() + known;
+        auto it = std::lower_bound(tracks.begin(), end, f.icao24, byId);
+        Track* t;
+        if (it != end && it->icao24 == f.icao24) {
+            t = &*it;
+        } else {
+            if (tracks.size() >= (size_t)MAX_TRACKS) continue;
+            tracks.push_back(Track{});
+            t = &tracks.back();
+            t->icao24 = f.icao24;
+            t->trailHead = 0;
+            t->trailCount = 0;
+
+            // Aircraft new to the screen start with the trail of earlier fetches
+            FlightHistory::TrackView past;
+            if (api.getHistory().find(f.icao24, past)) {
+                for (const FlightHistory::Fix& fix : past) {
+                    int32_t px, py;
+                    projection.project(fix.lat * 100, fix.lon * 100, px, py);
+                    int x = centerX + fix_to_int(px);
+                    int y = centerY + fix_to_int(py);
+                    if (x < -1000 || x > 1000 || y < -1000 || y > 1000) continue;
+                    pushTrail(*t, (int16_t)x, (int16_t)y);
+                }
+            }
+        }
+
+        t->lat = udeg_from_deg(f.latitude);
+        t->lon = udeg_from_deg(f.longitude);
+        projection.velocity(f.velocity, f.heading, t->vlat, t->vlon);
+        t->fixMs = clockMs;
+        t->direction = (uint8_t)((int)(f.heading * DIRECTIONS / 360.0f + 0.5f) % DIRECTIONS);
+
+        float alt = f.altitude < 0.0f ? 0.0f : (f.altitude > MAX_ALTITUDE_HUE ? MAX_ALTITUDE_HUE : f.altitude);
+        t->hue = (uint8_t)(alt * ALTITUDE_HUE_RANGE / MAX_ALTITUDE_HUE);
+        t->seen = true;
+        advance(*t);
+    }
+
+    tracks.erase(std::remove_if(tracks.begin(), tracks.end(), [](const Track& t) { return !t.seen; }),
+                 tracks.end());
+    std::sort(tracks.begin(), tracks.end(), [](const Track& a, const Track& b) { return a.icao24 < b.icao24; });
+}
+
+// -----------------------------------------------------
+// Range rings live in the static layer
+// -----------------------------------------------------
+void RadarScreen::drawRings(FrameBuffer& target) const
+{
+    target.drawCircle(centerX, centerY, radius / 2, RING_COLOR);
+    target.drawCircle(centerX, centerY, radius, RING_COLOR);
+}
+
+// False when the layer could not be allocated
+bool RadarScreen::prepareBackground()
+{
+    if (!rangeRings || background.ready(width, height)) return true;
+
+    FrameBuffer* layer = background.redraw(width, height);
+    if (!layer) return false;
+    drawRings(*layer);
+    return true;
+}
+
+// ---------------- SCREEN CLASS ----------------
+void RadarScreen::onEnter()
+{
+    // Prepared ahead of time: projection, tracks and rings are ready
+    if (!prepared) {
+        width = 0;          // re-read home and range on the first render
+        generation = FlightAPI::instance().getFetchGeneration() - 1;
+    }
+    prepared = false;
+}
+
+void RadarScreen::prepare(LEDMatrix& matrix)
+{
+    FrameBuffer* fb = matrix.gfx();
+    configure(fb->width(), fb->height());
+    if (hasHome) {
+        syncFlights();
+        prepareBackground();
+    }
+    prepared = true;
+}
+
+// Tracks are rebuilt from the next fetch (trails seeded from history)
+void RadarScreen::release()
+{
+    background.release();
+    std::vector<Track>().swap(tracks);
+    width = 0;
+    prepared = false;
+}
+
+size_t RadarScreen::memoryBudget(int w, int h)
+{
+    return sizeof(RadarScreen) + MAX_TRACKS * sizeof(Track) + (size_t)w * h * 3;
+}
+
+void RadarScreen::update(float dt)
+{
+    if (width == 0) return;     // projection is set up on the first render
+    if (dt > 0.1f) dt = 0.1f;
+
+    clockMs += (uint32_t)(dt * 1000.0f + 0.5f);
+
+    if (FlightAPI::instance().getFetchGeneration() != generation)
+        syncFlights();
+
+    for (auto& t : tracks)
+        advance(t);
+}
+
+void RadarScreen::render(LEDMatrix& matrix)
+{
+    FrameBuffer* fb = matrix.gfx();
+    if (fb->width() != width || fb->height() != height) {
+        configure(fb->width(), fb->height());
+        if (tracks.empty() && hasHome) syncFlights();
+    }
+
+    if (!hasHome) {
+        fb->fillScreen(0);
+        fb->setFont(&TomThumb);
+        fb->setTextSize(1);
+        fb->setTextColor(matrix.color565(255, 165, 0));
+        fb->setCursor(centerX - 30, centerY);
+        fb->print("Configure");
+        fb->setCursor(centerX - 30, centerY + 8);
+        fb->print("location");
+        return;
+    }
+
+    // ---- RANGE RINGS (static layer) ----
+    bool layered = prepareBackground();
+    background.restore(*fb);
+    if (!layered)
+        drawRings(*fb);     // no memory for the layer: draw them every frame
+
+    uint8_t* pixels = fb->pixels();
+    const int w = width;
+    const int h = height;
+
+    // ---- TRAILS (behind every sprite, oldest dimmest) ----
+    for (const auto& t : tracks) {
+        const Rgb888 color = color_hue(t.hue);
+        int idx = t.trailHead;
+        for (int i = 0; i < t.trailCount; ++i) {
+            if (i > 0) {
+                uint8_t level = (uint8_t)(180 - i * 180 / TRAIL_LENGTH);
+                plot(pixels, w, h, t.trailX[idx], t.trailY[idx], color_fade(color, level));
+            }
+            idx = (idx + TRAIL_LENGTH - 1) % TRAIL_LENGTH;
+        }
+    }
+
+    plot(pixels, w, h, centerX, centerY, HOME_COLOR);
+
+    // ---- AIRCRAFT ----
+    const bool large = std::min(w, h) >= 64;
+    for (const auto& t : tracks) {
+        const Rgb888 color = color_hue(t.hue);
+        if (large) {
+            for (const Offset& o : LARGE_SPRITES[t.direction])
+                plot(pixels, w, h, t.x + o.dx, t.y + o.dy, color);
+        } else {
+            for (const Offset& o : SMALL_SPRITES[t.direction])
+                plot(pixels, w, h, t.x + o.dx, t.y + o.dy, color);
+        }
+    }
+}
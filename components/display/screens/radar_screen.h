@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include "base_screen.h"
+#include "compositor.h"
+#include "local_projection.h"
+
+// Plan view of every aircraft around home. Positions are dead-reckoned
+// between fetches from ground speed and track, projected with integer
+// math and drawn as heading-oriented sprites with fading trails.
+class RadarScreen : public BaseScreen {
+public:
+    explicit RadarScreen(bool rangeRings = true) : rangeRings(rangeRings) {}
+
+    void onEnter() override;
+    void prepare(LEDMatrix& matrix) override;
+    void release() override;
+    void update(float dt) override;
+    void render(LEDMatrix& matrix) override;
+    const char* name() const override { return "Radar"; }
+
+    size_t trackCount() const { return tracks.size(); }
+
+    // Heap taken at most on a panel of this size (full track table + ring layer)
+    static size_t memoryBudget(int width, int height);
+
+private:
+    static const int TRAIL_LENGTH = 8;
+    static const int MAX_TRACKS = 512;
+
+    struct Track {
+        uint32_t icao24;
+        int32_t lat, lon;           // microdegrees at the last fix
+        int32_t vlat, vlon;         // microdegrees per second
+        uint32_t fixMs;             // radar clock when the fix arrived
+        int16_t x, y;               // current pixel (may be off-panel)
+        int16_t trailX[TRAIL_LENGTH];   // ring of distinct pixels passed, newest at trailHead
+        int16_t trailY[TRAIL_LENGTH];
+        uint8_t trailHead;
+        uint8_t trailCount;
+        uint8_t direction;          // sprite rotation, 0 = north, clockwise
+        uint8_t hue;                // by altitude
+        bool seen;
+    };
+
+    void configure(int width, int height);
+    void syncFlights();
+    void advance(Track& t);
+    static void pushTrail(Track& t, int16_t x, int16_t y);
+    bool prepareBackground();
+    void drawRings(FrameBuffer& target) const;
+
+    int width = 0;
+    int height = 0;
+    int centerX = 0;
+    int centerY = 0;
+    int radius = 0;                 // px covered by the fetch range
+    bool rangeRings;
+    bool hasHome = false;
+    bool prepared = false;          // prepare() ran since the last onEnter()
+
+    uint32_t clockMs = 0;
+    uint32_t generation = 0;        // FlightAPI fetch last merged
+    LocalProjection projection;
+    StaticLayer background;         // range rings, redrawn only on reconfigure
+    std::vector<Track> tracks;      // sorted by icao24
+};
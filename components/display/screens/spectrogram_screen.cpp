@@ -0,0 +1,148 @@
+#include "spectrogram_screen.h"
+#include "led_matrix.h"
+#include "microphone.h"
+#include "audio_capture.h"
+#include "app_config.h"
+#include "color_lut.h"
+
+// 25 columns a second: 2.5 s across 64 columns, 5 s across 128
+static const float COLUMN_S = 0.04f;
+
+size_t SpectrogramScreen::memoryBudget(int width, int height)
+{
+    return sizeof(SpectrogramScreen) + (size_t)width * height * sizeof(uint16_t);
+}
+
+void SpectrogramScreen::configure(int w, int h)
+{
+    width = w;
+    height = h;
+    history.assign((size_t)w * h, color_heat565(0));
+    head = w - 1;
+    columnTime = 0.0f;
+    bandCount = 0;
+    fresh = false;
+}
+
+// -----------------------------------------------------
+// Lifecycle: the microphone runs while the waterfall can be seen
+// -----------------------------------------------------
+void SpectrogramScreen::onEnter()
+{
+    AudioConfig ac = AppConfig::instance().getAudioConfig();
+    AudioCapture::instance().setAnalysis(ac.window, ac.hop());
+    AudioCapture::instance().setPipeline(AudioCapture::pipelineSetting(ac.pipeline));
+    AudioCapture::instance().setGate(ac.gate);
+    if (!micHeld) mic_acquire();
+    micHeld = true;
+}
+
+// Size the history before the switch; the microphone waits for onEnter()
+void SpectrogramScreen::prepare(LEDMatrix& matrix)
+{
+    FrameBuffer* fb = matrix.gfx();
+    if (fb->width() != width || fb->height() != height)
+        configure(fb->width(), fb->height());
+}
+
+void SpectrogramScreen::onExit()
+{
+    dropMic();
+}
+
+// Only our own reference: the screen showing may be using the microphone
+void SpectrogramScreen::release()
+{
+    dropMic();
+    std::vector<uint16_t>().swap(history);
+    width = height = 0;         // configure() again on the next prepare or render
+}
+
+void SpectrogramScreen::dropMic()
+{
+    if (micHeld) mic_release();
+    micHeld = false;
+}
+
+// -----------------------------------------------------
+// History
+// -----------------------------------------------------
+// The newest spectrum into the next column: the first one since the last
+// column replaces the levels, later ones keep the loudest per band so
+// short hits survive. Without a new one the column repeats the last.
+void SpectrogramScreen::takeSpectrum()
+{
+    AudioCapture& capture = AudioCapture::instance();
+    capture.setBands(height);
+    if (!capture.taskRunning()) capture.capture();
+
+    const AudioSpectrum* spectrum = capture.latest();
+    if (!spectrum || spectrum->seq == lastSeq) return;
+    lastSeq = spectrum->seq;
+
+    const int bands = spectrum->count;
+    if (!fresh || bands != bandCount) {
+        for (int b = 0; b < bands; ++b) levels[b] = spectrum->bands[b];
+    } else {
+        for (int b = 0; b < bands; ++b)
+            if (spectrum->bands[b] > levels[b]) levels[b] = spectrum->bands[b];
+    }
+    bandCount = bands;
+    fresh = true;
+}
+
+// Overwrites the oldest column, which becomes the newest
+void SpectrogramScreen::pushColumn()
+{
+    head = head + 1 < width ? head + 1 : 0;
+    uint16_t* px = history.data() + head;
+    for (int y = 0; y < height; ++y, px += width) {
+        if (bandCount == 0) {
+            *px = color_heat565(0);
+            continue;
+        }
+        const int band = (height - 1 - y) * bandCount / height;
+        float v = levels[band];
+        v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+        *px = color_heat565((uint8_t)(v * 255.0f));
+    }
+    fresh = false;
+}
+
+void SpectrogramScreen::update(float dt)
+{
+    if (history.empty()) return;     // sized on the first render
+
+    takeSpectrum();
+
+    // After a stall, at most one screen's worth of columns
+    columnTime += dt;
+    if (columnTime > COLUMN_S * width) columnTime = COLUMN_S * width;
+    while (columnTime >= COLUMN_S) {
+        columnTime -= COLUMN_S;
+        pushColumn();
+    }
+}
+
+static uint8_t* copy565(uint8_t* out, const uint16_t* src, int count)
+{
+    for (int i = 0; i < count; ++i, out += 3) FrameBuffer::unpack565(src[i], out[0], out[1], out[2]);
+    return out;
+}
+
+// Oldest column on the left: the columns after the head, then up to it
+void SpectrogramScreen::render(LEDMatrix& matrix)
+{
+    FrameBuffer* fb = matrix.gfx();
+    if (fb->width() != width || fb->height() != height)
+        configure(fb->width(), fb->height());
+    if (!fb->valid()) return;
+
+    const int older = width - 1 - head;
+    uint8_t* out = fb->pixels();
+    for (int y = 0; y < height; ++y) {
+        const uint16_t* row = history.data() + (size_t)y * width;
+        out = copy565(out, row + head + 1, older);
+        out = copy565(out, row, head + 1);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include "base_screen.h"
+#include "spectrum_bands.h"
+
+// Frequency against time as a scrolling waterfall: low frequencies at the
+// bottom, the newest moment in the right-hand column. Bands come from the
+// microphone's analysis (one per row), loudest-of since the last column.
+//
+// The history is a circular buffer of RGB565 pixels, one column per
+// COLUMN_S: scrolling writes the new column over the oldest and moves the
+// write position, so nothing is shifted. render() copies it out in two
+// straight runs per row either side of the wrap, colors already looked up
+// in the heat palette.
+class SpectrogramScreen : public BaseScreen {
+public:
+    void onEnter() override;
+    void onExit() override;
+    void prepare(LEDMatrix& matrix) override;
+    void release() override;
+    void update(float dt) override;
+    void render(LEDMatrix& matrix) override;
+    const char* name() const override { return "Spectrogram"; }
+
+    // Heap taken on a panel of this size (the history), microphone aside
+    static size_t memoryBudget(int width, int height);
+
+private:
+    void configure(int width, int height);
+    void takeSpectrum();
+    void pushColumn();
+    void dropMic();
+
+    int width = 0;
+    int height = 0;
+    std::vector<uint16_t> history;  // height rows of width pixels; column `head` is the newest
+    int head = 0;
+    float columnTime = 0.0f;        // since the last column
+
+    float levels[SpectrumBands::MAX_BANDS];     // next column's bands, 0..1
+    int bandCount = 0;
+    bool fresh = false;             // levels hold a spectrum since the last column
+    uint32_t lastSeq = 0;
+    bool micHeld = false;           // we hold a reference to the microphone
+};
@@ -1,13 +1,100 @@
 #include "spectrum_screen.h"
 #include "led_matrix.h"
 #include "microphone.h"   // NEW: our microphone/FFT module
+#include "audio_capture.h"
+#include "app_config.h"
+
+// Idle animation frames per second in silence; the frames in between
+// leave the frame buffer alone, so show() finds no pixels to send
+static const float IDLE_FPS = 4.0f;
 
 void SpectrumScreen::onEnter()
 {
-    mic_start();   // initialise I2S mic (implemented below)
+    idleS = -1.0f;
+    redraw = true;
+    applyAudioConfig();
+    holdMic();
+}
+
+// Settings only: the capture task opens the channel on its own core, so
+// entering waits for nothing, and a screen that is merely predicted next
+// must not keep the microphone running
+void SpectrumScreen::prepare(LEDMatrix&)
+{
+    applyAudioConfig();
+}
+
+// The microphone only runs while the spectrum can be seen
+void SpectrumScreen::onExit()
+{
+    dropMic();
+}
+
+// Released in the background: give back our reference, if we still hold
+// one; the screen showing may be using the microphone
+void SpectrumScreen::release()
+{
+    dropMic();
+}
+
+// The compositor mixed the outgoing screen into our frames
+void SpectrumScreen::onTransitionEnd()
+{
+    redraw = true;
+}
+
+// Window, overlap, pipeline and gate from the settings page take effect on the next hop
+void SpectrumScreen::update(float dt)
+{
+    frameDt = dt;
+    if (idleS >= 0.0f) idleS += dt;
+    applyAudioConfig();
 }
 
 void SpectrumScreen::render(LEDMatrix& matrix)
 {
-    draw_fft_visual(matrix);   // uses your exact FFT function
+    if (draw_fft_visual(matrix, frameDt)) {
+        idleS = -1.0f;
+        return;
+    }
+
+    // Silence gated by the capture, the bars down: idle at IDLE_FPS
+    if (idleS < 0.0f) {
+        idleS = 0.0f;
+        redraw = true;
+    }
+    if (!redraw && idleS - idleDrawnS < 1.0f / IDLE_FPS) return;
+    draw_idle_visual(matrix, idleS);
+    idleDrawnS = idleS;
+    redraw = false;
+}
+
+// One reference per screen, however often it is prepared and entered
+void SpectrumScreen::holdMic()
+{
+    if (micHeld) return;
+    mic_acquire();
+    micHeld = true;
+}
+
+void SpectrumScreen::dropMic()
+{
+    if (!micHeld) return;
+    mic_release();
+    micHeld = false;
+}
+
+void SpectrumScreen::applyAudioConfig()
+{
+    AudioConfig ac = AppConfig::instance().getAudioConfig();
+    if (ac.window == audioWindow && ac.overlap_pct == audioOverlap && ac.pipeline == audioPipeline &&
+        ac.gate == audioGate)
+        return;
+    AudioCapture::instance().setAnalysis(ac.window, ac.hop());
+    AudioCapture::instance().setPipeline(AudioCapture::pipelineSetting(ac.pipeline));
+    AudioCapture::instance().setGate(ac.gate);
+    audioWindow = ac.window;
+    audioOverlap = ac.overlap_pct;
+    audioPipeline = ac.pipeline;
+    audioGate = ac.gate;
 }
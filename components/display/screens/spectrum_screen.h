@@ -5,6 +5,26 @@
 class SpectrumScreen : public BaseScreen {
 public:
     void onEnter() override;
-    void update(float dt) override {}
+    void onExit() override;
+    void prepare(LEDMatrix& matrix) override;
+    void release() override;
+    void onTransitionEnd() override;
+    void update(float dt) override;
     void render(LEDMatrix& matrix) override;
+    const char* name() const override { return "Spectrum"; }
+
+private:
+    void applyAudioConfig();
+    void holdMic();
+    void dropMic();
+
+    float frameDt = 1.0f / 60.0f;
+    float idleS = -1.0f;            // time in the idle animation, < 0 = showing bars
+    float idleDrawnS = 0.0f;        // ... when its frame was last drawn
+    bool redraw = true;             // the frame buffer no longer holds our last frame
+    bool micHeld = false;           // we hold a reference to the microphone
+    uint16_t audioWindow = 0;       // AudioConfig last handed to the capture
+    uint8_t audioOverlap = 0;
+    uint8_t audioPipeline = 0xff;
+    uint8_t audioGate = 0xff;
 };
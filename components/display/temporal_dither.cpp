@@ -0,0 +1,35 @@
+#include "temporal_dither.h"
+#include <stdlib.h>
+
+TemporalDither::~TemporalDither()
+{
+    release();
+}
+
+bool TemporalDither::configure(int pixels, int depth, bool dither)
+{
+    release();
+
+    if (depth < MIN_DEPTH) depth = MIN_DEPTH;
+    if (depth > MAX_DEPTH) depth = MAX_DEPTH;
+
+    _depth = depth;
+    _outShift = 8 - depth;
+
+    // Full input maps exactly onto the top level, so x >> 8 never overflows
+    const uint32_t maxLevel = (1u << depth) - 1;
+    for (int v = 0; v < 256; ++v)
+        _target[v] = (uint16_t)((COLOR_GAMMA12[v] * maxLevel * 256u + 2047) / 4095);
+
+    if (!dither) return true;
+
+    // Zeroed so the first frame matches plain truncation
+    _error = (uint8_t*)calloc((size_t)pixels * 3, 1);
+    return _error != nullptr;
+}
+
+void TemporalDither::release()
+{
+    free(_error);
+    _error = nullptr;
+}
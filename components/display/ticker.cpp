@@ -0,0 +1,179 @@
+#include "ticker.h"
+#include <string.h>
+
+Ticker::~Ticker()
+{
+    delete _strip;
+}
+
+// -----------------------------------------------------
+// Configuration
+// -----------------------------------------------------
+void Ticker::setViewport(int x, int baselineY, int width)
+{
+    _x = x;
+    _baseline = baselineY;
+    _width = width;
+}
+
+void Ticker::setFont(const GFXfont* font, uint8_t size)
+{
+    if (font == _font && size == _size) return;
+
+    _font = font;
+    _size = size;
+    rebuild();
+}
+
+void Ticker::setColor(uint8_t r, uint8_t g, uint8_t b)
+{
+    _r = r;
+    _g = g;
+    _b = b;
+}
+
+void Ticker::setGap(int pixels)
+{
+    if (pixels == _gap) return;
+
+    _gap = pixels;
+    rebuild();
+}
+
+void Ticker::setText(const char* text)
+{
+    if (text == nullptr) text = "";
+    if (strncmp(text, _text, sizeof(_text) - 1) == 0) return;
+
+    strncpy(_text, text, sizeof(_text) - 1);
+    _text[sizeof(_text) - 1] = '\0';
+
+    rebuild();
+    reset();
+}
+
+void Ticker::reset()
+{
+    _offset = 0;
+    _remainder = 0.0f;
+    _dwell = 0.0f;
+}
+
+// -----------------------------------------------------
+// Rasterize the text once into the coverage strip
+// -----------------------------------------------------
+void Ticker::rebuild()
+{
+    delete _strip;
+    _strip = nullptr;
+    _textWidth = 0;
+
+    if (_text[0] == '\0') return;
+
+    // Measure with a throwaway 1x1 canvas so the font metrics match print()
+    int16_t x1 = 0, y1 = 0;
+    uint16_t w = 0, h = 0;
+    GFXcanvas8 probe(1, 1);
+    probe.setFont(_font);
+    probe.setTextSize(_size);
+    probe.setTextWrap(false);
+    probe.getTextBounds(_text, 0, 0, &x1, &y1, &w, &h);
+
+    _textWidth = x1 + w;
+    _top = y1;
+    if (_textWidth <= 0 || h == 0) return;
+
+    // The gap is part of the strip so wrapping the offset wraps the text
+    int stripWidth = _textWidth + _gap;
+    _strip = new GFXcanvas8(stripWidth, h);
+    if (_strip->getBuffer() == nullptr) {
+        delete _strip;
+        _strip = nullptr;
+        return;
+    }
+
+    _strip->fillScreen(0);
+    _strip->setFont(_font);
+    _strip->setTextSize(_size);
+    _strip->setTextWrap(false);
+    _strip->setTextColor(255);
+    _strip->setCursor(0, -y1);
+    _strip->print(_text);
+}
+
+// -----------------------------------------------------
+// Advance scroll position
+// -----------------------------------------------------
+void Ticker::update(float dt)
+{
+    if (!_strip || !isScrolling()) return;
+
+    if (_dwell > 0.0f) {
+        _dwell -= dt;
+        return;
+    }
+
+    // Keep the sub-step remainder so slow speeds at high frame rates still move
+    float step = dt * _speed * 256.0f + _remainder;
+    uint32_t whole = (uint32_t)step;
+    _remainder = step - (float)whole;
+
+    uint32_t loop = (uint32_t)_strip->width() << 8;
+    _offset += whole;
+    if (_offset >= loop) {
+        _offset %= loop;
+        if (_pause > 0.0f) {
+            _offset = 0;
+            _remainder = 0.0f;
+            _dwell = _pause;
+        }
+    }
+}
+
+// -----------------------------------------------------
+// Sample the strip at the fractional offset
+// -----------------------------------------------------
+void Ticker::render(LEDMatrix& matrix) const
+{
+    if (!_strip) return;
+
+    const uint8_t* px = _strip->getBuffer();
+    const int sw = _strip->width();
+    const int sh = _strip->height();
+    const int top = _baseline + _top;
+
+    if (!isScrolling()) {
+        int cols = (_textWidth < _width) ? _textWidth : _width;
+        for (int row = 0; row < sh; ++row) {
+            const uint8_t* line = px + row * sw;
+            for (int cx = 0; cx < cols; ++cx) {
+                uint32_t v = line[cx];
+                if (v == 0) continue;
+                v += 1;   // full coverage maps back to full color
+                matrix.drawPixelRGB(_x + cx, top + row,
+                                    (_r * v) >> 8, (_g * v) >> 8, (_b * v) >> 8);
+            }
+        }
+        return;
+    }
+
+    // Blend column a (weight 256 - frac) with column a + 1 (weight frac)
+    const uint32_t frac = _offset & 0xFF;
+    const uint32_t inv = 256 - frac;
+    int a = (int)(_offset >> 8) % sw;
+
+    for (int cx = 0; cx < _width; ++cx) {
+        int b = (a + 1 == sw) ? 0 : a + 1;
+
+        for (int row = 0; row < sh; ++row) {
+            const uint8_t* line = px + row * sw;
+            uint32_t v = (line[a] * inv + line[b] * frac) >> 8;
+            if (v == 0) continue;
+            v += 1;
+            matrix.drawPixelRGB(_x + cx, top + row,
+                                (_r * v) >> 8, (_g * v) >> 8, (_b * v) >> 8);
+        }
+
+        a = b;
+    }
+}
@@ -5,6 +5,7 @@
 #include <esp_log.h>
 #include <esp_crt_bundle.h>
 #include <cJSON.h>
+#include <stdlib.h>
 #include <string.h>
 #include <esp_timer.h>
 
@@ -215,6 +216,8 @@ bool FlightAPI::fetchFlights(float lat_min, float lat_max, float lon_min, float
 
     // Clear previous flights
     flights.clear();
+    fetchGeneration++;
+    history.beginPoll();
 
     // Get the "states" array
     cJSON *states = cJSON_GetObjectItem(root, "states");
@@ -255,6 +258,12 @@ bool FlightAPI::fetchFlights(float lat_min, float lat_max, float lon_min, float
 
         Flight flight;
 
+        // Index 0: icao24 (hex string)
+        cJSON *icao24 = cJSON_GetArrayItem(state, 0);
+        if (icao24 && cJSON_IsString(icao24) && icao24->valuestring) {
+            flight.icao24 = (uint32_t)strtoul(icao24->valuestring, nullptr, 16) & 0xFFFFFF;
+        }
+
         // Index 1: callsign
         cJSON *callsign = cJSON_GetArrayItem(state, 1);
         if (callsign && cJSON_IsString(callsign) && callsign->valuestring) {
@@ -322,12 +331,14 @@ bool FlightAPI::fetchFlights(float lat_min, float lat_max, float lon_min, float
 
         flight.valid = true;
         flights.push_back(flight);
+        history.record(flight);
         count++;
     }
 
     cJSON_Delete(root);
 
-    ESP_LOGI(TAG, "Successfully fetched %d flights", count);
+    ESP_LOGI(TAG, "Successfully fetched %d flights (%d tracked, %u evicted)",
+             count, history.trackCount(), (unsigned)history.evictions());
     return true;
 }
 
@@ -339,6 +350,14 @@ size_t FlightAPI::getFlightCount() const {
     return flights.size();
 }
 
+uint32_t FlightAPI::getFetchGeneration() const {
+    return fetchGeneration;
+}
+
+const FlightHistory& FlightAPI::getHistory() const {
+    return history;
+}
+
 bool FlightAPI::validateStoredCredentials() {
     OpenSkyAuthConfig auth = AppConfig::instance().getOpenSkyAuth();
 
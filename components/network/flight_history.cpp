@@ -0,0 +1,211 @@
+#include "flight_history.h"
+#include "flight_api.h"
+#include <math.h>
+#include <string.h>
+
+static const int32_t UNITS_PER_DEG = 10000;     // 1e-4 deg per unit
+static const float M_PER_UNIT_LAT = 11.1133f;
+static const float M_PER_UNIT_LON = 11.1319f;   // at the equator, * cos(lat)
+
+static bool fits_int16(int32_t v)
+{
+    return v >= INT16_MIN && v <= INT16_MAX;
+}
+
+// -----------------------------------------------------
+// Iteration: start from the oldest fix, add one step per increment
+// -----------------------------------------------------
+FlightHistory::Iterator::Iterator(const Track* t, int i) : track(t), index(i)
+{
+    if (track && track->count > 0) cur = track->first;
+    else cur = Fix{0, 0, 0, 0};
+}
+
+FlightHistory::Iterator& FlightHistory::Iterator::operator++()
+{
+    if (++index < track->count) {
+        const Delta& d = FlightHistory::step(*track, index - 1);
+        cur.lat += d.dlat;
+        cur.lon += d.dlon;
+        cur.alt = (int16_t)(cur.alt + d.dalt);
+        cur.time += d.dt;
+    }
+    return *this;
+}
+
+uint32_t FlightHistory::TrackView::icao24() const { return track ? track->icao24 : 0; }
+int FlightHistory::TrackView::size() const { return track ? track->count : 0; }
+const FlightHistory::Fix& FlightHistory::TrackView::oldest() const { return track->first; }
+const FlightHistory::Fix& FlightHistory::TrackView::newest() const { return track->last; }
+
+// -----------------------------------------------------
+// Arena
+// -----------------------------------------------------
+FlightHistory::FlightHistory()
+{
+    clear();
+}
+
+void FlightHistory::clear()
+{
+    memset(tracks, 0, sizeof(tracks));
+    poll = 0;
+    evicted = 0;
+}
+
+void FlightHistory::beginPoll()
+{
+    poll++;
+}
+
+int FlightHistory::trackCount() const
+{
+    int n = 0;
+    for (const Track& t : tracks)
+        if (t.icao24 != 0) n++;
+    return n;
+}
+
+const FlightHistory::Track* FlightHistory::lookup(uint32_t icao24) const
+{
+    for (const Track& t : tracks)
+        if (t.icao24 == icao24) return &t;
+    return nullptr;
+}
+
+// Existing track, else a free slot, else the least recently updated
+// track from an earlier poll
+FlightHistory::Track* FlightHistory::slotFor(uint32_t icao24)
+{
+    Track* free = nullptr;
+    Track* oldest = nullptr;
+
+    for (Track& t : tracks) {
+        if (t.icao24 == icao24) return &t;
+        if (t.icao24 == 0) {
+            if (!free) free = &t;
+        } else if (t.lastPoll != poll && (!oldest || t.lastPoll < oldest->lastPoll)) {
+            oldest = &t;
+        }
+    }
+
+    Track* slot = free;
+    if (!slot && oldest) {
+        slot = oldest;
+        evicted++;
+    }
+    if (!slot) return nullptr;
+
+    memset(slot, 0, sizeof(*slot));
+    slot->icao24 = icao24;
+    return slot;
+}
+
+bool FlightHistory::record(const Flight& flight)
+{
+    if (!flight.valid || flight.icao24 == 0) return false;
+    return record(flight.icao24, flight.latitude, flight.longitude, flight.altitude,
+                  (uint32_t)flight.lastContact);
+}
+
+bool FlightHistory::record(uint32_t icao24, float lat, float lon, float alt, uint32_t time)
+{
+    if (icao24 == 0) return false;
+
+    Fix fix;
+    fix.lat = (int32_t)lroundf(lat * UNITS_PER_DEG);
+    fix.lon = (int32_t)lroundf(lon * UNITS_PER_DEG);
+    fix.alt = (int16_t)(alt < INT16_MIN ? INT16_MIN : (alt > INT16_MAX ? INT16_MAX : lroundf(alt)));
+    fix.time = time;
+
+    Track* t = slotFor(icao24);
+    if (!t) return false;
+    t->lastPoll = poll;
+
+    if (t->count == 0) {
+        t->first = t->last = fix;
+        t->count = 1;
+        return true;
+    }
+
+    // Same report seen again (no new contact since the last fetch)
+    if (fix.time <= t->last.time) return false;
+
+    int32_t dlat = fix.lat - t->last.lat;
+    int32_t dlon = fix.lon - t->last.lon;
+    int32_t dalt = fix.alt - t->last.alt;
+    uint32_t dt = fix.time - t->last.time;
+
+    // A gap too long for the deltas (lost contact, antimeridian): restart
+    if (!fits_int16(dlat) || !fits_int16(dlon) || !fits_int16(dalt) || dt > UINT16_MAX) {
+        t->first = t->last = fix;
+        t->head = 0;
+        t->count = 1;
+        return true;
+    }
+
+    // Ring full: fold the oldest step into `first`
+    if (t->count == MAX_FIXES) {
+        const Delta& d = t->steps[t->head];
+        t->first.lat += d.dlat;
+        t->first.lon += d.dlon;
+        t->first.alt = (int16_t)(t->first.alt + d.dalt);
+        t->first.time += d.dt;
+        t->head = (t->head + 1) % (MAX_FIXES - 1);
+        t->count--;
+    }
+
+    Delta& d = t->steps[(t->head + t->count - 1) % (MAX_FIXES - 1)];
+    d.dlat = (int16_t)dlat;
+    d.dlon = (int16_t)dlon;
+    d.dalt = (int16_t)dalt;
+    d.dt = (uint16_t)dt;
+
+    t->last = fix;
+    t->count++;
+    return true;
+}
+
+bool FlightHistory::find(uint32_t icao24, TrackView& out) const
+{
+    const Track* t = icao24 ? lookup(icao24) : nullptr;
+    if (!t || t->count == 0) return false;
+    out = TrackView(t);
+    return true;
+}
+
+// -----------------------------------------------------
+// Trends from the newest steps
+// -----------------------------------------------------
+FlightHistory::Trend FlightHistory::trend(uint32_t icao24) const
+{
+    Trend trend = {0.0f, 0.0f, 0.0f, false};
+    const Track* t = icao24 ? lookup(icao24) : nullptr;
+    if (!t || t->count < 2) return trend;
+
+    const float cosLat = cosf(t->last.lat / (float)UNITS_PER_DEG * (float)M_PI / 180.0f);
+
+    auto bearing = [&](const Delta& d) {
+        float east = d.dlon * M_PER_UNIT_LON * cosLat;
+        float north = d.dlat * M_PER_UNIT_LAT;
+        return atan2f(east, north) * 180.0f / (float)M_PI;
+    };
+
+    const Delta& now = step(*t, t->count - 2);
+    float east = now.dlon * M_PER_UNIT_LON * cosLat;
+    float north = now.dlat * M_PER_UNIT_LAT;
+
+    trend.climbRate = (float)now.dalt / now.dt;
+    trend.groundSpeed = sqrtf(east * east + north * north) / now.dt;
+    trend.valid = true;
+
+    if (t->count >= 3) {
+        const Delta& before = step(*t, t->count - 3);
+        float turn = bearing(now) - bearing(before);
+        if (turn > 180.0f) turn -= 360.0f;
+        if (turn < -180.0f) turn += 360.0f;
+        // Heading change between the midpoints of the two steps
+        trend.turnRate = turn / ((now.dt + before.dt) / 2.0f);
+    }
+    return trend;
+}
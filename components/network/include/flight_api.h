@@ -3,9 +3,11 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include "flight_history.h"
 
 // Structure to hold flight data
 struct Flight {
+    uint32_t icao24;             // 24-bit ICAO transponder address, unique per airframe
     char callsign[16];           // Aircraft callsign
     float latitude;              // Current latitude
     float longitude;             // Current longitude
@@ -18,7 +20,7 @@ struct Flight {
     char country[32];            // Aircraft origin country
     bool valid;                  // Whether this flight data is valid
 
-    Flight() : latitude(0), longitude(0), altitude(0), velocity(0),
+    Flight() : icao24(0), latitude(0), longitude(0), altitude(0), velocity(0),
                heading(0), lastContact(0), valid(false) {
         callsign[0] = '\0';
         departureAirport[0] = '\0';
@@ -48,6 +50,13 @@ public:
     // Get the number of flights from last fetch
     size_t getFlightCount() const;
 
+    // Incremented whenever the flight list is replaced; screens compare it
+    // with the value they last saw to pick up new positions
+    uint32_t getFetchGeneration() const;
+
+    // Recent positions per aircraft, accumulated over fetches
+    const FlightHistory& getHistory() const;
+
     // Check if we're ready to fetch (respects rate limiting)
     bool canFetch() const;
 
@@ -64,6 +73,8 @@ private:
     FlightAPI& operator=(const FlightAPI&) = delete;
 
     std::vector<Flight> flights;
+    uint32_t fetchGeneration = 0;
+    FlightHistory history;
     int64_t lastFetchTime = -999999999;  // Initialize to far past to allow first fetch immediately
     static constexpr int MIN_FETCH_INTERVAL_AUTHENTICATED = 30000;  // 30 seconds (safe for authenticated users: ~2,880 requests/day)
     static constexpr int MIN_FETCH_INTERVAL_UNAUTHENTICATED = 300000;  // 5 minutes (safe for unauthenticated users)
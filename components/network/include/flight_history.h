@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Flight;
+
+// Recent positions of each aircraft, kept across fetches.
+//
+// Tracks live in a fixed arena of MAX_TRACKS slots keyed by ICAO24. Each
+// track holds its oldest and newest fix in full and the steps between
+// them as int16 deltas (1e-4 deg, m, s), so a busy sky costs a few KB.
+// When every slot is taken, the track updated longest ago is evicted;
+// tracks already updated in the current poll are never evicted.
+class FlightHistory {
+    struct Track;
+
+public:
+    static const int MAX_TRACKS = 48;
+    static const int MAX_FIXES = 8;         // per track, oldest dropped first
+
+    struct Fix {
+        int32_t lat;        // 1e-4 deg (~11 m)
+        int32_t lon;
+        uint32_t time;      // unix seconds (last contact)
+        int16_t alt;        // m
+    };
+
+    // Iterates a track oldest to newest, decoding the deltas in place
+    class Iterator {
+    public:
+        const Fix& operator*() const { return cur; }
+        const Fix* operator->() const { return &cur; }
+        Iterator& operator++();
+        bool operator!=(const Iterator& o) const { return index != o.index; }
+
+    private:
+        friend class FlightHistory;
+        Iterator(const Track* track, int index);
+
+        const Track* track;
+        int index;
+        Fix cur;
+    };
+
+    // Read-only view of one track; valid until the next record()
+    class TrackView {
+    public:
+        TrackView() = default;
+        uint32_t icao24() const;
+        int size() const;
+        const Fix& oldest() const;
+        const Fix& newest() const;
+        Iterator begin() const { return Iterator(track, 0); }
+        Iterator end() const { return Iterator(track, size()); }
+
+    private:
+        friend class FlightHistory;
+        explicit TrackView(const Track* t) : track(t) {}
+
+        const Track* track = nullptr;
+    };
+
+    // Rates over the newest step (and the one before it, for turning)
+    struct Trend {
+        float climbRate;    // m/s, positive = climbing
+        float groundSpeed;  // m/s
+        float turnRate;     // deg/s, positive = turning right
+        bool valid;         // false until the track has two fixes (three for turnRate)
+    };
+
+    FlightHistory();
+
+    // Call once per fetch, before recording its flights
+    void beginPoll();
+
+    // Append a fix; returns false when it was dropped (no usable position,
+    // nothing new, or no slot that may be evicted this poll)
+    bool record(const Flight& flight);
+    bool record(uint32_t icao24, float lat, float lon, float alt, uint32_t time);
+
+    // False when the aircraft has no history
+    bool find(uint32_t icao24, TrackView& out) const;
+    Trend trend(uint32_t icao24) const;
+
+    void clear();
+    int trackCount() const;
+    uint32_t evictions() const { return evicted; }
+    static constexpr size_t arenaBytes();
+
+private:
+    struct Delta {
+        int16_t dlat, dlon, dalt;
+        uint16_t dt;
+    };
+
+    struct Track {
+        uint32_t icao24;        // 0 = free slot
+        uint32_t lastPoll;      // LRU stamp
+        Fix first;              // oldest fix held
+        Fix last;               // newest fix
+        Delta steps[MAX_FIXES - 1];     // ring: fix i+1 minus fix i
+        uint8_t head;           // ring index of the step after `first`
+        uint8_t count;          // fixes held, 0..MAX_FIXES
+    };
+
+    Track* slotFor(uint32_t icao24);
+    const Track* lookup(uint32_t icao24) const;
+    static const Delta& step(const Track& t, int i) { return t.steps[(t.head + i) % (MAX_FIXES - 1)]; }
+
+    Track tracks[MAX_TRACKS];
+    uint32_t poll = 0;
+    uint32_t evicted = 0;
+};
+
+constexpr size_t FlightHistory::arenaBytes()
+{
+    return sizeof(Track) * MAX_TRACKS;
+}
@@ -0,0 +1,71 @@
+#include "activity_detector.h"
+#include <math.h>
+
+static const float SILENCE_DB = -120.0f;    // digital silence reads this
+
+// -----------------------------------------------------
+// Setup
+// -----------------------------------------------------
+void ActivityDetector::configure(int hop, int sampleRate)
+{
+    _dt = (float)hop / sampleRate;
+    _alpha = 1.0f - expf(-_dt / floorAverageS);
+    reset();
+}
+
+void ActivityDetector::reset()
+{
+    _hold = holdS;
+    _last = 0;
+    _meanSq = -1.0;
+    _level = AudioLevel();
+    _level.floorDb = 0.0f;      // the first hop sets it
+    _level.active = true;
+}
+
+// -----------------------------------------------------
+// One hop
+// -----------------------------------------------------
+const AudioLevel& ActivityDetector::process(const int32_t* samples, int count)
+{
+    if (count <= 0) return _level;
+
+    int64_t sumSq = 0;
+    int32_t peak = 0;
+    int crossings = 0;
+    int32_t prev = _last;
+    for (int i = 0; i < count; ++i) {
+        const int32_t s = samples[i];
+        sumSq += (int64_t)s * s;
+        const int32_t a = s < 0 ? -s : s;
+        if (a > peak) peak = a;
+        crossings += (s ^ prev) < 0;
+        prev = s;
+    }
+    _last = prev;
+
+    // A full-scale sine's mean square is fullScale^2 / 2
+    const double meanSq = (double)sumSq / count;
+    const double ref = 0.5 * (double)fullScale * fullScale;
+    auto toDb = [ref](double ms) { return ms > 0.0 ? fmaxf(10.0f * (float)log10(ms / ref), SILENCE_DB) : SILENCE_DB; };
+    const float rmsDb = toDb(meanSq);
+    _meanSq = _meanSq < 0.0 ? meanSq : _meanSq + _alpha * (meanSq - _meanSq);
+    const float averageDb = toDb(_meanSq);
+    const float peakDb = peak > 0 ? fmaxf(20.0f * log10f((float)peak / fullScale), SILENCE_DB) : SILENCE_DB;
+    const float zcr = (float)crossings / count;
+
+    const float floorDb = _level.floorDb;
+    const bool hiss = zcr > hissZcr && rmsDb < floorDb + hissDb;
+    const bool sound = rmsDb > floorDb + onDb && rmsDb > minDb && !hiss;
+    _hold = sound ? holdS : _hold - _dt;
+
+    _level.rmsDb = rmsDb;
+    _level.peakDb = fmaxf(peakDb, _level.peakDb - peakFallDbS * _dt);
+    _level.zcr = zcr;
+    _level.active = _hold > 0.0f;
+
+    // Down at once, up slowly, never over the average
+    const float rise = (_level.active ? activeRiseDbS : idleRiseDbS) * _dt;
+    _level.floorDb = averageDb < floorDb ? averageDb : fminf(averageDb, floorDb + rise);
+    return _level;
+}
@@ -0,0 +1,163 @@
+#include "audio_analyzer.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <math.h>
+
+// -----------------------------------------------------
+// Settings
+// -----------------------------------------------------
+bool AudioAnalyzer::configure(int window, int hop, int sampleRate)
+{
+    if (window < 8 || window > 4096 || (window & (window - 1)) || hop <= 0 || hop > window || window % hop)
+        return false;
+    if (window == _window && hop == _hop && sampleRate == _rate) return true;
+
+    _window = window;
+    _hop = hop;
+    _rate = sampleRate;
+    _ring.assign(window, 0);
+    _ringWrite = 0;
+    _samplePos = 0;
+    _bandsBuilt = 0;
+    _pipelineReady = false;
+    _onsets.configure(window, hop, sampleRate);
+    _activity.configure(hop, sampleRate);
+    return true;
+}
+
+void AudioAnalyzer::setBands(int count, BandScale scale)
+{
+    _bandLayout = (uint32_t)count | (uint32_t)scale << 16;
+}
+
+void AudioAnalyzer::setPipeline(AudioPipeline pipeline)
+{
+    if (pipeline != _pipeline) _pipelineReady = false;
+    _pipeline = pipeline;
+}
+
+void AudioAnalyzer::reset()
+{
+    std::fill(_ring.begin(), _ring.end(), 0);
+    _ringWrite = 0;
+    _samplePos = 0;
+    _onsets.reset();
+    _activity.reset();
+}
+
+// Frame, window and FFT tables of the pipeline in use; the other's go
+void AudioAnalyzer::buildPipeline()
+{
+    if (_pipeline == AudioPipeline::Q15) {
+        std::vector<float>().swap(_fftData);
+        std::vector<float>().swap(_fftWindow);
+        _q15Data.assign(_window, 0);
+        _q15Magnitude.assign(_window / 2, 0);
+        RealFFTQ15::hannWindow(_q15Window, _window);
+        _fftQ15.init(_window);
+    } else {
+        std::vector<int16_t>().swap(_q15Data);
+        std::vector<uint16_t>().swap(_q15Magnitude);
+        std::vector<int16_t>().swap(_q15Window);
+        _fftData.assign(_window, 0.0f);
+        _fftWindow.resize(_window);
+        for (int i = 0; i < _window; ++i)
+            _fftWindow[i] = 0.5f * (1.0f - cosf(2.0f * (float)M_PI * i / (_window - 1)));
+        _fft.init(_window);
+    }
+    _pipelineReady = true;
+}
+
+// -----------------------------------------------------
+// One hop
+// -----------------------------------------------------
+bool AudioAnalyzer::process(const int32_t* words, int64_t timeUs, AudioSpectrum& out, AudioEvent& event)
+{
+    if (_window == 0) return false;
+    if (!_pipelineReady) buildPipeline();
+    if (_bandLayout != _bandsBuilt) {
+        _bands.configure(_bandLayout & 0xFFFF, _window, _rate, (BandScale)(_bandLayout >> 16));
+        _agc.reset();
+        _bandsBuilt = _bandLayout;
+    }
+
+    // The new hop replaces the oldest samples: the 24-bit word's top 18
+    // bits. The hop divides the window, so they are one run in the ring.
+    const uint32_t ta = timer_cycles();
+    int32_t* fresh = &_ring[_ringWrite];
+    for (int i = 0; i < _hop; ++i) fresh[i] = words[i] >> 14;
+    _ringWrite = (_ringWrite + _hop) & (_window - 1);
+    _samplePos += _hop;
+
+    out.level = _activity.process(fresh, _hop);
+    out.gated = _gate && !out.level.active;
+    out.count = _bands.count();
+    out.window = (uint16_t)_window;
+    out.hop = (uint16_t)_hop;
+    out.pipeline = _pipeline;
+    uint32_t t0 = timer_cycles();
+    _stageUs.activity = timer_cycles_to_us_f(t0 - ta);
+
+    // Silence: nothing to transform, the bars fall to 0
+    if (out.gated) {
+        std::fill(out.bands, out.bands + out.count, 0.0f);
+        out.referenceDb = _agc.referenceDb();
+        out.novelty = 0.0f;
+        out.bpm = _onsets.bpm();
+        out.onsetUs = 0;
+        const float activity = _stageUs.activity;
+        _stageUs = AudioStageUs();
+        _stageUs.activity = activity;
+        return false;
+    }
+
+    _transforms++;
+    bool onset;
+    uint32_t t1, t2, t3, t4;
+    if (_pipeline == AudioPipeline::Q15) {
+        // Windowed into a Q15 block, FFT, then magnitudes: no floats until
+        // the one log per band
+        int exponent = _fftQ15.load(_q15Data.data(), _ring.data(), _ringWrite, _q15Window.data());
+        t1 = timer_cycles();
+        exponent += _fftQ15.forward(_q15Data.data());
+        t2 = timer_cycles();
+        _fftQ15.magnitudes(_q15Data.data(), _q15Magnitude.data());
+        t3 = timer_cycles();
+        _bands.process(_q15Magnitude.data(), exponent, _levelsDb);
+        t4 = timer_cycles();
+        onset = _onsets.process(_q15Magnitude.data(), exponent, _samplePos, timeUs, event);
+    } else {
+        // Window the ring oldest first: two straight runs either side of the seam
+        const int tail = _window - _ringWrite;
+        for (int i = 0; i < tail; ++i) _fftData[i] = (float)_ring[_ringWrite + i] * _fftWindow[i];
+        for (int i = tail; i < _window; ++i) _fftData[i] = (float)_ring[i - tail] * _fftWindow[i];
+        t1 = timer_cycles();
+
+        // Real-input FFT: packed spectrum, bins 0..window/2-1
+        _fft.forward(_fftData.data());
+        t2 = t3 = timer_cycles();
+        _bands.process(_fftData.data(), _levelsDb);
+        t4 = timer_cycles();
+        onset = _onsets.process(_fftData.data(), _samplePos, timeUs, event);
+    }
+    const uint32_t t5 = timer_cycles();
+
+    const int count = _bands.count();
+    std::copy(_levelsDb, _levelsDb + count, out.bands);
+    _agc.process(out.bands, count, (float)_hop / _rate);
+    const uint32_t t6 = timer_cycles();
+
+    out.referenceDb = _agc.referenceDb();
+    out.novelty = _onsets.novelty();
+    out.bpm = _onsets.bpm();
+    out.onsetUs = timer_cycles_to_us(t5 - t4);
+
+    _stageUs.window = timer_cycles_to_us_f(t1 - t0);
+    _stageUs.fft = timer_cycles_to_us_f(t2 - t1);
+    _stageUs.magnitude = timer_cycles_to_us_f(t3 - t2);
+    _stageUs.bands = timer_cycles_to_us_f(t4 - t3);
+    _stageUs.onset = timer_cycles_to_us_f(t5 - t4);
+    _stageUs.gain = timer_cycles_to_us_f(t6 - t5);
+    return onset;
+}
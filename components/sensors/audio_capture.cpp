@@ -0,0 +1,353 @@
+#include "audio_capture.h"
+
+#include <vector>
+#include "driver/i2s_std.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <esp_timer.h>
+#include <esp_log.h>
+
+static const char* TAG = "AudioCapture";
+
+#define MIC_BCLK 16
+#define MIC_LRCL 17
+#define MIC_DOUT 18
+
+// Producer's buffer, one hop from I2S; the analysis keeps its own
+static std::vector<int32_t> samples;
+static i2s_chan_handle_t rxChannel = nullptr;
+
+// Hops are read one DMA descriptor at a time, so stop() waits for one
+// descriptor at most. One fills in 11.6 ms; a read this late means the
+// channel is stuck.
+static const uint32_t READ_TIMEOUT_MS = 20;
+
+AudioCapture& AudioCapture::instance()
+{
+    static AudioCapture capture;
+    return capture;
+}
+
+AudioDmaPlan AudioCapture::dmaPlan(int hop)
+{
+    AudioDmaPlan plan;
+    plan.frames = hop < MAX_DMA_FRAMES ? hop : MAX_DMA_FRAMES;
+    plan.descriptors = 2 * (hop / plan.frames) + 1;
+    plan.bytes = (size_t)plan.descriptors * plan.frames * sizeof(int32_t);
+    plan.granularityMs = 1000.0f * plan.frames / SAMPLE_RATE;
+    plan.bufferedMs = plan.granularityMs * plan.descriptors;
+    return plan;
+}
+
+size_t AudioCapture::analysisBytes(int window, int hop)
+{
+    return (size_t)hop * sizeof(int32_t) + 3 * (size_t)window * sizeof(float);
+}
+
+// -----------------------------------------------------
+// I2S channel (ICS-43434: 24 bits left-justified in 32-bit slots, left channel)
+// -----------------------------------------------------
+bool AudioCapture::openChannel()
+{
+    const AudioDmaPlan plan = dmaPlan(_analyzer.hop());
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
+    chan_cfg.dma_desc_num = plan.descriptors;
+    chan_cfg.dma_frame_num = plan.frames;
+
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_MONO),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = (gpio_num_t)MIC_BCLK,
+            .ws = (gpio_num_t)MIC_LRCL,
+            .dout = I2S_GPIO_UNUSED,
+            .din = (gpio_num_t)MIC_DOUT,
+            .invert_flags = {
+                .mclk_inv = false,
+                .bclk_inv = false,
+                .ws_inv = false,
+            },
+        },
+    };
+    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
+
+    i2s_chan_handle_t chan = nullptr;
+    esp_err_t err = i2s_new_channel(&chan_cfg, nullptr, &chan);
+    if (err == ESP_OK) {
+        err = i2s_channel_init_std_mode(chan, &std_cfg);
+        if (err == ESP_OK) err = i2s_channel_enable(chan);
+        if (err != ESP_OK) i2s_del_channel(chan);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "I2S channel failed (%d)", (int)err);
+        return false;
+    }
+    rxChannel = chan;
+    _channelOpen = true;
+
+    ESP_LOGI(TAG, "Microphone on: %d x %d-sample DMA descriptors, %u bytes, %.2f ms granularity",
+             plan.descriptors, plan.frames, (unsigned)plan.bytes, plan.granularityMs);
+    return true;
+}
+
+void AudioCapture::closeChannel()
+{
+    if (!rxChannel) return;
+    i2s_channel_disable(rxChannel);
+    i2s_del_channel(rxChannel);
+    rxChannel = nullptr;
+    _channelOpen = false;
+    ESP_LOGI(TAG, "Microphone off, DMA buffers released");
+}
+
+// -----------------------------------------------------
+// Task
+// -----------------------------------------------------
+void AudioCapture::start()
+{
+    if (!_started) {
+        _levelStats = AudioLevels();
+        _transformsAtStart = _analyzer.transforms();
+    }
+    _started = true;
+    if (_task) return;
+
+    _run = true;
+    _exited = false;
+    TaskHandle_t task = nullptr;
+    if (xTaskCreatePinnedToCore(taskMain, "audio", TASK_STACK, this, TASK_PRIORITY, &task, TASK_CORE) != pdPASS) {
+        _run = false;
+        ESP_LOGW(TAG, "Capture task not started; capturing on the render side");
+        return;
+    }
+    _task = task;
+}
+
+bool AudioCapture::validAnalysis(int window, int hop)
+{
+    return window >= MIN_WINDOW && window <= MAX_WINDOW && (window & (window - 1)) == 0 &&
+           hop > 0 && hop <= window && window % hop == 0;
+}
+
+bool AudioCapture::setAnalysis(int window, int hop)
+{
+    if (!validAnalysis(window, hop)) return false;
+    _analysisRequest = (uint32_t)window | (uint32_t)hop << 16;
+    return true;
+}
+
+void AudioCapture::setBands(int count, BandScale scale)
+{
+    _bandRequest = (uint32_t)count | (uint32_t)scale << 16;
+}
+
+void AudioCapture::setPipeline(AudioPipeline pipeline)
+{
+    _pipelineRequest = (uint8_t)pipeline;
+}
+
+AudioPipeline AudioCapture::pipelineSetting(uint8_t setting)
+{
+    return setting == 1 ? AudioPipeline::FLOAT : (setting == 2 ? AudioPipeline::Q15 : BUILD_PIPELINE);
+}
+
+void AudioCapture::stop()
+{
+    if (_task) {
+        // The task gives up its hop at the next descriptor boundary
+        _run = false;
+        while (!_exited) vTaskDelay(1);
+        _task = nullptr;
+    }
+    // The producer is not running now, whichever side it was on
+    closeChannel();
+    _started = false;
+    _users = 0;
+}
+
+void AudioCapture::acquire()
+{
+    if (_users++ == 0) start();
+}
+
+void AudioCapture::release()
+{
+    if (_users == 0) return;
+    if (--_users == 0) stop();
+}
+
+void AudioCapture::taskMain(void* arg)
+{
+    AudioCapture* self = (AudioCapture*)arg;
+    while (self->_run) self->produce(&self->_run);
+    self->_exited = true;
+    vTaskDelete(nullptr);
+}
+
+// -----------------------------------------------------
+// Producer
+// -----------------------------------------------------
+// Hands changed settings to the analysis and (re)opens the channel with
+// DMA to match the hop. False without a channel.
+bool AudioCapture::applyRequests()
+{
+    const uint32_t analysis = _analysisRequest;
+    const int window = analysis & 0xFFFF, hop = analysis >> 16;
+    if (window != _analyzer.window() || hop != _analyzer.hop()) {
+        samples.assign(hop, 0);
+        closeChannel();
+        _analyzer.configure(window, hop, SAMPLE_RATE);
+        ESP_LOGI(TAG, "Analysis: %d-sample window, %d-sample hop (%d%% overlap, %.1f spectra/s)",
+                 window, hop, 100 - 100 * hop / window, (float)SAMPLE_RATE / hop);
+    }
+
+    const AudioPipeline pipeline = (AudioPipeline)_pipelineRequest.load();
+    if (pipeline != _analyzer.pipeline()) {
+        _analyzer.setPipeline(pipeline);
+        ESP_LOGI(TAG, "Pipeline: %s", pipeline == AudioPipeline::Q15 ? "Q15 fixed point" : "float");
+    }
+
+    _analyzer.setGate(_gateRequest);
+
+    const uint32_t layout = _bandRequest;
+    _analyzer.setBands(layout & 0xFFFF, (BandScale)(layout >> 16));
+
+    // A fresh channel starts from silence, not from whatever was in the ring
+    if (!rxChannel) {
+        if (!openChannel()) return false;
+        _analyzer.reset();
+    }
+    return true;
+}
+
+void AudioCapture::capture()
+{
+    produce(nullptr);
+}
+
+// `run`, on the task, is polled between descriptors; once it is false the
+// hop is dropped unpublished
+void AudioCapture::produce(const std::atomic<bool>* run)
+{
+    if (!_started) return;
+    if (!applyRequests()) {
+        for (int i = 0; i < 10 && (!run || *run); ++i) vTaskDelay(pdMS_TO_TICKS(10));
+        return;
+    }
+
+    const int hop = _analyzer.hop();
+    const int chunk = dmaPlan(hop).frames;
+    for (int at = 0; at < hop; at += chunk) {
+        if (run && !*run) return;
+        size_t bytes_read = 0;
+        i2s_channel_read(rxChannel, samples.data() + at, chunk * sizeof(int32_t), &bytes_read, READ_TIMEOUT_MS);
+        const int got = bytes_read / sizeof(int32_t);
+        for (int i = at + got; i < at + chunk; ++i) samples[i] = 0;
+    }
+    const int64_t captureUs = esp_timer_get_time();
+
+    // Onsets and beats are published as they are found
+    AudioSpectrum& out = _spectra.back();
+    AudioEvent event;
+    if (_analyzer.process(samples.data(), captureUs, out, event)) _events.publish(event);
+    out.seq = ++_seq;
+    out.captureUs = captureUs;
+    out.processUs = (uint32_t)(esp_timer_get_time() - captureUs);
+    publishLevels(out);
+    _spectra.publish();
+}
+
+// Running means over about a second of hops of each kind
+void AudioCapture::publishLevels(const AudioSpectrum& s)
+{
+    AudioLevels& st = _levelStats;
+    const float alpha = 1.0f / 64.0f;
+    float& mean = s.level.active ? st.activeUs : st.idleUs;
+    mean = mean > 0.0f ? mean + alpha * ((float)s.processUs - mean) : (float)s.processUs;
+
+    st.level = s.level;
+    st.gate = _analyzer.gate();
+    st.gated = s.gated;
+    st.hops++;
+    st.gatedHops += s.gated;
+    st.transforms = _analyzer.transforms() - _transformsAtStart;
+    st.hopMs = 1000.0f * _analyzer.hop() / SAMPLE_RATE;
+    _levels.back() = st;
+    _levels.publish();
+}
+
+// -----------------------------------------------------
+// Consumer
+// -----------------------------------------------------
+const AudioSpectrum* AudioCapture::latest()
+{
+    if (_spectra.fetch()) {
+        const AudioSpectrum& s = _spectra.front();
+        if (_lastSeq == 0) _firstSeq = s.seq - 1;
+        int64_t latencyUs = esp_timer_get_time() - s.captureUs;
+        _latencySumUs += latencyUs;
+        if (latencyUs > _latencyMaxUs) _latencyMaxUs = latencyUs;
+        _processSumUs += s.processUs;
+        _shown++;
+        _lastSeq = s.seq;
+    }
+    return _lastSeq ? &_spectra.front() : nullptr;
+}
+
+AudioStats AudioCapture::stats() const
+{
+    AudioStats st = {};
+    st.hops = _lastSeq - _firstSeq;
+    st.shown = _shown;
+    st.skipped = st.hops > _shown ? st.hops - _shown : 0;
+    if (_shown) {
+        st.latencyMeanMs = (float)(_latencySumUs / _shown / 1000.0);
+        st.latencyMaxMs = _latencyMaxUs / 1000.0f;
+        st.processMeanUs = (float)(_processSumUs / _shown);
+    }
+    return st;
+}
+
+const AudioLevels& AudioCapture::levels()
+{
+    _levels.fetch();
+    return _levels.front();
+}
+
+void AudioCapture::resetStats()
+{
+    _firstSeq = _lastSeq;
+    _shown = 0;
+    _latencySumUs = 0.0;
+    _latencyMaxUs = 0;
+    _processSumUs = 0.0;
+}
+
+// -----------------------------------------------------
+// Beat follower
+// -----------------------------------------------------
+void BeatFollower::begin()
+{
+    _cursor = AudioCapture::instance().eventCursor();
+    _pulse = 0.0f;
+    _sinceBeat = 1e9f;
+}
+
+int BeatFollower::update(float dt)
+{
+    _pulse *= expf(-dt / pulseS);
+    _sinceBeat += dt;
+
+    int beats = 0;
+    AudioEvent event;
+    while (AudioCapture::instance().nextEvent(_cursor, event)) {
+        if (event.bpm > 0.0f) _bpm = event.bpm;
+        if (!(event.flags & AUDIO_BEAT)) continue;
+        beats++;
+        _pulse = 1.0f;
+        _strength = event.strength;
+        _sinceBeat = 0.0f;
+    }
+    return beats;
+}
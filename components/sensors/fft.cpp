@@ -1 +1,157 @@
-// placeholder for components/sensors/fft.cpp
\ No newline at end of file
+#include "fft.h"
+
+#if __has_include("esp_dsp.h")
+#include "esp_dsp.h"
+#define FFT_HAVE_ESP_DSP 1
+#else
+#define FFT_HAVE_ESP_DSP 0
+#endif
+
+// -----------------------------------------------------
+// Tables
+// -----------------------------------------------------
+bool RealFFT::init(int n)
+{
+    if (n < 8 || n > 4096 || (n & (n - 1))) return false;
+    if (n == _n) return true;
+
+    const int m = n / 2;       // points of the complex stage
+
+    // Twiddles for the complex stage
+    _twiddle.resize(m);
+    for (int k = 0; k < m / 2; ++k) {
+        double a = 2.0 * M_PI * k / m;
+        _twiddle[2 * k] = (float)cos(a);
+        _twiddle[2 * k + 1] = (float)-sin(a);
+    }
+
+    // Twiddles for splitting the complex result into the real spectrum
+    _split.resize(m + 2);
+    for (int k = 0; k <= m / 2; ++k) {
+        double a = 2.0 * M_PI * k / n;
+        _split[2 * k] = (float)cos(a);
+        _split[2 * k + 1] = (float)-sin(a);
+    }
+
+    // Index pairs the bit-reversal permutation swaps
+    _swaps.clear();
+    int bits = 0;
+    while ((1 << bits) < m) ++bits;
+    for (int i = 0; i < m; ++i) {
+        int r = 0;
+        for (int b = 0; b < bits; ++b)
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        if (i < r) {
+            _swaps.push_back((uint16_t)i);
+            _swaps.push_back((uint16_t)r);
+        }
+    }
+
+    _n = n;
+    return true;
+}
+
+bool RealFFT::hasEspDsp()
+{
+    return FFT_HAVE_ESP_DSP;
+}
+
+void RealFFT::setBackend(FftBackend backend)
+{
+    _backend = hasEspDsp() ? backend : FftBackend::SCALAR;
+}
+
+// -----------------------------------------------------
+// Transform
+// -----------------------------------------------------
+void RealFFT::forward(float* data) const
+{
+    if (_n == 0) return;
+
+#if FFT_HAVE_ESP_DSP
+    static bool dspReady = false;
+    if (_backend == FftBackend::ESP_DSP && !dspReady)
+        dspReady = dsps_fft2r_init_fc32(nullptr, CONFIG_DSP_MAX_FFT_SIZE) == ESP_OK;
+
+    if (_backend == FftBackend::ESP_DSP && dspReady) {
+        dsps_fft2r_fc32(data, _n / 2);
+        dsps_bit_rev_fc32(data, _n / 2);
+    } else {
+        complexScalar(data);
+    }
+#else
+    complexScalar(data);
+#endif
+
+    split(data);
+}
+
+// Iterative radix-2, decimation in time, on interleaved re/im pairs
+void RealFFT::complexScalar(float* data) const
+{
+    const int m = _n / 2;
+
+    for (size_t i = 0; i < _swaps.size(); i += 2) {
+        float* a = data + 2 * _swaps[i];
+        float* b = data + 2 * _swaps[i + 1];
+        float tr = a[0], ti = a[1];
+        a[0] = b[0];
+        a[1] = b[1];
+        b[0] = tr;
+        b[1] = ti;
+    }
+
+    for (int half = 1; half < m; half <<= 1) {
+        const int stride = m / (2 * half);      // twiddle table step at this stage
+        for (int j = 0; j < half; ++j) {
+            const float wr = _twiddle[2 * j * stride];
+            const float wi = _twiddle[2 * j * stride + 1];
+            for (int k = j; k < m; k += 2 * half) {
+                float* u = data + 2 * k;
+                float* t = data + 2 * (k + half);
+                float tr = wr * t[0] - wi * t[1];
+                float ti = wr * t[1] + wi * t[0];
+                t[0] = u[0] - tr;
+                t[1] = u[1] - ti;
+                u[0] += tr;
+                u[1] += ti;
+            }
+        }
+    }
+}
+
+// Z = FFT of z[k] = x[2k] + i x[2k+1]. With E = (Z[k] + conj(Z[m-k])) / 2
+// and O = (Z[k] - conj(Z[m-k])) / 2i, X[k] = E + W^k O and
+// X[m-k] = conj(E - W^k O), W = exp(-2 pi i / n): each pair of bins is
+// finished from one pair of complex values, in place.
+void RealFFT::split(float* data) const
+{
+    const int m = _n / 2;
+
+    const float z0r = data[0], z0i = data[1];
+    data[0] = z0r + z0i;        // X[0]
+    data[1] = z0r - z0i;        // X[n/2]
+
+    for (int k = 1; k < m / 2; ++k) {
+        float* a = data + 2 * k;
+        float* b = data + 2 * (m - k);
+
+        const float er = 0.5f * (a[0] + b[0]);
+        const float ei = 0.5f * (a[1] - b[1]);
+        const float orr = 0.5f * (a[1] + b[1]);
+        const float oi = -0.5f * (a[0] - b[0]);
+
+        const float wr = _split[2 * k];
+        const float wi = _split[2 * k + 1];
+        const float tr = wr * orr - wi * oi;
+        const float ti = wr * oi + wi * orr;
+
+        a[0] = er + tr;
+        a[1] = ei + ti;
+        b[0] = er - tr;
+        b[1] = ti - ei;
+    }
+
+    // The middle bin pairs with itself: X[m/2] = conj(Z[m/2])
+    data[m + 1] = -data[m + 1];
+}
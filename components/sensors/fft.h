@@ -1 +0,0 @@
-// placeholder for components/sensors/fft.h
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "fft_q15.h"
+#include <algorithm>
+#include <math.h>
+
+// A block is safe for one stage while its peak component times 1 + sqrt(2),
+// plus a count of rounding, stays within int16
+static const int32_t STAGE_LIMIT = 13572;
+
+// Shift right, rounding to nearest; shift may be 0
+static inline int32_t shift_round(int32_t v, int shift)
+{
+    return (v + ((1 << shift) >> 1)) >> shift;
+}
+
+// Rounding right shift that brings `peak` within STAGE_LIMIT
+static inline int headroom(int32_t peak)
+{
+    int shift = 0;
+    while (shift_round(peak, shift) > STAGE_LIMIT) ++shift;
+    return shift;
+}
+
+static inline int16_t to_q15(double v)
+{
+    long q = lround(v * 32768.0);
+    return (int16_t)(q > Q15_ONE ? Q15_ONE : (q < -Q15_ONE ? -Q15_ONE : q));
+}
+
+// -----------------------------------------------------
+// Tables
+// -----------------------------------------------------
+bool RealFFTQ15::init(int n)
+{
+    if (n < 8 || n > 4096 || (n & (n - 1))) return false;
+    if (n == _n) return true;
+
+    const int m = n / 2;
+
+    _twiddle.resize(m);
+    for (int k = 0; k < m / 2; ++k) {
+        double a = 2.0 * M_PI * k / m;
+        _twiddle[2 * k] = to_q15(cos(a));
+        _twiddle[2 * k + 1] = to_q15(-sin(a));
+    }
+
+    _split.resize(m + 2);
+    for (int k = 0; k <= m / 2; ++k) {
+        double a = 2.0 * M_PI * k / n;
+        _split[2 * k] = to_q15(cos(a));
+        _split[2 * k + 1] = to_q15(-sin(a));
+    }
+
+    _swaps.clear();
+    int bits = 0;
+    while ((1 << bits) < m) ++bits;
+    for (int i = 0; i < m; ++i) {
+        int r = 0;
+        for (int b = 0; b < bits; ++b)
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        if (i < r) {
+            _swaps.push_back((uint16_t)i);
+            _swaps.push_back((uint16_t)r);
+        }
+    }
+
+    _n = n;
+    return true;
+}
+
+void RealFFTQ15::hannWindow(std::vector<int16_t>& window, int n)
+{
+    window.resize(n);
+    for (int i = 0; i < n; ++i) window[i] = to_q15(0.5 * (1.0 - cos(2.0 * M_PI * i / (n - 1))));
+}
+
+// -----------------------------------------------------
+// Transform
+// -----------------------------------------------------
+int RealFFTQ15::load(int16_t* data, const int32_t* ring, int oldest, const int16_t* window) const
+{
+    // The windowed peak is at most the raw one: scale for that, up or down
+    int32_t peak = 0;
+    for (int i = 0; i < _n; ++i) {
+        int32_t v = abs(ring[i]);
+        if (v > peak) peak = v;
+    }
+    if (peak == 0) {
+        for (int i = 0; i < _n; ++i) data[i] = 0;
+        return 0;
+    }
+    int exponent = headroom(peak);
+    if (exponent == 0)
+        while (exponent > -15 && (peak << (1 - exponent)) <= STAGE_LIMIT) --exponent;
+
+    // 24-bit sample times Q15 overflows 32 bits: one widening multiply
+    // each, in two straight runs either side of the ring's seam
+    const int shift = 15 + exponent;
+    const int64_t round = ((int64_t)1 << shift) >> 1;
+    const int tail = _n - oldest;
+    for (int i = 0; i < tail; ++i) data[i] = (int16_t)(((int64_t)ring[oldest + i] * window[i] + round) >> shift);
+    for (int i = tail; i < _n; ++i) data[i] = (int16_t)(((int64_t)ring[i - tail] * window[i] + round) >> shift);
+    return exponent;
+}
+
+int RealFFTQ15::forward(int16_t* data) const
+{
+    if (_n == 0) return 0;
+    const int m = _n / 2;
+    int exponent = 0;
+
+    // Bit reversal, finding the block's peak on the way
+    uint32_t* pairs = (uint32_t*)data;
+    for (size_t i = 0; i < _swaps.size(); i += 2) {
+        uint32_t t = pairs[_swaps[i]];
+        pairs[_swaps[i]] = pairs[_swaps[i + 1]];
+        pairs[_swaps[i + 1]] = t;
+    }
+    int32_t peak = 0;
+    for (int i = 0; i < _n; ++i) {
+        int32_t v = abs((int32_t)data[i]);
+        if (v > peak) peak = v;
+    }
+
+    // Radix-2 stages; each scales its inputs by the shift the previous
+    // stage's peak asks for and records its own
+    for (int half = 1; half < m; half <<= 1) {
+        const int shift = headroom(peak);
+        exponent += shift;
+        peak = 0;
+
+        const int stride = m / (2 * half);
+        for (int j = 0; j < half; ++j) {
+            const int32_t wr = _twiddle[2 * j * stride];
+            const int32_t wi = _twiddle[2 * j * stride + 1];
+            for (int k = j; k < m; k += 2 * half) {
+                int16_t* u = data + 2 * k;
+                int16_t* t = data + 2 * (k + half);
+                const int32_t ur = shift_round(u[0], shift), ui = shift_round(u[1], shift);
+                const int32_t xr = shift_round(t[0], shift), xi = shift_round(t[1], shift);
+
+                // w = 1 on the first butterfly of every group: exact
+                const int32_t tr = j ? q15_mul(wr, xr) - q15_mul(wi, xi) : xr;
+                const int32_t ti = j ? q15_mul(wr, xi) + q15_mul(wi, xr) : xi;
+                const int32_t a = ur + tr, b = ui + ti, c = ur - tr, d = ui - ti;
+                u[0] = (int16_t)a;
+                u[1] = (int16_t)b;
+                t[0] = (int16_t)c;
+                t[1] = (int16_t)d;
+
+                peak = std::max(peak, std::max(std::max(abs(a), abs(b)), std::max(abs(c), abs(d))));
+            }
+        }
+    }
+
+    // Split into the real spectrum as RealFFT::split does, halves included
+    const int shift = headroom(peak);
+    exponent += shift;
+
+    const int32_t z0r = shift_round(data[0], shift), z0i = shift_round(data[1], shift);
+    data[0] = (int16_t)(z0r + z0i);
+    data[1] = (int16_t)(z0r - z0i);
+
+    for (int k = 1; k < m / 2; ++k) {
+        int16_t* a = data + 2 * k;
+        int16_t* b = data + 2 * (m - k);
+        const int32_t ar = shift_round(a[0], shift), ai = shift_round(a[1], shift);
+        const int32_t br = shift_round(b[0], shift), bi = shift_round(b[1], shift);
+
+        const int32_t er = (ar + br) >> 1;
+        const int32_t ei = (ai - bi) >> 1;
+        const int32_t orr = (ai + bi) >> 1;
+        const int32_t oi = -((ar - br) >> 1);
+
+        const int32_t wr = _split[2 * k];
+        const int32_t wi = _split[2 * k + 1];
+        const int32_t tr = q15_mul(wr, orr) - q15_mul(wi, oi);
+        const int32_t ti = q15_mul(wr, oi) + q15_mul(wi, orr);
+
+        a[0] = (int16_t)(er + tr);
+        a[1] = (int16_t)(ei + ti);
+        b[0] = (int16_t)(er - tr);
+        b[1] = (int16_t)(ti - ei);
+    }
+
+    data[m] = (int16_t)shift_round(data[m], shift);
+    data[m + 1] = (int16_t)-shift_round(data[m + 1], shift);
+    return exponent;
+}
+
+void RealFFTQ15::magnitudes(const int16_t* spectrum, uint16_t* mag) const
+{
+    const int m = _n / 2;
+    mag[0] = (uint16_t)abs(spectrum[0]);
+    for (int k = 1; k < m; ++k) mag[k] = (uint16_t)q15_magnitude(spectrum[2 * k], spectrum[2 * k + 1]);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+
+// Sound level of the newest hop
+struct AudioLevel {
+    float rmsDb = -120.0f;      // RMS relative to a full-scale sine's (dBFS, as the bands)
+    float peakDb = -120.0f;     // loudest sample, held and falling like a meter's
+    float floorDb = -120.0f;    // noise floor estimate
+    float zcr = 0.0f;           // zero crossings per sample, 0..1
+    bool active = false;        // sound over the floor, or within holdS of it
+};
+
+// Whether anything is playing, from the samples alone and before any FFT.
+//
+// Per hop it takes one pass over the samples: the sum of squares, the
+// largest magnitude and the sign changes. The noise floor follows the
+// level averaged over floorAverageS (long enough to steady a room's
+// rumble, which swings several dB from hop to hop, short enough to empty
+// between notes) down at once and creeps back up, quickly while idle and
+// very slowly while active, so a fridge that starts becomes the floor
+// within seconds while a sustained chord takes minutes. A hop is sound
+// when its own RMS is onDb over the floor and over minDb, unless it
+// crosses zero like hiss (zcr over hissZcr) without rising hissDb over
+// the floor. Sound keeps the detector active for holdS, so pauses
+// between notes and words do not gate; it starts active after a reset,
+// while the floor settles.
+class ActivityDetector {
+public:
+    float onDb = 9.0f;              // RMS over the floor that is sound
+    float minDb = -70.0f;           // ... and over this whatever the floor
+    float hissZcr = 0.25f;          // crossing rate above which a level near the floor is hiss
+    float hissDb = 12.0f;           // ... and this far over it sound again
+    float holdS = 2.0f;             // active this long after the last sound
+    float floorAverageS = 0.05f;    // level the floor follows, averaged over this
+    float idleRiseDbS = 3.0f;       // noise floor creep while idle
+    float activeRiseDbS = 0.1f;     // ... and while active
+    float peakFallDbS = 20.0f;
+
+    void configure(int hop, int sampleRate);
+    void reset();
+
+    // One hop of samples scaled to +-fullScale
+    const AudioLevel& process(const int32_t* samples, int count);
+
+    const AudioLevel& level() const { return _level; }
+    bool active() const { return _level.active; }
+
+    float fullScale = 131072.0f;    // microphone samples after >> 14
+
+private:
+    float _dt = 0.0f;
+    float _hold = 0.0f;             // seconds of activity left without sound
+    float _alpha = 0.0f;            // per hop, for the average
+    double _meanSq = -1.0;          // averaged, < 0 until the first hop
+    int32_t _last = 0;              // previous hop's newest sample, for its crossing
+    AudioLevel _level;
+};
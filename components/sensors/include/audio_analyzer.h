@@ -0,0 +1,138 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "fft.h"
+#include "fft_q15.h"
+#include "spectrum_bands.h"
+#include "onset_detector.h"
+#include "activity_detector.h"
+
+// How a hop becomes a spectrum
+enum class AudioPipeline : uint8_t {
+    FLOAT,      // float window, RealFFT, power per bin
+    Q15         // Q15 window, block-floating-point RealFFTQ15, alpha-max-plus-beta-min magnitudes
+};
+
+// One analysis hop as published to the render side
+struct AudioSpectrum {
+    float bands[SpectrumBands::MAX_BANDS];  // 0..1 per band after AGC, not smoothed
+    int count;              // bands in use, low to high frequency
+    float referenceDb;      // AGC reference (bar top), dBFS
+    uint16_t window;        // samples analysed (FFT size)
+    uint16_t hop;           // new samples since the previous spectrum
+    float novelty;          // onset detector's spectral flux, dB per band
+    float bpm;              // tempo estimate, 0 = none yet
+    AudioPipeline pipeline; // that made this spectrum
+    uint32_t seq;           // hops published so far; 0 = none yet
+    int64_t captureUs;      // esp_timer time the newest sample arrived
+    uint32_t processUs;     // window + FFT + bands + onsets for this hop
+    uint32_t onsetUs;       // of which onset detection
+    AudioLevel level;       // of the hop's samples, before any FFT
+    bool gated;             // silence: no FFT this hop, bands at 0 (see AudioAnalyzer::setGate)
+};
+
+// Microseconds per stage of the last hop
+struct AudioStageUs {
+    float activity = 0.0f;      // new samples into the ring, their level, peak and crossings
+    float window = 0.0f;        // ring to windowed frame (Q15: block-scaled)
+    float fft = 0.0f;
+    float magnitude = 0.0f;     // Q15 only; the float bands square the bins themselves
+    float bands = 0.0f;         // bins to band dBFS
+    float gain = 0.0f;          // AGC
+    float onset = 0.0f;
+
+    float total() const { return activity + window + fft + magnitude + bands + gain + onset; }
+};
+
+// The microphone's analysis from samples to bar levels, with no hardware
+// behind it: AudioCapture feeds it I2S hops on the device, the host test
+// bench feeds it synthetic signals and WAV files.
+//
+// The newest `window` samples are kept in a ring. Every hop the new
+// samples are measured first (ActivityDetector); with the gate on, hops
+// of silence stop there. Otherwise the whole ring is windowed oldest first and transformed, float or Q15
+// (see fft_q15.h), its bins are mapped to bands (SpectrumBands), the
+// bands go through the automatic gain (AutoGain) and the spectrum through
+// the onset detector (OnsetDetector). Each stage is timed with
+// timer_cycles(), so a change to any of them shows up in stageUs().
+//
+// Buffers and tables are those of the pipeline in use; switching frees
+// the other's. Settings take effect before the next process().
+class AudioAnalyzer {
+public:
+    // Restarts the ring, so the next spectra see a partly silent window.
+    // `window` is a power of two from 8 to 4096 and `hop` divides it.
+    bool configure(int window, int hop, int sampleRate);
+    // The band count is clamped to what the FFT resolves
+    void setBands(int count, BandScale scale = BandScale::LOG);
+    void setPipeline(AudioPipeline pipeline);
+    // Silence in the ring, the detectors restarted, the stream back at 0
+    void reset();
+
+    // On: once the activity detector has gone idle, hops skip everything
+    // after it and come out gated with the bands at 0. The ring still
+    // fills, so the first hop of sound is analysed over a whole window.
+    void setGate(bool on) { _gate = on; }
+    bool gate() const { return _gate; }
+
+    // One hop of microphone words (24-bit samples, left-justified in 32
+    // bits, as I2S delivers them) captured at `timeUs`. Fills `out` but
+    // for seq, captureUs and processUs; true with `event` filled when the
+    // onset detector found one.
+    bool process(const int32_t* words, int64_t timeUs, AudioSpectrum& out, AudioEvent& event);
+
+    int window() const { return _window; }
+    int hop() const { return _hop; }
+    int sampleRate() const { return _rate; }
+    AudioPipeline pipeline() const { return _pipeline; }
+    int bandCount() const { return _bands.count(); }
+    const SpectrumBands& bands() const { return _bands; }
+    uint64_t samplePos() const { return _samplePos; }
+
+    // The last analysed hop's bands in dBFS, before the gain
+    const float* levelsDb() const { return _levelsDb; }
+    const AudioLevel& level() const { return _activity.level(); }
+    const AudioStageUs& stageUs() const { return _stageUs; }
+    // Hops that ran the FFT, since construction; gated ones do not
+    uint32_t transforms() const { return _transforms; }
+
+    AutoGain& gain() { return _agc; }
+    OnsetDetector& onsets() { return _onsets; }
+    ActivityDetector& activity() { return _activity; }
+
+private:
+    void buildPipeline();
+
+    int _window = 0;
+    int _hop = 0;
+    int _rate = 0;
+    uint32_t _bandLayout = 0;               // count | scale << 16 asked for
+    uint32_t _bandsBuilt = 0;               // ... and what _bands holds
+    AudioPipeline _pipeline = AudioPipeline::FLOAT;
+    bool _pipelineReady = false;            // its buffers match the window
+    bool _gate = false;
+
+    std::vector<int32_t> _ring;             // newest `window` samples, 18 bits
+    int _ringWrite = 0;                     // oldest sample, where the next hop goes
+    uint64_t _samplePos = 0;
+
+    // Float pipeline
+    RealFFT _fft;
+    std::vector<float> _fftData;            // windowed frame in, packed spectrum out
+    std::vector<float> _fftWindow;
+
+    // Q15 pipeline
+    RealFFTQ15 _fftQ15;
+    std::vector<int16_t> _q15Data;          // block in, packed spectrum out
+    std::vector<int16_t> _q15Window;
+    std::vector<uint16_t> _q15Magnitude;
+
+    SpectrumBands _bands;
+    AutoGain _agc;
+    OnsetDetector _onsets;
+    ActivityDetector _activity;
+    float _levelsDb[SpectrumBands::MAX_BANDS] = {0};
+    AudioStageUs _stageUs;
+    uint32_t _transforms = 0;
+};
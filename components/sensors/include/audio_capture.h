@@ -0,0 +1,225 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include "event_ring.h"
+#include "triple_buffer.h"
+#include "audio_analyzer.h"
+
+// 1 = start on the fixed-point pipeline (AudioPipeline::Q15), for builds
+// where the FPU is better left to other work; setPipeline() switches
+// either way at run time
+#ifndef AUDIO_FIXED_POINT
+#define AUDIO_FIXED_POINT 0
+#endif
+
+// I2S DMA buffering for one analysis hop (see AudioCapture::dmaPlan)
+struct AudioDmaPlan {
+    int descriptors;        // dma_desc_num
+    int frames;             // dma_frame_num: samples per descriptor
+    size_t bytes;           // DMA buffer memory
+    float granularityMs;    // one descriptor: the longest a sample waits to be readable
+    float bufferedMs;       // all descriptors: how far the reader may fall behind
+};
+
+// Capture-to-render figures since the last resetStats()
+struct AudioStats {
+    uint32_t hops;          // published
+    uint32_t shown;         // taken by the render side
+    uint32_t skipped;       // published but overwritten before being taken
+    float latencyMeanMs;    // newest sample to render, per spectrum taken
+    float latencyMaxMs;
+    float processMeanUs;
+};
+
+// The microphone's level for the web API (see AudioCapture::levels()),
+// with what the analysis costs per hop in sound and in silence
+struct AudioLevels {
+    AudioLevel level;       // newest hop
+    bool gate;              // silence skips the analysis
+    bool gated;             // ... and the newest hop was skipped
+    uint32_t hops;          // since start()
+    uint32_t gatedHops;     // of which skipped
+    uint32_t transforms;    // FFTs run since start()
+    float activeUs;         // analysis per hop with sound, running mean
+    float idleUs;           // ... per hop in silence (all of it gated with the gate on)
+    float hopMs;            // time between hops: CPU share = us / (1000 * hopMs)
+};
+
+// Microphone capture and analysis, off the render loop.
+//
+// A task pinned to the core the main loop does not use (the main loop
+// shares core 0 with WiFi) blocks on I2S for one hop of samples at a
+// time and hands it to an AudioAnalyzer, which keeps the newest window of
+// them and transforms the whole window every hop, so consecutive windows
+// overlap by window - hop samples (Welch-style: 75% overlap keeps a
+// 1024-point window's resolution at a 256-sample update rate). The bar
+// levels are published through a TripleBuffer. Spectra are evenly spaced
+// in sample time and depend only on the samples, never on the render
+// rate. The render side only takes the newest spectrum and never waits
+// for audio. Should the task fail to start, the render side calls
+// capture() itself, blocking as it did before the task existed.
+//
+// Samples come from an I2S standard-mode RX channel whose DMA buffers are
+// sized from the hop (dmaPlan()): a hop's last sample becomes readable as
+// soon as its descriptor fills, with a couple of hops of slack behind it.
+// The producer opens the channel and reopens it when the hop changes;
+// stop() deletes it, handing the peripheral and its DMA memory back.
+// Screens share the microphone through acquire() and release(), so one
+// that is released in the background never stops another's capture.
+//
+// Settings are requested from any thread and applied by the producer
+// between hops. The analysis runs in float or, with AudioPipeline::Q15,
+// in integers (see fft_q15.h).
+//
+// With the gate on (setGate()), hops the activity detector calls silence
+// skip the FFT and everything after it; the spectrum screen then drops to
+// an idle animation. Levels, peak and noise floor are kept up to date
+// either way for levels().
+//
+// Onsets and beats found by the analysis are broadcast on an EventRing
+// any number of readers can follow (see BeatFollower).
+class AudioCapture {
+public:
+    static AudioCapture& instance();
+
+    static const int SAMPLE_RATE = 44100;
+    static const int MIN_WINDOW = 256;
+    static const int MAX_WINDOW = 2048;
+    static const int TASK_CORE = 1;
+    static const int TASK_PRIORITY = 5;     // above the main loop's 1
+    static const int TASK_STACK = 4096;
+
+    static const int MAX_DMA_FRAMES = 512;  // per descriptor, within the 4092-byte limit
+
+    // Starts the task, which opens the I2S channel before its first hop.
+    // Idempotent.
+    void start();
+    // Stops the task at its next DMA descriptor, dropping the hop in
+    // progress, then disables and deletes the I2S channel, releasing the
+    // peripheral and its DMA buffers. Waits for one descriptor (11.6 ms at
+    // most), or for the analysis of a hop already read.
+    void stop();
+    // Counted start() and stop() for the screens: the first acquire()
+    // starts capturing, the last release() stops it. Render loop only;
+    // stop() drops every reference.
+    void acquire();
+    void release();
+    int users() const { return _users; }
+
+    bool taskRunning() const { return _task != nullptr; }
+    // Any thread: the web server reports it
+    bool channelOpen() const { return _channelOpen; }
+
+    // DMA for `hop`: descriptors of at most MAX_DMA_FRAMES that divide the
+    // hop, two hops of them plus one
+    static AudioDmaPlan dmaPlan(int hop);
+    // Producer buffers for an analysis: one hop of raw samples, and the
+    // sample ring, FFT frame and window table of `window` words each (the
+    // float pipeline's; the Q15 one needs less)
+    static size_t analysisBytes(int window, int hop);
+
+    // Analysis for the next hop on: `window` is a power of two from
+    // MIN_WINDOW to MAX_WINDOW, `hop` divides it. A change restarts the
+    // ring, so the first spectra after it see a partly silent window.
+    static bool validAnalysis(int window, int hop);
+    bool setAnalysis(int window, int hop);
+
+    // Band layout for the next hop on; the band count is clamped to what
+    // the FFT resolves (see SpectrumBands::configure)
+    void setBands(int count, BandScale scale = BandScale::LOG);
+
+    // Pipeline for the next hop on; switching keeps the ring and the
+    // channel, the buffers of the other pipeline are freed
+    void setPipeline(AudioPipeline pipeline);
+    AudioPipeline pipeline() const { return (AudioPipeline)_pipelineRequest.load(); }
+    // The settings page's choice (AudioConfig::pipeline): 0 = the build's
+    static constexpr AudioPipeline BUILD_PIPELINE = AUDIO_FIXED_POINT ? AudioPipeline::Q15 : AudioPipeline::FLOAT;
+    static AudioPipeline pipelineSetting(uint8_t setting);
+
+    // Silence gating for the next hop on (see AudioAnalyzer::setGate)
+    void setGate(bool on) { _gateRequest = on; }
+    bool gate() const { return _gateRequest; }
+
+    // Producer: reads one hop (blocking) and publishes its spectrum.
+    // Does nothing before start().
+    void capture();
+
+    // Consumer: the newest spectrum, nullptr before the first. Takes the
+    // timestamp of a spectrum seen for the first time as its latency.
+    const AudioSpectrum* latest();
+
+    AudioStats stats() const;
+    void resetStats();
+
+    // Newest level and the gate's figures, for one reader other than the
+    // render side (the web server); they stay as they were while stopped
+    const AudioLevels& levels();
+
+    // Onset and beat events: start from eventCursor(), then take events
+    // with nextEvent() until it returns false. Any thread, any number of
+    // readers, each with its own cursor.
+    static const int EVENT_SLOTS = 16;
+    uint32_t eventCursor() const { return _events.head(); }
+    bool nextEvent(uint32_t& cursor, AudioEvent& event) const { return _events.poll(cursor, event); }
+
+private:
+    AudioCapture() = default;
+    static void taskMain(void* arg);
+    void produce(const std::atomic<bool>* run);
+    bool applyRequests();
+    bool openChannel();
+    void closeChannel();
+    void publishLevels(const AudioSpectrum& s);
+
+    TripleBuffer<AudioSpectrum> _spectra;
+    std::atomic<uint32_t> _analysisRequest{1024 | 256 << 16};  // window | hop << 16
+    std::atomic<uint8_t> _pipelineRequest{(uint8_t)BUILD_PIPELINE};
+    std::atomic<uint32_t> _bandRequest{16};     // count | scale << 16
+    std::atomic<bool> _gateRequest{false};
+    AudioAnalyzer _analyzer;                // producer's
+    EventRing<AudioEvent, EVENT_SLOTS> _events;
+    TripleBuffer<AudioLevels> _levels;
+    AudioLevels _levelStats = {};           // producer's running figures
+    uint32_t _transformsAtStart = 0;
+    uint32_t _seq = 0;
+    std::atomic<bool> _run{false};
+    std::atomic<bool> _exited{true};
+    std::atomic<bool> _channelOpen{false};
+    void* _task = nullptr;
+    bool _started = false;
+    int _users = 0;                         // acquire()s not yet released
+
+    // Consumer's
+    uint32_t _lastSeq = 0;
+    uint32_t _firstSeq = 0;
+    uint32_t _shown = 0;
+    double _latencySumUs = 0.0;
+    int64_t _latencyMaxUs = 0;
+    double _processSumUs = 0.0;
+};
+
+// A screen's view of the beats: begin() when the screen is entered, then
+// update() once a frame. pulse() jumps to 1 on each beat and decays, for
+// anything that should throb with the music.
+class BeatFollower {
+public:
+    float pulseS = 0.15f;           // pulse() decay time constant
+
+    void begin();
+    // Takes the events since the last call; returns how many were beats
+    int update(float dt);
+
+    float pulse() const { return _pulse; }
+    float bpm() const { return _bpm; }
+    float strength() const { return _strength; }    // of the last beat
+    float sinceBeatS() const { return _sinceBeat; }
+
+private:
+    uint32_t _cursor = 0;
+    float _pulse = 0.0f;
+    float _bpm = 0.0f;
+    float _strength = 0.0f;
+    float _sinceBeat = 1e9f;
+};
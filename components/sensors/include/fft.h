@@ -0,0 +1,62 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+// FFT of real input.
+//
+// The N real samples are read as N/2 complex values (even samples real,
+// odd samples imaginary), transformed with an N/2-point complex radix-2
+// FFT, and split into the N/2 + 1 bins of the real spectrum. That is half
+// the work of a complex FFT over zero-padded imaginary parts.
+//
+// Twiddle factors come from tables computed once per size in double
+// precision, not from a recurrence, so the error does not grow with N.
+//
+// With ESP-DSP available (ESP32-S3 builds) the complex stage runs on its
+// assembly kernels (dsps_fft2r_fc32, using the S3's vector unit); host
+// builds and FftBackend::SCALAR use the portable C++ kernel.
+//
+// The result is unnormalized, as a plain DFT, and packed in place:
+//   data[0] = X[0] (real), data[1] = X[N/2] (real, Nyquist),
+//   data[2k], data[2k + 1] = Re, Im of X[k] for 0 < k < N/2
+
+enum class FftBackend : uint8_t {
+    SCALAR,
+    ESP_DSP
+};
+
+class RealFFT {
+public:
+    // `n` is a power of two, 8 to 4096. Rebuilds the tables on size change.
+    bool init(int n);
+    int size() const { return _n; }
+
+    // ESP_DSP falls back to SCALAR when the library is not linked in
+    void setBackend(FftBackend backend);
+    FftBackend backend() const { return _backend; }
+    static bool hasEspDsp();
+
+    // In place: n real samples in, packed spectrum out (see above)
+    void forward(float* data) const;
+
+    // |X[k]| for 0 <= k < n/2 from a packed spectrum
+    static float magnitude(const float* spectrum, int k)
+    {
+        if (k == 0) return fabsf(spectrum[0]);
+        float re = spectrum[2 * k];
+        float im = spectrum[2 * k + 1];
+        return sqrtf(re * re + im * im);
+    }
+
+private:
+    void complexScalar(float* data) const;
+    void split(float* data) const;
+
+    int _n = 0;
+    FftBackend _backend = FftBackend::ESP_DSP;
+    std::vector<float> _twiddle;        // exp(-2 pi i k / (n/2)), k < n/4, interleaved
+    std::vector<float> _split;          // exp(-2 pi i k / n), k <= n/4, interleaved
+    std::vector<uint16_t> _swaps;       // bit-reversal pairs for the n/2-point stage
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+// Fixed-point counterpart of RealFFT (fft.h) for targets and modes where
+// the FPU is busy elsewhere: every per-sample and per-bin step is integer.
+//
+// Data is Q15 (int16) with one exponent for the whole block: the value of
+// element i is data[i] * 2^exponent. Before each radix-2 stage, and before
+// the split into the real spectrum, the block is shifted right just enough
+// that the stage cannot overflow (a butterfly can grow a component by
+// 1 + sqrt(2)), and the shift is added to the exponent. Stages track the
+// peak they write, so the check costs no extra pass, and quiet input is
+// shifted up into the full 16 bits before the first stage (negative
+// exponent), so precision follows the signal rather than full scale.
+//
+// Same real-input scheme and packed layout as RealFFT: data[0] = X[0],
+// data[1] = X[N/2], data[2k], data[2k + 1] = Re, Im of X[k]; unnormalized,
+// times 2^exponent.
+
+// Q15 helpers
+static const int Q15_ONE = 32767;
+
+// Rounded (a * b) >> 15 for Q15 values held in int32
+static inline int32_t q15_mul(int32_t a, int32_t b)
+{
+    return (a * b + (1 << 14)) >> 15;
+}
+
+// |re + i im| ~ alpha * max + beta * min, alpha = 0.96043, beta = 0.39782:
+// within 4% of the true magnitude at any angle, no square root
+static const int32_t MAG_ALPHA_Q15 = 31471;
+static const int32_t MAG_BETA_Q15 = 13036;
+
+static inline uint32_t q15_magnitude(int32_t re, int32_t im)
+{
+    uint32_t a = (uint32_t)abs(re);
+    uint32_t b = (uint32_t)abs(im);
+    if (a < b) {
+        uint32_t t = a;
+        a = b;
+        b = t;
+    }
+    return (a * MAG_ALPHA_Q15 + b * MAG_BETA_Q15 + (1 << 14)) >> 15;
+}
+
+class RealFFTQ15 {
+public:
+    // `n` is a power of two, 8 to 4096. Rebuilds the tables on size change.
+    bool init(int n);
+    int size() const { return _n; }
+
+    // Hann window in Q15, the same curve as the float path's
+    static void hannWindow(std::vector<int16_t>& window, int n);
+
+    // The n samples of `ring`, oldest (at `oldest`) first, times a Q15
+    // window into the block, scaled to fill it; returns the block exponent
+    // (samples * window = data * 2^exponent). Samples must fit in 24 bits.
+    int load(int16_t* data, const int32_t* ring, int oldest, const int16_t* window) const;
+
+    // In place, n Q15 samples in, packed spectrum out; returns the shift
+    // added to the block exponent
+    int forward(int16_t* data) const;
+
+    // |X[k]| for 0 <= k < n/2 by alpha-max-plus-beta-min, same exponent
+    void magnitudes(const int16_t* spectrum, uint16_t* mag) const;
+
+private:
+    int _n = 0;
+    std::vector<int16_t> _twiddle;      // exp(-2 pi i k / (n/2)), k < n/4, interleaved Q15
+    std::vector<int16_t> _split;        // exp(-2 pi i k / n), k <= n/4, interleaved Q15
+    std::vector<uint16_t> _swaps;       // bit-reversal pairs for the n/2-point stage
+};
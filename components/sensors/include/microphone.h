@@ -2,8 +2,22 @@
 
 class LEDMatrix;
 
-// Initialise mic (will just ensure I2S is set up)
-void mic_start();
+// Take a reference to the microphone: the first one starts capturing,
+// and the capture task opens the I2S channel on its first hop
+void mic_acquire();
 
-// Draw the FFT spectrum into the given matrix
-void draw_fft_visual(LEDMatrix& matrix);
+// Give back a reference taken with mic_acquire(); the last one stops
+// capturing and releases the I2S peripheral and its DMA buffers
+void mic_release();
+
+// Spectrum bars drawn on a panel `width` columns wide
+int mic_bars_for_width(int width);
+
+// Draw the FFT spectrum into the given matrix; dt drives the bar smoothing.
+// Returns false without drawing once the capture gates silence and the
+// bars have fallen: the frame is left as it was, for draw_idle_visual().
+bool draw_fft_visual(LEDMatrix& matrix, float dt);
+
+// Silence: a dim wave drifting along the bars' baseline, `t` seconds in.
+// Meant to be drawn a few times a second, not every frame.
+void draw_idle_visual(LEDMatrix& matrix, float t);
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+#include "spectrum_bands.h"
+
+static const uint8_t AUDIO_ONSET = 1 << 0;
+static const uint8_t AUDIO_BEAT = 1 << 1;
+
+// One detected onset, as published to subscribers (see AudioCapture)
+struct AudioEvent {
+    uint8_t flags;          // AUDIO_ONSET, plus AUDIO_BEAT when it falls on the beat
+    float strength;         // novelty over the threshold: 1 = just detected
+    float bpm;              // tempo estimate at the time, 0 = none yet
+    uint64_t sample;        // stream position of the onset
+    int64_t timeUs;         // esp_timer time that sample was captured
+};
+
+// Onsets, beats and tempo from the analysis spectra, one hop at a time.
+//
+// Novelty is log-filterbank spectral flux: the summed rise, in dB, of
+// BANDS log-spaced bands against the frame about half a window earlier
+// (so heavily overlapped frames do not dilute it), averaged over the
+// bands. An onset is a local maximum of the novelty above an adaptive
+// threshold, a margin over its running mean and mean deviation; peak
+// picking looks one hop ahead, so events come one hop late.
+//
+// Tempo comes from inter-onset intervals: each onset votes for the
+// intervals to the few before it, folded into one octave of tempo
+// (MIN_BPM..2 * MIN_BPM), in a histogram that decays over a few seconds.
+// An onset is also a beat when it lands on the grid the previous beat
+// and the tempo predict, or when the grid has been lost.
+//
+// The work per hop is fixed: one pass over the bins in range and BANDS
+// logs for the filterbank, O(BANDS) for the flux, and on an onset
+// IOI_HISTORY votes and one pass over the TEMPO_BINS histogram.
+class OnsetDetector {
+public:
+    static const int BANDS = 24;
+    static const int MAX_LAG = 8;           // hops the flux reaches back, at most
+    static const int IOI_HISTORY = 8;       // earlier onsets each onset votes against
+    static const int MIN_BPM = 80;
+    static const int TEMPO_BINS = MIN_BPM;  // one per BPM up to 2 * MIN_BPM
+    static const int BUDGET_US = 100;       // per hop on the ESP32-S3, under 2% of the core at hop 256
+
+    float thresholdDb = 1.0f;       // novelty margin over the running mean
+    float thresholdDev = 1.5f;      // ... plus this many mean deviations
+    float averageS = 1.0f;          // running mean and deviation time constant
+    float minIntervalS = 0.07f;     // refractory time between onsets
+    float tempoDecayS = 4.0f;       // tempo histogram memory
+    float beatTolerance = 0.15f;    // of a period, either side of the grid
+
+    void configure(int window, int hop, int sampleRate);
+    void reset();
+
+    // One hop's packed spectrum; `sample` is the stream position just
+    // after its newest sample, captured at `timeUs`. True with `event`
+    // filled when the previous hop was an onset.
+    bool process(const float* spectrum, uint64_t sample, int64_t timeUs, AudioEvent& event);
+
+    // The same from the fixed-point path's bin magnitudes (see fft_q15.h)
+    bool process(const uint16_t* magnitude, int exponent, uint64_t sample, int64_t timeUs, AudioEvent& event);
+
+    float novelty() const { return _novelty[0]; }
+    float threshold() const { return _mean + thresholdDb + thresholdDev * _dev; }
+    float bpm() const { return _bpm; }
+
+private:
+    bool detect(uint64_t sample, int64_t timeUs, AudioEvent& event);
+    void vote(double t, float strength);
+    bool onBeat(double t, float strength);
+
+    SpectrumBands _bands;
+    int _window = 0;
+    int _hop = 0;
+    int _rate = 0;
+    int _lag = 1;
+    float _dt = 0.0f;
+    float _alpha = 0.0f;                    // running average coefficient per hop
+
+    float _frames[MAX_LAG + 1][BANDS];      // band dB, ring of the last lag + 1 hops
+    int _frame = 0;
+    int _framesSeen = 0;
+    float _novelty[3] = {0, 0, 0};          // this hop, one and two hops back
+    float _threshold1 = 0.0f;               // threshold when the hop one back arrived
+    float _mean = 0.0f;
+    float _dev = 0.0f;
+
+    double _onsets[IOI_HISTORY];            // seconds, ring of the latest onsets
+    int _onsetCount = 0;
+    double _lastOnset = -1.0;
+    float _tempo[TEMPO_BINS];
+    float _bpm = 0.0f;
+    double _lastBeat = -1.0;
+    float _gridStrength = 0.0f;             // average strength of onsets on the beat grid
+    float _offStrength = 0.0f;              // ... and off it
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+// Time the audio DSP on the target: microseconds per real FFT at 256, 512
+// and 1024 points for each backend, its error against a double-precision
+// DFT, and the capture task's hop rate and capture-to-render latency
+void sensor_bench_run_all();
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// Frequency axis of the spectrum bars
+enum class BandScale : uint8_t {
+    LOG,        // equal width per octave
+    MEL         // linear below ~1 kHz, logarithmic above: closer to pitch perception
+};
+
+// Bin-to-band map for a packed real spectrum (see fft.h).
+//
+// Band edges are spaced on the chosen scale between fMin and fMax, then
+// snapped to FFT bins with at least one bin per band, so the bass end,
+// where bands are narrower than a bin, degrades to one bin per band
+// instead of leaving bars empty. process() is then one pass over the bins
+// in range, adding each bin's power to the band the table names, and one
+// log per band. The fixed-point variant sums in integers.
+class SpectrumBands {
+public:
+    static const int MAX_BANDS = 128;
+
+    // Returns the band count actually used: at most `bands`, MAX_BANDS
+    // and the number of bins between fMin and fMax
+    int configure(int bands, int fftSize, int sampleRate, BandScale scale = BandScale::LOG,
+                  float fMin = 60.0f, float fMax = 16000.0f);
+
+    int count() const { return _count; }
+    int firstBin() const { return _firstBin; }
+    int lastBin() const { return _lastBin; }         // inclusive
+    int bandOf(int bin) const { return _bandOf[bin - _firstBin]; }
+
+    // Lowest bin of band b; edge(count()) is lastBin() + 1
+    int edge(int band) const { return _edges[band]; }
+
+    // Band energies in dB relative to a full-scale sine (dBFS), from a
+    // packed spectrum of samples scaled to +-fullScale and Hann windowed
+    void process(const float* spectrum, float* bandDb) const;
+
+    // The same from bin magnitudes of the fixed-point path (see
+    // fft_q15.h): the true magnitude of bin k is magnitude[k] * 2^exponent
+    void process(const uint16_t* magnitude, int exponent, float* bandDb) const;
+
+    float fullScale = 131072.0f;    // microphone samples after >> 14
+
+private:
+    int _count = 0;
+    int _firstBin = 1;
+    int _lastBin = 0;
+    float _refPower = 1.0f;         // power of a full-scale sine's bins
+    std::vector<uint8_t> _bandOf;   // per bin from _firstBin
+    std::vector<uint8_t> _powerShift;   // per band: squares are shifted so the sum fits 32 bits
+    std::vector<uint16_t> _edges;
+};
+
+// Automatic gain: maps band levels in dBFS to 0..1 bar heights against a
+// reference that follows the loudest band, quickly up (attack) and slowly
+// down (release). The reference never drops below floorDb, so a quiet
+// room stays low instead of being amplified to full scale.
+class AutoGain {
+public:
+    float attackS = 0.05f;
+    float releaseS = 3.0f;
+    float rangeDb = 40.0f;          // bar height 0..1 spans reference - range..reference
+    float floorDb = -50.0f;         // lowest reference, dBFS
+
+    // In place, dB in, 0..1 out; dt is the time since the previous call
+    void process(float* levels, int count, float dt);
+
+    float referenceDb() const { return _refDb; }
+    void reset() { _refDb = floorDb; }
+
+private:
+    float _refDb = -50.0f;
+};
+
+// Bar heights following the levels: fast rise, slower fall, at any frame
+// time. Runs on the render side once a frame, between spectra too.
+class BarSmoother {
+public:
+    float riseS = 0.014f;
+    float fallS = 0.075f;
+
+    // Towards `target` over dt; a new band count restarts from zero
+    void process(const float* target, int count, float dt);
+
+    const float* levels() const { return _levels; }
+    int count() const { return _count; }
+
+private:
+    float _levels[SpectrumBands::MAX_BANDS] = {0};
+    int _count = 0;
+};
@@ -0,0 +1,227 @@
+#include "onset_detector.h"
+#include <math.h>
+#include <string.h>
+
+static const float FLOOR_DB = -80.0f;       // bands quieter than this count as silence
+static const float MIN_TEMPO_VOTES = 2.0f;  // histogram peak before a tempo is reported
+static const double MAX_IOI_S = 2.0;        // longest interval that votes
+static const float GRID_SMOOTHING = 0.3f;   // per onset, on- and off-grid strength averages
+static const float GRID_SWITCH = 1.5f;      // off-grid over on-grid strength that moves the grid
+
+// Where in its window a detected onset sits, as a fraction of the window
+// back from the newest sample: the flux against the frame half a window
+// earlier peaks while the attack is a little past the window's middle
+static const float ONSET_POSITION = 0.5f;
+
+// -----------------------------------------------------
+// Setup
+// -----------------------------------------------------
+void OnsetDetector::configure(int window, int hop, int sampleRate)
+{
+    _window = window;
+    _hop = hop;
+    _rate = sampleRate;
+    _bands.configure(BANDS, window, sampleRate, BandScale::LOG, 40.0f, 16000.0f);
+
+    _lag = (int)lroundf((float)window / 2 / hop);
+    if (_lag < 1) _lag = 1;
+    if (_lag > MAX_LAG) _lag = MAX_LAG;
+
+    _dt = (float)hop / sampleRate;
+    _alpha = 1.0f - expf(-_dt / averageS);
+    reset();
+}
+
+void OnsetDetector::reset()
+{
+    for (auto& f : _frames)
+        for (float& v : f) v = FLOOR_DB;
+    _frame = 0;
+    _framesSeen = 0;
+    _novelty[0] = _novelty[1] = _novelty[2] = 0.0f;
+    _threshold1 = 0.0f;
+    _mean = 0.0f;
+    _dev = 0.0f;
+
+    _onsetCount = 0;
+    _lastOnset = -1.0;
+    memset(_tempo, 0, sizeof(_tempo));
+    _bpm = 0.0f;
+    _lastBeat = -1.0;
+}
+
+// -----------------------------------------------------
+// Novelty and peak picking
+// -----------------------------------------------------
+bool OnsetDetector::process(const float* spectrum, uint64_t sample, int64_t timeUs, AudioEvent& event)
+{
+    if (_window == 0) return false;
+    _frame = (_frame + 1) % (MAX_LAG + 1);
+    _bands.process(spectrum, _frames[_frame]);
+    return detect(sample, timeUs, event);
+}
+
+bool OnsetDetector::process(const uint16_t* magnitude, int exponent, uint64_t sample, int64_t timeUs,
+                            AudioEvent& event)
+{
+    if (_window == 0) return false;
+    _frame = (_frame + 1) % (MAX_LAG + 1);
+    _bands.process(magnitude, exponent, _frames[_frame]);
+    return detect(sample, timeUs, event);
+}
+
+bool OnsetDetector::detect(uint64_t sample, int64_t timeUs, AudioEvent& event)
+{
+    // Band levels in the ring, floored so silence does not flicker
+    float* now = _frames[_frame];
+    const int bands = _bands.count();
+    for (int b = 0; b < bands; ++b)
+        if (now[b] < FLOOR_DB) now[b] = FLOOR_DB;
+
+    // Rise against the loudest of each band and its neighbours `_lag` hops
+    // back, so noise and vibrato moving between bands do not count;
+    // nothing until the ring reaches that far
+    const float* then = _frames[(_frame + MAX_LAG + 1 - _lag) % (MAX_LAG + 1)];
+    float flux = 0.0f;
+    for (int b = 0; b < bands; ++b) {
+        float ref = then[b];
+        if (b > 0 && then[b - 1] > ref) ref = then[b - 1];
+        if (b + 1 < bands && then[b + 1] > ref) ref = then[b + 1];
+        float d = now[b] - ref;
+        if (d > 0.0f) flux += d;
+    }
+    flux = _framesSeen >= _lag ? flux / bands : 0.0f;
+    if (_framesSeen * _alpha < 1.0f) _framesSeen++;       // counts up to the end of settling
+
+    _novelty[2] = _novelty[1];
+    _novelty[1] = _novelty[0];
+    _novelty[0] = flux;
+
+    // The hop one back is an onset if it peaks above the threshold it met
+    const float candidate = _novelty[1];
+    const float thresholdThen = _threshold1;
+    _threshold1 = threshold();
+
+    // The running statistics follow the background: onsets enter them
+    // clipped to the threshold, so a loud beat does not hide the next hits.
+    // For the first averageS they are a plain average and nothing is
+    // reported, while they settle.
+    const bool settling = _framesSeen * _alpha < 1.0f;
+    const float alpha = settling ? 1.0f / _framesSeen : _alpha;
+    const float background = settling || flux < _threshold1 ? flux : _threshold1;
+    _dev += (fabsf(background - _mean) - _dev) * alpha;
+    _mean += (background - _mean) * alpha;
+
+    if (settling) return false;
+    if (!(candidate > thresholdThen && candidate > _novelty[2] && candidate >= flux)) return false;
+
+    const uint64_t back = (uint64_t)_hop + (uint64_t)(_window * ONSET_POSITION);
+    const uint64_t at = sample > back ? sample - back : 0;
+    const double t = (double)at / _rate;
+    if (_lastOnset >= 0.0 && t - _lastOnset < minIntervalS) return false;
+    _lastOnset = t;
+
+    const float strength = thresholdThen > 0.0f ? candidate / thresholdThen : 1.0f;
+    vote(t, strength);
+
+    event.flags = AUDIO_ONSET | (onBeat(t, strength) ? AUDIO_BEAT : 0);
+    event.strength = strength;
+    event.bpm = _bpm;
+    event.sample = at;
+    event.timeUs = timeUs - (int64_t)((sample - at) * 1000000ull / _rate);
+    return true;
+}
+
+// -----------------------------------------------------
+// Tempo and beats
+// -----------------------------------------------------
+// Intervals to the earlier onsets, folded into MIN_BPM..2 * MIN_BPM and
+// spread over the neighbouring bins; nearer onsets weigh more
+void OnsetDetector::vote(double t, float strength)
+{
+    const float decay = _onsetCount ? expf(-(float)(t - _onsets[(_onsetCount - 1) % IOI_HISTORY]) / tempoDecayS)
+                                    : 1.0f;
+    float peak = 0.0f;
+    int best = 0;
+    for (int i = 0; i < TEMPO_BINS; ++i) _tempo[i] *= decay;
+
+    const int earlier = _onsetCount < IOI_HISTORY ? _onsetCount : IOI_HISTORY;
+    const float w = strength > 3.0f ? 3.0f : strength;
+    for (int k = 1; k <= earlier; ++k) {
+        const double interval = t - _onsets[(_onsetCount - k) % IOI_HISTORY];
+        if (interval <= 0.0 || interval > MAX_IOI_S) continue;
+        float bpm = (float)(60.0 / interval);
+        while (bpm < MIN_BPM) bpm *= 2.0f;
+        while (bpm >= 2 * MIN_BPM) bpm *= 0.5f;
+
+        // Triangle two bins wide either side
+        const float pos = bpm - MIN_BPM;
+        const float weight = w / k;
+        const int lo = (int)floorf(pos) - 1;
+        for (int i = lo; i <= lo + 3; ++i) {
+            float v = weight * (1.0f - fabsf(i - pos) * 0.5f);
+            if (v > 0.0f) _tempo[(i + TEMPO_BINS) % TEMPO_BINS] += v;
+        }
+    }
+
+    _onsets[_onsetCount % IOI_HISTORY] = t;
+    _onsetCount++;
+
+    for (int i = 0; i < TEMPO_BINS; ++i)
+        if (_tempo[i] > peak) {
+            peak = _tempo[i];
+            best = i;
+        }
+    if (peak < MIN_TEMPO_VOTES) {
+        _bpm = 0.0f;
+        return;
+    }
+
+    // Parabola through the peak and its neighbours (the axis wraps an octave)
+    const float l = _tempo[(best + TEMPO_BINS - 1) % TEMPO_BINS];
+    const float r = _tempo[(best + 1) % TEMPO_BINS];
+    const float den = l - 2.0f * peak + r;
+    const float offset = den < 0.0f ? 0.5f * (l - r) / den : 0.0f;
+    _bpm = MIN_BPM + best + offset;
+    if (_bpm < MIN_BPM) _bpm += MIN_BPM;
+    if (_bpm >= 2 * MIN_BPM) _bpm -= MIN_BPM;
+}
+
+// On the grid from the last beat at the current tempo, or the first onset
+// after the grid was lost (or before there is a tempo). Onsets off the grid
+// keep their own average strength; when they are clearly stronger than
+// the ones on it (the grid locked onto off-beats) the grid moves to them.
+bool OnsetDetector::onBeat(double t, float strength)
+{
+    if (_lastBeat < 0.0 || _bpm <= 0.0f) {
+        _lastBeat = t;
+        _gridStrength = strength;
+        _offStrength = 0.0f;
+        return true;
+    }
+
+    const double period = 60.0 / _bpm;
+    const double since = t - _lastBeat;
+    const double n = floor(since / period + 0.5);
+    if (n >= 1.0 && fabs(since - n * period) <= beatTolerance * period) {
+        _gridStrength += (strength - _gridStrength) * GRID_SMOOTHING;
+        _lastBeat = t;
+        return true;
+    }
+    if (since > 2.5 * period) {
+        _lastBeat = t;
+        _gridStrength = strength;
+        _offStrength = 0.0f;
+        return true;
+    }
+
+    _offStrength += (strength - _offStrength) * GRID_SMOOTHING;
+    if (_offStrength > GRID_SWITCH * _gridStrength) {
+        const float s = _gridStrength;
+        _gridStrength = _offStrength;
+        _offStrength = s;
+        _lastBeat = t;
+        return true;
+    }
+    return false;
+}
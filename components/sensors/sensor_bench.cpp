@@ -0,0 +1,247 @@
+#include "sensor_bench.h"
+#include "fft.h"
+#include "audio_capture.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <esp_log.h>
+#include <math.h>
+#include <vector>
+
+static const char* TAG = "SensorBench";
+
+static const int BENCH_REPS = 200;
+
+// Windowed sines over noise, scaled like the microphone's samples
+static void fillSignal(std::vector<float>& x)
+{
+    const int n = (int)x.size();
+    uint32_t seed = 41;
+    for (int i = 0; i < n; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        float t = (float)i / n;
+        float v = 300.0f * sinf(2.0f * (float)M_PI * 5.0f * t) +
+                  120.0f * sinf(2.0f * (float)M_PI * (n / 7.3f) * t) + (float)((int)(seed % 64) - 32);
+        x[i] = v * 0.5f * (1.0f - cosf(2.0f * (float)M_PI * i / (n - 1)));
+    }
+}
+
+// Worst bin error relative to the largest bin of a double-precision DFT
+static double maxError(const std::vector<float>& x, const std::vector<float>& packed)
+{
+    const int n = (int)x.size();
+    double peak = 0.0, worst = 0.0;
+    for (int k = 0; k <= n / 2; ++k) {
+        double re = 0.0, im = 0.0;
+        for (int i = 0; i < n; ++i) {
+            double a = 2.0 * M_PI * (double)(((long long)k * i) % n) / n;
+            re += x[i] * cos(a);
+            im -= x[i] * sin(a);
+        }
+        double r, j;
+        if (k == 0) { r = packed[0]; j = 0.0; }
+        else if (k == n / 2) { r = packed[1]; j = 0.0; }
+        else { r = packed[2 * k]; j = packed[2 * k + 1]; }
+        peak = fmax(peak, hypot(re, im));
+        worst = fmax(worst, hypot(r - re, j - im));
+    }
+    return worst / peak;
+}
+
+static void bench_fft()
+{
+    const int sizes[] = {256, 512, 1024};
+    const FftBackend backends[] = {FftBackend::SCALAR, FftBackend::ESP_DSP};
+    const char* names[] = {"scalar", "ESP-DSP"};
+
+    for (int n : sizes) {
+        RealFFT fft;
+        fft.init(n);
+        std::vector<float> x(n), data(n);
+        fillSignal(x);
+
+        for (int b = 0; b < 2; ++b) {
+            if (backends[b] == FftBackend::ESP_DSP && !RealFFT::hasEspDsp()) continue;
+            fft.setBackend(backends[b]);
+
+            data = x;
+            fft.forward(data.data());       // also initializes the backend
+            double err = maxError(x, data);
+
+            int64_t t0 = esp_timer_get_time();
+            for (int r = 0; r < BENCH_REPS; ++r) {
+                data = x;
+                fft.forward(data.data());
+            }
+            int64_t us = esp_timer_get_time() - t0;
+
+            ESP_LOGI(TAG, "Real FFT %4d points, %-7s: %.1f us per transform, max error %.2e",
+                     n, names[b], (double)us / BENCH_REPS, err);
+        }
+    }
+}
+
+// Capture task against a 60 FPS reader, as SpectrumScreen reads it
+static void bench_capture()
+{
+    AudioCapture& capture = AudioCapture::instance();
+    capture.start();
+    if (!capture.taskRunning()) {
+        ESP_LOGW(TAG, "Capture task not running");
+        return;
+    }
+    capture.latest();
+    capture.resetStats();
+
+    int64_t t0 = esp_timer_get_time();
+    int64_t readUs = 0;
+    const int frames = 180;
+    for (int n = 0; n < frames; ++n) {
+        vTaskDelay(pdMS_TO_TICKS(16));
+        int64_t r0 = esp_timer_get_time();
+        capture.latest();
+        readUs += esp_timer_get_time() - r0;
+    }
+    float seconds = (esp_timer_get_time() - t0) * 1e-6f;
+
+    AudioStats st = capture.stats();
+    ESP_LOGI(TAG, "Capture task: %u hops in %.1f s (%.1f/s), %u shown, %u skipped, DSP %.0f us per hop",
+             (unsigned)st.hops, seconds, st.hops / seconds, (unsigned)st.shown, (unsigned)st.skipped,
+             st.processMeanUs);
+    ESP_LOGI(TAG, "Capture to render: mean %.2f ms, max %.2f ms after the read returns; reader %.1f us per frame",
+             st.latencyMeanMs, st.latencyMaxMs, (double)readUs / frames);
+}
+
+// DSP load of the capture task at each window and overlap (every hop is
+// taken, so processMeanUs covers them all), and the memory and latency of
+// the DMA sized for its hop. The capture restarts for each setting so the
+// heap shows what a running microphone holds.
+static void bench_analysis()
+{
+    static const int settings[][2] = {{256, 0}, {512, 0}, {512, 50}, {1024, 0}, {1024, 50},
+                                      {1024, 75}, {2048, 50}, {2048, 75}};
+    AudioCapture& capture = AudioCapture::instance();
+    if (!capture.taskRunning()) return;
+
+    for (const auto& st : settings) {
+        const int window = st[0], hop = window * (100 - st[1]) / 100;
+        capture.stop();
+        const size_t heapBefore = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+        capture.setAnalysis(window, hop);
+        capture.start();
+        vTaskDelay(pdMS_TO_TICKS(100));
+        const int heapDelta = (int)heapBefore - (int)heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+        capture.latest();
+        capture.resetStats();
+        uint32_t onsetMaxUs = 0;
+        for (int n = 0; n < 500; ++n) {
+            vTaskDelay(1);
+            const AudioSpectrum* s = capture.latest();
+            if (s && s->onsetUs > onsetMaxUs) onsetMaxUs = s->onsetUs;
+        }
+        AudioStats as = capture.stats();
+        const float rate = (float)AudioCapture::SAMPLE_RATE / hop;
+        const AudioDmaPlan plan = AudioCapture::dmaPlan(hop);
+        ESP_LOGI(TAG, "Analysis %4d/%2d%% (hop %4d, %5.1f spectra/s): DSP %5.0f us per hop, %5.2f%% of core %d",
+                 window, st[1], hop, rate, as.processMeanUs, as.processMeanUs * rate / 1e4f, AudioCapture::TASK_CORE);
+        ESP_LOGI(TAG, "  DMA %d x %d (%u bytes, %.2f ms granularity), buffers %u bytes, %d bytes of heap in use; "
+                 "read to render %.2f ms mean, %.2f ms max",
+                 plan.descriptors, plan.frames, (unsigned)plan.bytes, plan.granularityMs,
+                 (unsigned)AudioCapture::analysisBytes(window, hop), heapDelta, as.latencyMeanMs, as.latencyMaxMs);
+        ESP_LOGI(TAG, "  Onset detection %u us worst per hop (budget %d us)", (unsigned)onsetMaxUs,
+                 OnsetDetector::BUDGET_US);
+    }
+    capture.setAnalysis(1024, 256);
+
+    // Back to no microphone: the heap should get the channel and DMA back
+    const size_t heapOn = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    capture.stop();
+    ESP_LOGI(TAG, "Capture stopped: %u bytes of internal heap returned",
+             (unsigned)(heap_caps_get_free_size(MALLOC_CAP_INTERNAL) - heapOn));
+}
+
+// DSP per hop on the float and the Q15 pipeline, same analysis and input.
+// Accuracy against the float path is what `led_matrix_sim q15` reports.
+static void bench_pipelines()
+{
+    static const int windows[] = {512, 1024, 2048};
+    static const AudioPipeline pipelines[] = {AudioPipeline::FLOAT, AudioPipeline::Q15};
+    static const char* names[] = {"float", "Q15"};
+    AudioCapture& capture = AudioCapture::instance();
+    capture.start();
+    if (!capture.taskRunning()) return;
+
+    for (int window : windows) {
+        float us[2];
+        for (int p = 0; p < 2; ++p) {
+            capture.setAnalysis(window, window / 4);
+            capture.setPipeline(pipelines[p]);
+            vTaskDelay(pdMS_TO_TICKS(100));
+            capture.latest();
+            capture.resetStats();
+            for (int n = 0; n < 300; ++n) {
+                vTaskDelay(1);
+                capture.latest();
+            }
+            us[p] = capture.stats().processMeanUs;
+        }
+        ESP_LOGI(TAG, "Pipeline %4d/75%%: %s %5.0f us per hop, %s %5.0f us per hop (%.2fx)",
+                 window, names[0], us[0], names[1], us[1], us[0] / us[1]);
+    }
+    capture.setPipeline(AudioCapture::BUILD_PIPELINE);
+    capture.setAnalysis(1024, 256);
+}
+
+// The silence gate: one hop of silence and of a tone through the analysis
+// with the gate off and on, 1024/256, the build's pipeline. The hold
+// after a reset runs out first, so gated hops are measured as they run.
+static void bench_gate()
+{
+    const int window = 1024, hop = 256;
+    std::vector<int32_t> silence(hop, 0), tone(hop);
+    AudioAnalyzer analyzer;
+    analyzer.configure(window, hop, AudioCapture::SAMPLE_RATE);
+    analyzer.setBands(64);
+    analyzer.setPipeline(AudioCapture::BUILD_PIPELINE);
+    AudioSpectrum out;
+    AudioEvent event;
+
+    float us[2][2];     // [gate][tone]
+    for (int gate = 0; gate < 2; ++gate) {
+        analyzer.setGate(gate);
+        for (int t = 0; t < 2; ++t) {
+            analyzer.reset();
+            const int settle = (int)(analyzer.activity().holdS * AudioCapture::SAMPLE_RATE / hop) + 2;
+            int64_t total = 0;
+            for (int n = 0; n < settle + BENCH_REPS; ++n) {
+                if (t) {
+                    for (int i = 0; i < hop; ++i)
+                        tone[i] = (int32_t)(0x7FFFFF * 0.25f * sinf(2.0f * (float)M_PI * 1000.0f * (n * hop + i) /
+                                                                     AudioCapture::SAMPLE_RATE)) * 256;
+                }
+                int64_t t0 = esp_timer_get_time();
+                analyzer.process(t ? tone.data() : silence.data(), t0, out, event);
+                if (n >= settle) total += esp_timer_get_time() - t0;
+            }
+            us[gate][t] = (float)total / BENCH_REPS;
+        }
+    }
+    const float hopsPerS = (float)AudioCapture::SAMPLE_RATE / hop;
+    ESP_LOGI(TAG, "Gate off: tone %5.1f us per hop, silence %5.1f us per hop (%.2f%% of a core)",
+             us[0][1], us[0][0], us[0][0] * hopsPerS / 1e4f);
+    ESP_LOGI(TAG, "Gate on:  tone %5.1f us per hop, silence %5.1f us per hop (%.2f%% of a core), %.0f%% saved in silence",
+             us[1][1], us[1][0], us[1][0] * hopsPerS / 1e4f, 100.0f * (1.0f - us[1][0] / us[0][0]));
+}
+
+void sensor_bench_run_all()
+{
+    ESP_LOGI(TAG, "=== Sensor benchmark ===");
+    bench_fft();
+    bench_capture();
+    bench_pipelines();
+    bench_gate();
+    bench_analysis();
+}
@@ -0,0 +1,139 @@
+#include "spectrum_bands.h"
+#include <math.h>
+
+static double toScale(double hz, BandScale scale)
+{
+    return scale == BandScale::MEL ? 2595.0 * log10(1.0 + hz / 700.0) : log(hz);
+}
+
+static double fromScale(double v, BandScale scale)
+{
+    return scale == BandScale::MEL ? 700.0 * (pow(10.0, v / 2595.0) - 1.0) : exp(v);
+}
+
+// -----------------------------------------------------
+// Band map
+// -----------------------------------------------------
+int SpectrumBands::configure(int bands, int fftSize, int sampleRate, BandScale scale, float fMin, float fMax)
+{
+    const double binHz = (double)sampleRate / fftSize;
+    const int nyquist = fftSize / 2;
+
+    // Bins whose centers fall inside fMin..fMax; never DC or Nyquist,
+    // which the packed spectrum stores without phase
+    _firstBin = (int)ceil(fMin / binHz);
+    if (_firstBin < 1) _firstBin = 1;
+    _lastBin = (int)floor(fMax / binHz);
+    if (_lastBin > nyquist - 1) _lastBin = nyquist - 1;
+    const int bins = _lastBin - _firstBin + 1;
+
+    if (bands > MAX_BANDS) bands = MAX_BANDS;
+    if (bands > bins) bands = bins;
+    if (bands < 1) bands = 1;
+    _count = bands;
+
+    // Edges on the scale, snapped to bins: at least one bin per band and
+    // enough left over for the bands above
+    _edges.assign(bands + 1, 0);
+    _edges[0] = _firstBin;
+    _edges[bands] = _lastBin + 1;
+    const double lo = toScale(_firstBin * binHz, scale);
+    const double hi = toScale((_lastBin + 1) * binHz, scale);
+    for (int b = 1; b < bands; ++b) {
+        int e = (int)lround(fromScale(lo + (hi - lo) * b / bands, scale) / binHz);
+        if (e < _edges[b - 1] + 1) e = _edges[b - 1] + 1;
+        if (e > _lastBin + 1 - (bands - b)) e = _lastBin + 1 - (bands - b);
+        _edges[b] = (uint16_t)e;
+    }
+
+    _bandOf.resize(bins);
+    for (int b = 0; b < bands; ++b)
+        for (int k = _edges[b]; k < _edges[b + 1]; ++k) _bandOf[k - _firstBin] = (uint8_t)b;
+
+    // Fixed-point sums: a squared Q15 magnitude takes 31 bits, so a band of
+    // up to 2^(s + 1) bins fits 32 bits when each square is shifted by s
+    _powerShift.assign(bands, 0);
+    for (int b = 0; b < bands; ++b) {
+        int s = 0;
+        while ((2 << s) < _edges[b + 1] - _edges[b]) ++s;
+        _powerShift[b] = (uint8_t)s;
+    }
+
+    // A full-scale sine under a Hann window (coherent gain 1/2) puts
+    // about 3/8 N^2 fullScale^2 / 4 of power into its bins
+    const double peak = fullScale * fftSize / 4.0;
+    _refPower = (float)(peak * peak * 1.5);
+    return bands;
+}
+
+void SpectrumBands::process(const float* spectrum, float* bandDb) const
+{
+    float power[MAX_BANDS] = {0};
+
+    const uint8_t* band = _bandOf.data();
+    for (int k = _firstBin; k <= _lastBin; ++k, ++band) {
+        float re = spectrum[2 * k];
+        float im = spectrum[2 * k + 1];
+        power[*band] += re * re + im * im;
+    }
+
+    const float inv = 1.0f / _refPower;
+    for (int b = 0; b < _count; ++b)
+        bandDb[b] = 10.0f * log10f(power[b] * inv + 1e-12f);
+}
+
+// Integer sums per band; floating point only for the one log per band
+void SpectrumBands::process(const uint16_t* magnitude, int exponent, float* bandDb) const
+{
+    uint32_t power[MAX_BANDS] = {0};
+
+    const uint8_t* band = _bandOf.data();
+    for (int k = _firstBin; k <= _lastBin; ++k, ++band) {
+        const uint32_t m = magnitude[k];
+        power[*band] += (m * m) >> _powerShift[*band];
+    }
+
+    const float inv = 1.0f / _refPower;
+    for (int b = 0; b < _count; ++b)
+        bandDb[b] = 10.0f * log10f(ldexpf((float)power[b], _powerShift[b] + 2 * exponent) * inv + 1e-12f);
+}
+
+// -----------------------------------------------------
+// Automatic gain
+// -----------------------------------------------------
+void AutoGain::process(float* levels, int count, float dt)
+{
+    float loudest = -120.0f;
+    for (int b = 0; b < count; ++b)
+        if (levels[b] > loudest) loudest = levels[b];
+
+    const float tau = loudest > _refDb ? attackS : releaseS;
+    _refDb += (loudest - _refDb) * (1.0f - expf(-dt / tau));
+    if (_refDb < floorDb) _refDb = floorDb;
+    if (_refDb > 0.0f) _refDb = 0.0f;
+
+    const float bottom = _refDb - rangeDb;
+    const float scale = 1.0f / rangeDb;
+    for (int b = 0; b < count; ++b) {
+        float v = (levels[b] - bottom) * scale;
+        levels[b] = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+    }
+}
+
+// -----------------------------------------------------
+// Bar smoothing
+// -----------------------------------------------------
+void BarSmoother::process(const float* target, int count, float dt)
+{
+    if (count != _count) {
+        for (int b = 0; b < count; ++b) _levels[b] = 0.0f;
+        _count = count;
+    }
+
+    const float rise = 1.0f - expf(-dt / riseS);
+    const float fall = 1.0f - expf(-dt / fallS);
+    for (int b = 0; b < count; ++b) {
+        float prev = _levels[b];
+        _levels[b] = prev + (target[b] - prev) * (target[b] > prev ? rise : fall);
+    }
+}
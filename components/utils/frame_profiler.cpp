@@ -0,0 +1,192 @@
+#include "frame_profiler.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+const uint16_t FrameProfiler::BUCKET_LIMITS_US[BUCKETS - 1] = {
+    250, 500, 1000, 2000, 4000, 8000, 16667, 33333
+};
+
+static const char* STAGE_NAMES[(int)ProfileStage::COUNT] = {
+    "update", "render", "blit", "network", "input", "frame"
+};
+
+FrameProfiler& FrameProfiler::instance()
+{
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+FrameProfiler::FrameProfiler()
+{
+    memset(_screens, 0, sizeof(_screens));
+}
+
+int FrameProfiler::bucketFor(uint32_t us)
+{
+    for (int i = 0; i < BUCKETS - 1; ++i)
+        if (us < BUCKET_LIMITS_US[i]) return i;
+    return BUCKETS - 1;
+}
+
+// -----------------------------------------------------
+// Recording (main loop only)
+// -----------------------------------------------------
+void FrameProfiler::beginFrame(int screenIndex, const char* screenName)
+{
+    if (!_enabled) return;
+
+    _screen = (screenIndex >= 0 && screenIndex < MAX_SCREENS) ? screenIndex : -1;
+    if (_screen >= 0) _screens[_screen].name = screenName;
+
+    memset(_frameUs, 0, sizeof(_frameUs));
+    _start[(int)ProfileStage::FRAME] = timer_cycles();
+}
+
+void FrameProfiler::begin(ProfileStage stage)
+{
+    if (!_enabled) return;
+    _start[(int)stage] = timer_cycles();
+}
+
+void FrameProfiler::end(ProfileStage stage)
+{
+    if (!_enabled) return;
+
+    // Stages that run more than once per frame add up
+    _frameUs[(int)stage] += timer_cycles_to_us(timer_cycles() - _start[(int)stage]);
+}
+
+void FrameProfiler::screenSwitched(int screenIndex, uint32_t startCycles)
+{
+    if (!_enabled) return;
+
+    _switchTo = (screenIndex >= 0 && screenIndex < MAX_SCREENS) ? screenIndex : -1;
+    _switchStart = startCycles;
+}
+
+void FrameProfiler::endFrame()
+{
+    if (!_enabled || _screen < 0) return;
+
+    const int frame = (int)ProfileStage::FRAME;
+    const uint32_t now = timer_cycles();
+    _frameUs[frame] = timer_cycles_to_us(now - _start[frame]);
+
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_switchTo >= 0) {
+        uint32_t us = timer_cycles_to_us(now - _switchStart);
+        ScreenStats& to = _screens[_switchTo];
+        Histogram& h = to.firstFrame;
+        h.counts[bucketFor(us)]++;
+        h.total++;
+        h.sumUs += us;
+        if (us > h.maxUs) h.maxUs = us;
+        to.firstFrameLastUs = us;
+        _switchTo = -1;
+    }
+
+    ScreenStats& s = _screens[_screen];
+    for (int i = 0; i < (int)ProfileStage::COUNT; ++i) {
+        uint32_t us = _frameUs[i];
+        Histogram& h = s.stages[i];
+        h.counts[bucketFor(us)]++;
+        h.total++;
+        h.sumUs += us;
+        if (us > h.maxUs) h.maxUs = us;
+    }
+    if (_frameUs[frame] > BUDGET_US) s.overBudget++;
+
+    _history[_historyHead] = _frameUs[frame];
+    _historyHead = (_historyHead + 1) % HISTORY;
+    if (_historyCount < HISTORY) _historyCount++;
+}
+
+void FrameProfiler::reset()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    // Keep the screen names, they are only set when a screen is shown
+    for (auto& s : _screens) {
+        memset(s.stages, 0, sizeof(s.stages));
+        s.overBudget = 0;
+        memset(&s.firstFrame, 0, sizeof(s.firstFrame));
+        s.firstFrameLastUs = 0;
+    }
+    _historyHead = 0;
+    _historyCount = 0;
+}
+
+// -----------------------------------------------------
+// Reading (any task)
+// -----------------------------------------------------
+int FrameProfiler::history(uint32_t* out, int max) const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    int n = (_historyCount < max) ? _historyCount : max;
+    int idx = (_historyHead - n + HISTORY) % HISTORY;
+    for (int i = 0; i < n; ++i) {
+        out[i] = _history[idx];
+        idx = (idx + 1) % HISTORY;
+    }
+    return n;
+}
+
+// snprintf that keeps appending safely once the buffer is full
+static void append(char* buf, size_t len, size_t& pos, const char* fmt, ...)
+{
+    if (pos >= len) return;
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + pos, len - pos, fmt, args);
+    va_end(args);
+
+    if (n > 0) pos = (pos + n < len) ? pos + n : len - 1;
+}
+
+size_t FrameProfiler::toJson(char* buf, size_t len) const
+{
+    if (len == 0) return 0;
+    buf[0] = '\0';
+
+    std::lock_guard<std::mutex> guard(_lock);
+
+    size_t pos = 0;
+    append(buf, len, pos, "{\"enabled\":%s,\"overlay\":%s,\"budget_us\":%lu,\"buckets_us\":[",
+           _enabled ? "true" : "false", _overlay ? "true" : "false", (unsigned long)BUDGET_US);
+    for (int i = 0; i < BUCKETS - 1; ++i)
+        append(buf, len, pos, "%s%u", i ? "," : "", BUCKET_LIMITS_US[i]);
+    append(buf, len, pos, "],\"screens\":[");
+
+    bool first = true;
+    for (int i = 0; i < MAX_SCREENS; ++i) {
+        const ScreenStats& s = _screens[i];
+        if (!s.name) continue;
+
+        const Histogram& frame = s.stages[(int)ProfileStage::FRAME];
+        append(buf, len, pos, "%s{\"index\":%d,\"name\":\"%s\",\"frames\":%lu,\"over_budget\":%lu,\"stages\":{",
+               first ? "" : ",", i, s.name, (unsigned long)frame.total, (unsigned long)s.overBudget);
+        first = false;
+
+        for (int st = 0; st < (int)ProfileStage::COUNT; ++st) {
+            const Histogram& h = s.stages[st];
+            unsigned long avg = h.total ? (unsigned long)(h.sumUs / h.total) : 0;
+            append(buf, len, pos, "%s\"%s\":{\"avg_us\":%lu,\"max_us\":%lu,\"hist\":[",
+                   st ? "," : "", STAGE_NAMES[st], avg, (unsigned long)h.maxUs);
+            for (int b = 0; b < BUCKETS; ++b)
+                append(buf, len, pos, "%s%lu", b ? "," : "", (unsigned long)h.counts[b]);
+            append(buf, len, pos, "]}");
+        }
+
+        const Histogram& ff = s.firstFrame;
+        append(buf, len, pos, "},\"first_frame\":{\"switches\":%lu,\"avg_us\":%lu,\"max_us\":%lu,\"last_us\":%lu}}",
+               (unsigned long)ff.total, ff.total ? (unsigned long)(ff.sumUs / ff.total) : 0UL,
+               (unsigned long)ff.maxUs, (unsigned long)s.firstFrameLastUs);
+    }
+
+    append(buf, len, pos, "]}");
+    return pos;
+}
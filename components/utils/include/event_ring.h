@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// Lock-free single-producer, many-reader broadcast of small events.
+//
+// The producer writes each event into the next of N slots and bumps the
+// head sequence; it never waits for readers. Every reader keeps its own
+// cursor (the sequence of the last event it took) and polls for the ones
+// after it, so any number of readers see every event, each at its own
+// pace. A reader more than N events behind has lost the oldest and
+// resumes at the oldest still held.
+//
+// Each slot carries the sequence of the event in it, written after the
+// event itself (a seqlock), so a reader can tell a slot being rewritten
+// under it and skip that event rather than take a torn copy. T must be
+// trivially copyable.
+//
+// One thread may call publish(); any thread head() and poll().
+template <typename T, int N>
+class EventRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "EventRing size must be a power of two");
+
+public:
+    // Producer
+    void publish(const T& value)
+    {
+        const uint32_t seq = _head.load(std::memory_order_relaxed) + 1;
+        Slot& slot = _slots[seq & (N - 1)];
+        slot.seq.store(0, std::memory_order_relaxed);           // being written
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.value = value;
+        slot.seq.store(seq, std::memory_order_release);
+        _head.store(seq, std::memory_order_release);
+    }
+
+    // Reader: a cursor that skips everything published so far
+    uint32_t head() const { return _head.load(std::memory_order_acquire); }
+
+    // Reader: the next event after `cursor`, advancing it; false when the
+    // reader has caught up
+    bool poll(uint32_t& cursor, T& out) const
+    {
+        for (;;) {
+            const uint32_t head = _head.load(std::memory_order_acquire);
+            if (cursor == head) return false;
+            if (head - cursor > (uint32_t)N) cursor = head - N;     // lapped
+
+            const uint32_t want = cursor + 1;
+            const Slot& slot = _slots[want & (N - 1)];
+            const uint32_t before = slot.seq.load(std::memory_order_acquire);
+            T copy = slot.value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint32_t after = slot.seq.load(std::memory_order_relaxed);
+
+            cursor = want;
+            if (before == want && after == want) {
+                out = copy;
+                return true;
+            }
+            // Overwritten while we looked: that event is lost, try the next
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq{0};
+        T value{};
+    };
+
+    Slot _slots[N];
+    std::atomic<uint32_t> _head{0};
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+
+// Fixed-point helpers for per-pixel and per-particle hot loops.
+//
+// Positions and velocities are Q24.8 (1/256 px), durations Q16.16 seconds
+// and sines Q1.14. Angles are 8-bit: 256 steps per turn, so wrapping is
+// free and the tables index directly.
+
+static const int FIX_SHIFT = 8;
+static const int32_t FIX_ONE = 1 << FIX_SHIFT;
+
+constexpr int32_t fix_from_int(int v) { return v * FIX_ONE; }
+constexpr int32_t fix_from_float(float v) { return (int32_t)(v * FIX_ONE); }
+constexpr int fix_to_int(int32_t v) { return v >> FIX_SHIFT; }    // floor
+
+// Seconds as Q16.16, the form dt is passed to fix_scale()
+constexpr int32_t fix_seconds(float s) { return (int32_t)(s * 65536.0f); }
+
+// v * t, with t in Q16.16. Stays in 32 bits as long as one step moves
+// less than 128 px (e.g. 1000 px/s with dt up to 0.125 s).
+constexpr int32_t fix_scale(int32_t v, int32_t t) { return (v * t) >> 16; }
+
+// -----------------------------------------------------
+// Sine / cosine, 256-step angle, Q1.14 result
+// -----------------------------------------------------
+namespace fixed_detail {
+
+// Taylor series after range reduction to [-pi/2, pi/2]; only ever
+// evaluated by the compiler to build the table
+constexpr double sin_poly(double x)
+{
+    const double PI = 3.14159265358979323846;
+    if (x > PI / 2) x = PI - x;
+    if (x < -PI / 2) x = -PI - x;
+
+    double term = x, sum = x;
+    for (int n = 1; n < 12; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr std::array<int16_t, 256> make_sin_table()
+{
+    std::array<int16_t, 256> t{};
+    const double PI = 3.14159265358979323846;
+    for (int i = 0; i < 256; ++i) {
+        double a = (i < 128 ? i : i - 256) * (2.0 * PI / 256.0);
+        double v = sin_poly(a) * 16384.0;
+        t[i] = (int16_t)(v < 0 ? v - 0.5 : v + 0.5);
+    }
+    return t;
+}
+
+}  // namespace fixed_detail
+
+inline constexpr std::array<int16_t, 256> FIX_SIN_TABLE = fixed_detail::make_sin_table();
+
+constexpr int16_t fix_sin(uint8_t angle) { return FIX_SIN_TABLE[angle]; }
+constexpr int16_t fix_cos(uint8_t angle) { return FIX_SIN_TABLE[(uint8_t)(angle + 64)]; }
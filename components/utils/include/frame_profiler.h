@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+#include "timer.h"
+
+// Main-loop stages timed by the profiler
+enum class ProfileStage : uint8_t {
+    UPDATE,     // ScreenManager::update
+    RENDER,     // ScreenManager::render (+ overlays)
+    BLIT,       // LEDMatrix::show
+    NETWORK,    // WiFi/web server housekeeping and flight fetches
+    INPUT,      // button polling and screen switching
+    FRAME,      // everything between beginFrame() and endFrame()
+    COUNT
+};
+
+// Frame-time profiler for the main loop.
+//
+// Stages are timed with the cycle counter and accumulated into fixed
+// histograms per screen, so recording costs a few dozen cycles and never
+// allocates. A short history of whole-frame times feeds the on-panel
+// graph. The main loop writes; the web server reads through toJson(),
+// which takes the same lock endFrame() does.
+class FrameProfiler {
+public:
+    static FrameProfiler& instance();
+
+    static const int MAX_SCREENS = 8;
+    static const int BUCKETS = 9;
+    static const int HISTORY = 64;
+    static const uint32_t BUDGET_US = 16667;    // 60 FPS
+
+    // Upper bound (exclusive, us) of each histogram bucket; the last is open
+    static const uint16_t BUCKET_LIMITS_US[BUCKETS - 1];
+
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool enabled() const { return _enabled; }
+
+    void setOverlay(bool on) { _overlay = on; }
+    bool overlay() const { return _overlay; }
+
+    // Stage times recorded until endFrame() are charged to this screen
+    void beginFrame(int screenIndex, const char* screenName);
+    void begin(ProfileStage stage);
+    void end(ProfileStage stage);
+    void endFrame();
+
+    // A screen switch started at `startCycles` (timer_cycles() before
+    // leaving the old screen); the next endFrame() records the time to
+    // the new screen's first frame against `screenIndex`
+    void screenSwitched(int screenIndex, uint32_t startCycles);
+
+    void reset();
+
+    // Most recent whole-frame times in us, oldest first; returns the count
+    int history(uint32_t* out, int max) const;
+
+    // Writes the histograms as JSON; returns the length (truncated to len - 1)
+    size_t toJson(char* buf, size_t len) const;
+
+private:
+    FrameProfiler();
+
+    struct Histogram {
+        uint32_t counts[BUCKETS];
+        uint32_t total;
+        uint64_t sumUs;
+        uint32_t maxUs;
+    };
+
+    struct ScreenStats {
+        const char* name;
+        Histogram stages[(int)ProfileStage::COUNT];
+        uint32_t overBudget;
+        Histogram firstFrame;       // switch to first frame shown
+        uint32_t firstFrameLastUs;
+    };
+
+    static int bucketFor(uint32_t us);
+
+    bool _enabled = true;
+    bool _overlay = false;
+
+    int _screen = -1;
+    int _switchTo = -1;             // switch waiting for its first frame
+    uint32_t _switchStart = 0;
+    uint32_t _start[(int)ProfileStage::COUNT] = {};
+    uint32_t _frameUs[(int)ProfileStage::COUNT] = {};
+
+    ScreenStats _screens[MAX_SCREENS];
+    uint32_t _history[HISTORY] = {};
+    int _historyHead = 0;
+    int _historyCount = 0;
+
+    mutable std::mutex _lock;
+};
+
+// Times the enclosing block as one stage
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileStage stage) : _stage(stage) { FrameProfiler::instance().begin(stage); }
+    ~ProfileScope() { FrameProfiler::instance().end(_stage); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileStage _stage;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+// Integer local-tangent-plane projection around a home position.
+//
+// Positions are int32 microdegrees (1e-6 deg, about 0.11 m), which keeps
+// a whole-world coordinate in 32 bits. Near the origin the earth is
+// treated as flat: east and north offsets are the longitude and latitude
+// differences times a per-axis scale, precomputed once per origin. Per
+// point this is two subtractions and two 32x32->64 multiplies, with the
+// result in Q24.8 pixels so sprites and trails can be placed sub-pixel.
+//
+// Good to well under a pixel within a few hundred km of home, which is
+// far beyond what the radar ever shows.
+
+static const int32_t UDEG_PER_DEG = 1000000;
+
+constexpr int32_t udeg_from_deg(double deg)
+{
+    return (int32_t)(deg * UDEG_PER_DEG + (deg < 0 ? -0.5 : 0.5));
+}
+
+class LocalProjection {
+public:
+    // Meters per microdegree of latitude; longitude shrinks with cos(lat)
+    static constexpr double M_PER_UDEG_LAT = 0.111132954;
+    static constexpr double M_PER_UDEG_LON = 0.111319491;
+
+    // Setup only (float math); metersPerPixel sets the zoom
+    void setOrigin(float latDeg, float lonDeg, float metersPerPixel)
+    {
+        _lat0 = udeg_from_deg(latDeg);
+        _lon0 = udeg_from_deg(lonDeg);
+
+        const double q = 256.0 * 65536.0 / metersPerPixel;
+        _cosLat = (float)cos(latDeg * M_PI / 180.0);
+        _kx = (int32_t)(M_PER_UDEG_LON * _cosLat * q + 0.5);
+        _ky = (int32_t)(M_PER_UDEG_LAT * q + 0.5);
+        _metersPerPixel = metersPerPixel;
+    }
+
+    // Offset from the origin in Q24.8 pixels, x east and y south (screen down)
+    void project(int32_t latUdeg, int32_t lonUdeg, int32_t& x, int32_t& y) const
+    {
+        int32_t dlon = lonUdeg - _lon0;
+        if (dlon > 180 * UDEG_PER_DEG) dlon -= 360 * UDEG_PER_DEG;
+        else if (dlon < -180 * UDEG_PER_DEG) dlon += 360 * UDEG_PER_DEG;
+        int32_t dlat = latUdeg - _lat0;
+
+        x = (int32_t)(((int64_t)dlon * _kx) >> 16);
+        y = (int32_t)(-((int64_t)dlat * _ky) >> 16);
+    }
+
+    // Velocity in microdegrees per second for a ground speed and track
+    void velocity(float speedMps, float trackDeg, int32_t& vlat, int32_t& vlon) const
+    {
+        const double a = trackDeg * M_PI / 180.0;
+        const double cosLat = _cosLat > 0.01f ? _cosLat : 0.01;
+        vlat = (int32_t)(speedMps * cos(a) / M_PER_UDEG_LAT);
+        vlon = (int32_t)(speedMps * sin(a) / (M_PER_UDEG_LON * cosLat));
+    }
+
+    float metersPerPixel() const { return _metersPerPixel; }
+
+private:
+    int32_t _lat0 = 0;
+    int32_t _lon0 = 0;
+    int32_t _kx = 0;        // Q8 px per udeg, << 16
+    int32_t _ky = 0;
+    float _metersPerPixel = 1.0f;
+    float _cosLat = 1.0f;
+};
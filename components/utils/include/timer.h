@@ -1 +1,17 @@
-// placeholder for components/utils/include/timer.h
\ No newline at end of file
+#pragma once
+
+#include <stdint.h>
+
+// Cheap timestamps for profiling hot paths.
+//
+// On the ESP32 these read the CPU cycle counter (a single register read,
+// wraps every ~27 s at 160 MHz); elsewhere they fall back to a monotonic
+// nanosecond clock. Differences are only meaningful between two calls on
+// the same core, taken less than one wrap apart.
+uint32_t timer_cycles();
+
+// Converts a timer_cycles() difference to microseconds
+uint32_t timer_cycles_to_us(uint32_t cycles);
+
+// The same with the fraction, for stages that take about a microsecond
+float timer_cycles_to_us_f(uint32_t cycles);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// Lock-free single-producer/single-consumer "latest value" channel.
+//
+// Three slots: the producer fills its back slot and publishes it by
+// swapping it with the middle one; the consumer takes the middle slot in
+// exchange for its front slot when a new value is waiting. Both sides
+// only ever exchange indices with one atomic operation, so neither blocks
+// or waits on the other, and the consumer always sees the newest complete
+// value. Values the consumer was too slow to take are overwritten, which
+// is what a display wants from a sensor.
+//
+// One thread may call back()/publish(), one other thread fetch()/front().
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer: slot to fill, then publish() it
+    T& back() { return _slots[_back]; }
+
+    void publish()
+    {
+        // Middle index plus the fresh flag, swapped for our filled slot
+        uint8_t old = _middle.exchange(_back | FRESH, std::memory_order_acq_rel);
+        _back = old & INDEX;
+    }
+
+    // Consumer: takes the newest published value, if there is one since
+    // the last call; front() keeps the previous value otherwise
+    bool fetch()
+    {
+        if (!(_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t old = _middle.exchange(_front, std::memory_order_acq_rel);
+        _front = old & INDEX;
+        return true;
+    }
+
+    const T& front() const { return _slots[_front]; }
+
+private:
+    static const uint8_t INDEX = 0x03;
+    static const uint8_t FRESH = 0x04;
+
+    T _slots[3] = {};
+    uint8_t _back = 0;                      // producer's
+    std::atomic<uint8_t> _middle{1};        // shared: index | FRESH
+    uint8_t _front = 2;                     // consumer's
+};
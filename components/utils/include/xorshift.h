@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// Marsaglia xorshift32: three shifts and xors per number, no division.
+// Not for anything security related; seed it once from esp_random().
+class XorShift32 {
+public:
+    explicit XorShift32(uint32_t seed = 0x9E3779B9u) { setSeed(seed); }
+
+    // Zero is a fixed point of the generator, so it is remapped
+    void setSeed(uint32_t seed) { _state = seed ? seed : 0x9E3779B9u; }
+
+    uint32_t next()
+    {
+        uint32_t x = _state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return _state = x;
+    }
+
+    // Uniform in [0, n) by multiply-shift instead of modulo
+    uint32_t below(uint32_t n) { return (uint32_t)(((uint64_t)next() * n) >> 32); }
+
+    // Uniform in [lo, hi]
+    int32_t range(int32_t lo, int32_t hi) { return lo + (int32_t)below((uint32_t)(hi - lo) + 1); }
+
+private:
+    uint32_t _state;
+};
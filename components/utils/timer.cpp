@@ -1 +1,40 @@
-// placeholder for components/utils/timer.cpp
\ No newline at end of file
+#include "timer.h"
+
+#ifdef ESP_PLATFORM
+#include "esp_cpu.h"
+#include "sdkconfig.h"
+
+uint32_t timer_cycles()
+{
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+
+uint32_t timer_cycles_to_us(uint32_t cycles)
+{
+    return cycles / CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+}
+
+float timer_cycles_to_us_f(uint32_t cycles)
+{
+    return (float)cycles / CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+}
+
+#else
+#include <chrono>
+
+uint32_t timer_cycles()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+uint32_t timer_cycles_to_us(uint32_t cycles)
+{
+    return cycles / 1000;
+}
+
+float timer_cycles_to_us_f(uint32_t cycles)
+{
+    return cycles * 0.001f;
+}
+#endif
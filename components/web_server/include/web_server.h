@@ -23,6 +23,13 @@ public:
     bool shouldReconnect();
     void clearReconnectFlag();
 
+    // Check if the panel layout changed (applied by restarting)
+    bool shouldRestartForDisplay();
+
+    // Check if the display profile changed (applied at runtime by the main loop)
+    bool shouldApplyDisplayProfile();
+    void clearDisplayProfileFlag();
+
     // Check if flight fetch is pending (from web settings update)
     bool shouldFetchFlights();
     void clearFetchFlightFlag();
@@ -32,10 +39,14 @@ private:
     httpd_handle_t server = nullptr;
     bool reconnect_pending = false;
     bool fetch_flights_pending = false;
+    bool display_restart_pending = false;
+    bool display_profile_pending = false;
     ServerMode current_mode = ServerMode::AP_MODE;
 
     // HTTP handlers
     static esp_err_t handleRoot(httpd_req_t* req);
     static esp_err_t handleConfigure(httpd_req_t* req);
     static esp_err_t handleDebug(httpd_req_t* req);
+    static esp_err_t handleProfiler(httpd_req_t* req);
+    static esp_err_t handleAudio(httpd_req_t* req);
 };
@@ -2,6 +2,8 @@
 #include "app_config.h"
 #include "wifi_manager.h"
 #include "flight_api.h"
+#include "frame_profiler.h"
+#include "audio_capture.h"
 #include "esp_log.h"
 #include <string.h>
 #include <stdlib.h>
@@ -415,6 +417,28 @@ static bool parse_geojson_polygon(const char* geojson_str, float* lat_min, float
     return true;
 }
 
+// Panel layouts offered in the settings form
+struct PanelLayout {
+    const char* id;
+    const char* label;
+    uint16_t panel_width;
+    uint16_t panel_height;
+    uint8_t chain_length;
+    uint8_t tile_rows;
+};
+
+static const PanelLayout panel_layouts[] = {
+    {"64x32",   "64x32 (single module)",          64,  32, 1, 1},
+    {"128x32",  "128x32 (2 x 64x32 chained)",     64,  32, 2, 1},
+    {"64x64",   "64x64 (single module)",          64,  64, 1, 1},
+    {"128x64",  "128x64 (single module)",         128, 64, 1, 1},
+    {"128x64t", "128x64 (2x2 tiled 64x32)",       64,  32, 4, 2},
+};
+static const int num_panel_layouts = sizeof(panel_layouts) / sizeof(panel_layouts[0]);
+
+// Size of the dynamically generated STA settings page
+static const int STA_PAGE_SIZE = 8192;
+
 // GET / - Serve configuration form (adapts to current server mode)
 esp_err_t WebServer::handleRoot(httpd_req_t* req) {
     httpd_resp_set_type(req, "text/html");
@@ -427,9 +451,11 @@ esp_err_t WebServer::handleRoot(httpd_req_t* req) {
         FlightConfig flight_cfg = config.getFlightConfig();
         OpenSkyAuthConfig auth = config.getOpenSkyAuth();
 
+        DisplayConfig display_cfg = config.getDisplayConfig();
+
         // Allocate buffer on heap to avoid stack overflow
-        // Increased to 5120 to accommodate all form elements
-        char* html = (char*)malloc(5120);
+        // Sized to accommodate all form elements
+        char* html = (char*)malloc(STA_PAGE_SIZE);
         if (!html) {
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Memory allocation failed");
             return ESP_FAIL;
@@ -438,7 +464,7 @@ esp_err_t WebServer::handleRoot(httpd_req_t* req) {
         int offset = 0;
 
         // Header and styles
-        offset += snprintf(html + offset, 5120 - offset,
+        offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
             "<!DOCTYPE html>\n"
             "<html>\n"
             "<head>\n"
@@ -513,7 +539,7 @@ esp_err_t WebServer::handleRoot(httpd_req_t* req) {
 
         for (int i = 0; i < 6; i++) {
             const char* selected = (strcmp(time_cfg.timezone, timezones[i][0]) == 0) ? " selected" : "";
-            offset += snprintf(html + offset, 5120 - offset,
+            offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
                 "        <option value=\"%s\"%s>%s</option>\n",
                 timezones[i][0],
                 selected,
@@ -521,9 +547,104 @@ esp_err_t WebServer::handleRoot(httpd_req_t* req) {
             );
         }
 
-        // Rest of form with OpenSky credentials
-        offset += snprintf(html + offset, 5120 - offset,
+        // Display geometry - mark current layout as selected
+        offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+            "      </select>\n"
+            "\n"
+            "      <h2>Display</h2>\n"
+            "      <label>Panel Layout:</label>\n"
+            "      <select name=\"panel_layout\">\n"
+        );
+
+        for (int i = 0; i < num_panel_layouts; i++) {
+            const PanelLayout& pl = panel_layouts[i];
+            bool current = pl.panel_width == display_cfg.panel_width &&
+                           pl.panel_height == display_cfg.panel_height &&
+                           pl.chain_length == display_cfg.chain_length &&
+                           pl.tile_rows == display_cfg.tile_rows;
+            offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+                "        <option value=\"%s\"%s>%s</option>\n",
+                pl.id,
+                current ? " selected" : "",
+                pl.label
+            );
+        }
+
+        offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+            "      </select>\n"
+            "      <label>E Address Pin (64-row modules, -1 = unused):</label>\n"
+            "      <input type=\"number\" name=\"pin_e\" min=\"-1\" max=\"48\" value=\"%d\">\n"
+            "      <p class=\"hint\">Changing the layout restarts the device</p>\n"
+            "      <label>Quality Profile:</label>\n"
+            "      <select name=\"display_profile\">\n",
+            display_cfg.pin_e
+        );
+
+        for (int i = 0; i < (int)DisplayProfile::COUNT; i++) {
+            const DisplayProfileSpec& spec = display_profile_spec((DisplayProfile)i);
+            offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+                "        <option value=\"%s\"%s>%s</option>\n",
+                spec.id,
+                (int)display_cfg.profile == i ? " selected" : "",
+                spec.label
+            );
+        }
+
+        // What the driver actually allocated for the running profile
+        DisplayStatus status = config.getDisplayStatus();
+        offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
             "      </select>\n"
+            "      <p class=\"hint\">Applied immediately. Running: %d-bit%s, %u Hz refresh, %lu bytes DMA</p>\n",
+            status.color_depth,
+            status.dither ? " dithered" : "",
+            (unsigned)status.refresh_hz,
+            (unsigned long)status.dma_bytes
+        );
+
+        // Spectrum analysis: FFT window and overlap between windows
+        AudioConfig audio_cfg = config.getAudioConfig();
+        offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+            "      <label>Spectrum Window (samples):</label>\n"
+            "      <select name=\"audio_window\">\n");
+        static const uint16_t audio_windows[] = {256, 512, 1024, 2048};
+        for (uint16_t w : audio_windows) {
+            offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+                "        <option value=\"%u\"%s>%u (%.0f Hz bins)</option>\n",
+                (unsigned)w, audio_cfg.window == w ? " selected" : "", (unsigned)w, 44100.0f / w);
+        }
+        offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+            "      </select>\n"
+            "      <label>Spectrum Overlap:</label>\n"
+            "      <select name=\"audio_overlap\">\n");
+        static const uint8_t audio_overlaps[] = {0, 50, 75};
+        for (uint8_t o : audio_overlaps) {
+            offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+                "        <option value=\"%u\"%s>%u%%</option>\n",
+                (unsigned)o, audio_cfg.overlap_pct == o ? " selected" : "", (unsigned)o);
+        }
+        offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+            "      </select>\n"
+            "      <label>Spectrum Arithmetic:</label>\n"
+            "      <select name=\"audio_pipeline\">\n");
+        static const char* const audio_pipelines[] = {"Build default", "Floating point", "Q15 fixed point"};
+        for (uint8_t p = 0; p < 3; ++p) {
+            offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+                "        <option value=\"%u\"%s>%s</option>\n",
+                (unsigned)p, audio_cfg.pipeline == p ? " selected" : "", audio_pipelines[p]);
+        }
+        offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
+            "      </select>\n"
+            "      <label>Spectrum In Silence:</label>\n"
+            "      <select name=\"audio_gate\">\n"
+            "        <option value=\"1\"%s>Pause analysis, idle animation</option>\n"
+            "        <option value=\"0\"%s>Always analyse</option>\n"
+            "      </select>\n"
+            "      <p class=\"hint\">Longer windows resolve the bass; more overlap updates more often for more CPU. "
+            "Levels and CPU per hop at /audio</p>\n",
+            audio_cfg.gate ? " selected" : "", audio_cfg.gate ? "" : " selected");
+
+        // Rest of form with OpenSky credentials
+        offset += snprintf(html + offset, STA_PAGE_SIZE - offset,
             "\n"
             "      <h2>OpenSky Network (Optional)</h2>\n"
             "      <p style=\"color: #666; font-size: 14px;\">\n"
@@ -665,6 +786,70 @@ esp_err_t WebServer::handleConfigure(httpd_req_t* req) {
     config.setBBoxSize(bbox_size);
     config.setBoundingBox(bbox_lat_min, bbox_lat_max, bbox_lon_min, bbox_lon_max);
 
+    // Panel layout is optional (only present in the STA settings form)
+    char panel_layout[16] = {0};
+    char pin_e_str[8] = {0};
+    if (parse_form_value(content, "panel_layout", panel_layout, sizeof(panel_layout))) {
+        for (int i = 0; i < num_panel_layouts; i++) {
+            if (strcmp(panel_layout, panel_layouts[i].id) != 0) continue;
+
+            DisplayConfig dc = config.getDisplayConfig();
+            DisplayConfig updated = dc;
+            updated.panel_width = panel_layouts[i].panel_width;
+            updated.panel_height = panel_layouts[i].panel_height;
+            updated.chain_length = panel_layouts[i].chain_length;
+            updated.tile_rows = panel_layouts[i].tile_rows;
+            if (parse_form_value(content, "pin_e", pin_e_str, sizeof(pin_e_str))) {
+                updated.pin_e = (int8_t)atoi(pin_e_str);
+            }
+
+            bool changed = updated.panel_width != dc.panel_width ||
+                           updated.panel_height != dc.panel_height ||
+                           updated.chain_length != dc.chain_length ||
+                           updated.tile_rows != dc.tile_rows ||
+                           updated.pin_e != dc.pin_e;
+            if (changed && config.setDisplayConfig(updated)) {
+                ESP_LOGI(TAG, "  Panel layout: %s (restart pending)", panel_layout);
+                WebServer::instance().display_restart_pending = true;
+            }
+            break;
+        }
+    }
+
+    // Quality profile only restarts the DMA engine, handled by the main loop
+    char display_profile[16] = {0};
+    DisplayProfile profile;
+    if (parse_form_value(content, "display_profile", display_profile, sizeof(display_profile)) &&
+        display_profile_from_id(display_profile, profile) &&
+        profile != config.getDisplayConfig().profile &&
+        config.setDisplayProfile(profile)) {
+        ESP_LOGI(TAG, "  Display profile: %s", display_profile);
+        WebServer::instance().display_profile_pending = true;
+    }
+
+    // Spectrum analysis is optional too; the spectrum screen picks it up
+    char audio_window[8] = {0};
+    char audio_overlap[8] = {0};
+    char audio_pipeline[4] = {0};
+    char audio_gate[4] = {0};
+    if (parse_form_value(content, "audio_window", audio_window, sizeof(audio_window)) &&
+        parse_form_value(content, "audio_overlap", audio_overlap, sizeof(audio_overlap))) {
+        AudioConfig current = config.getAudioConfig();
+        AudioConfig ac;
+        ac.window = (uint16_t)atoi(audio_window);
+        ac.overlap_pct = (uint8_t)atoi(audio_overlap);
+        ac.pipeline = parse_form_value(content, "audio_pipeline", audio_pipeline, sizeof(audio_pipeline))
+                    ? (uint8_t)atoi(audio_pipeline) : current.pipeline;
+        ac.gate = parse_form_value(content, "audio_gate", audio_gate, sizeof(audio_gate))
+                    ? (uint8_t)atoi(audio_gate) : current.gate;
+        if ((ac.window != current.window || ac.overlap_pct != current.overlap_pct ||
+             ac.pipeline != current.pipeline || ac.gate != current.gate) &&
+            config.setAudioConfig(ac)) {
+            ESP_LOGI(TAG, "  Spectrum: %s-sample window, %s%% overlap, pipeline %u, gate %u",
+                     audio_window, audio_overlap, (unsigned)ac.pipeline, (unsigned)ac.gate);
+        }
+    }
+
     // Save OpenSky credentials if provided
     // NOTE: Validation is deferred to main loop to avoid stack overflow in HTTP handler
     if (strlen(sky_user) > 0 && strlen(sky_pass) > 0) {
@@ -784,6 +969,69 @@ esp_err_t WebServer::handleDebug(httpd_req_t* req) {
     return ESP_OK;
 }
 
+// Frame-time histograms as JSON. Optional query: overlay=0|1, enabled=0|1, reset=1
+esp_err_t WebServer::handleProfiler(httpd_req_t* req) {
+    FrameProfiler& profiler = FrameProfiler::instance();
+
+    char query[64];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        char value[4];
+        if (httpd_query_key_value(query, "overlay", value, sizeof(value)) == ESP_OK) {
+            profiler.setOverlay(value[0] == '1');
+        }
+        if (httpd_query_key_value(query, "enabled", value, sizeof(value)) == ESP_OK) {
+            profiler.setEnabled(value[0] == '1');
+        }
+        if (httpd_query_key_value(query, "reset", value, sizeof(value)) == ESP_OK && value[0] == '1') {
+            profiler.reset();
+        }
+    }
+
+    const size_t JSON_SIZE = 6144;
+    char* json = (char*)malloc(JSON_SIZE);
+    if (!json) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Memory allocation failed");
+        return ESP_FAIL;
+    }
+
+    size_t len = profiler.toJson(json, JSON_SIZE);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json, len);
+    free(json);
+    return ESP_OK;
+}
+
+// Microphone level and the silence gate's savings as JSON. Figures are
+// from the last time the microphone ran (capturing = false since)
+esp_err_t WebServer::handleAudio(httpd_req_t* req) {
+    AudioCapture& capture = AudioCapture::instance();
+    const AudioLevels& lv = capture.levels();
+
+    // Analysis CPU per hop as a share of the hop's real time
+    const float hopUs = lv.hopMs * 1000.0f;
+    const float activePct = hopUs > 0.0f ? 100.0f * lv.activeUs / hopUs : 0.0f;
+    const float idlePct = hopUs > 0.0f ? 100.0f * lv.idleUs / hopUs : 0.0f;
+
+    char json[512];
+    int len = snprintf(json, sizeof(json),
+        "{\"capturing\":%s,\"active\":%s,\"gate\":%s,\"gated\":%s,"
+        "\"rms_dbfs\":%.1f,\"peak_dbfs\":%.1f,\"floor_dbfs\":%.1f,\"zcr\":%.3f,"
+        "\"hops\":%lu,\"gated_hops\":%lu,\"ffts\":%lu,\"hop_ms\":%.2f,"
+        "\"active_us\":%.0f,\"idle_us\":%.0f,\"active_cpu_pct\":%.2f,\"idle_cpu_pct\":%.2f}",
+        capture.channelOpen() ? "true" : "false",
+        lv.level.active ? "true" : "false",
+        lv.gate ? "true" : "false",
+        lv.gated ? "true" : "false",
+        lv.level.rmsDb, lv.level.peakDb, lv.level.floorDb, lv.level.zcr,
+        (unsigned long)lv.hops, (unsigned long)lv.gatedHops, (unsigned long)lv.transforms, lv.hopMs,
+        lv.activeUs, lv.idleUs, activePct, idlePct);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json, len);
+    return ESP_OK;
+}
+
 // Check if reconnection is pending
 bool WebServer::shouldReconnect() {
     return reconnect_pending;
@@ -794,6 +1042,21 @@ void WebServer::clearReconnectFlag() {
     reconnect_pending = false;
 }
 
+// Check if a display geometry change needs a restart
+bool WebServer::shouldRestartForDisplay() {
+    return display_restart_pending;
+}
+
+// Check if a display profile change needs a driver restart
+bool WebServer::shouldApplyDisplayProfile() {
+    return display_profile_pending;
+}
+
+// Clear display profile flag
+void WebServer::clearDisplayProfileFlag() {
+    display_profile_pending = false;
+}
+
 // Check if flight fetch is pending
 bool WebServer::shouldFetchFlights() {
     return fetch_flights_pending;
@@ -849,10 +1112,28 @@ void WebServer::begin(ServerMode mode) {
         };
         httpd_register_uri_handler(server, &debug_uri);
 
+        httpd_uri_t profiler_uri = {
+            .uri = "/profiler",
+            .method = HTTP_GET,
+            .handler = handleProfiler,
+            .user_ctx = nullptr
+        };
+        httpd_register_uri_handler(server, &profiler_uri);
+
+        httpd_uri_t audio_uri = {
+            .uri = "/audio",
+            .method = HTTP_GET,
+            .handler = handleAudio,
+            .user_ctx = nullptr
+        };
+        httpd_register_uri_handler(server, &audio_uri);
+
         ESP_LOGI(TAG, "HTTP server started successfully in %s", mode_str);
         if (mode == ServerMode::AP_MODE) {
             ESP_LOGI(TAG, "Access form at http://192.168.4.1");
             ESP_LOGI(TAG, "Debug info available at http://192.168.4.1/debug");
+            ESP_LOGI(TAG, "Frame profiler available at http://192.168.4.1/profiler");
+            ESP_LOGI(TAG, "Microphone levels available at http://192.168.4.1/audio");
         } else {
             ESP_LOGI(TAG, "Settings update server running on local network");
         }
@@ -0,0 +1,209 @@
+#include "anim_bench.h"
+#include "anim_partition.h"
+#include "anim_player.h"
+#include "animation_screen.h"
+#include "led_matrix.h"
+#include "sim_fakes.h"
+#include "xorshift.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+static uint32_t fbCrc(const FrameBuffer& fb)
+{
+    return anim_crc32(fb.pixels(), fb.sizeBytes());
+}
+
+// Reference frames (raw RGB565 from anim_encode.py --reference) expanded
+// the way the decoder expands them
+static bool loadReference(const char* path, int width, int height, int frames,
+                          std::vector<uint8_t>& rgb)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    const size_t pixels = (size_t)width * height * frames;
+    std::vector<uint16_t> raw(pixels);
+    size_t got = fread(raw.data(), sizeof(uint16_t), pixels, f);
+    fclose(f);
+    if (got != pixels) return false;
+
+    rgb.resize(pixels * 3);
+    for (size_t i = 0; i < pixels; ++i)
+        FrameBuffer::unpack565(raw[i], rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+    return true;
+}
+
+// Damaged copies of the file must be refused or fail cleanly
+static void checkCorruption(const uint8_t* data, size_t size)
+{
+    std::vector<uint8_t> copy(data, data + size);
+    AnimPlayer player;
+
+    copy[0] ^= 0xFF;
+    bool magic = !player.open(copy.data(), copy.size());
+    copy[0] ^= 0xFF;
+
+    bool truncated = !player.open(copy.data(), copy.size() - 1);
+
+    copy[size / 2] ^= 0x5A;
+    bool crc = !player.open(copy.data(), copy.size());
+    copy[size / 2] ^= 0x5A;
+    check(magic && truncated && crc, "bad magic, truncated file and flipped bits are refused");
+
+    // A run longer than the frame, with the CRC made to match: opens, but
+    // decoding stops at the bad run instead of writing past the frame
+    AnimHeader* h = (AnimHeader*)copy.data();
+    const uint32_t* offsets = (const uint32_t*)(copy.data() + sizeof(AnimHeader));
+    uint16_t* firstRun = (uint16_t*)(copy.data() + offsets[0]) + 1;
+    bool hasRun = offsets[1] - offsets[0] > sizeof(uint16_t);
+    if (hasRun) {
+        *firstRun = (RLE_SKIP << RLE_OP_SHIFT) | RLE_LENGTH_MASK;
+        h->crc32 = anim_crc32(copy.data() + sizeof(AnimHeader), h->fileBytes - sizeof(AnimHeader));
+    }
+    FrameBuffer fb(h->width, h->height);
+    bool opened = player.open(copy.data(), copy.size());
+    player.seek(0, fb);
+    check(!hasRun || (opened && player.frame() == -1), "an overlong run is caught while decoding");
+}
+
+int anim_bench_run(const char* file, const char* reference, int frames)
+{
+    sim_set_anim_file(file);
+    AnimPartition& part = AnimPartition::instance();
+    check(part.map(), "animation file maps like the flash partition");
+    if (!part.data()) return 1;
+
+    AnimPlayer player;
+    bool opened = player.open(part.data(), part.size());
+    check(opened, opened ? "header, CRC and frame table are valid" : player.error());
+    if (!opened) return 1;
+
+    const int w = player.width(), h = player.height(), count = player.frameCount();
+    int keys = 0;
+    for (int i = 0; i < count; ++i) keys += player.isKeyframe(i);
+    printf("%s: %dx%d, %d frames (%d keyframes) at %.2f FPS, %zu bytes\n",
+           file, w, h, count, keys, 1.0f / player.frameSeconds(), player.fileBytes());
+
+    // Sequential playback, one frame's deltas at a time
+    FrameBuffer fb(w, h);
+    std::vector<uint32_t> crcs(count);
+    std::vector<uint8_t> expected;
+    bool haveReference = reference && loadReference(reference, w, h, count, expected);
+    bool sequential = true, matches = true;
+    for (int i = 0; i < count; ++i) {
+        sequential &= player.seek(i, fb) == 1;
+        crcs[i] = fbCrc(fb);
+        if (haveReference)
+            matches &= memcmp(fb.pixels(), &expected[(size_t)i * w * h * 3], fb.sizeBytes()) == 0;
+    }
+    check(sequential, "playback decodes exactly one frame per step");
+    if (reference)
+        check(haveReference && matches, "every frame matches the encoder's reference decode");
+
+    // Seeking (and wrapping) starts from the nearest keyframe
+    XorShift32 rng(11);
+    bool seeks = true;
+    for (int n = 0; n < 200; ++n) {
+        int target = rng.next() % count;
+        player.seek(target, fb);
+        seeks &= player.frame() == target && fbCrc(fb) == crcs[target];
+    }
+    check(seeks, "random seeks land on the same frames as playback");
+
+    // Centered on a bigger panel, the border stays black
+    FrameBuffer big(w * 2, h * 2);
+    AnimPlayer centered;
+    centered.open(part.data(), part.size());
+    bool inside = true;
+    for (int i = 0; i < count && i < 300; ++i) {
+        centered.seek(i, big);
+        for (int y = 0; y < h; ++y)
+            memcpy(fb.pixels() + (size_t)y * w * 3, big.pixels() + ((size_t)(y + h / 2) * w * 2 + w / 2) * 3,
+                   (size_t)w * 3);
+        inside &= fbCrc(fb) == crcs[i];
+    }
+    for (int y = 0; y < h / 2; ++y)
+        memset(big.pixels() + ((size_t)(y + h / 2) * w * 2 + w / 2) * 3, 0, (size_t)w * 3);
+    for (int y = h / 2; y < h / 2 + h; ++y)
+        memset(big.pixels() + ((size_t)y * w * 2 + w / 2) * 3, 0, (size_t)w * 3);
+    bool border = true;
+    for (size_t i = 0; i < big.sizeBytes(); ++i) border &= big.pixels()[i] == 0;
+    check(inside && border, "a smaller animation plays centered on a bigger panel");
+
+    checkCorruption(part.data(), part.size());
+
+    // Cost per frame: deltas as played, keyframes, and a plain RGB565
+    // frame expanded to the frame buffer for comparison
+    double totalUs = 0.0, worstUs = 0.0, keyUs = 0.0;
+    size_t worstBytes = 0;
+    const int passes = frames > count ? (frames + count - 1) / count : 1;
+    player.invalidate();
+    for (int p = 0; p < passes; ++p) {
+        for (int i = 0; i < count; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            player.seek(i, fb);
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+            totalUs += us;
+            if (us > worstUs) worstUs = us;
+            if (player.isKeyframe(i)) keyUs += us;
+            if (player.frameBytes(i) > worstBytes) worstBytes = player.frameBytes(i);
+        }
+    }
+    const double meanUs = totalUs / (passes * count);
+    keyUs /= passes * keys;
+
+    std::vector<uint16_t> raw((size_t)w * h);
+    for (auto& px : raw) px = (uint16_t)rng.next();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int n = 0; n < 1000; ++n)
+        for (size_t i = 0; i < raw.size(); ++i) {
+            uint8_t* d = fb.pixels() + i * 3;
+            FrameBuffer::unpack565(raw[i], d[0], d[1], d[2]);
+        }
+    double rawUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / 1000;
+
+    // Through the screen, as the device plays it at 60 FPS
+    DisplayConfig dc;
+    dc.panel_width = w;
+    dc.panel_height = h;
+    LEDMatrix matrix(dc);
+    matrix.begin();
+    AnimationScreen screen;
+    screen.onEnter();
+    auto s0 = std::chrono::steady_clock::now();
+    for (int n = 0; n < frames; ++n) {
+        screen.update(1.0f / 60.0f);
+        screen.render(matrix);
+    }
+    double screenUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - s0).count() / frames;
+
+    const double seconds = count * player.frameSeconds();
+    const size_t rawBytes = (size_t)w * h * 2 * count;
+    printf("\n%-26s %10s\n", "size", "");
+    printf("%-26s %10zu (%.1f%% of raw RGB565)\n", "file bytes", player.fileBytes(),
+           100.0 * player.fileBytes() / rawBytes);
+    printf("%-26s %10.0f\n", "bytes per frame, mean", (double)player.fileBytes() / count);
+    printf("%-26s %10zu\n", "bytes per frame, worst", worstBytes);
+    printf("%-26s %10.0f\n", "KB per minute", player.fileBytes() / seconds * 60.0 / 1024.0);
+    printf("\n%-26s %10s\n", "decode", "us");
+    printf("%-26s %10.2f\n", "frame, mean", meanUs);
+    printf("%-26s %10.2f\n", "frame, worst", worstUs);
+    printf("%-26s %10.2f\n", "keyframe, mean", keyUs);
+    printf("%-26s %10.2f\n", "raw RGB565 frame", rawUs);
+    printf("%-26s %10.2f (%.2f%% of a 60 FPS frame)\n", "AnimationScreen render", screenUs,
+           100.0 * screenUs / 16667.0);
+    check(worstUs < 16667.0, "worst frame decodes within a 60 FPS frame");
+
+    sim_set_anim_file(nullptr);
+    printf("\n%s\n", failures ? "FAILED" : "All animation checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+// Plays an anim_encode.py file through the mapped-partition path: checks
+// the decode against the encoder's reference frames, seeking, centering
+// and damaged files, then reports size per minute and decode cost
+int anim_bench_run(const char* file, const char* reference, int frames);
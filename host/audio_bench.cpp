@@ -0,0 +1,477 @@
+#include "audio_bench.h"
+#include "app_config.h"
+#include "audio_capture.h"
+#include "fireworks_screen.h"
+#include "led_matrix.h"
+#include "microphone.h"
+#include "screen_manager.h"
+#include "sim_fakes.h"
+#include "spectrogram_screen.h"
+#include "spectrum_screen.h"
+#include "triple_buffer.h"
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+// Producer and consumer hammering the buffer: every value taken must be
+// whole (all words from one publish) and newer than the one before, and
+// the last one taken the last one published. Both yield so they
+// interleave even on a single core.
+static void checkTripleBuffer()
+{
+    struct Value {
+        uint32_t words[16];
+    };
+    static const uint32_t PUBLISHES = 200000;
+    TripleBuffer<Value> buffer;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (uint32_t n = 1; n <= PUBLISHES; ++n) {
+            Value& v = buffer.back();
+            for (uint32_t& w : v.words) w = n;
+            buffer.publish();
+            std::this_thread::yield();
+        }
+        done = true;
+    });
+
+    bool whole = true, ordered = true;
+    uint32_t last = 0, taken = 0;
+    auto take = [&] {
+        if (!buffer.fetch()) {
+            std::this_thread::yield();
+            return;
+        }
+        const Value& v = buffer.front();
+        for (uint32_t w : v.words) whole &= w == v.words[0];
+        ordered &= v.words[0] > last;
+        last = v.words[0];
+        taken++;
+    };
+    while (!done) take();
+    producer.join();
+    take();
+
+    printf("triple buffer: %u values published, %u taken, last %u\n", PUBLISHES, taken, last);
+    check(whole, "values taken from the triple buffer are never torn");
+    check(ordered && last == PUBLISHES, "values arrive in order and the newest is never lost");
+}
+
+// Restarts the analysis at sample 0 of `tones`: a throwaway hop at another
+// analysis first, so the ring and AGC always start from silence
+static void restartAnalysis(int window, int hop, const std::vector<std::pair<float, float>>& tones)
+{
+    AudioCapture& capture = AudioCapture::instance();
+    capture.setAnalysis(window == AudioCapture::MIN_WINDOW ? AudioCapture::MAX_WINDOW : AudioCapture::MIN_WINDOW,
+                        AudioCapture::MIN_WINDOW);
+    capture.capture();
+    capture.setAnalysis(window, hop);
+    sim_audio_set_tones(tones);
+}
+
+// Bands after `samples` samples, analysed in hops of `hop`
+static std::vector<float> spectrumAfter(int window, int hop, int samples,
+                                        const std::vector<std::pair<float, float>>& tones)
+{
+    AudioCapture& capture = AudioCapture::instance();
+    restartAnalysis(window, hop, tones);
+    for (int n = 0; n < samples / hop; ++n) capture.capture();
+    const AudioSpectrum* s = capture.latest();
+    if (!s) return {};
+    return std::vector<float>(s->bands, s->bands + s->count);
+}
+
+// Same samples, same spectra; and the spectrum of a window depends on
+// its samples, not on how many hops led up to it
+static void checkOverlap()
+{
+    const std::vector<std::pair<float, float>> tones = {{220.0f, 0.3f}, {1760.0f, 0.1f}, {5000.0f, 0.05f}};
+    const int samples = AudioCapture::SAMPLE_RATE * 2 / 512 * 512;
+
+    std::vector<float> a = spectrumAfter(1024, 256, samples, tones);
+    std::vector<float> b = spectrumAfter(1024, 256, samples, tones);
+    check(!a.empty() && a == b, "the same samples give bit-identical spectra");
+
+    std::vector<float> fine = spectrumAfter(512, 128, samples, tones);
+    std::vector<float> coarse = spectrumAfter(512, 512, samples, tones);
+    float worst = fine.size() == coarse.size() && !fine.empty() ? 0.0f : 1.0f;
+    for (size_t i = 0; i < fine.size() && i < coarse.size(); ++i)
+        worst = fmaxf(worst, fabsf(fine[i] - coarse[i]));
+    printf("512-sample window after %d samples, hop 128 vs. hop 512: max band difference %.4f\n", samples, worst);
+    check(worst < 0.01f, "a window's spectrum does not depend on the hop that reached it");
+}
+
+// Analysis cost per hop at each window and overlap, as a share of one
+// core: cost per hop times hops per second. DSP is window, FFT, bands and
+// gain as AudioCapture times it; the hop adds the fake microphone's sine
+// synthesis and the ring update.
+static void printCpuLoad(int hops)
+{
+    struct Setting {
+        int window;
+        int overlapPct;
+    };
+    static const Setting settings[] = {{256, 0}, {512, 0}, {512, 50}, {1024, 0}, {1024, 50},
+                                       {1024, 75}, {2048, 50}, {2048, 75}};
+    const std::vector<std::pair<float, float>> tones = {{440.0f, 0.3f}, {3000.0f, 0.1f}};
+    AudioCapture& capture = AudioCapture::instance();
+
+    printf("\n%-8s %8s %6s %10s %8s %8s %8s %8s %8s\n", "window", "overlap", "hop", "FFTs/s", "res Hz",
+           "dsp us", "DSP CPU", "hop us", "hop CPU");
+    double ffts[2] = {0.0, 0.0};        // 1024 at 0% and 75%, per second of samples
+    for (const Setting& st : settings) {
+        const int hop = st.window * (100 - st.overlapPct) / 100;
+        restartAnalysis(st.window, hop, tones);
+        capture.capture();
+        capture.latest();
+        capture.resetStats();
+        const uint32_t before = capture.levels().transforms;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int n = 0; n < hops; ++n) {
+            capture.capture();
+            capture.latest();
+        }
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / hops;
+        const double rate = (capture.levels().transforms - before) * (double)AudioCapture::SAMPLE_RATE / ((double)hops * hop);
+        const double dspUs = capture.stats().processMeanUs;
+        const double cpu = dspUs * rate / 1e4;
+        printf("%-8d %7d%% %6d %10.1f %8.1f %8.1f %7.2f%% %8.1f %7.2f%%\n", st.window, st.overlapPct, hop, rate,
+               (double)AudioCapture::SAMPLE_RATE / st.window, dspUs, cpu, us, us * rate / 1e4);
+        if (st.window == 1024 && st.overlapPct == 0) ffts[0] = rate;
+        if (st.window == 1024 && st.overlapPct == 75) ffts[1] = rate;
+    }
+    printf("(host figures; sensor_bench prints the same table on the device)\n\n");
+    check(ffts[0] > 0.0 && fabs(ffts[1] - 4.0 * ffts[0]) < 1e-6 * ffts[1],
+          "75% overlap runs four times the FFTs per second of samples at the same window");
+}
+
+struct RenderRun {
+    AudioStats stats;
+    double renderMeanUs;
+    double renderMaxUs;
+    double ageMeanMs;       // newest sample's age when the read returned
+    uint32_t reads;         // microphone reads made by the render thread
+};
+
+// `frames` frames at 60 FPS in real time, as the main loop would draw them
+static RenderRun renderFrames(LEDMatrix& matrix, int frames)
+{
+    AudioCapture& capture = AudioCapture::instance();
+    capture.latest();
+    capture.resetStats();
+
+    RenderRun run = {};
+    const uint32_t reads = sim_audio_reads_here();
+    auto next = std::chrono::steady_clock::now();
+    for (int n = 0; n < frames; ++n) {
+        next += std::chrono::microseconds(16667);
+        auto t0 = std::chrono::steady_clock::now();
+        draw_fft_visual(matrix, 1.0f / 60.0f);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        run.renderMeanUs += us / frames;
+        if (us > run.renderMaxUs) run.renderMaxUs = us;
+        run.ageMeanMs += sim_audio_age_us() / 1000.0 / frames;
+        std::this_thread::sleep_until(next);
+    }
+    run.stats = capture.stats();
+    run.reads = sim_audio_reads_here() - reads;
+    return run;
+}
+
+static double totalLatencyMs(const RenderRun& r)
+{
+    return r.ageMeanMs + r.stats.latencyMeanMs;
+}
+
+static void printRun(const char* name, const RenderRun& r)
+{
+    printf("%-18s %9.0f %8.0f %6u %6u %6u %8.2f %8.2f %8.2f %8.2f %7.1f\n", name, r.renderMeanUs,
+           r.renderMaxUs, r.stats.hops, r.stats.shown, r.stats.skipped, r.ageMeanMs, r.stats.latencyMeanMs,
+           r.stats.latencyMaxMs, totalLatencyMs(r), r.stats.processMeanUs);
+}
+
+// Waits (up to a second) for the capture task to open its channel
+static bool waitForChannel()
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!AudioCapture::instance().channelOpen() && std::chrono::steady_clock::now() < end)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return AudioCapture::instance().channelOpen();
+}
+
+// The spectrum screen holds the microphone only while it is showing
+static void checkChannelLifecycle(LEDMatrix& matrix)
+{
+    AudioCapture& capture = AudioCapture::instance();
+    SpectrumScreen screen;
+
+    screen.prepare(matrix);
+    check(!capture.taskRunning() && !capture.channelOpen() && capture.users() == 0,
+          "prepare() leaves the microphone off");
+    screen.release();
+
+    using clock = std::chrono::steady_clock;
+    const auto entered = clock::now();
+    screen.onEnter();
+    const double enterUs = std::chrono::duration<double, std::micro>(clock::now() - entered).count();
+    bool opened = waitForChannel();
+    const AudioSpectrum* s = nullptr;
+    for (auto end = clock::now() + std::chrono::seconds(1); !(s = capture.latest()) && clock::now() < end;)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const double firstMs = std::chrono::duration<double, std::milli>(clock::now() - entered).count();
+    printf("onEnter() %.0f us on the render side, first spectrum %.1f ms after it\n", enterUs, firstMs);
+    const size_t expected = s ? AudioCapture::dmaPlan(s->hop).bytes : 0;
+    check(opened && sim_audio_dma_bytes() == expected, "onEnter() opens one channel with DMA sized for the hop");
+    screen.update(1.0f / 60.0f);
+    screen.render(matrix);
+    screen.onExit();
+    check(opened && !capture.taskRunning() && !capture.channelOpen() && sim_audio_dma_bytes() == 0,
+          "onExit() stops the task and deletes the channel, DMA memory included");
+
+    // The screen manager releases screens in the background (idle timeout,
+    // making room) while another one shows
+    SpectrumScreen showing;
+    showing.onEnter();
+    opened = waitForChannel();
+    screen.prepare(matrix);
+    screen.release();
+    screen.release();
+    check(opened && capture.taskRunning() && capture.channelOpen() && capture.users() == 1,
+          "releasing a screen in the background keeps the showing one's capture");
+    showing.onExit();
+    check(!capture.taskRunning() && !capture.channelOpen() && capture.users() == 0,
+          "the last reference stops the capture");
+
+    // Spectrum, spectrogram, fireworks and round again: the incoming screen
+    // takes the microphone before the outgoing one lets go, so the channel
+    // carries over
+    {
+        ScreenManager manager(matrix);
+        manager.addScreen("Spectrum", []() -> BaseScreen* { return new SpectrumScreen(); }, 0);
+        manager.addScreen("Spectrogram", []() -> BaseScreen* { return new SpectrogramScreen(); }, 0);
+        manager.addScreen("Fireworks", []() -> BaseScreen* { return new FireworksScreen(); }, 0);
+        opened = waitForChannel();
+        const uint32_t channels = sim_audio_channels_opened();
+        bool kept = opened;
+        for (int i = 0; i < 3; ++i) {
+            manager.nextScreen();
+            manager.update(1.0f / 60.0f);
+            manager.render();
+            kept &= capture.channelOpen() && capture.users() == 1;
+        }
+        check(kept && sim_audio_channels_opened() == channels,
+              "switching between microphone screens keeps the channel open");
+        manager.current()->onExit();
+    }
+    check(capture.users() == 0 && !capture.channelOpen(), "leaving the last microphone screen closes the channel");
+}
+
+// DMA sized from each hop: memory held, and how fresh samples are when the
+// read returns, with the task and a 60 FPS reader in real time
+static void printDmaTable(LEDMatrix& matrix, int frames)
+{
+    static const int settings[][2] = {{256, 64}, {1024, 256}, {1024, 512}, {2048, 1024}, {2048, 2048}};
+    AudioCapture& capture = AudioCapture::instance();
+
+    printf("\n%-7s %5s %11s %9s %9s %8s %8s %8s %8s %8s\n", "window", "hop", "DMA", "DMA bytes", "buffers",
+           "gran ms", "age ms", "read ms", "total ms", "spectra");
+    bool fresh = true, sized = true;
+    for (const auto& st : settings) {
+        const AudioDmaPlan plan = AudioCapture::dmaPlan(st[1]);
+        capture.setAnalysis(st[0], st[1]);
+        capture.start();
+        // The first spectrum at the new hop comes from the new channel
+        auto end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        for (const AudioSpectrum* s = capture.latest(); (!s || s->hop != st[1]) && std::chrono::steady_clock::now() < end;
+             s = capture.latest())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        sized &= sim_audio_dma_bytes() == plan.bytes;
+
+        RenderRun run = renderFrames(matrix, frames);
+        char dma[16];
+        snprintf(dma, sizeof(dma), "%d x %d", plan.descriptors, plan.frames);
+        printf("%-7d %5d %11s %9zu %9zu %8.2f %8.2f %8.2f %8.2f %8u\n", st[0], st[1], dma, plan.bytes,
+               AudioCapture::analysisBytes(st[0], st[1]), plan.granularityMs, run.ageMeanMs,
+               run.stats.latencyMeanMs, totalLatencyMs(run), run.stats.shown);
+        fresh &= run.ageMeanMs < 2.0;
+    }
+    capture.stop();
+    printf("(before: legacy driver, 4 x 512 for every hop: 8192 DMA bytes, 11.61 ms granularity;\n"
+           " buffers: hop, ring, FFT frame and window held by the producer)\n\n");
+    check(sized, "each hop gets its own DMA sizing");
+    check(fresh, "at every hop the newest sample is under 2 ms old when the read returns");
+    check(sim_audio_dma_bytes() == 0, "stop() leaves no DMA memory behind");
+}
+
+struct GateRun {
+    double frameUs;         // update + render + show, capture on the render side included
+    float dspUs;            // analysis per hop, as /audio reports it
+    int redrawn;            // frames whose pixels changed
+    uint32_t hops;          // analysed during the frames
+    uint32_t transforms;    // ... of which ran the FFT
+    bool gated;
+};
+
+// The spectrum screen playing `samples` for `frames` frames once the hold
+// and the bars' fall are over, capturing on the render side, one hop per
+// frame
+static GateRun spectrumFrames(LEDMatrix& matrix, bool gate, const std::vector<float>& samples, int frames)
+{
+    AudioConfig ac = AppConfig::instance().getAudioConfig();
+    ac.gate = gate;
+    AppConfig::instance().setAudioConfig(ac);
+    sim_reset();
+    sim_audio_set_samples(samples);
+
+    SpectrumScreen screen;
+    screen.onEnter();
+    for (int n = 0; n < 480; ++n) {
+        screen.update(1.0f / 60.0f);
+        screen.render(matrix);
+        matrix.show();
+    }
+
+    GateRun run = {};
+    const AudioLevels before = AudioCapture::instance().levels();
+    const size_t bytes = (size_t)matrix.width() * matrix.height() * 3;
+    std::vector<uint8_t> last(matrix.shownPixels(), matrix.shownPixels() + bytes);
+    for (int n = 0; n < frames; ++n) {
+        auto t0 = std::chrono::steady_clock::now();
+        screen.update(1.0f / 60.0f);
+        screen.render(matrix);
+        matrix.show();
+        run.frameUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        if (memcmp(last.data(), matrix.shownPixels(), bytes)) {
+            run.redrawn++;
+            memcpy(last.data(), matrix.shownPixels(), bytes);
+        }
+    }
+    run.frameUs /= frames;
+
+    const AudioLevels& lv = AudioCapture::instance().levels();
+    run.dspUs = lv.level.active ? lv.activeUs : lv.idleUs;
+    run.gated = lv.gated;
+    run.hops = lv.hops - before.hops;
+    run.transforms = lv.transforms - before.transforms;
+    screen.onExit();
+    return run;
+}
+
+// What the silence gate saves on the spectrum screen, DSP and drawing
+static void printGateSavings(LEDMatrix& matrix, int frames)
+{
+    const AudioConfig saved = AppConfig::instance().getAudioConfig();
+    // Chords of 0.3 s with 0.2 s between them; a tone that never changes
+    // would become the noise floor, as a hum does
+    const int hop = AudioConfig().hop();
+    std::vector<float> music((size_t)(480 + frames) * hop);
+    for (size_t i = 0; i < music.size(); ++i) {
+        const double t = (double)i / AudioCapture::SAMPLE_RATE;
+        if (fmod(t, 0.5) >= 0.3) continue;
+        music[i] = (float)(0.3 * sin(2.0 * M_PI * 220.0 * t) + 0.2 * sin(2.0 * M_PI * 1000.0 * t) +
+                           0.1 * sin(2.0 * M_PI * 4000.0 * t));
+    }
+    const std::vector<float> silence(music.size(), 0.0f);
+
+    const GateRun sound = spectrumFrames(matrix, true, music, frames);
+    const GateRun open = spectrumFrames(matrix, false, silence, frames);
+    const GateRun gated = spectrumFrames(matrix, true, silence, frames);
+    AppConfig::instance().setAudioConfig(saved);
+
+    printf("\nSpectrum screen, %d frames at 60 FPS after the hold, one hop per frame\n", frames);
+    printf("%-22s %9s %8s %6s %6s %9s\n", "", "frame us", "dsp us", "hops", "FFTs", "redrawn");
+    auto row = [](const char* name, const GateRun& r) {
+        printf("%-22s %9.1f %8.2f %6u %6u %9d\n", name, r.frameUs, r.dspUs, r.hops, r.transforms, r.redrawn);
+    };
+    row("sound", sound);
+    row("silence, gate off", open);
+    row("silence, gate on", gated);
+    printf("(frame: update, render and show; dsp: per hop; redrawn: frames with changed pixels;\n"
+           " host figures, the device's are at /audio)\n\n");
+
+    check(!sound.gated && gated.gated && !open.gated, "the gate closes in silence only, and only when on");
+    check(sound.transforms == sound.hops && open.transforms == open.hops && open.hops > 0,
+          "every hop runs the FFT with sound, or with the gate off");
+    check(gated.hops == open.hops && gated.transforms == 0, "gated silence skips the FFT on every hop");
+    check(gated.redrawn > 0 && gated.redrawn <= frames / 10,
+          "the idle animation moves, at a few frames per second");
+}
+
+int audio_bench_run(int frames)
+{
+    checkTripleBuffer();
+
+    sim_reset();
+    AudioCapture& capture = AudioCapture::instance();
+    capture.setBands(32);
+    capture.start();
+    checkOverlap();
+    printCpuLoad(frames * 4);
+
+    // Render-side runs at the default analysis, 1024 samples with 75% overlap
+    const int window = 1024, hop = 256;
+    capture.setAnalysis(window, hop);
+    sim_reset();
+    sim_audio_set_realtime(true);
+
+    DisplayConfig dc;
+    dc.panel_width = 64;
+    dc.panel_height = 32;
+    LEDMatrix matrix(dc);
+    matrix.begin();
+
+    const double hopMs = 1000.0 * hop / AudioCapture::SAMPLE_RATE;
+
+    // Before: no task, every frame waits for its own block of samples
+    capture.start();
+    check(!capture.taskRunning(), "without tasks, capture falls back to the render side");
+    RenderRun inlineRun = renderFrames(matrix, frames);
+
+    // After: the capture task publishes every hop, render takes the newest
+    sim_set_tasks(true);
+    capture.start();
+    check(capture.taskRunning(), "capture task starts");
+    RenderRun taskRun = renderFrames(matrix, frames);
+    capture.stop();
+    check(!capture.taskRunning(), "capture task stops");
+
+    const double seconds = frames / 60.0;
+    printf("\n%.1f s at 60 FPS, %d-sample window, %d-sample hops (%.2f ms) at %d Hz\n", seconds, window, hop,
+           hopMs, AudioCapture::SAMPLE_RATE);
+    printf("%-18s %9s %8s %6s %6s %6s %8s %8s %8s %8s %7s\n", "", "render us", "max us", "hops", "shown",
+           "skip", "age ms", "read ms", "read max", "total ms", "dsp us");
+    printRun("capture in render", inlineRun);
+    printRun("capture task", taskRun);
+    printf("(age: newest sample when the read returns, from DMA buffering and backlog;\n"
+           " read: the read returning to the spectrum being drawn, as AudioCapture measures it\n"
+           " on the device; total: capture to drawn bar, the blit follows)\n\n");
+
+    const double expectedHops = seconds * AudioCapture::SAMPLE_RATE / hop;
+    check(taskRun.stats.hops > expectedHops * 0.9, "the task keeps up with the microphone, every hop analysed");
+    check(taskRun.stats.shown >= (uint32_t)(frames * 0.9), "nearly every frame draws a fresh spectrum");
+    check(taskRun.stats.latencyMeanMs < hopMs * 2, "mean read-to-render latency under two hops");
+    check(totalLatencyMs(taskRun) < totalLatencyMs(inlineRun), "capture-to-render latency is lower than before");
+    check(inlineRun.reads == (uint32_t)frames, "without the task, every frame waits for its own read");
+    check(taskRun.reads == 0, "with the task, render never reads the microphone");
+
+    checkChannelLifecycle(matrix);
+    printDmaTable(matrix, frames / 6 > 10 ? frames / 6 : 10);
+    printGateSavings(matrix, frames > 120 ? frames : 120);
+
+    sim_reset();
+    printf("\n%s\n", failures ? "FAILED" : "All audio checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Checks the triple buffer between two threads, then runs the audio
+// capture task against a microphone paced to the sample rate and renders
+// the spectrum at 60 FPS, reporting capture-to-render latency and render
+// cost next to capturing on the render side
+int audio_bench_run(int frames);
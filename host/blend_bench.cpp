@@ -0,0 +1,167 @@
+#include "blend_bench.h"
+#include "compositor.h"
+#include "xorshift.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+static void fillRandom(FrameBuffer& fb, uint32_t seed)
+{
+    XorShift32 rng(seed);
+    uint8_t* p = fb.pixels();
+    for (size_t i = 0; i < fb.sizeBytes(); ++i)
+        p[i] = (uint8_t)rng.next();
+}
+
+static void checkKernel()
+{
+    // Odd length so the scalar tail is exercised too
+    const size_t bytes = 64 * 32 * 3 + 7;
+    std::vector<uint32_t> a(bytes / 4 + 1), b(bytes / 4 + 1), fast(bytes / 4 + 1), ref(bytes / 4 + 1);
+    XorShift32 rng(7);
+    for (auto& w : a) w = rng.next();
+    for (auto& w : b) w = rng.next();
+
+    bool exact = true;
+    for (int alpha = 0; alpha <= 256; ++alpha) {
+        blend_rgb888((uint8_t*)fast.data(), (uint8_t*)a.data(), (uint8_t*)b.data(), bytes, (uint16_t)alpha);
+        blend_rgb888_scalar((uint8_t*)ref.data(), (uint8_t*)a.data(), (uint8_t*)b.data(), bytes, (uint16_t)alpha);
+        exact &= memcmp(fast.data(), ref.data(), bytes) == 0;
+    }
+    check(exact, "word-wide blend matches the scalar kernel for alpha 0..256");
+
+    // In place, the way the compositor calls it
+    memcpy(fast.data(), b.data(), bytes);
+    blend_rgb888((uint8_t*)fast.data(), (uint8_t*)a.data(), (uint8_t*)fast.data(), bytes, 100);
+    blend_rgb888_scalar((uint8_t*)ref.data(), (uint8_t*)a.data(), (uint8_t*)b.data(), bytes, 100);
+    check(memcmp(fast.data(), ref.data(), bytes) == 0, "blend in place (dst aliases b)");
+
+    // Sub-rectangles of a frame start on any byte
+    bool unaligned = true;
+    for (int offset = 1; offset < 4; ++offset) {
+        uint8_t* pa = (uint8_t*)a.data() + offset;
+        uint8_t* pb = (uint8_t*)b.data() + 4 - offset;
+        blend_rgb888((uint8_t*)fast.data() + offset, pa, pb, bytes - 4, 77);
+        blend_rgb888_scalar((uint8_t*)ref.data() + offset, pa, pb, bytes - 4, 77);
+        unaligned &= memcmp((uint8_t*)fast.data() + offset, (uint8_t*)ref.data() + offset, bytes - 4) == 0;
+    }
+    check(unaligned, "blend matches at every byte offset");
+}
+
+// Frame of a one-second transition at `progress` seconds, over a fixed
+// incoming frame
+static bool transitionFrame(Transition type, int direction, const FrameBuffer& from,
+                            const FrameBuffer& to, float progress, FrameBuffer& out)
+{
+    Compositor c;
+    if (!c.begin(from, type, 1.0f, direction)) return false;
+    c.update(progress);
+    memcpy(out.pixels(), to.pixels(), to.sizeBytes());
+    c.apply(out);
+    return true;
+}
+
+static void checkTransitions()
+{
+    const int w = 64, h = 32;
+    FrameBuffer from(w, h), to(w, h), out(w, h);
+    fillRandom(from, 1);
+    fillRandom(to, 2);
+
+    const Transition kinds[] = {Transition::CROSSFADE, Transition::SLIDE, Transition::WIPE};
+    bool starts = true;
+    for (Transition k : kinds)
+        for (int dir = -1; dir <= 1; dir += 2)
+            starts &= transitionFrame(k, dir, from, to, 0.0f, out) &&
+                      memcmp(out.pixels(), from.pixels(), out.sizeBytes()) == 0;
+    check(starts, "every transition starts on the outgoing frame");
+
+    // Halfway through a slide to the left: the left half shows the right
+    // half of the outgoing frame, the right half the left of the incoming
+    transitionFrame(Transition::SLIDE, 1, from, to, 0.5f, out);
+    const size_t half = (size_t)w / 2 * 3, stride = (size_t)w * 3;
+    bool slide = true;
+    for (int y = 0; y < h; ++y) {
+        slide &= memcmp(out.pixels() + y * stride, from.pixels() + y * stride + half, half) == 0;
+        slide &= memcmp(out.pixels() + y * stride + half, to.pixels() + y * stride, half) == 0;
+    }
+    check(slide, "slide at 50% shows both halves in place");
+
+    transitionFrame(Transition::SLIDE, -1, from, to, 0.5f, out);
+    slide = true;
+    for (int y = 0; y < h; ++y) {
+        slide &= memcmp(out.pixels() + y * stride, to.pixels() + y * stride + half, half) == 0;
+        slide &= memcmp(out.pixels() + y * stride + half, from.pixels() + y * stride, half) == 0;
+    }
+    check(slide, "reverse slide at 50% shows both halves in place");
+
+    transitionFrame(Transition::WIPE, 1, from, to, 0.5f, out);
+    bool wipe = true;
+    for (int y = 0; y < h; ++y) {
+        wipe &= memcmp(out.pixels() + y * stride, to.pixels() + y * stride, half) == 0;
+        wipe &= memcmp(out.pixels() + y * stride + half, from.pixels() + y * stride + half, half) == 0;
+    }
+    check(wipe, "wipe at 50% splits at the middle column");
+
+    Compositor c;
+    c.begin(from, Transition::CROSSFADE, 0.3f);
+    for (int i = 0; i < 18 && c.active(); ++i) c.update(1.0f / 60.0f);
+    check(!c.active(), "transition releases its layer when done");
+
+    StaticLayer layer;
+    layer.restore(out);
+    bool cleared = true;
+    for (size_t i = 0; i < out.sizeBytes(); ++i) cleared &= out.pixels()[i] == 0;
+    FrameBuffer* canvas = layer.redraw(w, h);
+    if (canvas) memcpy(canvas->pixels(), from.pixels(), from.sizeBytes());
+    layer.restore(out);
+    check(cleared && canvas && layer.ready(w, h) &&
+          memcmp(out.pixels(), from.pixels(), out.sizeBytes()) == 0,
+          "static layer clears when empty, restores once drawn");
+}
+
+static void benchKernel(int frames)
+{
+    const int sizes[][2] = {{64, 32}, {128, 64}, {256, 128}};
+    printf("\n%-9s %10s %12s %12s %8s\n", "canvas", "bytes", "scalar us", "word us", "speedup");
+    for (const auto& s : sizes) {
+        FrameBuffer a(s[0], s[1]), b(s[0], s[1]);
+        fillRandom(a, 3);
+        fillRandom(b, 4);
+        const size_t bytes = a.sizeBytes();
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i)
+            blend_rgb888_scalar(b.pixels(), a.pixels(), b.pixels(), bytes, (uint16_t)(i & 255));
+        auto t1 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i)
+            blend_rgb888(b.pixels(), a.pixels(), b.pixels(), bytes, (uint16_t)(i & 255));
+        auto t2 = std::chrono::steady_clock::now();
+
+        double scalarUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / frames;
+        double wordUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / frames;
+        printf("%4dx%-4d %10zu %12.2f %12.2f %7.1fx\n", s[0], s[1], bytes, scalarUs, wordUs,
+               wordUs > 0 ? scalarUs / wordUs : 0.0);
+    }
+    printf("(desktop compilers vectorize the scalar loop; the word-wide kernel is for\n"
+           " the S3's 32-bit core, see bench_blend in display_bench for device timings)\n");
+}
+
+int blend_bench_run(int frames)
+{
+    checkKernel();
+    checkTransitions();
+    benchKernel(frames);
+
+    printf("\n%s\n", failures ? "FAILED" : "All compositor checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Checks the compositor (word-wide blend vs. scalar reference, slide and
+// wipe end states, static layer restore) and times the blend kernel
+int blend_bench_run(int frames);
@@ -0,0 +1,121 @@
+#include "color_bench.h"
+#include "color_lut.h"
+#include "frame_buffer.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+// Keeps results observable so the compiler cannot drop the loops
+static volatile uint32_t sink;
+
+// -----------------------------------------------------
+// Code paths before the tables
+// -----------------------------------------------------
+static uint16_t legacy_wheel(uint8_t pos)
+{
+    pos = 255 - pos;
+    if (pos < 85) return FrameBuffer::color565(255 - pos * 3, 0, pos * 3);
+    if (pos < 170) {
+        pos -= 85;
+        return FrameBuffer::color565(0, pos * 3, 255 - pos * 3);
+    }
+    pos -= 170;
+    return FrameBuffer::color565(pos * 3, 255 - pos * 3, 0);
+}
+
+static void legacy_hsv(float h, uint8_t& r, uint8_t& g, uint8_t& b)
+{
+    float c = 1.0f;
+    float x = c * (1.0f - fabs(fmod(h / 60.0f, 2.0f) - 1.0f));
+    float r1, g1, b1;
+    if (h < 60)       { r1 = c; g1 = x; b1 = 0; }
+    else if (h < 120) { r1 = x; g1 = c; b1 = 0; }
+    else if (h < 180) { r1 = 0; g1 = c; b1 = x; }
+    else if (h < 240) { r1 = 0; g1 = x; b1 = c; }
+    else if (h < 300) { r1 = x; g1 = 0; b1 = c; }
+    else              { r1 = c; g1 = 0; b1 = x; }
+    r = (uint8_t)(r1 * 255);
+    g = (uint8_t)(g1 * 255);
+    b = (uint8_t)(b1 * 255);
+}
+
+// -----------------------------------------------------
+// Timing
+// -----------------------------------------------------
+template <typename F>
+static double ns_per_call(int iterations, F body)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) body(i);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+static void report(const char* name, double legacy, double lut)
+{
+    printf("%-24s %10.2f %10.2f %8.1fx\n", name, legacy, lut, lut > 0 ? legacy / lut : 0.0);
+}
+
+int color_bench_run(int iterations)
+{
+    printf("%-24s %10s %10s %9s\n", "path", "old ns", "lut ns", "speedup");
+
+    // Spectrum bars: wheel() -> 565 -> unpack to RGB888
+    double a = ns_per_call(iterations, [](int i) {
+        uint16_t c = legacy_wheel((uint8_t)i);
+        sink += ((c >> 11) & 0x1F) * 8 + ((c >> 5) & 0x3F) * 4 + (c & 0x1F) * 8;
+    });
+    double b = ns_per_call(iterations, [](int i) {
+        Rgb888 c = color_wheel((uint8_t)i);
+        sink += c.r + c.g + c.b;
+    });
+    report("wheel -> rgb888", a, b);
+
+    // Clock rainbow: float HSV per frame
+    a = ns_per_call(iterations, [](int i) {
+        uint8_t r, g, bl;
+        legacy_hsv((i % 3600) * 0.1f, r, g, bl);
+        sink += r + g + bl;
+    });
+    b = ns_per_call(iterations, [](int i) {
+        Rgb888 c = color_hue((uint8_t)((i % 3600) * 0.1f * (256.0f / 360.0f)));
+        sink += c.r + c.g + c.b;
+    });
+    report("hue -> rgb888", a, b);
+
+    // Spark fade: unpack 565, scale by a float life
+    a = ns_per_call(iterations, [](int i) {
+        uint16_t c = legacy_wheel((uint8_t)i);
+        float fade = (i & 0xFF) / 255.0f;
+        uint8_t r = ((c >> 11) & 0x1F) * 8 * fade;
+        uint8_t g = ((c >> 5) & 0x3F) * 4 * fade;
+        uint8_t bl = (c & 0x1F) * 8 * fade;
+        sink += r + g + bl;
+    });
+    b = ns_per_call(iterations, [](int i) {
+        Rgb888 c = scale_rgb(color_wheel((uint8_t)i), (uint8_t)i);
+        sink += c.r + c.g + c.b;
+    });
+    report("wheel + fade", a, b);
+
+    // Gamma: powf per channel vs table
+    a = ns_per_call(iterations, [](int i) {
+        sink += (uint8_t)(powf((i & 0xFF) / 255.0f, 2.2f) * 255.0f + 0.5f);
+    });
+    b = ns_per_call(iterations, [](int i) {
+        sink += color_gamma((uint8_t)i);
+    });
+    report("gamma", a, b);
+
+    // Tables must reproduce the old math
+    int wheelMismatch = 0, gammaError = 0;
+    for (int i = 0; i < 256; ++i) {
+        if (color_wheel565(i) != legacy_wheel(i)) wheelMismatch++;
+        int ref = (int)(powf(i / 255.0f, 2.2f) * 255.0f + 0.5f);
+        int err = abs(ref - color_gamma(i));
+        if (err > gammaError) gammaError = err;
+    }
+    printf("wheel table mismatches: %d, max gamma error: %d\n", wheelMismatch, gammaError);
+
+    return (wheelMismatch == 0 && gammaError <= 1) ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+// Compares the shared color tables (color_lut.h) with the per-call code
+// they replaced: wheel() through color565 and back, float HSV for the
+// clock, and float fades on unpacked RGB565 for sparks
+int color_bench_run(int iterations);
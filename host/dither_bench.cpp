@@ -0,0 +1,93 @@
+#include "dither_bench.h"
+#include "temporal_dither.h"
+#include "hub75_budget.h"
+#include "led_matrix.h"
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+struct LevelStats {
+    double meanError;   // mean |average output - target|, 12-bit units
+    int levels;         // distinguishable averaged levels out of 256 inputs
+};
+
+// Feeds each of the 256 gray levels through the encoder for `frames`
+// frames and compares the time-averaged light output with the target
+static LevelStats measure(int depth, bool dither, int frames)
+{
+    TemporalDither td;
+    td.configure(256, depth, dither);
+
+    std::vector<double> sum(256, 0.0);
+    uint8_t rgb[3], out[3];
+
+    for (int f = 0; f < frames; ++f) {
+        for (int v = 0; v < 256; ++v) {
+            rgb[0] = rgb[1] = rgb[2] = (uint8_t)v;
+            td.encode(v, rgb, out);
+            // The driver shows the top `depth` bits at full BCM weight
+            int level = out[0] >> (8 - depth);
+            sum[v] += level * 4095.0 / ((1 << depth) - 1);
+        }
+    }
+
+    LevelStats stats = {0.0, 0};
+    double last = -1.0;
+    for (int v = 0; v < 256; ++v) {
+        double avg = sum[v] / frames;
+        stats.meanError += fabs(avg - COLOR_GAMMA12[v]);
+        if (avg - last >= 0.5) {
+            stats.levels++;
+            last = avg;
+        }
+    }
+    stats.meanError /= 256;
+    return stats;
+}
+
+int dither_bench_run(int frames)
+{
+    printf("Averaged over %d frames; errors in 12-bit linear units\n", frames);
+    printf("%5s %11s %8s %11s %8s | %10s %7s | %10s %7s\n",
+           "depth", "DMA 64x32", "Hz", "DMA 128x64", "Hz",
+           "round err", "levels", "dither err", "levels");
+
+    for (int depth = TemporalDither::MIN_DEPTH; depth <= TemporalDither::MAX_DEPTH; ++depth) {
+        LevelStats plain = measure(depth, false, frames);
+        LevelStats dith = measure(depth, true, frames);
+
+        printf("%5d %11u %8.0f %11u %8.0f | %10.1f %7d | %10.1f %7d\n", depth,
+               (unsigned)hub75_dma_bytes(64, 32, 1, depth), hub75_refresh_hz(64, 32, 1, depth),
+               (unsigned)hub75_dma_bytes(64, 64, 2, depth), hub75_refresh_hz(64, 64, 2, depth),
+               plain.meanError, plain.levels, dith.meanError, dith.levels);
+    }
+
+    // Each profile applied through LEDMatrix::reconfigure(), as the web UI does
+    printf("\n%-13s %5s %4s | %11s %8s %4s | %11s %8s %4s\n", "profile", "depth", "MHz",
+           "DMA 64x32", "Hz", "lsb", "DMA 128x64", "Hz", "lsb");
+
+    DisplayConfig small, large;
+    large.panel_width = 64;
+    large.panel_height = 64;
+    large.chain_length = 2;
+    LEDMatrix smallPanel(small), largePanel(large);
+    smallPanel.begin();
+    largePanel.begin();
+
+    for (int p = 0; p < (int)DisplayProfile::COUNT; ++p) {
+        small.applyProfile((DisplayProfile)p);
+        large.applyProfile((DisplayProfile)p);
+        if (!smallPanel.reconfigure(small) || !largePanel.reconfigure(large)) {
+            printf("reconfigure failed for profile %d\n", p);
+            return 1;
+        }
+
+        const DisplayStatus& a = smallPanel.status();
+        const DisplayStatus& b = largePanel.status();
+        printf("%-13s %5d %4d | %11u %8u %4d | %11u %8u %4d\n",
+               display_profile_spec((DisplayProfile)p).id, a.color_depth, small.clock_mhz,
+               (unsigned)a.dma_bytes, (unsigned)a.refresh_hz, a.lsb_msb_transition,
+               (unsigned)b.dma_bytes, (unsigned)b.refresh_hz, b.lsb_msb_transition);
+    }
+    return 0;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Bit depth trade-off: DMA memory and refresh rate from the HUB75 cost
+// model, and how closely rounding vs. temporal dithering reproduce the
+// gamma-corrected target levels when averaged over time. Then the same
+// numbers for each display profile, switched at runtime on a simulated panel
+int dither_bench_run(int frames);
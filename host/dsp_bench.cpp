@@ -0,0 +1,573 @@
+#include "dsp_bench.h"
+#include "audio_analyzer.h"
+#include "timer.h"
+#include "wav_io.h"
+#include "xorshift.h"
+#include <algorithm>
+#include <filesystem>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+static const int RATE = 44100;
+static const int WINDOW = 1024;
+static const int HOP = 256;
+static const int BANDS = 32;
+static const int GOLDEN_STRIDE = 16;        // hops between golden rows, ~93 ms
+static const int GOLDEN_ROWS = 48;
+static const float GOLDEN_TOLERANCE_DB = 0.05f;
+static const float GOLDEN_FLOOR_DB = -90.0f;    // below this, rounding noise is not compared
+
+static const AudioPipeline PIPELINES[] = {AudioPipeline::FLOAT, AudioPipeline::Q15};
+static const char* PIPELINE_NAMES[] = {"float", "q15"};
+
+// -----------------------------------------------------
+// Signals, -1..1 at RATE
+// -----------------------------------------------------
+struct TestSignal {
+    std::string name;
+    std::vector<float> samples;
+    float toneHz;               // sines: the tone, 0 otherwise
+    float dbfs;                 // sines: its level
+};
+
+static std::vector<float> sine(double hz, double dbfs, double seconds)
+{
+    std::vector<float> x((size_t)(seconds * RATE));
+    const double a = pow(10.0, dbfs / 20.0);
+    for (size_t i = 0; i < x.size(); ++i) x[i] = (float)(a * sin(2.0 * M_PI * hz * i / RATE));
+    return x;
+}
+
+static std::vector<TestSignal> synthetic()
+{
+    std::vector<TestSignal> out;
+    out.push_back({"sine100", sine(100.0, -6.0, 1.0), 100.0f, -6.0f});
+    out.push_back({"sine1k", sine(1000.0, -20.0, 1.0), 1000.0f, -20.0f});
+    out.push_back({"sine8k", sine(8000.0, -40.0, 1.0), 8000.0f, -40.0f});
+
+    TestSignal tones = {"tones", std::vector<float>(RATE), 0.0f, 0.0f};
+    for (double hz : {220.0, 1760.0, 7040.0}) {
+        std::vector<float> s = sine(hz, -12.0, 1.0);
+        for (size_t i = 0; i < s.size(); ++i) tones.samples[i] += s[i];
+    }
+    out.push_back(tones);
+
+    // 50 Hz to 16 kHz over two seconds, exponentially, -12 dBFS
+    TestSignal chirp = {"chirp", std::vector<float>(2 * RATE), 0.0f, 0.0f};
+    const double k = log(16000.0 / 50.0) / chirp.samples.size();
+    for (size_t i = 0; i < chirp.samples.size(); ++i)
+        chirp.samples[i] = (float)(0.25 * sin(2.0 * M_PI * 50.0 / RATE * (exp(k * i) - 1.0) / k));
+    out.push_back(chirp);
+
+    TestSignal noise = {"noise", std::vector<float>(RATE), 0.0f, 0.0f};
+    XorShift32 rng(49);
+    for (float& v : noise.samples) v = 0.1f * ((int)rng.below(2001) - 1000) / 1000.0f;
+    out.push_back(noise);
+
+    out.push_back({"silence", std::vector<float>(RATE / 2, 0.0f), 0.0f, 0.0f});
+    return out;
+}
+
+// -----------------------------------------------------
+// Running
+// -----------------------------------------------------
+struct Playback {
+    std::vector<std::vector<float>> levels;     // band dBFS per hop
+    std::vector<float> referenceDb;             // AGC per hop
+    AudioStageUs meanUs;
+    int bands = 0;
+};
+
+// As I2S delivers them: 24-bit samples left-justified in 32-bit words
+static int32_t word(float v)
+{
+    v = v > 1.0f ? 1.0f : (v < -1.0f ? -1.0f : v);
+    return (int32_t)(v * 0x7FFFFF) * 256;
+}
+
+static Playback play(AudioAnalyzer& analyzer, const std::vector<float>& samples)
+{
+    analyzer.reset();
+    analyzer.gain().reset();
+    Playback run;
+    const int hop = analyzer.hop();
+    std::vector<int32_t> words(hop);
+    AudioSpectrum out;
+    AudioEvent event;
+    const int hops = (int)(samples.size() / hop);
+    for (int h = 0; h < hops; ++h) {
+        for (int i = 0; i < hop; ++i) words[i] = word(samples[(size_t)h * hop + i]);
+        analyzer.process(words.data(), (int64_t)h * hop * 1000000 / RATE, out, event);
+        run.levels.push_back(std::vector<float>(analyzer.levelsDb(), analyzer.levelsDb() + out.count));
+        run.referenceDb.push_back(out.referenceDb);
+
+        const AudioStageUs& st = analyzer.stageUs();
+        run.meanUs.activity += st.activity / hops;
+        run.meanUs.window += st.window / hops;
+        run.meanUs.fft += st.fft / hops;
+        run.meanUs.magnitude += st.magnitude / hops;
+        run.meanUs.bands += st.bands / hops;
+        run.meanUs.gain += st.gain / hops;
+        run.meanUs.onset += st.onset / hops;
+    }
+    run.bands = analyzer.bandCount();
+    return run;
+}
+
+// -----------------------------------------------------
+// What each signal should give
+// -----------------------------------------------------
+static double powerDb(const std::vector<float>& levels)
+{
+    double sum = 0.0;
+    for (float db : levels) sum += pow(10.0, db / 10.0);
+    return 10.0 * log10(sum + 1e-30);
+}
+
+static int loudest(const std::vector<float>& levels)
+{
+    return (int)(std::max_element(levels.begin(), levels.end()) - levels.begin());
+}
+
+struct Expectations {
+    bool toneBand = true, toneLevel = true, chirpClimbs = true, chirpSpan = true, noiseFlat = true,
+         silent = true;
+};
+
+static void checkPhysics(const TestSignal& sig, const Playback& run, const SpectrumBands& bands, Expectations& ph)
+{
+    const std::vector<float>& last = run.levels.back();
+    if (sig.toneHz > 0.0f) {
+        // Every band together holds the tone's power; the loudest holds its bin
+        const int bin = (int)lroundf(sig.toneHz * WINDOW / RATE);
+        ph.toneBand &= loudest(last) == bands.bandOf(bin);
+        ph.toneLevel &= fabs(powerDb(last) - sig.dbfs) < 0.5;
+    } else if (sig.name == "chirp") {
+        // Once the window is full, the loudest band only moves up, to the top
+        int prev = 0, top = 0;
+        for (size_t h = WINDOW / HOP; h < run.levels.size(); ++h) {
+            int b = loudest(run.levels[h]);
+            ph.chirpClimbs &= b >= prev - 1;
+            prev = std::max(prev, b);
+            top = std::max(top, b);
+        }
+        ph.chirpSpan &= top >= run.bands - 2;
+    } else if (sig.name == "noise") {
+        // Power per bin the same in every band wide enough to average
+        float lo = 1e9f, hi = -1e9f;
+        for (int b = 0; b < run.bands; ++b) {
+            const int bins = bands.edge(b + 1) - bands.edge(b);
+            if (bins < 8) continue;
+            double mean = 0.0;
+            for (size_t h = WINDOW / HOP; h < run.levels.size(); ++h) mean += run.levels[h][b];
+            mean /= run.levels.size() - WINDOW / HOP;
+            const float perBin = (float)(mean - 10.0 * log10((double)bins));
+            lo = std::min(lo, perBin);
+            hi = std::max(hi, perBin);
+        }
+        ph.noiseFlat &= hi - lo < 2.0f;
+    } else if (sig.name == "silence") {
+        for (float db : last) ph.silent &= db < -100.0f;
+        ph.silent &= run.referenceDb.back() == AutoGain().floorDb;
+    }
+}
+
+// -----------------------------------------------------
+// Goldens: one row every GOLDEN_STRIDE hops, band levels in dBFS
+// -----------------------------------------------------
+static std::vector<std::vector<float>> goldenRows(const Playback& run)
+{
+    std::vector<std::vector<float>> rows;
+    for (size_t h = GOLDEN_STRIDE - 1; h < run.levels.size() && rows.size() < GOLDEN_ROWS; h += GOLDEN_STRIDE)
+        rows.push_back(run.levels[h]);
+    return rows;
+}
+
+static bool writeGolden(const std::string& path, const std::string& title,
+                        const std::vector<std::vector<float>>& rows)
+{
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "# %s: %d-sample window, %d-sample hop, %d log bands 60 Hz-16 kHz\n", title.c_str(), WINDOW, HOP,
+            BANDS);
+    fprintf(f, "# band levels in dBFS every %d hops\n", GOLDEN_STRIDE);
+    for (const auto& row : rows) {
+        for (size_t b = 0; b < row.size(); ++b) fprintf(f, b ? " %.2f" : "%.2f", row[b]);
+        fprintf(f, "\n");
+    }
+    return fclose(f) == 0;
+}
+
+static bool readGolden(const std::string& path, std::vector<std::vector<float>>& rows)
+{
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return false;
+    char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') continue;
+        std::vector<float> row;
+        char* p = line;
+        for (;;) {
+            char* end;
+            float v = strtof(p, &end);
+            if (end == p) break;
+            row.push_back(v);
+            p = end;
+        }
+        if (!row.empty()) rows.push_back(row);
+    }
+    fclose(f);
+    return true;
+}
+
+// Worst difference over the levels above the floor; < 0 when the shapes differ
+static float goldenDiff(const std::vector<std::vector<float>>& golden, const std::vector<std::vector<float>>& rows)
+{
+    if (golden.size() != rows.size()) return -1.0f;
+    float worst = 0.0f;
+    for (size_t r = 0; r < rows.size(); ++r) {
+        if (golden[r].size() != rows[r].size()) return -1.0f;
+        for (size_t b = 0; b < rows[r].size(); ++b)
+            if (golden[r][b] > GOLDEN_FLOOR_DB || rows[r][b] > GOLDEN_FLOOR_DB)
+                worst = std::max(worst, fabsf(golden[r][b] - rows[r][b]));
+    }
+    return worst;
+}
+
+// Compares with the golden, or records it with `update`; counts a failure
+// on mismatch or when there is no golden
+static void matchGolden(const std::string& dir, const std::string& name, int pipeline, const Playback& run, bool update)
+{
+    const std::string title = name + ", " + PIPELINE_NAMES[pipeline];
+    const std::string path = dir + "/" + name + "." + PIPELINE_NAMES[pipeline] + ".txt";
+    const std::vector<std::vector<float>> rows = goldenRows(run);
+
+    if (update) {
+        if (writeGolden(path, title, rows)) {
+            printf("[ REC  ] %s -> %s\n", title.c_str(), path.c_str());
+        } else {
+            printf("[ FAIL ] %s: cannot write %s\n", title.c_str(), path.c_str());
+            failures++;
+        }
+        return;
+    }
+
+    std::vector<std::vector<float>> golden;
+    if (!readGolden(path, golden)) {
+        printf("[ FAIL ] %s: no golden at %s (record it with --update)\n", title.c_str(), path.c_str());
+        failures++;
+        return;
+    }
+
+    const float diff = goldenDiff(golden, rows);
+    if (diff < 0.0f) {
+        printf("[ FAIL ] %s: golden has %zu rows, run has %zu\n", title.c_str(), golden.size(), rows.size());
+        failures++;
+    } else if (diff > GOLDEN_TOLERANCE_DB) {
+        printf("[ FAIL ] %s: bands differ from the golden by up to %.2f dB\n", title.c_str(), diff);
+        failures++;
+    } else {
+        printf("[  OK  ] %s matches its golden (within %.2f dB)\n", title.c_str(), diff);
+    }
+}
+
+// -----------------------------------------------------
+// Stage timing
+// -----------------------------------------------------
+static void printTiming(int iterations)
+{
+    printf("\n%-6s %-6s %8s %8s %8s %8s %8s %8s %8s %9s %8s %8s\n", "window", "path", "level", "window", "fft",
+           "magn", "bands", "gain", "onsets", "hop us", "core %", "smooth");
+
+    // White noise, long enough for `iterations` hops at every hop size
+    std::vector<float> noise((size_t)iterations * 512 + 2048);
+    XorShift32 rng(7);
+    for (float& v : noise) v = 0.1f * ((int)rng.below(2001) - 1000) / 1000.0f;
+
+    // Bar smoothing runs per frame, not per hop: 64 bars at 60 FPS
+    BarSmoother bars;
+    float target[64];
+    for (int b = 0; b < 64; ++b) target[b] = (b % 7) / 7.0f;
+    uint32_t t0 = timer_cycles();
+    for (int f = 0; f < iterations; ++f) {
+        target[f % 64] = 1.0f - target[f % 64];
+        bars.process(target, 64, 1.0f / 60.0f);
+    }
+    const float smoothUs = timer_cycles_to_us_f(timer_cycles() - t0) / iterations;
+
+    for (int window : {256, 512, 1024, 2048}) {
+        for (int p = 0; p < 2; ++p) {
+            AudioAnalyzer analyzer;
+            analyzer.configure(window, window / 4, RATE);
+            analyzer.setBands(BANDS);
+            analyzer.setPipeline(PIPELINES[p]);
+            std::vector<float> clip(noise.begin(), noise.begin() + (size_t)iterations * window / 4);
+            const Playback run = play(analyzer, clip);
+            const AudioStageUs& us = run.meanUs;
+            const float rate = (float)RATE / (window / 4);
+            printf("%-6d %-6s %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %9.2f %7.3f%% %8.3f\n", window,
+                   PIPELINE_NAMES[p], us.activity, us.window, us.fft, us.magnitude, us.bands, us.gain, us.onset,
+                   us.total(), us.total() * rate / 1e4f, smoothUs);
+        }
+    }
+    printf("(75%% overlap, %d bands; level: activity detector; core %%: hop us x hops per second;\n"
+           " smooth: bar smoothing per frame, 64 bars;"
+           " host figures, SENSOR_BENCH logs the device's)\n", BANDS);
+}
+
+// -----------------------------------------------------
+// Silence gate
+// -----------------------------------------------------
+// A noisy room at -60 dBFS (a one-pole rumble under 300 Hz) throughout,
+// and over it in turn: nothing, notes with gaps, nothing, hiss 8 dB over
+// the room, nothing, a quiet tone 12 dB over the room
+static const float ROOM_DB = -60.0f;
+static const float NOTES_S = 3.0f, NOTES_END_S = 5.8f;     // the last note's end
+static const float HISS_S = 9.5f, HISS_END_S = 12.0f;
+static const float TONE_S = 14.0f, SCENE_END_S = 16.0f;
+
+static std::vector<float> gateScene()
+{
+    std::vector<float> x((size_t)(SCENE_END_S * RATE));
+    XorShift32 rng(50);
+    auto white = [&] { return ((int)rng.below(2001) - 1000) / 1000.0f; };
+
+    // Rumble, scaled to ROOM_DB once its level is known
+    const float a = expf(-2.0f * (float)M_PI * 300.0f / RATE);
+    float lp = 0.0f;
+    double sumSq = 0.0;
+    for (float& v : x) {
+        lp = a * lp + (1.0f - a) * white();
+        v = lp;
+        sumSq += (double)v * v;
+    }
+    const float room = (float)(pow(10.0, ROOM_DB / 20.0) / sqrt(2.0 * sumSq / x.size()));
+    for (float& v : x) v *= room;
+
+    // Five notes of 0.4 s with 0.2 s between them, -30 dBFS
+    static const float notes[] = {262.0f, 330.0f, 392.0f, 523.0f, 659.0f};
+    for (int n = 0; n < 5; ++n) {
+        const size_t start = (size_t)((NOTES_S + 0.6f * n) * RATE);
+        const std::vector<float> tone = sine(notes[n], -30.0, 0.4);
+        for (size_t i = 0; i < tone.size(); ++i) x[start + i] += tone[i];
+    }
+
+    // White noise has a full-scale sine's peak at sqrt(3) times its RMS
+    const float hiss = (float)(pow(10.0, (ROOM_DB + 8.0f) / 20.0) * sqrt(1.5));
+    for (size_t i = (size_t)(HISS_S * RATE); i < (size_t)(HISS_END_S * RATE); ++i) x[i] += hiss * white();
+
+    const std::vector<float> tone = sine(1000.0, ROOM_DB + 12.0f, SCENE_END_S - TONE_S);
+    for (size_t i = 0; i < tone.size(); ++i) x[(size_t)(TONE_S * RATE) + i] += tone[i];
+    return x;
+}
+
+struct GateHop {
+    AudioLevel level;
+    bool gated;
+    bool zeroed;            // all bands at 0
+    float us;               // process(), all of it
+};
+
+static std::vector<GateHop> runGate(AudioAnalyzer& analyzer, const std::vector<float>& samples)
+{
+    analyzer.reset();
+    analyzer.gain().reset();
+    std::vector<GateHop> hops;
+    const int hop = analyzer.hop();
+    std::vector<int32_t> words(hop);
+    AudioSpectrum out;
+    AudioEvent event;
+    for (size_t h = 0; (h + 1) * hop <= samples.size(); ++h) {
+        for (int i = 0; i < hop; ++i) words[i] = word(samples[h * hop + i]);
+        const uint32_t t0 = timer_cycles();
+        analyzer.process(words.data(), (int64_t)(h * hop * 1000000 / RATE), out, event);
+        GateHop g;
+        g.us = timer_cycles_to_us_f(timer_cycles() - t0);
+        g.level = out.level;
+        g.gated = out.gated;
+        g.zeroed = std::all_of(out.bands, out.bands + out.count, [](float b) { return b == 0.0f; });
+        hops.push_back(g);
+    }
+    return hops;
+}
+
+// Whether every hop from `fromS` to `toS` is (in)active
+static bool activeThrough(const std::vector<GateHop>& hops, float fromS, float toS, bool active)
+{
+    const int from = (int)(fromS * RATE / HOP), to = (int)(toS * RATE / HOP);
+    bool ok = to > from;
+    for (int h = from; h < to && h < (int)hops.size(); ++h) ok &= hops[h].level.active == active;
+    return ok;
+}
+
+// The hop holding sample `s` seconds in
+static int hopAt(float s)
+{
+    return (int)(s * RATE) / HOP;
+}
+
+static void checkGate(int iterations)
+{
+    const std::vector<float> scene = gateScene();
+    AudioAnalyzer analyzer;
+    analyzer.configure(WINDOW, HOP, RATE);
+    analyzer.setBands(BANDS);
+    analyzer.setGate(true);
+    const float hold = analyzer.activity().holdS;
+    const std::vector<GateHop> hops = runGate(analyzer, scene);
+
+    printf("\nSilence gate: room at %.0f dBFS, notes %.1f-%.1f s, hiss %.1f-%.1f s, quiet tone from %.1f s\n",
+           ROOM_DB, NOTES_S, NOTES_END_S, HISS_S, HISS_END_S, TONE_S);
+    printf("%6s %8s %8s %8s %6s %6s\n", "s", "rms dB", "peak dB", "floor dB", "zcr", "state");
+    for (float t = 0.5f; t < SCENE_END_S; t += 0.5f) {
+        const GateHop& g = hops[hopAt(t) - 1];
+        printf("%6.1f %8.1f %8.1f %8.1f %6.3f %6s\n", t, g.level.rmsDb, g.level.peakDb, g.level.floorDb,
+               g.level.zcr, g.gated ? "gated" : (g.level.active ? "sound" : "quiet"));
+    }
+
+    check(activeThrough(hops, hold + 0.5f, NOTES_S - 0.1f, false),
+          "the room alone is silence once the hold after start-up has run out");
+    check(!hops[hopAt(NOTES_S) - 1].level.active && hops[hopAt(NOTES_S)].level.active,
+          "the first note opens the gate on the hop it starts in");
+    check(activeThrough(hops, NOTES_S, NOTES_END_S, true), "the gaps between notes do not close it");
+    check(activeThrough(hops, NOTES_END_S, NOTES_END_S + hold - 0.05f, true) &&
+              activeThrough(hops, NOTES_END_S + hold + 0.05f, HISS_S, false),
+          "it closes the hold time after the last note");
+    check(activeThrough(hops, HISS_S, HISS_END_S, false), "hiss 8 dB over the room stays silence");
+    check(activeThrough(hops, TONE_S + 0.05f, SCENE_END_S, true), "a tone 12 dB over the room is sound");
+
+    const GateHop& note = hops[hopAt(NOTES_S + 0.3f)];
+    const GateHop& room = hops[hopAt(NOTES_S - 0.1f)];
+    printf("note: %.2f dBFS RMS, %.2f peak; room: %.2f RMS, floor %.2f\n", note.level.rmsDb, note.level.peakDb,
+           room.level.rmsDb, room.level.floorDb);
+    check(fabsf(note.level.rmsDb + 30.0f) < 0.2f && fabsf(note.level.peakDb + 30.0f) < 0.5f,
+          "a -30 dBFS sine reads -30 dBFS RMS and peak, as the bands do");
+    check(fabsf(room.level.floorDb - ROOM_DB) < 2.0f, "the noise floor reads the room's level within 2 dB");
+
+    bool zeroed = true, gatedOnlyInSilence = true;
+    for (const GateHop& g : hops) {
+        zeroed &= !g.gated || g.zeroed;
+        gatedOnlyInSilence &= g.gated == !g.level.active;
+    }
+    check(zeroed && gatedOnlyInSilence, "silence, and only silence, comes out gated with the bands at 0");
+
+    // Cost per hop of sound and of silence, gate off and on, over repeats
+    // of the scene
+    printf("\n%-6s %-5s %9s %10s %8s %10s\n", "path", "gate", "sound us", "silence us", "saving", "idle core");
+    const int repeats = std::max(1, iterations / (int)hops.size());
+    bool cheap = true;
+    for (int p = 0; p < 2; ++p) {
+        float silenceUs[2] = {0.0f, 0.0f};
+        for (int gate = 0; gate < 2; ++gate) {
+            analyzer.setPipeline(PIPELINES[p]);
+            analyzer.setGate(gate);
+            double us[2] = {0.0, 0.0};
+            int count[2] = {0, 0};
+            for (int r = 0; r < repeats; ++r) {
+                for (const GateHop& g : runGate(analyzer, scene)) {
+                    us[g.level.active] += g.us;
+                    count[g.level.active]++;
+                }
+            }
+            const float sound = (float)(us[1] / std::max(count[1], 1));
+            silenceUs[gate] = (float)(us[0] / std::max(count[0], 1));
+            const float saving = gate ? 100.0f * (1.0f - silenceUs[1] / silenceUs[0]) : 0.0f;
+            printf("%-6s %-5s %9.2f %10.2f %7.1f%% %9.3f%%\n", PIPELINE_NAMES[p], gate ? "on" : "off", sound,
+                   silenceUs[gate], saving, silenceUs[gate] * RATE / HOP / 1e4f);
+        }
+        cheap &= silenceUs[1] * 4.0f < silenceUs[0];
+    }
+    printf("(%d-sample window, %d-sample hop; idle core: silence us x hops per second; host figures)\n", WINDOW,
+           HOP);
+    check(cheap, "a gated hop of silence costs under a quarter of an analysed one");
+}
+
+int dsp_bench_run(const std::vector<const char*>& wavs, const std::string& goldenDir, bool update, int iterations)
+{
+    const std::string dir = goldenDir + "/dsp";
+    std::error_code ec;
+    if (update) std::filesystem::create_directories(dir, ec);
+
+    AudioAnalyzer analyzer;
+    check(!analyzer.configure(1000, 250, RATE) && !analyzer.configure(1024, 300, RATE) &&
+              analyzer.configure(WINDOW, HOP, RATE),
+          "analysis settings: the window a power of two, the hop dividing it");
+    analyzer.setBands(BANDS);
+
+    // Synthetic signals unless files are given
+    std::vector<TestSignal> signals;
+    if (wavs.empty()) {
+        signals = synthetic();
+    } else {
+        for (const char* path : wavs) {
+            TestSignal sig = {std::filesystem::path(path).stem().string(), {}, 0.0f, 0.0f};
+            int rate = 0;
+            if (!read_wav(path, sig.samples, rate)) {
+                printf("[ FAIL ] %s: not a readable WAV file\n", path);
+                failures++;
+                continue;
+            }
+            sig.samples = resample_linear(sig.samples, rate, RATE);
+            sig.name = "wav_" + sig.name;
+            signals.push_back(sig);
+        }
+    }
+
+    printf("%-10s %-6s %6s %9s %9s %9s\n", "signal", "path", "hops", "power dB", "loudest", "ref dB");
+    Expectations ph[2];
+    for (const TestSignal& sig : signals) {
+        for (int p = 0; p < 2; ++p) {
+            analyzer.setPipeline(PIPELINES[p]);
+            const Playback run = play(analyzer, sig.samples);
+            if (run.levels.empty()) continue;
+            printf("%-10s %-6s %6zu %9.2f %9d %9.2f\n", sig.name.c_str(), PIPELINE_NAMES[p], run.levels.size(),
+                   powerDb(run.levels.back()), loudest(run.levels.back()), run.referenceDb.back());
+            checkPhysics(sig, run, analyzer.bands(), ph[p]);
+            matchGolden(dir, sig.name, p, run, update);
+        }
+    }
+
+    if (wavs.empty()) {
+        printf("\n");
+        for (int p = 0; p < 2; ++p) {
+            const std::string n = PIPELINE_NAMES[p];
+            check(ph[p].toneBand, (n + ": each sine is loudest in the band holding its frequency").c_str());
+            check(ph[p].toneLevel, (n + ": the bands of a sine add up to its level within 0.5 dB").c_str());
+            check(ph[p].chirpClimbs && ph[p].chirpSpan, (n + ": the chirp's loudest band climbs to the top").c_str());
+            check(ph[p].noiseFlat, (n + ": white noise is flat per bin within 2 dB").c_str());
+            check(ph[p].silent, (n + ": silence stays below -100 dBFS with the gain at its floor").c_str());
+        }
+
+        // Bar smoothing keeps its time constants whatever the frame rate:
+        // after t of a step, 1 - exp(-t / tau) of the way there
+        bool smooth = true;
+        for (float dt : {1.0f / 30.0f, 1.0f / 60.0f, 1.0f / 240.0f}) {
+            BarSmoother bars;
+            const float one = 1.0f, zero = 0.0f;
+            bars.process(&zero, 1, dt);
+            const int frames = (int)ceilf(0.1f / dt);
+            for (int f = 0; f < frames; ++f) bars.process(&one, 1, dt);
+            const float risen = bars.levels()[0];
+            smooth &= fabsf(risen - (1.0f - expf(-frames * dt / bars.riseS))) < 1e-4f;
+            for (int f = 0; f < frames; ++f) bars.process(&zero, 1, dt);
+            smooth &= fabsf(bars.levels()[0] - risen * expf(-frames * dt / bars.fallS)) < 1e-4f;
+        }
+        check(smooth, "bar smoothing rises and falls by its time constants at 30, 60 and 240 FPS");
+
+        checkGate(iterations);
+        printTiming(iterations);
+    }
+
+    printf("\n%s\n", failures ? "FAILED" : "All DSP checks passed");
+    return failures ? 1 : 0;
+}
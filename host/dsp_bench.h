@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// The microphone's DSP (AudioAnalyzer, no hardware behind it) on a test
+// bench: synthetic sines, a chirp, white noise and silence, plus any WAV
+// files given, through both pipelines at a 1024-sample window and 256-
+// sample hop. Checks the band levels against what each signal should
+// give (tones land in their band at their level, the chirp climbs, noise
+// is flat per bin, silence stays silent) and against golden band levels
+// in `goldenDir`/dsp, recording missing ones (all with `update`). Then
+// prints microseconds per stage (window, FFT, magnitude, bands, gain,
+// onsets, bar smoothing) for every window size.
+int dsp_bench_run(const std::vector<const char*>& wavs, const std::string& goldenDir, bool update,
+                  int iterations);
@@ -0,0 +1,61 @@
+#include "anim_partition.h"
+#include "anim_player.h"
+#include "sim_fakes.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The partition is a file mapped read-only, as the flash is on the device
+static std::string animFile;
+static size_t mappedBytes = 0;
+
+AnimPartition& AnimPartition::instance()
+{
+    static AnimPartition inst;
+    return inst;
+}
+
+bool AnimPartition::map()
+{
+    if (_data) return true;
+    if (animFile.empty()) return false;
+
+    int fd = ::open(animFile.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    void* ptr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(AnimHeader))
+        ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) return false;
+
+    const AnimHeader* header = (const AnimHeader*)ptr;
+    if (header->magic != ANIM_MAGIC || header->fileBytes < sizeof(AnimHeader) ||
+        header->fileBytes > (size_t)st.st_size) {
+        munmap(ptr, st.st_size);
+        return false;
+    }
+
+    _data = (const uint8_t*)ptr;
+    _size = header->fileBytes;
+    mappedBytes = st.st_size;
+    return true;
+}
+
+void AnimPartition::unmap()
+{
+    if (!_data) return;
+    munmap((void*)_data, mappedBytes);
+    _data = nullptr;
+    _size = 0;
+}
+
+void sim_set_anim_file(const char* path)
+{
+    AnimPartition::instance().unmap();
+    animFile = path ? path : "";
+}
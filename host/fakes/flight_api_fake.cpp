@@ -0,0 +1,96 @@
+#include "flight_api.h"
+#include "sim_fakes.h"
+#include <string.h>
+
+// Fixture handed out by the next fetchFlights() call
+static std::vector<Flight> fixture;
+
+FlightAPI& FlightAPI::instance()
+{
+    static FlightAPI inst;
+    return inst;
+}
+
+void FlightAPI::begin()
+{
+    initialized = true;
+}
+
+bool FlightAPI::fetchFlights(float, float, float, float)
+{
+    flights = fixture;
+    fetchGeneration++;
+    history.beginPoll();
+    for (const Flight& f : flights)
+        history.record(f);
+    return true;
+}
+
+void FlightAPI::resetFetchTimer() {}
+
+const std::vector<Flight>& FlightAPI::getFlights() const
+{
+    return flights;
+}
+
+size_t FlightAPI::getFlightCount() const
+{
+    return flights.size();
+}
+
+uint32_t FlightAPI::getFetchGeneration() const
+{
+    return fetchGeneration;
+}
+
+const FlightHistory& FlightAPI::getHistory() const
+{
+    return history;
+}
+
+bool FlightAPI::canFetch() const
+{
+    return false;
+}
+
+int FlightAPI::getSecondsUntilNextFetch() const
+{
+    return 0;
+}
+
+bool FlightAPI::validateStoredCredentials()
+{
+    return false;
+}
+
+int FlightAPI::getMinFetchInterval() const
+{
+    return MIN_FETCH_INTERVAL_UNAUTHENTICATED;
+}
+
+void sim_set_flights(const std::vector<Flight>& flights)
+{
+    fixture = flights;
+}
+
+Flight sim_make_flight(const char* callsign, const char* country,
+                       float lat, float lon, float altitude, float velocity, float heading)
+{
+    Flight f;
+
+    // Stable made-up transponder address: FNV-1a of the callsign
+    uint32_t hash = 2166136261u;
+    for (const char* c = callsign; *c; ++c)
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    f.icao24 = hash & 0xFFFFFF;
+
+    strncpy(f.callsign, callsign, sizeof(f.callsign) - 1);
+    strncpy(f.country, country, sizeof(f.country) - 1);
+    f.latitude = lat;
+    f.longitude = lon;
+    f.altitude = altitude;
+    f.velocity = velocity;
+    f.heading = heading;
+    f.valid = true;
+    return f;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// Control surface for the fake WiFi, time, flight and audio sources the
+// simulator links in place of the ESP-IDF implementations.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "flight_api.h"
+#include "wifi_manager.h"
+
+// Restore every fake to its default (disconnected, unsynced, no flights,
+// RNG reseeded) so each scenario starts from the same state
+void sim_reset(uint32_t seed = 1);
+
+void sim_set_wifi(WiFiState state, const char* ip = "192.168.1.42");
+
+// Local time reported by time_sync_get_time(); synced drives time_sync_ready()
+void sim_set_time(int hour, int minute, bool synced = true);
+
+// Flights returned by the next FlightAPI::fetchFlights() call
+void sim_set_flights(const std::vector<Flight>& flights);
+Flight sim_make_flight(const char* callsign, const char* country,
+                       float lat, float lon, float altitude, float velocity, float heading);
+
+// File standing in for the anim flash partition; nullptr = no partition
+void sim_set_anim_file(const char* path);
+
+// Synthetic microphone: sum of sines (Hz, amplitude 0..1) or silence
+void sim_audio_set_tones(const std::vector<std::pair<float, float>>& tones);
+
+// Microphone playing recorded samples (-1..1 full scale, at the capture's
+// 44.1 kHz) from the start, then silence; replaces the tones until the
+// next sim_audio_set_tones()
+void sim_audio_set_samples(const std::vector<float>& samples);
+
+// Pace i2s_channel_read() to the sample rate and the channel's DMA
+// buffers instead of returning at once
+void sim_audio_set_realtime(bool realtime);
+
+// Real time only: how old the newest sample of the last
+// i2s_channel_read() was when the call returned (DMA buffering and backlog)
+int64_t sim_audio_age_us();
+
+// DMA buffer bytes held by I2S channels not yet deleted
+size_t sim_audio_dma_bytes();
+
+// I2S channels created so far
+uint32_t sim_audio_channels_opened();
+
+// i2s_channel_read() calls made so far by the calling thread
+uint32_t sim_audio_reads_here();
+
+// Let xTaskCreatePinnedToCore() start real threads; off after sim_reset()
+void sim_set_tasks(bool enabled);
@@ -0,0 +1,275 @@
+#include "sim_fakes.h"
+#include "esp_random.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "driver/i2s_std.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <malloc.h>
+#include <math.h>
+
+// -----------------------------------------------------
+// esp_random - xorshift32 so runs are reproducible
+// -----------------------------------------------------
+static uint32_t rngState = 1;
+
+uint32_t esp_random(void)
+{
+    uint32_t x = rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rngState = x;
+    return x;
+}
+
+// -----------------------------------------------------
+// esp_system / esp_timer
+// -----------------------------------------------------
+uint32_t esp_get_free_heap_size(void)
+{
+    return 200000;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+    return 180000;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+// -----------------------------------------------------
+// esp_heap_caps - live bytes from the allocator against a nominal 8 MB
+// (an S3 with PSRAM)
+// -----------------------------------------------------
+static const size_t SIM_HEAP_BYTES = 8 * 1024 * 1024;
+static size_t heapMinFree = SIM_HEAP_BYTES;
+
+size_t heap_caps_get_free_size(unsigned)
+{
+    size_t used = mallinfo2().uordblks;
+    size_t free = used < SIM_HEAP_BYTES ? SIM_HEAP_BYTES - used : 0;
+    if (free < heapMinFree) heapMinFree = free;
+    return free;
+}
+
+size_t heap_caps_get_minimum_free_size(unsigned caps)
+{
+    heap_caps_get_free_size(caps);
+    return heapMinFree;
+}
+
+// -----------------------------------------------------
+// Synthetic I2S microphone
+// -----------------------------------------------------
+static const float SIM_SAMPLE_RATE = 44100.0f;
+static std::vector<std::pair<float, float>> audioTones;
+static uint64_t audioSample = 0;
+static bool audioRealtime = false;
+static int64_t audioStartUs = 0;       // when audioOrigin was recorded
+static uint64_t audioOrigin = 0;        // first sample of the running channel
+static int audioDmaLen = 512;
+static int audioDmaCount = 4;
+static std::atomic<int64_t> audioAgeUs{0};
+
+struct i2s_channel_obj_t {
+    std::vector<uint8_t> dma;       // stands in for the driver's DMA buffers
+    bool configured = false;
+    bool enabled = false;
+};
+static std::atomic<size_t> audioDmaBytes{0};
+static std::atomic<uint32_t> audioChannels{0};
+static thread_local uint32_t audioReadsHere = 0;
+
+static std::vector<float> audioSamples;
+static bool audioPlayback = false;
+
+void sim_audio_set_tones(const std::vector<std::pair<float, float>>& tones)
+{
+    audioTones = tones;
+    audioPlayback = false;
+    audioSample = 0;
+}
+
+void sim_audio_set_samples(const std::vector<float>& samples)
+{
+    audioSamples = samples;
+    audioPlayback = true;
+    audioSample = 0;
+}
+
+void sim_audio_set_realtime(bool realtime)
+{
+    audioRealtime = realtime;
+    audioSample = 0;
+    audioOrigin = 0;
+    audioStartUs = esp_timer_get_time();
+    audioAgeUs = 0;
+}
+
+int64_t sim_audio_age_us()
+{
+    return audioAgeUs;
+}
+
+size_t sim_audio_dma_bytes()
+{
+    return audioDmaBytes;
+}
+
+uint32_t sim_audio_channels_opened()
+{
+    return audioChannels;
+}
+
+uint32_t sim_audio_reads_here()
+{
+    return audioReadsHere;
+}
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t* config, i2s_chan_handle_t* tx, i2s_chan_handle_t* rx)
+{
+    if (tx || !rx || config->dma_desc_num < 2 || config->dma_frame_num == 0) return ESP_ERR_INVALID_ARG;
+    i2s_chan_handle_t chan = new i2s_channel_obj_t;
+    chan->dma.resize((size_t)config->dma_desc_num * config->dma_frame_num * sizeof(int32_t));
+    audioDmaLen = config->dma_frame_num;
+    audioDmaCount = config->dma_desc_num;
+    audioDmaBytes += chan->dma.size();
+    audioChannels++;
+    *rx = chan;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t*)
+{
+    if (!handle || handle->enabled) return ESP_ERR_INVALID_STATE;
+    handle->configured = true;
+    return ESP_OK;
+}
+
+// Recording starts when the channel is enabled, from where the signal
+// left off, and the DMA buffers fill from there
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle)
+{
+    if (!handle || !handle->configured || handle->enabled) return ESP_ERR_INVALID_STATE;
+    handle->enabled = true;
+    audioOrigin = audioSample;
+    audioStartUs = esp_timer_get_time();
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle)
+{
+    if (!handle || !handle->enabled) return ESP_ERR_INVALID_STATE;
+    handle->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_del_channel(i2s_chan_handle_t handle)
+{
+    if (!handle || handle->enabled) return ESP_ERR_INVALID_STATE;
+    audioDmaBytes -= handle->dma.size();
+    delete handle;
+    return ESP_OK;
+}
+
+// In real time, samples become readable a whole DMA buffer at a time, and
+// when the reader falls more than the DMA buffers behind the oldest are
+// dropped, as with the driver
+esp_err_t i2s_channel_read(i2s_chan_handle_t handle, void* dest, size_t size, size_t* bytes_read, uint32_t)
+{
+    if (!handle || !handle->enabled) return ESP_ERR_INVALID_STATE;
+    audioReadsHere++;
+    int32_t* out = (int32_t*)dest;
+    size_t count = size / sizeof(int32_t);
+
+    if (audioRealtime) {
+        int64_t elapsed = esp_timer_get_time() - audioStartUs;
+        uint64_t recorded = (uint64_t)(elapsed * 1e-6 * SIM_SAMPLE_RATE) / audioDmaLen * audioDmaLen;
+        uint64_t capacity = (uint64_t)audioDmaLen * audioDmaCount;
+        uint64_t read = audioSample - audioOrigin;
+        if (recorded > read + capacity) audioSample = audioOrigin + recorded - capacity;
+        read = audioSample - audioOrigin;
+
+        uint64_t buffers = (read + count + audioDmaLen - 1) / audioDmaLen;
+        int64_t readyUs = audioStartUs + (int64_t)(buffers * audioDmaLen * 1e6 / SIM_SAMPLE_RATE);
+        int64_t waitUs = readyUs - esp_timer_get_time();
+        if (waitUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(waitUs));
+    }
+
+    for (size_t i = 0; i < count; ++i, ++audioSample) {
+        // Full scale of the 24-bit ICS-43434 word, left-justified
+        if (audioPlayback) {
+            float v = audioSample < audioSamples.size() ? audioSamples[audioSample] : 0.0f;
+            v = v > 1.0f ? 1.0f : (v < -1.0f ? -1.0f : v);
+            out[i] = (int32_t)(v * 0x7FFFFF) * 256;
+            continue;
+        }
+        double t = (double)audioSample / SIM_SAMPLE_RATE;
+        double v = 0.0;
+        for (const auto& tone : audioTones) {
+            v += tone.second * sin(2.0 * M_PI * tone.first * t);
+        }
+        int32_t s24 = (int32_t)(v * 0x7FFFFF * 0.5);
+        out[i] = s24 * 256;
+    }
+
+    if (audioRealtime)
+        audioAgeUs = esp_timer_get_time() -
+                     (audioStartUs + (int64_t)((audioSample - audioOrigin) * 1e6 / SIM_SAMPLE_RATE));
+
+    if (bytes_read) *bytes_read = count * sizeof(int32_t);
+    return ESP_OK;
+}
+
+// -----------------------------------------------------
+// FreeRTOS tasks on detached threads, when enabled
+// -----------------------------------------------------
+static bool tasksEnabled = false;
+
+void sim_set_tasks(bool enabled)
+{
+    tasksEnabled = enabled;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char*, uint32_t, void* arg, UBaseType_t,
+                                   TaskHandle_t* handle, BaseType_t)
+{
+    if (!tasksEnabled) return pdFAIL;
+    static uintptr_t nextHandle = 1;
+    std::thread(fn, arg).detach();
+    if (handle) *handle = (TaskHandle_t)nextHandle++;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t)
+{
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+// -----------------------------------------------------
+// Shared reset
+// -----------------------------------------------------
+void sim_reset(uint32_t seed)
+{
+    rngState = seed ? seed : 1;
+    sim_set_wifi(WiFiState::DISCONNECTED, "0.0.0.0");
+    sim_set_time(12, 0, false);
+    sim_set_flights({});
+    FlightAPI::instance().fetchFlights(-90.0f, 90.0f, -180.0f, 180.0f);
+    sim_audio_set_tones({{220.0f, 0.3f}, {1000.0f, 0.2f}, {4000.0f, 0.1f}});
+    sim_audio_set_realtime(false);
+    sim_set_tasks(false);
+}
@@ -0,0 +1,31 @@
+#include "time_sync.h"
+#include "sim_fakes.h"
+#include <string.h>
+
+static bool synced = false;
+static struct tm simTime;
+
+void time_sync_init(const char*) {}
+void time_sync_start() {}
+void time_sync_set_timezone(const char*) {}
+
+bool time_sync_ready()
+{
+    return synced;
+}
+
+void time_sync_get_time(struct tm* timeinfo)
+{
+    *timeinfo = simTime;
+}
+
+void sim_set_time(int hour, int minute, bool isSynced)
+{
+    memset(&simTime, 0, sizeof(simTime));
+    simTime.tm_year = 2025 - 1900;
+    simTime.tm_mon = 0;
+    simTime.tm_mday = 1;
+    simTime.tm_hour = hour;
+    simTime.tm_min = minute;
+    synced = isSynced;
+}
@@ -0,0 +1,42 @@
+#include "wifi_manager.h"
+#include "sim_fakes.h"
+#include <string.h>
+
+WiFiManager& WiFiManager::instance()
+{
+    static WiFiManager inst;
+    return inst;
+}
+
+void WiFiManager::begin() {}
+void WiFiManager::startAP() { state = WiFiState::AP_MODE; }
+
+void WiFiManager::startSTA(const char* s, const char* p)
+{
+    strncpy(ssid, s, sizeof(ssid) - 1);
+    strncpy(pwd, p, sizeof(pwd) - 1);
+    state = WiFiState::CONNECTED;
+}
+
+WiFiState WiFiManager::getState() { return state; }
+const char* WiFiManager::getSSID() { return ssid; }
+const char* WiFiManager::getIPAddress() { return ipStr; }
+
+bool WiFiManager::hasSavedCredentials() { return false; }
+void WiFiManager::saveCredentials(const char*, const char*) {}
+void WiFiManager::loadCredentials() {}
+void WiFiManager::clearCredentials() {}
+
+void WiFiManager::setState(WiFiState s) { state = s; }
+
+void WiFiManager::setIPAddress(const char* ip)
+{
+    strncpy(ipStr, ip, sizeof(ipStr) - 1);
+    ipStr[sizeof(ipStr) - 1] = '\0';
+}
+
+void sim_set_wifi(WiFiState state, const char* ip)
+{
+    WiFiManager::instance().setState(state);
+    WiFiManager::instance().setIPAddress(ip);
+}
@@ -0,0 +1,210 @@
+#include "fft_bench.h"
+#include "fft.h"
+#include "xorshift.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+// The microphone's previous FFT: complex radix-2 over zero imaginary
+// parts, twiddles advanced by a recurrence, kept here as the baseline
+static void legacyFft(float* real, float* imag, int n)
+{
+    int j = 0;
+    for (int i = 0; i < n - 1; ++i) {
+        if (i < j) {
+            float tr = real[i]; real[i] = real[j]; real[j] = tr;
+            float ti = imag[i]; imag[i] = imag[j]; imag[j] = ti;
+        }
+        int k = n >> 1;
+        while (k <= j) {
+            j -= k;
+            k >>= 1;
+        }
+        j += k;
+    }
+
+    for (int len = 2; len <= n; len <<= 1) {
+        float angle = -2.0f * (float)M_PI / len;
+        float wlenCos = cosf(angle);
+        float wlenSin = sinf(angle);
+        for (int i = 0; i < n; i += len) {
+            float wCos = 1.0f;
+            float wSin = 0.0f;
+            for (int k = 0; k < len / 2; ++k) {
+                int u = i + k;
+                int v = i + k + len / 2;
+                float tr = wCos * real[v] - wSin * imag[v];
+                float ti = wCos * imag[v] + wSin * real[v];
+                real[v] = real[u] - tr;
+                imag[v] = imag[u] - ti;
+                real[u] += tr;
+                imag[u] += ti;
+                float tmp = wCos;
+                wCos = tmp * wlenCos - wSin * wlenSin;
+                wSin = tmp * wlenSin + wSin * wlenCos;
+            }
+        }
+    }
+}
+
+// Bins 0..n/2 of the DFT, in double precision
+static void referenceDft(const std::vector<float>& x, std::vector<double>& re, std::vector<double>& im)
+{
+    const int n = (int)x.size();
+    std::vector<double> c(n), s(n);
+    for (int i = 0; i < n; ++i) {
+        c[i] = cos(2.0 * M_PI * i / n);
+        s[i] = -sin(2.0 * M_PI * i / n);
+    }
+    re.assign(n / 2 + 1, 0.0);
+    im.assign(n / 2 + 1, 0.0);
+    for (int k = 0; k <= n / 2; ++k) {
+        double sr = 0.0, si = 0.0;
+        for (int i = 0; i < n; ++i) {
+            int t = (int)(((long long)k * i) % n);
+            sr += x[i] * c[t];
+            si += x[i] * s[t];
+        }
+        re[k] = sr;
+        im[k] = si;
+    }
+}
+
+// Windowed microphone-like input: a few sines over noise, in the range
+// the microphone path feeds the FFT (24-bit samples >> 14)
+static std::vector<float> testSignal(int n, int kind, XorShift32& rng)
+{
+    std::vector<float> x(n);
+    for (int i = 0; i < n; ++i) {
+        double t = (double)i / n;
+        double v = 0.0;
+        if (kind == 0) {
+            v = 300.0 * sin(2.0 * M_PI * 5.0 * t) + 120.0 * sin(2.0 * M_PI * (n / 7.3) * t);
+        } else if (kind == 1) {
+            v = ((int)(rng.next() % 1024) - 512);
+        } else {
+            v = 400.0 * sin(2.0 * M_PI * (n / 2.0 - 3.5) * t) + ((int)(rng.next() % 64) - 32);
+        }
+        double w = 0.5 * (1.0 - cos(2.0 * M_PI * i / (n - 1)));
+        x[i] = (float)(v * w);
+    }
+    return x;
+}
+
+struct FftError {
+    double max = 0.0;       // worst bin error / largest reference bin
+    double rms = 0.0;       // RMS bin error / RMS reference bin
+};
+
+template <typename Bin>
+static FftError measureError(const std::vector<double>& re, const std::vector<double>& im, Bin bin)
+{
+    double peak = 0.0, sumRef = 0.0, sumErr = 0.0, worst = 0.0;
+    for (size_t k = 0; k < re.size(); ++k) {
+        double r, i;
+        bin((int)k, r, i);
+        double e = hypot(r - re[k], i - im[k]);
+        double m = hypot(re[k], im[k]);
+        if (m > peak) peak = m;
+        if (e > worst) worst = e;
+        sumRef += m * m;
+        sumErr += e * e;
+    }
+    FftError err;
+    err.max = worst / peak;
+    err.rms = sqrt(sumErr / sumRef);
+    return err;
+}
+
+template <typename F>
+static double timeUs(int iterations, F body)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) body();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / iterations;
+}
+
+int fft_bench_run(int iterations)
+{
+    RealFFT fft;
+    check(!fft.init(100) && !fft.init(4) && !fft.init(8192) && fft.size() == 0,
+          "sizes that are not powers of two from 8 to 4096 are refused");
+
+    printf("\n%-6s %12s %12s %8s %12s %12s %12s %12s\n", "points", "complex us", "real us", "speedup",
+           "old max err", "old rms err", "new max err", "new rms err");
+
+    XorShift32 rng(41);
+    bool accurate = true, better = true, magnitudes = true;
+    const int sizes[] = {256, 512, 1024};
+    for (int n : sizes) {
+        fft.init(n);
+
+        FftError oldWorst, newWorst;
+        for (int kind = 0; kind < 3; ++kind) {
+            std::vector<float> x = testSignal(n, kind, rng);
+            std::vector<double> re, im;
+            referenceDft(x, re, im);
+
+            std::vector<float> real(x), imag(n, 0.0f);
+            legacyFft(real.data(), imag.data(), n);
+            FftError o = measureError(re, im, [&](int k, double& r, double& i) { r = real[k]; i = imag[k]; });
+
+            std::vector<float> packed(x);
+            fft.forward(packed.data());
+            FftError e = measureError(re, im, [&](int k, double& r, double& i) {
+                if (k == 0) { r = packed[0]; i = 0.0; }
+                else if (k == n / 2) { r = packed[1]; i = 0.0; }
+                else { r = packed[2 * k]; i = packed[2 * k + 1]; }
+            });
+
+            double peak = 0.0;
+            for (int k = 0; k <= n / 2; ++k) peak = fmax(peak, hypot(re[k], im[k]));
+            for (int k = 0; k < n / 2; ++k)
+                magnitudes &= fabs(RealFFT::magnitude(packed.data(), k) - hypot(re[k], im[k])) <= 1e-5 * peak;
+
+            if (o.max > oldWorst.max) oldWorst.max = o.max;
+            if (o.rms > oldWorst.rms) oldWorst.rms = o.rms;
+            if (e.max > newWorst.max) newWorst.max = e.max;
+            if (e.rms > newWorst.rms) newWorst.rms = e.rms;
+        }
+        accurate &= newWorst.max < 1e-5 && newWorst.rms < 1e-5;
+        better &= newWorst.max <= oldWorst.max;
+
+        // Cost per transform, including the copy in that both need
+        const int reps = iterations * 256 / n;
+        std::vector<float> x = testSignal(n, 0, rng);
+        std::vector<float> real(n), imag(n), packed(n);
+        double oldUs = timeUs(reps, [&] {
+            for (int i = 0; i < n; ++i) {
+                real[i] = x[i];
+                imag[i] = 0.0f;
+            }
+            legacyFft(real.data(), imag.data(), n);
+        });
+        double newUs = timeUs(reps, [&] {
+            for (int i = 0; i < n; ++i) packed[i] = x[i];
+            fft.forward(packed.data());
+        });
+
+        printf("%-6d %12.2f %12.2f %7.1fx %12.2e %12.2e %12.2e %12.2e\n", n, oldUs, newUs, oldUs / newUs,
+               oldWorst.max, oldWorst.rms, newWorst.max, newWorst.rms);
+    }
+    printf("(errors relative to the largest / RMS bin of a double-precision DFT, "
+           "worst of sines, noise and near-Nyquist tones)\n\n");
+
+    check(accurate, "real FFT within 1e-5 of the double-precision DFT at every size");
+    check(better, "real FFT at least as accurate as the complex FFT it replaces");
+    check(magnitudes, "magnitude() of the packed spectrum matches the reference bins");
+
+    printf("\n%s\n", failures ? "FAILED" : "All FFT checks passed");
+    return failures ? 1 : 0;
+}
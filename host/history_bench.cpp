@@ -0,0 +1,156 @@
+#include "history_bench.h"
+#include "flight_history.h"
+#include "xorshift.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+static int32_t units(float deg)
+{
+    return (int32_t)lroundf(deg * 10000.0f);
+}
+
+struct Input {
+    float lat, lon, alt;
+    uint32_t time;
+};
+
+// Straight climbing track, then a steady right turn
+static std::vector<Input> makeTrack(int fixes)
+{
+    std::vector<Input> in;
+    float lat = -33.95f, lon = 151.18f, alt = 1000.0f, hdg = 0.0f;
+    uint32_t time = 1700000000u;
+    for (int i = 0; i < fixes; ++i) {
+        in.push_back({lat, lon, alt, time});
+        if (i >= fixes / 2) hdg += 9.0f;            // 0.3 deg/s over 30 s
+        float a = hdg * (float)M_PI / 180.0f;
+        lat += 0.0675f * cosf(a);                   // 250 m/s for 30 s
+        lon += 0.0675f * sinf(a) / cosf(lat * (float)M_PI / 180.0f);
+        alt += 150.0f;                              // 5 m/s
+        time += 30;
+    }
+    return in;
+}
+
+static void checkRoundTrip()
+{
+    FlightHistory h;
+    auto in = makeTrack(20);
+    for (const auto& f : in) {
+        h.beginPoll();
+        h.record(0xABCDEF, f.lat, f.lon, f.alt, f.time);
+    }
+
+    FlightHistory::TrackView track;
+    bool found = h.find(0xABCDEF, track);
+    check(found && track.size() == FlightHistory::MAX_FIXES, "ring keeps the newest MAX_FIXES fixes");
+    if (!found) return;
+
+    // Iterator must reproduce the quantized inputs exactly, oldest first
+    size_t i = in.size() - FlightHistory::MAX_FIXES;
+    bool exact = true;
+    for (const FlightHistory::Fix& fix : track) {
+        const Input& e = in[i++];
+        exact &= fix.lat == units(e.lat) && fix.lon == units(e.lon) &&
+                 fix.alt == (int16_t)lroundf(e.alt) && fix.time == e.time;
+    }
+    check(exact && i == in.size(), "deltas decode to the recorded fixes in order");
+    check(track.newest().time == in.back().time, "newest() is the last fix");
+
+    FlightHistory::Trend t = h.trend(0xABCDEF);
+    check(t.valid && fabsf(t.climbRate - 5.0f) < 0.1f, "climb rate from the newest step");
+    check(fabsf(t.groundSpeed - 250.0f) < 5.0f, "ground speed from the newest step");
+    check(fabsf(t.turnRate - 0.3f) < 0.05f, "turn rate from the last two steps");
+}
+
+static void checkEvictionAndGaps()
+{
+    FlightHistory h;
+
+    h.beginPoll();
+    for (uint32_t id = 1; id <= FlightHistory::MAX_TRACKS; ++id)
+        h.record(id, -33.0f, 151.0f, 1000.0f, 100);
+    check(h.trackCount() == FlightHistory::MAX_TRACKS, "arena fills to MAX_TRACKS");
+
+    // Same poll: nothing may be evicted
+    check(!h.record(9999, -33.0f, 151.0f, 1000.0f, 100), "full arena drops new aircraft within a poll");
+
+    // Next poll: aircraft 1..10 keep reporting, 10 new ones evict the stale rest
+    h.beginPoll();
+    for (uint32_t id = 1; id <= 10; ++id)
+        h.record(id, -33.0f, 151.0f, 1000.0f, 130);
+    for (uint32_t id = 1000; id < 1010; ++id)
+        h.record(id, -33.0f, 151.0f, 1000.0f, 130);
+
+    FlightHistory::TrackView v;
+    bool keptActive = true;
+    for (uint32_t id = 1; id <= 10; ++id) keptActive &= h.find(id, v) && v.size() == 2;
+    check(keptActive && h.find(1005, v) && h.evictions() == 10, "LRU evicts tracks not updated this poll");
+
+    // Jump beyond int16 deltas: track restarts instead of wrapping
+    h.beginPoll();
+    h.record(1, -20.0f, 151.0f, 1000.0f, 160);
+    check(h.find(1, v) && v.size() == 1 && v.oldest().lat == units(-20.0f), "oversized step restarts the track");
+
+    check(!h.record(2, -33.0f, 151.0f, 1000.0f, 100), "repeated report is ignored");
+}
+
+int history_bench_run(int polls)
+{
+    checkRoundTrip();
+    checkEvictionAndGaps();
+
+    // Busy sky: 300 aircraft per poll competing for the arena
+    using clock = std::chrono::steady_clock;
+    const int AIRCRAFT = 300;
+    FlightHistory h;
+    XorShift32 rng(3);
+    std::vector<Input> sky(AIRCRAFT);
+    for (auto& a : sky)
+        a = {-33.95f + rng.below(5000) * 1e-4f, 151.18f + rng.below(5000) * 1e-4f, (float)rng.below(12000), 0};
+
+    double recordUs = 0, iterateUs = 0;
+    long fixesRead = 0, dropped = 0;
+    for (int p = 0; p < polls; ++p) {
+        h.beginPoll();
+        auto t0 = clock::now();
+        for (int i = 0; i < AIRCRAFT; ++i) {
+            Input& a = sky[i];
+            a.lat += 0.01f;
+            a.time += 30;
+            if (!h.record(0x100000 + i, a.lat, a.lon, a.alt, a.time)) dropped++;
+        }
+        auto t1 = clock::now();
+        for (int i = 0; i < AIRCRAFT; ++i) {
+            FlightHistory::TrackView v;
+            if (!h.find(0x100000 + i, v)) continue;
+            for (const auto& fix : v) {
+                (void)fix;
+                fixesRead++;
+            }
+        }
+        auto t2 = clock::now();
+        recordUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        iterateUs += std::chrono::duration<double, std::micro>(t2 - t1).count();
+    }
+
+    printf("\nArena %zu bytes for %d tracks x %d fixes (%zu bytes/track)\n",
+           FlightHistory::arenaBytes(), FlightHistory::MAX_TRACKS, FlightHistory::MAX_FIXES,
+           FlightHistory::arenaBytes() / FlightHistory::MAX_TRACKS);
+    printf("%d aircraft/poll: record %.1f us/poll, find+iterate %.1f us/poll (%ld fixes), "
+           "%u evictions, %ld fixes dropped (arena full of current tracks)\n",
+           AIRCRAFT, recordUs / polls, iterateUs / polls, fixesRead, (unsigned)h.evictions(), dropped);
+
+    printf("%d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
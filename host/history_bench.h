@@ -0,0 +1,5 @@
+#pragma once
+
+// Checks the flight history store (delta round trip, ring wrap, LRU
+// eviction, gap restart) and times record/iterate on a busy sky
+int history_bench_run(int polls);
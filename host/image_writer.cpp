@@ -0,0 +1,249 @@
+#include "image_writer.h"
+#include <string.h>
+
+#ifdef SIM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+// -----------------------------------------------------
+// PPM (P6)
+// -----------------------------------------------------
+bool write_ppm(const char* path, const uint8_t* rgb, int width, int height)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    fprintf(f, "P6\n%d %d\n255\n", width, height);
+    size_t n = (size_t)width * height * 3;
+    bool ok = fwrite(rgb, 1, n, f) == n;
+    fclose(f);
+    return ok;
+}
+
+bool read_ppm(const char* path, std::vector<uint8_t>& rgb, int& width, int& height)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+
+    int maxval = 0;
+    if (fscanf(f, "P6 %d %d %d", &width, &height, &maxval) != 3 || maxval != 255) {
+        fclose(f);
+        return false;
+    }
+    fgetc(f);   // single whitespace after the header
+
+    rgb.resize((size_t)width * height * 3);
+    bool ok = fread(rgb.data(), 1, rgb.size(), f) == rgb.size();
+    fclose(f);
+    return ok;
+}
+
+// -----------------------------------------------------
+// PNG helpers
+// -----------------------------------------------------
+static uint32_t crc_table[256];
+
+static void init_crc()
+{
+    if (crc_table[1]) return;
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crc_table[n] = c;
+    }
+}
+
+static uint32_t crc32(uint32_t crc, const uint8_t* buf, size_t len)
+{
+    crc = ~crc;
+    while (len--) crc = crc_table[(crc ^ *buf++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void put_be32(std::vector<uint8_t>& v, uint32_t x)
+{
+    v.push_back(x >> 24);
+    v.push_back(x >> 16);
+    v.push_back(x >> 8);
+    v.push_back(x);
+}
+
+static void put_be16(std::vector<uint8_t>& v, uint16_t x)
+{
+    v.push_back(x >> 8);
+    v.push_back(x);
+}
+
+static bool write_chunk(FILE* f, const char* type, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> buf;
+    put_be32(buf, (uint32_t)data.size());
+    buf.insert(buf.end(), type, type + 4);
+    buf.insert(buf.end(), data.begin(), data.end());
+    put_be32(buf, crc32(0, buf.data() + 4, buf.size() - 4));
+    return fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+}
+
+// Scaled, filter-less scanlines wrapped in a zlib stream. Uses zlib when the
+// build found it, otherwise stored blocks (large, but needs no library).
+static std::vector<uint8_t> zlib_image(const uint8_t* rgb, int width, int height, int scale)
+{
+    const int outW = width * scale;
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)(outW * 3 + 1) * height * scale);
+
+    for (int y = 0; y < height * scale; ++y) {
+        raw.push_back(0);   // filter: none
+        const uint8_t* row = rgb + (size_t)(y / scale) * width * 3;
+        for (int x = 0; x < outW; ++x) {
+            const uint8_t* p = row + (x / scale) * 3;
+            raw.insert(raw.end(), p, p + 3);
+        }
+    }
+
+#ifdef SIM_HAVE_ZLIB
+    uLongf zlen = compressBound(raw.size());
+    std::vector<uint8_t> packed(zlen);
+    if (compress2(packed.data(), &zlen, raw.data(), raw.size(), Z_BEST_SPEED) == Z_OK) {
+        packed.resize(zlen);
+        return packed;
+    }
+#endif
+
+    std::vector<uint8_t> z = {0x78, 0x01};
+    size_t pos = 0;
+    do {
+        size_t len = raw.size() - pos;
+        if (len > 65535) len = 65535;
+        bool last = pos + len == raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back(len & 0xFF);
+        z.push_back(len >> 8);
+        z.push_back(~len & 0xFF);
+        z.push_back((~len >> 8) & 0xFF);
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+    } while (pos < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t c : raw) {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    put_be32(z, (b << 16) | a);
+    return z;
+}
+
+static bool write_header(FILE* f, int width, int height)
+{
+    static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (fwrite(sig, 1, 8, f) != 8) return false;
+
+    std::vector<uint8_t> ihdr;
+    put_be32(ihdr, width);
+    put_be32(ihdr, height);
+    ihdr.push_back(8);      // bit depth
+    ihdr.push_back(2);      // truecolor RGB
+    ihdr.push_back(0);      // deflate
+    ihdr.push_back(0);      // adaptive filtering
+    ihdr.push_back(0);      // no interlace
+    return write_chunk(f, "IHDR", ihdr);
+}
+
+bool write_png(const char* path, const uint8_t* rgb, int width, int height, int scale)
+{
+    init_crc();
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    bool ok = write_header(f, width * scale, height * scale) &&
+              write_chunk(f, "IDAT", zlib_image(rgb, width, height, scale)) &&
+              write_chunk(f, "IEND", {});
+    fclose(f);
+    return ok;
+}
+
+// -----------------------------------------------------
+// Animated PNG
+// -----------------------------------------------------
+ApngWriter::~ApngWriter()
+{
+    close();
+}
+
+bool ApngWriter::open(const char* path, int width, int height, int fps, int scale)
+{
+    init_crc();
+    close();
+
+    _file = fopen(path, "wb");
+    if (!_file) return false;
+
+    _width = width;
+    _height = height;
+    _fps = fps;
+    _scale = scale;
+    _frames = 0;
+    _sequence = 0;
+
+    if (!write_header(_file, width * scale, height * scale)) return false;
+
+    // acTL is rewritten with the real frame count in close()
+    _actlOffset = ftell(_file);
+    std::vector<uint8_t> actl;
+    put_be32(actl, 0);      // num_frames
+    put_be32(actl, 0);      // loop forever
+    return write_chunk(_file, "acTL", actl);
+}
+
+bool ApngWriter::addFrame(const uint8_t* rgb)
+{
+    if (!_file) return false;
+
+    std::vector<uint8_t> fctl;
+    put_be32(fctl, _sequence++);
+    put_be32(fctl, _width * _scale);
+    put_be32(fctl, _height * _scale);
+    put_be32(fctl, 0);      // x offset
+    put_be32(fctl, 0);      // y offset
+    put_be16(fctl, 1);      // delay = 1 / fps
+    put_be16(fctl, _fps);
+    fctl.push_back(0);      // dispose: none
+    fctl.push_back(0);      // blend: source
+    if (!write_chunk(_file, "fcTL", fctl)) return false;
+
+    std::vector<uint8_t> z = zlib_image(rgb, _width, _height, _scale);
+    bool ok;
+    if (_frames == 0) {
+        ok = write_chunk(_file, "IDAT", z);
+    } else {
+        std::vector<uint8_t> fdat;
+        put_be32(fdat, _sequence++);
+        fdat.insert(fdat.end(), z.begin(), z.end());
+        ok = write_chunk(_file, "fdAT", fdat);
+    }
+
+    _frames++;
+    return ok;
+}
+
+bool ApngWriter::close()
+{
+    if (!_file) return false;
+
+    bool ok = write_chunk(_file, "IEND", {});
+
+    // Patch the frame count now that it is known
+    long end = ftell(_file);
+    fseek(_file, _actlOffset, SEEK_SET);
+    std::vector<uint8_t> actl;
+    put_be32(actl, _frames);
+    put_be32(actl, 0);
+    ok = write_chunk(_file, "acTL", actl) && ok;
+    fseek(_file, end, SEEK_SET);
+
+    fclose(_file);
+    _file = nullptr;
+    return ok;
+}
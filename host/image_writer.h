@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Small image I/O for the simulator. PNGs are deflated with zlib when it is
+// available (SIM_HAVE_ZLIB) and fall back to stored blocks otherwise, which
+// every viewer still accepts.
+// `scale` repeats each LED as a scale x scale block for easier viewing.
+
+bool write_ppm(const char* path, const uint8_t* rgb, int width, int height);
+bool read_ppm(const char* path, std::vector<uint8_t>& rgb, int& width, int& height);
+bool write_png(const char* path, const uint8_t* rgb, int width, int height, int scale = 1);
+
+// Animated PNG, one frame per addFrame() call
+class ApngWriter {
+public:
+    ~ApngWriter();
+
+    bool open(const char* path, int width, int height, int fps, int scale = 1);
+    bool addFrame(const uint8_t* rgb);
+    bool close();
+
+private:
+    FILE* _file = nullptr;
+    int _width = 0;
+    int _height = 0;
+    int _fps = 60;
+    int _scale = 1;
+    uint32_t _frames = 0;
+    uint32_t _sequence = 0;
+    long _actlOffset = 0;
+};
@@ -0,0 +1,74 @@
+#include "led_matrix.h"
+#include "hub75_budget.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Host backend: no driver, the "panel" is the _shown buffer that show()
+// copies the frame buffer into. The simulator reads it back through
+// LEDMatrix::shownPixels() for golden images and exports. Tiled layouts
+// also get the frame in chain order, through the same mapToChain() the
+// HUB75 backend uses, for chainPixels(). The driver status is what the
+// HUB75 cost model predicts for the same settings.
+
+LEDMatrix::~LEDMatrix()
+{
+    free(_shown);
+    free(_chain);
+}
+
+void LEDMatrix::begin()
+{
+    startDriver();
+}
+
+bool LEDMatrix::startDriver()
+{
+    const uint32_t clockHz = _config.clock_mhz * 1000000u;
+    const int transition = hub75_transition_bit(_config.panel_width, _config.panel_height,
+                                                _config.chain_length, _config.color_depth,
+                                                clockHz, _config.latch_blanking, _config.min_refresh_hz);
+
+    _status.profile = _config.profile;
+    _status.dma_bytes = (uint32_t)hub75_dma_bytes(_config.panel_width, _config.panel_height,
+                                                  _config.chain_length, _config.color_depth,
+                                                  _config.latch_blanking);
+    _status.refresh_hz = (uint16_t)hub75_refresh_hz(_config.panel_width, _config.panel_height,
+                                                    _config.chain_length, _config.color_depth,
+                                                    clockHz, _config.latch_blanking, transition);
+    _status.color_depth = _config.color_depth;
+    _status.lsb_msb_transition = (uint8_t)transition;
+    _status.dither = _config.dither;
+    _status.valid = true;
+
+    if (_config.tile_rows > 1 && !_chain)
+        _chain = (uint8_t*)calloc((size_t)_width * _height, 3);
+    return true;
+}
+
+void LEDMatrix::stopDriver()
+{
+    _status.valid = false;
+}
+
+void LEDMatrix::show()
+{
+    if (!_fb.valid() || !_shown) return;
+
+    memcpy(_shown, _fb.pixels(), _fb.sizeBytes());
+    if (!_chain) return;
+
+    const int chainWidth = _config.panel_width * _config.chain_length;
+    const uint8_t* src = _shown;
+    for (int y = 0; y < _height; ++y) {
+        for (int x = 0; x < _width; ++x, src += 3) {
+            int cx, cy;
+            mapToChain(x, y, cx, cy);
+            memcpy(_chain + ((size_t)cy * chainWidth + cx) * 3, src, 3);
+        }
+    }
+}
+
+void LEDMatrix::setBrightness(uint8_t b)
+{
+    (void)b;
+}
@@ -0,0 +1,427 @@
+#include "onset_bench.h"
+#include "audio_capture.h"
+#include "sim_fakes.h"
+#include "wav_io.h"
+#include "xorshift.h"
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+static const int RATE = AudioCapture::SAMPLE_RATE;
+static const double ONSET_TOLERANCE_S = 0.05;
+static const double BEAT_TOLERANCE_S = 0.07;
+static const double BEAT_SETTLE_S = 4.0;    // beats are scored after the tempo has had time to lock
+static const double LEAD_IN_S = 1.5;        // before the first hit: the detector settles for a second
+
+// -----------------------------------------------------
+// Synthetic drums
+// -----------------------------------------------------
+struct Track {
+    const char* name;
+    float bpm;                      // 0 = no beat
+    std::vector<float> samples;
+    std::vector<double> onsets;     // seconds
+    std::vector<double> beats;
+};
+
+// Raised-cosine fade over the last 10 ms of a `length`-sample hit, so it
+// does not end in a click of its own
+static float fade(int i, int length)
+{
+    const int n = RATE / 100;
+    const int left = length - i;
+    return left >= n ? 1.0f : 0.5f - 0.5f * cosf((float)M_PI * left / n);
+}
+
+static void addKick(std::vector<float>& buf, double at, float gain, XorShift32& rng)
+{
+    const size_t start = (size_t)(at * RATE);
+    const int length = RATE / 4;
+    double phase = 0.0;
+    for (int i = 0; i < length && start + i < buf.size(); ++i) {
+        const double t = (double)i / RATE;
+        phase += 2.0 * M_PI * (50.0 + 110.0 * exp(-t / 0.03)) / RATE;
+        float v = (float)(sin(phase) * exp(-t / 0.12));
+        if (i < RATE / 500) v += ((int)rng.below(2001) - 1000) / 2000.0f;      // beater click
+        buf[start + i] += gain * v * fade(i, length);
+    }
+}
+
+static void addSnare(std::vector<float>& buf, double at, float gain, XorShift32& rng)
+{
+    const size_t start = (size_t)(at * RATE);
+    const int length = RATE / 5;
+    for (int i = 0; i < length && start + i < buf.size(); ++i) {
+        const double t = (double)i / RATE;
+        float noise = ((int)rng.below(2001) - 1000) / 1000.0f;
+        float v = (float)(noise * exp(-t / 0.06) + 0.5 * sin(2.0 * M_PI * 190.0 * t) * exp(-t / 0.05));
+        buf[start + i] += gain * v * fade(i, length);
+    }
+}
+
+static void addHat(std::vector<float>& buf, double at, float gain, XorShift32& rng)
+{
+    const size_t start = (size_t)(at * RATE);
+    const int length = RATE * 6 / 100;
+    float last = 0.0f;
+    for (int i = 0; i < length && start + i < buf.size(); ++i) {
+        const double t = (double)i / RATE;
+        float noise = ((int)rng.below(2001) - 1000) / 1000.0f;
+        // First difference: highs only
+        buf[start + i] += gain * (noise - last) * 0.5f * (float)exp(-t / 0.02) * fade(i, length);
+        last = noise;
+    }
+}
+
+static void addPad(std::vector<float>& buf, float gain)
+{
+    static const double chord[] = {220.0, 277.18, 329.63, 440.0};
+    for (size_t i = 0; i < buf.size(); ++i) {
+        double v = 0.0;
+        for (double f : chord) v += sin(2.0 * M_PI * f * i / RATE);
+        buf[i] += gain * (float)v;
+    }
+}
+
+static void addNoise(std::vector<float>& buf, float gain, XorShift32& rng)
+{
+    for (float& v : buf) v += gain * ((int)rng.below(2001) - 1000) / 1000.0f;
+}
+
+// Kick on every beat, or kick and snare alternating with hats on the
+// eighths between, from LEAD_IN_S
+static Track drums(const char* name, float bpm, bool pattern, float padGain, float noiseGain, double seconds,
+                   uint32_t seed)
+{
+    Track tr;
+    tr.name = name;
+    tr.bpm = bpm;
+    tr.samples.assign((size_t)(seconds * RATE), 0.0f);
+    XorShift32 rng(seed);
+
+    const double beat = 60.0 / bpm;
+    for (int n = 0;; ++n) {
+        const double t = LEAD_IN_S + n * beat;
+        if (t > seconds - 0.5) break;
+        tr.beats.push_back(t);
+        tr.onsets.push_back(t);
+        if (!pattern || n % 2 == 0) addKick(tr.samples, t, 0.5f, rng);
+        else addSnare(tr.samples, t, 0.25f, rng);
+        if (pattern) {
+            addHat(tr.samples, t, 0.06f, rng);
+            addHat(tr.samples, t + beat / 2, 0.12f, rng);
+            tr.onsets.push_back(t + beat / 2);
+        }
+    }
+    if (padGain > 0.0f) addPad(tr.samples, padGain);
+    if (noiseGain > 0.0f) addNoise(tr.samples, noiseGain, rng);
+    return tr;
+}
+
+static Track steady(double seconds)
+{
+    Track tr;
+    tr.name = "pad + noise, no onsets";
+    tr.bpm = 0.0f;
+    tr.samples.assign((size_t)(seconds * RATE), 0.0f);
+    XorShift32 rng(5);
+    addPad(tr.samples, 0.05f);
+    addNoise(tr.samples, 0.02f, rng);
+    return tr;
+}
+
+// -----------------------------------------------------
+// Running and scoring
+// -----------------------------------------------------
+struct Run {
+    std::vector<AudioEvent> events;
+    float bpm;
+    double onsetMeanUs;
+    uint32_t onsetMaxUs;
+    double hopMeanUs;           // whole capture() per hop, wall clock
+    double realtime;            // audio seconds per wall second
+};
+
+// The whole track through capture(), hop by hop, from a fresh channel
+static Run play(const std::vector<float>& samples, int window, int hop)
+{
+    AudioCapture& capture = AudioCapture::instance();
+    capture.stop();
+    capture.setAnalysis(window, hop);
+    sim_audio_set_samples(samples);
+    capture.start();
+    uint32_t cursor = capture.eventCursor();
+
+    Run run = {};
+    const int hops = (int)(samples.size() / hop);
+    double onsetSum = 0.0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int n = 0; n < hops; ++n) {
+        capture.capture();
+        AudioEvent e;
+        while (capture.nextEvent(cursor, e)) run.events.push_back(e);
+        const AudioSpectrum* s = capture.latest();
+        if (!s) continue;
+        onsetSum += s->onsetUs;
+        run.onsetMaxUs = std::max(run.onsetMaxUs, s->onsetUs);
+        run.bpm = s->bpm;
+    }
+    const double wallUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    capture.stop();
+
+    run.onsetMeanUs = hops ? onsetSum / hops : 0.0;
+    run.hopMeanUs = hops ? wallUs / hops : 0.0;
+    run.realtime = wallUs > 0.0 ? (double)samples.size() / RATE / (wallUs * 1e-6) : 0.0;
+    return run;
+}
+
+struct Score {
+    int hits, detected, truth;
+    double meanErrorMs;         // detected - truth over the hits
+    double f() const { return detected + truth ? 2.0 * hits / (detected + truth) : 1.0; }
+};
+
+// Greedy one-to-one matching of sorted times within `tolerance`
+static Score score(const std::vector<double>& detected, const std::vector<double>& truth, double tolerance,
+                   double from = 0.0)
+{
+    Score sc = {0, 0, 0, 0.0};
+    std::vector<double> d, t;
+    for (double v : detected) if (v >= from) d.push_back(v);
+    for (double v : truth) if (v >= from) t.push_back(v);
+    sc.detected = (int)d.size();
+    sc.truth = (int)t.size();
+
+    size_t i = 0, j = 0;
+    double errorSum = 0.0;
+    while (i < d.size() && j < t.size()) {
+        const double diff = d[i] - t[j];
+        if (fabs(diff) <= tolerance) {
+            sc.hits++;
+            errorSum += diff;
+            ++i;
+            ++j;
+        } else if (diff < 0) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+    sc.meanErrorMs = sc.hits ? 1000.0 * errorSum / sc.hits : 0.0;
+    return sc;
+}
+
+static std::vector<double> eventTimes(const Run& run, bool beatsOnly)
+{
+    std::vector<double> times;
+    for (const AudioEvent& e : run.events)
+        if (!beatsOnly || (e.flags & AUDIO_BEAT)) times.push_back((double)e.sample / RATE);
+    return times;
+}
+
+static float tempoError(float bpm, float truth)
+{
+    return truth > 0.0f ? fabsf(bpm - truth) / truth : 0.0f;
+}
+
+static void printHeader()
+{
+    printf("%-28s %6s %6s %7s %6s %7s %7s %7s %8s %8s %7s\n", "", "onsets", "found", "onset F", "err ms",
+           "beat F", "bpm", "truth", "det us", "det max", "x real");
+}
+
+// `beat` may be null where there is no beat truth
+static void printRow(const char* name, const Track& tr, const Run& run, const Score& on, const Score* beat)
+{
+    char beatF[16] = "-";
+    if (beat) snprintf(beatF, sizeof(beatF), "%.3f", beat->f());
+    printf("%-28s %6zu %6zu %7.3f %6.1f %7s %7.1f %7.1f %8.2f %8u %7.0f\n", name, tr.onsets.size(),
+           run.events.size(), on.f(), on.meanErrorMs, beatF, run.bpm, tr.bpm, run.onsetMeanUs, run.onsetMaxUs,
+           run.realtime);
+}
+
+// -----------------------------------------------------
+// Checks
+// -----------------------------------------------------
+// The event ring keeps every reader's events in order, and a reader that
+// fell behind loses only the oldest
+static void checkEventRing()
+{
+    EventRing<AudioEvent, 16> ring;
+    uint32_t a = ring.head(), b = ring.head();
+    AudioEvent e = {};
+    bool ordered = true;
+    for (int n = 1; n <= 10; ++n) {
+        e.sample = n;
+        ring.publish(e);
+        AudioEvent got;
+        ordered &= ring.poll(a, got) && got.sample == (uint64_t)n;
+    }
+    for (int n = 11; n <= 40; ++n) {
+        e.sample = n;
+        ring.publish(e);
+    }
+    AudioEvent got;
+    uint64_t first = 0, last = 0;
+    int taken = 0;
+    while (ring.poll(b, got)) {
+        if (!taken) first = got.sample;
+        last = got.sample;
+        taken++;
+    }
+    check(ordered, "a reader keeping up takes every event in order");
+    check(first == 25 && last == 40 && taken == 16, "a reader 40 events behind gets the newest 16");
+}
+
+static void scoreSuite()
+{
+    std::vector<Track> tracks;
+    tracks.push_back(drums("kick, 120 BPM", 120.0f, false, 0.0f, 0.0f, 10.0, 1));
+    tracks.push_back(drums("drums + pad, 128 BPM", 128.0f, true, 0.04f, 0.0f, 10.0, 2));
+    tracks.push_back(drums("drums + noise, 95 BPM", 95.0f, true, 0.0f, 0.01f, 12.0, 3));
+    tracks.push_back(drums("drums + pad + noise, 140 BPM", 140.0f, true, 0.04f, 0.01f, 10.0, 4));
+
+    printf("\nSynthetic tracks, 1024-sample window, 256-sample hop (onsets within %.0f ms, beats within %.0f ms"
+           " after %.0f s)\n", ONSET_TOLERANCE_S * 1000, BEAT_TOLERANCE_S * 1000, BEAT_SETTLE_S);
+    printHeader();
+    double worstF = 1.0, worstBeatF = 1.0, worstMean = 0.0;
+    float worstTempo = 0.0f;
+    uint32_t worstMax = 0;
+    for (const Track& tr : tracks) {
+        Run run = play(tr.samples, 1024, 256);
+        Score on = score(eventTimes(run, false), tr.onsets, ONSET_TOLERANCE_S);
+        Score beat = score(eventTimes(run, true), tr.beats, BEAT_TOLERANCE_S, BEAT_SETTLE_S);
+        printRow(tr.name, tr, run, on, &beat);
+        worstF = std::min(worstF, on.f());
+        worstBeatF = std::min(worstBeatF, beat.f());
+        worstTempo = std::max(worstTempo, tempoError(run.bpm, tr.bpm));
+        worstMean = std::max(worstMean, run.onsetMeanUs);
+        worstMax = std::max(worstMax, run.onsetMaxUs);
+    }
+
+    Track quiet = steady(8.0);
+    Run run = play(quiet.samples, 1024, 256);
+    printf("%-28s %6d %6zu\n", quiet.name, 0, run.events.size());
+
+    printf("\n");
+    check(worstF >= 0.9, "onset F-measure at least 0.9 on every track");
+    check(worstBeatF >= 0.9, "beat F-measure at least 0.9 once the tempo has locked");
+    check(worstTempo < 0.03f, "tempo within 3% on every track");
+    check(run.events.size() <= 1, "a steady pad over noise raises no onsets");
+    // Host timings vary with the load; reported against the device's budget, not checked
+    printf("detection: mean %.2f us, worst %u us per hop (host); device budget %d us, mean %.1f%% of it\n",
+           worstMean, worstMax, OnsetDetector::BUDGET_US, 100.0 * worstMean / OnsetDetector::BUDGET_US);
+}
+
+// The same track at other windows and hops
+static void sweepAnalysis()
+{
+    static const int settings[][2] = {{512, 128}, {512, 256}, {1024, 256}, {1024, 512}, {2048, 512}};
+    Track tr = drums("drums + pad, 128 BPM", 128.0f, true, 0.04f, 0.0f, 10.0, 2);
+
+    printf("\nAnalysis settings, %s\n", tr.name);
+    printHeader();
+    double worstF = 1.0;
+    for (const auto& st : settings) {
+        Run run = play(tr.samples, st[0], st[1]);
+        Score on = score(eventTimes(run, false), tr.onsets, ONSET_TOLERANCE_S);
+        Score beat = score(eventTimes(run, true), tr.beats, BEAT_TOLERANCE_S, BEAT_SETTLE_S);
+        char name[32];
+        snprintf(name, sizeof(name), "window %d, hop %d", st[0], st[1]);
+        printRow(name, tr, run, on, &beat);
+        worstF = std::min(worstF, on.f());
+    }
+    printf("\n");
+    check(worstF >= 0.85, "onsets are found at every window and hop");
+
+    // For the WAV path: the same track through a file
+    FILE* f = fopen("onset_drums128.txt", "w");
+    if (f) {
+        fprintf(f, "# %s, onset times in seconds\n# bpm %.0f\n", tr.name, tr.bpm);
+        for (double t : tr.onsets) fprintf(f, "%.6f\n", t);
+        fclose(f);
+    }
+    check(f && write_wav("onset_drums128.wav", tr.samples, RATE), "wrote onset_drums128.wav and its truth");
+}
+
+// -----------------------------------------------------
+// WAV files
+// -----------------------------------------------------
+static bool readTruth(const char* path, std::vector<double>& onsets, float& bpm)
+{
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        float v;
+        if (sscanf(line, "# bpm %f", &v) == 1) bpm = v;
+        else if (line[0] != '#' && sscanf(line, "%f", &v) == 1) onsets.push_back(v);
+    }
+    fclose(f);
+    std::sort(onsets.begin(), onsets.end());
+    return true;
+}
+
+static void scoreWav(const char* path, const char* truthPath)
+{
+    std::vector<float> samples;
+    int rate = 0;
+    if (!read_wav(path, samples, rate)) {
+        check(false, "WAV file readable (PCM 8/16/24/32-bit or float)");
+        return;
+    }
+    samples = resample_linear(samples, rate, RATE);
+
+    Track tr;
+    tr.name = path;
+    tr.bpm = 0.0f;
+    const bool haveTruth = truthPath && readTruth(truthPath, tr.onsets, tr.bpm);
+    if (truthPath) check(haveTruth, "truth file readable");
+
+    Run run = play(samples, 1024, 256);
+    printf("\n%s: %.1f s at %d Hz, %zu events\n", path, (double)samples.size() / RATE, rate, run.events.size());
+    if (!haveTruth) {
+        for (const AudioEvent& e : run.events)
+            printf("  %8.3f s  %s  strength %.2f  %.1f BPM\n", (double)e.sample / RATE,
+                   e.flags & AUDIO_BEAT ? "beat " : "onset", e.strength, e.bpm);
+        printf("tempo %.1f BPM, detection %.2f us mean, %u us worst per hop, %.0fx real time\n", run.bpm,
+               run.onsetMeanUs, run.onsetMaxUs, run.realtime);
+        return;
+    }
+
+    Score on = score(eventTimes(run, false), tr.onsets, ONSET_TOLERANCE_S);
+    printHeader();
+    printRow("file", tr, run, on, nullptr);
+    printf("onsets: %d hits, %d false, %d missed\n\n", on.hits, on.detected - on.hits, on.truth - on.hits);
+    check(on.f() >= 0.9, "onset F-measure at least 0.9");
+    if (tr.bpm > 0.0f) check(tempoError(run.bpm, tr.bpm) < 0.03f, "tempo within 3% of the truth");
+}
+
+int onset_bench_run(const std::vector<const char*>& wavs, const char* truth)
+{
+    sim_reset();
+    checkEventRing();
+
+    if (wavs.empty()) {
+        scoreSuite();
+        sweepAnalysis();
+    } else {
+        for (const char* path : wavs) scoreWav(path, truth);
+    }
+
+    AudioCapture::instance().setAnalysis(1024, 256);
+    sim_reset();
+    printf("\n%s\n", failures ? "FAILED" : "All onset checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vector>
+
+// Plays audio through the fake microphone and the whole capture pipeline
+// and scores the onset and beat events against the truth: F-measure of
+// onsets (within 50 ms) and beats (within 70 ms), tempo error, and the
+// detector's cost per hop against its budget.
+//
+// Without files it synthesizes drum tracks with known onsets (plus a
+// steady one that should stay quiet), also sweeps the analysis settings,
+// and writes one track as onset_drums128.wav with its truth in
+// onset_drums128.txt. With WAV files it scores each against `truth`, a
+// text file of onset times in seconds, one per line ("# bpm N" adds a
+// tempo check), or just lists the events when there is none.
+int onset_bench_run(const std::vector<const char*>& wavs, const char* truth);
@@ -0,0 +1,347 @@
+#include "q15_bench.h"
+#include "audio_capture.h"
+#include "fft.h"
+#include "fft_q15.h"
+#include "spectrum_bands.h"
+#include "sim_fakes.h"
+#include "xorshift.h"
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+static const int RATE = AudioCapture::SAMPLE_RATE;
+static const double FULL_SCALE = 131071.0;     // ring samples: the 24-bit word >> 14
+static const int BANDS = 32;
+static const int SIZES[] = {256, 512, 1024, 2048};
+
+// -----------------------------------------------------
+// Test signals, as the capture ring holds them
+// -----------------------------------------------------
+struct Signal {
+    const char* name;
+    double dbfs;                // of its loudest part
+    std::vector<int32_t> ring;
+};
+
+static int32_t sample(double v)
+{
+    return (int32_t)lround(std::max(-1.0, std::min(1.0, v)) * FULL_SCALE);
+}
+
+static std::vector<Signal> signals(int n, XorShift32& rng)
+{
+    std::vector<Signal> out;
+    const double dbs[] = {0.0, -20.0, -40.0, -60.0};
+    static const char* names[] = {"1 kHz tone, 0 dBFS", "1 kHz tone, -20 dBFS", "1 kHz tone, -40 dBFS",
+                                  "1 kHz tone, -60 dBFS"};
+    for (int d = 0; d < 4; ++d) {
+        Signal s = {names[d], dbs[d], std::vector<int32_t>(n)};
+        const double a = pow(10.0, dbs[d] / 20.0);
+        for (int i = 0; i < n; ++i) s.ring[i] = sample(a * sin(2.0 * M_PI * 1000.0 * i / RATE + 0.3));
+        out.push_back(s);
+    }
+
+    Signal chord = {"220/1760/7040 Hz, -12 dBFS each", -12.0, std::vector<int32_t>(n)};
+    for (int i = 0; i < n; ++i) {
+        double t = (double)i / RATE, v = 0.0;
+        for (double hz : {220.0, 1760.0, 7040.0}) v += 0.25 * sin(2.0 * M_PI * hz * t);
+        chord.ring[i] = sample(v);
+    }
+    out.push_back(chord);
+
+    Signal noise = {"white noise, -20 dBFS peak", -20.0, std::vector<int32_t>(n)};
+    for (int i = 0; i < n; ++i) noise.ring[i] = sample(0.1 * ((int)rng.below(2001) - 1000) / 1000.0);
+    out.push_back(noise);
+
+    // 100 Hz to 12 kHz across the window, exponentially
+    Signal chirp = {"chirp 100 Hz-12 kHz, -6 dBFS", -6.0, std::vector<int32_t>(n)};
+    const double k = log(12000.0 / 100.0) / n;
+    for (int i = 0; i < n; ++i) {
+        double phase = 2.0 * M_PI * 100.0 / RATE * (exp(k * i) - 1.0) / k;
+        chirp.ring[i] = sample(0.5 * sin(phase));
+    }
+    out.push_back(chirp);
+    return out;
+}
+
+// -----------------------------------------------------
+// The two pipelines, stage by stage as AudioCapture runs them
+// -----------------------------------------------------
+struct StageUs {
+    double window = 0.0, fft = 0.0, magnitude = 0.0, bands = 0.0;
+    double total() const { return window + fft + magnitude + bands; }
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double since(Clock::time_point& t)
+{
+    Clock::time_point now = Clock::now();
+    double us = std::chrono::duration<double, std::micro>(now - t).count();
+    t = now;
+    return us;
+}
+
+struct FloatPath {
+    RealFFT fft;
+    std::vector<float> window, data;
+    SpectrumBands bands;
+
+    void init(int n)
+    {
+        fft.init(n);
+        data.assign(n, 0.0f);
+        window.resize(n);
+        for (int i = 0; i < n; ++i) window[i] = 0.5f * (1.0f - cosf(2.0f * (float)M_PI * i / (n - 1)));
+        bands.configure(BANDS, n, RATE);
+    }
+
+    // The float path has no separate magnitude stage: bands take power per bin
+    void run(const int32_t* ring, int oldest, float* db, StageUs& us)
+    {
+        const int n = fft.size();
+        Clock::time_point t = Clock::now();
+        const int tail = n - oldest;
+        for (int i = 0; i < tail; ++i) data[i] = (float)ring[oldest + i] * window[i];
+        for (int i = tail; i < n; ++i) data[i] = (float)ring[i - tail] * window[i];
+        us.window += since(t);
+        fft.forward(data.data());
+        us.fft += since(t);
+        bands.process(data.data(), db);
+        us.bands += since(t);
+    }
+};
+
+struct Q15Path {
+    RealFFTQ15 fft;
+    std::vector<int16_t> window, data;
+    std::vector<uint16_t> magnitude;
+    SpectrumBands bands;
+    int exponent = 0;
+
+    void init(int n)
+    {
+        fft.init(n);
+        RealFFTQ15::hannWindow(window, n);
+        data.assign(n, 0);
+        magnitude.assign(n / 2, 0);
+        bands.configure(BANDS, n, RATE);
+    }
+
+    void run(const int32_t* ring, int oldest, float* db, StageUs& us)
+    {
+        Clock::time_point t = Clock::now();
+        exponent = fft.load(data.data(), ring, oldest, window.data());
+        us.window += since(t);
+        exponent += fft.forward(data.data());
+        us.fft += since(t);
+        fft.magnitudes(data.data(), magnitude.data());
+        us.magnitude += since(t);
+        bands.process(magnitude.data(), exponent, db);
+        us.bands += since(t);
+    }
+};
+
+// Transform error against the float spectrum of the same frame, as SNR
+static double fftSnrDb(const FloatPath& f, const Q15Path& q)
+{
+    const int n = f.fft.size();
+    double signal = 0.0, noise = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double ref = f.data[i];
+        double err = ldexp((double)q.data[i], q.exponent) - ref;
+        signal += ref * ref;
+        noise += err * err;
+    }
+    return noise > 0.0 ? 10.0 * log10(signal / noise) : 200.0;
+}
+
+// Worst band difference over the bands that show: within the AGC's 40 dB
+// of the loudest, and above the -100 dBFS both paths floor at
+static double bandErrorDb(const float* ref, const float* db)
+{
+    const float loudest = *std::max_element(ref, ref + BANDS);
+    double worst = 0.0;
+    for (int b = 0; b < BANDS; ++b)
+        if (ref[b] > loudest - 40.0f && ref[b] > -100.0f) worst = std::max(worst, (double)fabsf(db[b] - ref[b]));
+    return worst;
+}
+
+// -----------------------------------------------------
+// Checks
+// -----------------------------------------------------
+// alpha-max-plus-beta-min against hypot at every angle of a quarter turn
+static double magnitudeError()
+{
+    double worst = 0.0;
+    for (int a = 0; a <= 9000; ++a) {
+        double angle = a * M_PI / 18000.0;
+        int32_t re = (int32_t)lround(30000.0 * cos(angle));
+        int32_t im = (int32_t)lround(-30000.0 * sin(angle));
+        double exact = hypot((double)re, (double)im);
+        worst = std::max(worst, fabs(q15_magnitude(re, im) - exact) / exact);
+    }
+    return worst;
+}
+
+// Plays a chirp through AudioCapture on each pipeline; returns the
+// largest bar height difference between the two runs' spectra
+static float capturePipelines(bool& tagged, bool& switched)
+{
+    const int seconds = 2;
+    std::vector<float> samples(RATE * seconds);
+    const double k = log(12000.0 / 100.0) / samples.size();
+    for (size_t i = 0; i < samples.size(); ++i)
+        samples[i] = (float)(0.3 * sin(2.0 * M_PI * 100.0 / RATE * (exp(k * i) - 1.0) / k));
+
+    AudioCapture& capture = AudioCapture::instance();
+    const AudioPipeline pipelines[] = {AudioPipeline::FLOAT, AudioPipeline::Q15};
+    std::vector<std::vector<float>> bars[2];
+    tagged = true;
+    for (int p = 0; p < 2; ++p) {
+        capture.stop();
+        capture.setAnalysis(1024, 256);
+        capture.setBands(BANDS);
+        capture.setPipeline(pipelines[p]);
+        sim_audio_set_samples(samples);
+        capture.start();
+        for (size_t n = 0; n < samples.size() / 256; ++n) {
+            capture.capture();
+            const AudioSpectrum* s = capture.latest();
+            if (!s) continue;
+            tagged &= s->pipeline == pipelines[p];
+            bars[p].push_back(std::vector<float>(s->bands, s->bands + s->count));
+        }
+        capture.stop();
+    }
+
+    // The gain carries over from one run to the next: compare once its
+    // attack has settled on the chirp, half a second in
+    float worst = 0.0f;
+    const size_t settled = RATE / 2 / 256;
+    for (size_t h = settled; h < std::min(bars[0].size(), bars[1].size()); ++h)
+        for (size_t b = 0; b < bars[0][h].size(); ++b) worst = std::max(worst, fabsf(bars[0][h][b] - bars[1][h][b]));
+
+    // Switching while running keeps the spectra coming, on the new path
+    capture.setPipeline(AudioPipeline::FLOAT);
+    sim_audio_set_samples(samples);
+    capture.start();
+    switched = true;
+    for (int n = 0; n < 40; ++n) {
+        if (n == 20) capture.setPipeline(AudioPipeline::Q15);
+        capture.capture();
+        const AudioSpectrum* s = capture.latest();
+        switched &= s && s->pipeline == (n < 20 ? AudioPipeline::FLOAT : AudioPipeline::Q15);
+    }
+    capture.stop();
+    capture.setPipeline(AudioCapture::BUILD_PIPELINE);
+    return worst;
+}
+
+int q15_bench_run(int iterations)
+{
+    RealFFTQ15 probe;
+    check(!probe.init(100) && !probe.init(4) && !probe.init(8192) && probe.size() == 0,
+          "Q15 FFT refuses sizes that are not powers of two from 8 to 4096");
+
+    const double magError = magnitudeError();
+    printf("alpha-max-plus-beta-min magnitude: worst %.2f%% from hypot over a quarter turn\n", magError * 100.0);
+    check(magError <= 0.04, "magnitude approximation within 4% at every angle");
+
+    // Cost per hop, stage by stage
+    printf("\n%-6s %-6s %9s %9s %9s %9s %9s %8s\n", "window", "path", "window", "fft", "magnitude", "bands",
+           "total us", "speedup");
+    XorShift32 rng(48);
+    float db[SpectrumBands::MAX_BANDS];
+    for (int n : SIZES) {
+        FloatPath f;
+        Q15Path q;
+        f.init(n);
+        q.init(n);
+        std::vector<Signal> sigs = signals(n, rng);
+        const int reps = std::max(1, iterations * 256 / n);
+
+        StageUs fu, qu;
+        for (int r = 0; r < reps; ++r) {
+            const Signal& s = sigs[r % sigs.size()];
+            const int oldest = (r * 61) % n;
+            f.run(s.ring.data(), oldest, db, fu);
+            q.run(s.ring.data(), oldest, db, qu);
+        }
+        printf("%-6d %-6s %9.2f %9.2f %9s %9.2f %9.2f\n", n, "float", fu.window / reps, fu.fft / reps, "-",
+               fu.bands / reps, fu.total() / reps);
+        printf("%-6s %-6s %9.2f %9.2f %9.2f %9.2f %9.2f %7.2fx\n", "", "Q15", qu.window / reps, qu.fft / reps,
+               qu.magnitude / reps, qu.bands / reps, qu.total() / reps, fu.total() / qu.total());
+    }
+    printf("(host CPU: its FPU is as fast as its integer unit; SENSOR_BENCH prints the device's figures)\n");
+
+    // Accuracy against the float path, per signal and window
+    printf("\n%-32s", "band error vs float, dB / SNR");
+    for (int n : SIZES) printf(" %13d", n);
+    printf("\n");
+    double loudWorst = 0.0, quietWorst = 0.0, snrWorst = 1e9;
+    bool silence = true;
+    const size_t kinds = signals(256, rng).size();
+    for (size_t k = 0; k < kinds; ++k) {
+        bool named = false;
+        for (int n : SIZES) {
+            FloatPath f;
+            Q15Path q;
+            f.init(n);
+            q.init(n);
+            std::vector<Signal> sigs = signals(n, rng);
+            const Signal& s = sigs[k];
+            if (!named) {
+                printf("%-32s", s.name);
+                named = true;
+            }
+
+            StageUs unused;
+            float ref[SpectrumBands::MAX_BANDS];
+            f.run(s.ring.data(), n / 3, ref, unused);
+            q.run(s.ring.data(), n / 3, db, unused);
+            const double err = bandErrorDb(ref, db);
+            const double snr = fftSnrDb(f, q);
+            printf(" %5.2f / %5.1f", err, snr);
+
+            if (s.dbfs >= -40.0) loudWorst = std::max(loudWorst, err);
+            else quietWorst = std::max(quietWorst, err);
+            if (s.dbfs >= -20.0) snrWorst = std::min(snrWorst, snr);
+        }
+        printf("\n");
+    }
+    for (int n : SIZES) {
+        Q15Path q;
+        q.init(n);
+        std::vector<int32_t> zeros(n, 0);
+        StageUs unused;
+        q.run(zeros.data(), 0, db, unused);
+        for (int b = 0; b < q.bands.count(); ++b) silence &= db[b] < -100.0f;
+    }
+    printf("(worst difference over bands within 40 dB of the loudest; SNR of the Q15 spectrum against the float one)\n\n");
+
+    check(loudWorst <= 0.5, "Q15 band levels within 0.5 dB of float for signals down to -40 dBFS");
+    check(quietWorst <= 1.0, "Q15 band levels within 1 dB of float at -60 dBFS");
+    check(snrWorst >= 50.0, "Q15 spectrum at least 50 dB SNR against float for signals from -20 dBFS");
+    check(silence, "Q15 path gives silence as silence");
+
+    bool tagged = false, switched = false;
+    const float barError = capturePipelines(tagged, switched);
+    printf("\nAudioCapture on a chirp: bar heights differ by at most %.3f between pipelines\n", barError);
+    check(barError <= 0.0625f, "AudioCapture bars on Q15 within 2.5 dB (1/16 of the bar) of the float ones");
+    check(tagged, "spectra name the pipeline that made them");
+    check(switched, "setPipeline() switches a running capture on the next hop");
+
+    printf("\n%s\n", failures ? "FAILED" : "All Q15 checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// The fixed-point audio path (components/sensors/fft_q15.h) side by side
+// with the float one at every window size: microseconds per hop for each
+// stage (window, FFT, magnitudes, bands), then an accuracy report of band
+// levels against the float path for tones from 0 to -60 dBFS, noise and a
+// chirp, the transform's SNR, and the magnitude approximation's error.
+// Also plays a chirp through AudioCapture on both pipelines.
+int q15_bench_run(int iterations);
@@ -0,0 +1,3 @@
+#pragma once
+// Adafruit GFX includes BusIO for its display drivers; the canvas code
+// used by the simulator needs none of it.
@@ -0,0 +1,21 @@
+#pragma once
+
+// Minimal Arduino surface needed to build Adafruit GFX and the screens on
+// the host. Only what the display code actually touches is provided.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Print.h"
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+#define pgm_read_byte(addr)    (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)    (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr)   (*(const uint32_t*)(addr))
+#define pgm_read_pointer(addr) ((void*)*(void* const*)(addr))
+
+inline void initArduino() {}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+
+class __FlashStringHelper;
+
+class String {
+public:
+    String(const char* s = "") : _s(s ? s : "") {}
+    size_t length() const { return _s.size(); }
+    const char* c_str() const { return _s.c_str(); }
+
+private:
+    std::string _s;
+};
+
+class Print {
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t n) {
+        size_t written = 0;
+        while (n--) written += write(*buf++);
+        return written;
+    }
+    size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(long v, int base = DEC) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%ld", v);
+        return write(buf);
+    }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned long v, int base = DEC) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%lu", v);
+        return write(buf);
+    }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(double v, int digits = 2) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.*f", digits, v);
+        return write(buf);
+    }
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+// I2S channel API (standard mode, RX) surface used by audio_capture.cpp.
+// i2s_channel_read() returns a deterministic synthetic signal (see
+// sim_audio_* in sim_fakes.h) in the ICS-43434 format: 24-bit samples
+// left-justified in 32-bit words. A channel holds real memory for its DMA
+// buffers, so heap figures see it come and go.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "nvs.h"
+
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+
+typedef int gpio_num_t;
+typedef int i2s_port_t;
+typedef struct i2s_channel_obj_t* i2s_chan_handle_t;
+
+#define I2S_NUM_0 0
+#define I2S_ROLE_MASTER 0
+#define I2S_GPIO_UNUSED (-1)
+#define I2S_DATA_BIT_WIDTH_32BIT 32
+#define I2S_SLOT_BIT_WIDTH_AUTO 0
+#define I2S_SLOT_MODE_MONO 1
+#define I2S_STD_SLOT_LEFT 1
+#define I2S_CLK_SRC_DEFAULT 0
+#define I2S_MCLK_MULTIPLE_256 256
+
+typedef struct {
+    int id;
+    int role;
+    uint32_t dma_desc_num;
+    uint32_t dma_frame_num;
+    bool auto_clear;
+} i2s_chan_config_t;
+
+#define I2S_CHANNEL_DEFAULT_CONFIG(i2s_num, i2s_role) \
+    { (i2s_num), (i2s_role), 6, 240, false }
+
+typedef struct {
+    uint32_t sample_rate_hz;
+    int clk_src;
+    int mclk_multiple;
+} i2s_std_clk_config_t;
+
+typedef struct {
+    int data_bit_width;
+    int slot_bit_width;
+    int slot_mode;
+    int slot_mask;
+} i2s_std_slot_config_t;
+
+typedef struct {
+    bool mclk_inv;
+    bool bclk_inv;
+    bool ws_inv;
+} i2s_std_gpio_invert_t;
+
+typedef struct {
+    gpio_num_t mclk;
+    gpio_num_t bclk;
+    gpio_num_t ws;
+    gpio_num_t dout;
+    gpio_num_t din;
+    i2s_std_gpio_invert_t invert_flags;
+} i2s_std_gpio_config_t;
+
+typedef struct {
+    i2s_std_clk_config_t clk_cfg;
+    i2s_std_slot_config_t slot_cfg;
+    i2s_std_gpio_config_t gpio_cfg;
+} i2s_std_config_t;
+
+#define I2S_STD_CLK_DEFAULT_CONFIG(rate) \
+    { (uint32_t)(rate), I2S_CLK_SRC_DEFAULT, I2S_MCLK_MULTIPLE_256 }
+#define I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(bits, mode) \
+    { (bits), I2S_SLOT_BIT_WIDTH_AUTO, (mode), I2S_STD_SLOT_LEFT }
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t* config, i2s_chan_handle_t* tx, i2s_chan_handle_t* rx);
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t* config);
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle);
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle);
+esp_err_t i2s_del_channel(i2s_chan_handle_t handle);
+esp_err_t i2s_channel_read(i2s_chan_handle_t handle, void* dest, size_t size, size_t* bytes_read,
+                           uint32_t timeout_ms);
@@ -0,0 +1,15 @@
+#pragma once
+
+// Heap queries backed by the C allocator's statistics, so allocations
+// made by the code under test show up as changes in free memory. The
+// numbers are against a nominal heap size; only differences mean much.
+
+#include <stddef.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+size_t heap_caps_get_free_size(unsigned caps);
+size_t heap_caps_get_minimum_free_size(unsigned caps);
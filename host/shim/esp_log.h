@@ -0,0 +1,13 @@
+#pragma once
+#include <stdio.h>
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W (%s) " fmt "\n", tag, ##__VA_ARGS__)
+// Info logs would drown the test/bench output; build with SIM_VERBOSE to see them
+#ifdef SIM_VERBOSE
+#define ESP_LOGI(tag, fmt, ...) fprintf(stderr, "I (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#else
+#define ESP_LOGI(tag, fmt, ...) do { } while (0)
+#endif
+#define ESP_LOGD(tag, fmt, ...) do { } while (0)
+#define ESP_LOGV(tag, fmt, ...) do { } while (0)
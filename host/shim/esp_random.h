@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+// Deterministic xorshift in the simulator, reseeded by sim_reset()
+uint32_t esp_random(void);
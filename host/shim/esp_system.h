@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+
+// Fixed values keep golden frames that print heap figures stable
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
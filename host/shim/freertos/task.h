@@ -0,0 +1,20 @@
+#pragma once
+
+// FreeRTOS task API on host threads. Tasks only run after
+// sim_set_tasks(true); otherwise creation fails the way it does on the
+// device when memory runs out, so scenarios stay single-threaded and
+// deterministic.
+
+#include "freertos/FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdPASS 1
+#define pdFAIL 0
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+// Only vTaskDelete(nullptr) at the end of a task function is supported
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
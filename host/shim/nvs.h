@@ -0,0 +1,42 @@
+#pragma once
+
+// NVS with nothing stored: read-only opens fail so AppConfig runs on its
+// defaults, read-write opens succeed and every write is dropped.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int esp_err_t;
+typedef uint32_t nvs_handle_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NVS_NOT_FOUND 0x1102
+
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+inline esp_err_t nvs_open(const char*, nvs_open_mode_t mode, nvs_handle_t* handle)
+{
+    *handle = 1;
+    return mode == NVS_READWRITE ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+inline void nvs_close(nvs_handle_t) {}
+inline esp_err_t nvs_commit(nvs_handle_t) { return ESP_OK; }
+inline esp_err_t nvs_erase_key(nvs_handle_t, const char*) { return ESP_OK; }
+inline esp_err_t nvs_get_blob(nvs_handle_t, const char*, void*, size_t*) { return ESP_ERR_NVS_NOT_FOUND; }
+inline esp_err_t nvs_set_blob(nvs_handle_t, const char*, const void*, size_t) { return ESP_OK; }
+inline esp_err_t nvs_get_str(nvs_handle_t, const char*, char*, size_t*) { return ESP_ERR_NVS_NOT_FOUND; }
+inline esp_err_t nvs_set_str(nvs_handle_t, const char*, const char*) { return ESP_OK; }
+
+#define SIM_NVS_INT(type, name) \
+    inline esp_err_t nvs_get_##name(nvs_handle_t, const char*, type*) { return ESP_ERR_NVS_NOT_FOUND; } \
+    inline esp_err_t nvs_set_##name(nvs_handle_t, const char*, type) { return ESP_OK; }
+
+SIM_NVS_INT(uint8_t, u8)
+SIM_NVS_INT(int8_t, i8)
+SIM_NVS_INT(uint16_t, u16)
+SIM_NVS_INT(int16_t, i16)
+SIM_NVS_INT(uint32_t, u32)
+SIM_NVS_INT(int32_t, i32)
+
+#undef SIM_NVS_INT
@@ -0,0 +1,629 @@
+// Host-side LED matrix simulator.
+//
+//   led_matrix_sim list                       scenarios known to the simulator
+//   led_matrix_sim test [--update]            compare final frames with golden/*.ppm, --actual DIR
+//   led_matrix_sim bench [--frames N]         microseconds per frame for each scenario
+//   led_matrix_sim dump <scenario> [out.png]  animated PNG of a scenario (+ final frame), --scale N
+//   led_matrix_sim particles [--frames N]     particle engine throughput (particles/ms)
+//   led_matrix_sim colors                     color lookup tables vs. per-call math
+//   led_matrix_sim dither [--frames N]        bit depth vs. DMA memory, refresh and shading
+//   led_matrix_sim history [--frames N]       flight history store checks and cost per poll
+//   led_matrix_sim blend [--frames N]         compositor checks and blend kernel cost per frame
+//   led_matrix_sim sprites [--frames N]       RLE sprite blitter checks, flash bytes and blit cost per sprite
+//   led_matrix_sim anim <clip.lma>            animation partition decode checks, size and cost per frame
+//   led_matrix_sim fft [--frames N]           real FFT vs. double-precision DFT, us per 256/512/1024 points
+//   led_matrix_sim dsp [in.wav...]            audio DSP on synthetic signals and WAVs vs. golden bands, us per stage
+//   led_matrix_sim q15 [--frames N]           fixed-point audio path vs. float: us per stage, band accuracy
+//   led_matrix_sim spectrum [--frames N]      band maps and AGC checks, band stage cost per hop
+//   led_matrix_sim audio [--frames N]         overlap, CPU and DMA per analysis setting, capture task latency
+//   led_matrix_sim onset [in.wav...]          onset, beat and tempo accuracy and detection cost per hop
+//   led_matrix_sim memory [--frames N]        heap per screen vs. budget, peak and steady state
+//   led_matrix_sim radar [--frames N]         radar cost with 100 to 1000 aircraft, fails over 60 FPS budget
+//
+// Every scenario resets the fakes (WiFi, time, flights, RNG, microphone),
+// builds its screen on a LEDMatrix of the requested geometry and drives
+// it frame by frame at a fixed 60 FPS time step.
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "led_matrix.h"
+#include "app_config.h"
+#include "flight_api.h"
+#include "flight_screen.h"
+#include "clock_screen.h"
+#include "fireworks_screen.h"
+#include "spectrum_screen.h"
+#include "spectrogram_screen.h"
+#include "info_screen.h"
+#include "radar_screen.h"
+#include "screen_manager.h"
+#include "particle_system.h"
+#include "image_writer.h"
+#include "color_bench.h"
+#include "dither_bench.h"
+#include "history_bench.h"
+#include "blend_bench.h"
+#include "sprite_bench.h"
+#include "anim_bench.h"
+#include "fft_bench.h"
+#include "q15_bench.h"
+#include "dsp_bench.h"
+#include "audio_bench.h"
+#include "onset_bench.h"
+#include "spectrum_bench.h"
+#include "sim_fakes.h"
+#include "esp_heap_caps.h"
+
+#ifndef SIM_GOLDEN_DIR
+#define SIM_GOLDEN_DIR "golden"
+#endif
+
+static const float SIM_DT = 1.0f / 60.0f;
+
+struct Scenario {
+    const char* name;
+    int width;
+    int height;
+    int frames;
+    std::function<void()> setup;
+    std::function<BaseScreen*()> create;
+    int tiles = 1;              // > 1: tiles x tiles modules on one serpentine chain; the golden is the chain
+};
+
+// One module, or a tiles x tiles grid of them folded into a serpentine chain
+static DisplayConfig geometry(int width, int height, int tiles = 1)
+{
+    DisplayConfig dc;
+    dc.panel_width = width / tiles;
+    dc.panel_height = height / tiles;
+    dc.chain_length = tiles * tiles;
+    dc.tile_rows = tiles;
+    dc.serpentine = true;
+    return dc;
+}
+
+// -----------------------------------------------------
+// Fixtures
+// -----------------------------------------------------
+static void setupConnected()
+{
+    sim_set_wifi(WiFiState::CONNECTED, "192.168.1.42");
+    AppConfig::instance().setLocation(-33.95f, 151.18f);
+}
+
+static void setupFlights()
+{
+    setupConnected();
+    sim_set_flights({
+        sim_make_flight("QFA1", "Australia", -33.90f, 151.20f, 10668.0f, 250.0f, 45.0f),
+        sim_make_flight("UAE413", "United Arab Emirates", -33.80f, 151.00f, 3048.0f, 160.0f, 270.0f),
+        sim_make_flight("VOZ977", "Australia", -34.10f, 151.30f, 1524.0f, 120.0f, 180.0f),
+    });
+    FlightAPI::instance().fetchFlights(-90.0f, 90.0f, -180.0f, 180.0f);
+}
+
+// Aircraft scattered over the radar range (+-0.25 deg) around home
+static std::vector<Flight> busySky(int count, uint32_t seed)
+{
+    XorShift32 rng(seed);
+    std::vector<Flight> sky;
+    sky.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        char callsign[16];
+        snprintf(callsign, sizeof(callsign), "SIM%04d", i);
+        float lat = -33.95f + ((int)rng.below(5001) - 2500) * 0.0001f;
+        float lon = 151.18f + ((int)rng.below(5001) - 2500) * 0.0001f;
+        sky.push_back(sim_make_flight(callsign, "Australia", lat, lon,
+                                      (float)rng.below(12000), 60.0f + rng.below(200),
+                                      (float)rng.below(360)));
+    }
+    return sky;
+}
+
+static void setupBusySky()
+{
+    setupConnected();
+    sim_set_flights(busySky(120, 7));
+    FlightAPI::instance().fetchFlights(-90.0f, 90.0f, -180.0f, 180.0f);
+}
+
+// A low note, an overtone-ish high one and some air for the waterfall
+static void setupChord()
+{
+    sim_audio_set_tones({{220.0f, 0.4f}, {1760.0f, 0.1f}, {7040.0f, 0.03f}});
+}
+
+static std::vector<Scenario> scenarios()
+{
+    auto flight = [] { return new FlightScreen(); };
+    auto clock = [] { return new ClockScreen(); };
+
+    return {
+        {"flight_no_wifi",      64, 32,  30, [] {}, flight},
+        {"flight_loading",      64, 32,  10, setupConnected, flight},
+        {"flight_no_flights",   64, 32,  60, setupConnected, flight},
+        {"flight_ready",        64, 32, 240, setupFlights, flight},
+        {"flight_ready_128x64", 128, 64, 240, setupFlights, flight},
+        {"clock_no_wifi",       64, 32,  30, [] {}, clock},
+        {"clock_syncing",       64, 32,  30, setupConnected, clock},
+        {"clock_ready",         64, 32,  45, [] { setupConnected(); sim_set_time(10, 42); }, clock},
+        {"clock_ready_128x64",  128, 64, 45, [] { setupConnected(); sim_set_time(21, 7); }, clock},
+        {"fireworks",           64, 32, 180, [] {}, [] { return new FireworksScreen(); }},
+        {"fireworks_128x64",    128, 64, 180, [] {}, [] { return new FireworksScreen(); }},
+        {"fireworks_256x128",   256, 128, 180, [] {}, [] { return new FireworksScreen(); }},
+        {"spectrum",            64, 32,  30, [] {}, [] { return new SpectrumScreen(); }},
+        {"spectrogram",         64, 32,  90, setupChord, [] { return new SpectrogramScreen(); }},
+        {"spectrogram_128x64",  128, 64, 180, setupChord, [] { return new SpectrogramScreen(); }},
+        {"spectrum_idle",       64, 32, 480, [] { sim_audio_set_tones({}); }, [] { return new SpectrumScreen(); }},
+        {"spectrum_2x2",        64, 32,  30, [] {}, [] { return new SpectrumScreen(); }, 2},
+        {"info_connected",      64, 32, 120, setupConnected, [] { return new InfoScreen(); }},
+        {"radar_no_location",   64, 32,  10, [] {}, [] { return new RadarScreen(); }},
+        {"radar",               64, 32, 240, setupFlights, [] { return new RadarScreen(); }},
+        {"radar_busy_128x64",   128, 64, 600, setupBusySky, [] { return new RadarScreen(); }},
+    };
+}
+
+// -----------------------------------------------------
+// Driver
+// -----------------------------------------------------
+using FrameHook = std::function<void(int frame, const LEDMatrix& matrix)>;
+
+// Runs a scenario; returns mean microseconds spent in update+render+show
+static double runScenario(const Scenario& sc, LEDMatrix& matrix, int frames, const FrameHook& hook)
+{
+    sim_reset();
+    sc.setup();
+
+    std::unique_ptr<BaseScreen> screen(sc.create());
+    screen->onEnter();
+
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+
+    for (int i = 0; i < frames; ++i) {
+        screen->update(SIM_DT);
+        screen->render(matrix);
+        matrix.show();
+        if (hook) hook(i, matrix);
+    }
+
+    auto elapsed = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+    screen->onExit();
+    return elapsed / frames;
+}
+
+static const Scenario* findScenario(const std::vector<Scenario>& all, const char* name)
+{
+    for (const auto& sc : all)
+        if (strcmp(sc.name, name) == 0) return &sc;
+    return nullptr;
+}
+
+// -----------------------------------------------------
+// Commands
+// -----------------------------------------------------
+static int cmdList()
+{
+    for (const auto& sc : scenarios())
+        printf("%-22s %dx%d, %d frames\n", sc.name, sc.width, sc.height, sc.frames);
+    return 0;
+}
+
+// 2x2 modules of 32x16 on one chain: every pixel the chain receives must
+// come from where that module hangs. Serpentine, the chain runs along the
+// top row left to right, then back along the bottom row right to left
+// with those modules upside-down.
+static bool checkChainMapping(bool serpentine)
+{
+    struct Module {
+        int x, y;           // canvas origin
+        bool flipped;       // mounted upside-down
+    };
+    const Module straight[4] = {{0, 0, false}, {32, 0, false}, {0, 16, false}, {32, 16, false}};
+    const Module folded[4] = {{0, 0, false}, {32, 0, false}, {32, 16, true}, {0, 16, true}};
+    const Module* modules = serpentine ? folded : straight;
+
+    DisplayConfig dc = geometry(64, 32, 2);
+    dc.serpentine = serpentine;
+    LEDMatrix matrix(dc);
+    matrix.begin();
+    for (int y = 0; y < 32; ++y)
+        for (int x = 0; x < 64; ++x) matrix.drawPixelRGB(x, y, (uint8_t)x, (uint8_t)y, 0x5A);
+    matrix.show();
+
+    const uint8_t* chain = matrix.chainPixels();
+    if (!chain) return false;
+    for (int cy = 0; cy < 16; ++cy) {
+        for (int cx = 0; cx < 128; ++cx, chain += 3) {
+            const Module& m = modules[cx / 32];
+            const int lx = cx % 32;
+            const int x = m.flipped ? m.x + 31 - lx : m.x + lx;
+            const int y = m.flipped ? m.y + 15 - cy : m.y + cy;
+            if (chain[0] != x || chain[1] != y || chain[2] != 0x5A) return false;
+        }
+    }
+    return true;
+}
+
+// A missing golden fails, unless it is being recorded; frames that differ
+// are written to actualDir, never next to the goldens
+static int cmdTest(const std::string& goldenDir, const std::string& actualDir, bool update)
+{
+    int failures = 0;
+    std::error_code ec;
+    std::filesystem::create_directories(update ? goldenDir : actualDir, ec);
+
+    for (bool serpentine : {true, false}) {
+        const bool ok = checkChainMapping(serpentine);
+        printf("[ %s ] 2x2 %s chain: every module's pixels where it hangs\n", ok ? " OK " : "FAIL",
+               serpentine ? "serpentine" : "straight");
+        failures += !ok;
+    }
+
+    for (const auto& sc : scenarios()) {
+        LEDMatrix matrix(geometry(sc.width, sc.height, sc.tiles));
+        matrix.begin();
+        runScenario(sc, matrix, sc.frames, nullptr);
+
+        // Tiled: the frame as the chain receives it
+        const uint8_t* actual = sc.tiles > 1 ? matrix.chainPixels() : matrix.shownPixels();
+        const int width = sc.width * sc.tiles, height = sc.height / sc.tiles;
+        std::string golden = goldenDir + "/" + sc.name + ".ppm";
+
+        std::vector<uint8_t> expected;
+        int w = 0, h = 0;
+        bool have = read_ppm(golden.c_str(), expected, w, h);
+
+        if (update) {
+            if (write_ppm(golden.c_str(), actual, width, height)) {
+                printf("[ REC  ] %s -> %s\n", sc.name, golden.c_str());
+            } else {
+                printf("[ FAIL ] %s: cannot write %s\n", sc.name, golden.c_str());
+                failures++;
+            }
+            continue;
+        }
+        if (!have) {
+            printf("[ FAIL ] %s: no golden at %s (record it with --update)\n", sc.name, golden.c_str());
+            failures++;
+            continue;
+        }
+
+        size_t bytes = (size_t)width * height * 3;
+        int diff = 0;
+        if (w == width && h == height) {
+            for (size_t i = 0; i < bytes; i += 3)
+                if (memcmp(actual + i, expected.data() + i, 3) != 0) diff++;
+        } else {
+            diff = -1;
+        }
+
+        if (diff == 0) {
+            printf("[  OK  ] %s\n", sc.name);
+        } else {
+            std::string out = actualDir + "/" + sc.name + ".actual.png";
+            write_png(out.c_str(), actual, width, height, 8);
+            if (diff < 0)
+                printf("[ FAIL ] %s: golden is %dx%d, frame is %dx%d\n", sc.name, w, h, width, height);
+            else
+                printf("[ FAIL ] %s: %d pixel(s) differ, see %s\n", sc.name, diff, out.c_str());
+            failures++;
+        }
+    }
+
+    printf("%d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
+
+static int cmdBench(int frames)
+{
+    printf("%-22s %9s %12s %10s\n", "scenario", "size", "us/frame", "max FPS");
+    for (const auto& sc : scenarios()) {
+        LEDMatrix matrix(geometry(sc.width, sc.height, sc.tiles));
+        matrix.begin();
+        double us = runScenario(sc, matrix, frames, nullptr);
+        char size[16];
+        snprintf(size, sizeof(size), "%dx%d", sc.width, sc.height);
+        printf("%-22s %9s %12.2f %10.0f\n", sc.name, size, us, us > 0 ? 1e6 / us : 0.0);
+    }
+    return 0;
+}
+
+// Keeps the pool full of sparks and times update and render separately
+static int cmdParticles(int frames)
+{
+    using clock = std::chrono::steady_clock;
+
+    printf("%-10s %9s %14s %14s %14s\n", "particles", "panel", "update p/ms", "render p/ms", "total p/ms");
+
+    const int sizes[] = {250, 1000, 4000, 16000};
+    for (int capacity : sizes) {
+        int w = capacity <= 1000 ? 128 : 256;
+        int h = w / 2;
+        FrameBuffer fb(w, h);
+
+        ParticleSystem ps;
+        ps.reserve(capacity);
+        ps.setPalette(COLOR_WHEEL.data());
+        ps.setGravity(72.0f);
+        ps.setFadeTime(0.4f);
+
+        XorShift32 rng(1);
+        ParticleSystem::Burst burst = {w / 2.0f, h / 3.0f, 50, 24.0f, 73.5f, 0.27f, 0.93f, 0, 255};
+
+        double updateUs = 0, renderUs = 0;
+        long processed = 0;
+
+        for (int f = 0; f < frames; ++f) {
+            while (ps.emit(burst, rng) > 0) {
+                burst.x = (float)rng.below(w);
+                burst.y = (float)rng.below(h);
+            }
+            processed += ps.count();
+
+            auto t0 = clock::now();
+            ps.update(1.0f / 60.0f);
+            auto t1 = clock::now();
+            ps.render(fb);
+            auto t2 = clock::now();
+
+            updateUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+            renderUs += std::chrono::duration<double, std::micro>(t2 - t1).count();
+        }
+
+        char panel[16];
+        snprintf(panel, sizeof(panel), "%dx%d", w, h);
+        printf("%-10d %9s %14.0f %14.0f %14.0f\n", capacity, panel,
+               processed / (updateUs / 1000.0), processed / (renderUs / 1000.0),
+               processed / ((updateUs + renderUs) / 1000.0));
+    }
+    return 0;
+}
+
+// Radar with a busy sky: a fresh fetch every 30 s (merged in update),
+// dead reckoning, trails and sprites for every aircraft
+static int cmdRadar(int frames)
+{
+    using clock = std::chrono::steady_clock;
+    const double BUDGET_US = 1e6 / 60.0;
+    const int FETCH_EVERY = 1800;
+    bool overBudget = false;
+
+    printf("%-9s %9s %12s %12s %10s\n", "aircraft", "panel", "us/frame", "worst us", "max FPS");
+
+    const int counts[] = {100, 300, 500, 1000};
+    const int panels[][2] = {{64, 32}, {128, 64}, {256, 128}};
+    for (const auto& panel : panels) {
+        for (int count : counts) {
+            sim_reset();
+            setupConnected();
+
+            LEDMatrix matrix(geometry(panel[0], panel[1]));
+            matrix.begin();
+            RadarScreen radar;
+            radar.onEnter();
+
+            double totalUs = 0, worstUs = 0;
+            for (int f = 0; f < frames; ++f) {
+                if (f % FETCH_EVERY == 0) {
+                    // Same aircraft, moved on: exercises the merge, not just inserts
+                    sim_set_flights(busySky(count, 7 + f / FETCH_EVERY));
+                    FlightAPI::instance().fetchFlights(-90.0f, 90.0f, -180.0f, 180.0f);
+                }
+
+                auto t0 = clock::now();
+                radar.update(SIM_DT);
+                radar.render(matrix);
+                matrix.show();
+                double us = std::chrono::duration<double, std::micro>(clock::now() - t0).count();
+
+                totalUs += us;
+                if (us > worstUs) worstUs = us;
+            }
+
+            double mean = totalUs / frames;
+            char size[16];
+            snprintf(size, sizeof(size), "%dx%d", panel[0], panel[1]);
+            printf("%-9zu %9s %12.2f %12.2f %10.0f\n", radar.trackCount(), size, mean, worstUs,
+                   mean > 0 ? 1e6 / mean : 0.0);
+            if (mean > BUDGET_US) overBudget = true;
+        }
+    }
+
+    if (overBudget) printf("FAIL: mean frame time over the 60 FPS budget\n");
+    return overBudget ? 1 : 0;
+}
+
+// Lazily built screens under a ScreenManager: heap each one takes against
+// its budget, peak with every screen built, and steady state once the
+// inactive ones have released their buffers
+static size_t heapUsed(size_t baseline)
+{
+    size_t free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    return baseline > free ? baseline - free : 0;
+}
+
+static int cmdMemory(int frames)
+{
+    bool ok = true;
+    auto check = [&ok](bool pass, const char* what) {
+        printf("[ %s ] %s\n", pass ? " OK " : "FAIL", what);
+        if (!pass) ok = false;
+    };
+
+    // The first pass only warms up one-time allocations (stdio buffers,
+    // singletons) so they are not charged to whichever screen hits them
+    const int panels[][2] = {{64, 32}, {64, 32}, {128, 64}, {256, 128}};
+    for (const auto& panel : panels) {
+        const bool warmup = &panel == &panels[0];
+        const int w = panel[0], h = panel[1];
+        if (warmup) printf("Warm-up pass (budget warnings here are one-time allocations):\n");
+        sim_reset();
+        setupBusySky();
+
+        LEDMatrix matrix(geometry(w, h));
+        matrix.begin();
+        const size_t baseline = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+        // Same registrations as main.cpp (no I2S driver on the host)
+        ScreenManager manager(matrix);
+        manager.addScreen("Flight", []() -> BaseScreen* { return new FlightScreen(); }, sizeof(FlightScreen));
+        manager.addScreen("Radar", []() -> BaseScreen* { return new RadarScreen(); }, RadarScreen::memoryBudget(w, h));
+        manager.addScreen("Clock", []() -> BaseScreen* { return new ClockScreen(); }, sizeof(ClockScreen));
+        manager.addScreen("Spectrum", []() -> BaseScreen* { return new SpectrumScreen(); }, sizeof(SpectrumScreen));
+        manager.addScreen("Spectrogram", []() -> BaseScreen* { return new SpectrogramScreen(); },
+                          SpectrogramScreen::memoryBudget(w, h));
+        manager.addScreen("Fireworks", []() -> BaseScreen* { return new FireworksScreen(); }, FireworksScreen::memoryBudget(w, h));
+        manager.addScreen("Info", []() -> BaseScreen* { return new InfoScreen(); }, sizeof(InfoScreen));
+        manager.setReleaseAfter(0.0f);
+        manager.resetHeapLowWater();
+
+        const size_t booted = heapUsed(baseline);
+        auto run = [&](int n) {
+            for (int f = 0; f < n; ++f) {
+                manager.update(SIM_DT);
+                manager.render();
+                matrix.show();
+            }
+        };
+
+        // One lap: every screen entered once, the next one prepared ahead
+        for (size_t s = 0; s < manager.screenCount(); ++s) {
+            run(frames);
+            manager.nextScreen();
+        }
+        run(1);
+        const size_t peak = baseline - manager.heapLowWater();
+        const size_t allBuilt = heapUsed(baseline);
+
+        const size_t freed = manager.releaseInactive();
+        const size_t steady = heapUsed(baseline);
+        if (warmup) continue;
+
+        printf("\n%dx%d  %-10s %8s %8s %8s\n", w, h, "screen", "budget", "measured", "holding");
+        bool withinBudget = true;
+        for (size_t s = 0; s < manager.screenCount(); ++s) {
+            ScreenManager::MemoryInfo mi = manager.memoryInfo((int)s);
+            printf("         %-10s %8zu %8zu %8s\n", mi.name, mi.budget, mi.measured, mi.holding ? "yes" : "no");
+            withinBudget &= mi.built && mi.measured <= mi.budget + ScreenManager::ALLOCATOR_SLACK;
+        }
+        printf("heap: %zu at boot (first screen only), %zu peak, %zu with all built, %zu steady (%zu released)\n",
+               booted, peak, allBuilt, steady, freed);
+
+        check(withinBudget, "every screen stays within its declared budget");
+        check(steady < allBuilt && freed > 0, "releasing inactive screens returns their buffers");
+
+        // Released screens rebuild their buffers when shown again
+        for (size_t s = 0; s < manager.screenCount(); ++s) {
+            manager.nextScreen();
+            run(frames);
+        }
+        check(heapUsed(baseline) <= allBuilt + 1024, "screens rebuild after release without growing");
+
+        // Idle timeout: only the current and the prepared next screen keep buffers
+        manager.setReleaseAfter(0.25f);
+        run(frames > 60 ? frames : 60);
+        int holding = 0;
+        for (size_t s = 0; s < manager.screenCount(); ++s)
+            holding += manager.memoryInfo((int)s).holding ? 1 : 0;
+        check(holding <= 2, "inactive screens release after the idle timeout");
+    }
+
+    return ok ? 0 : 1;
+}
+
+static int cmdDump(const char* name, const char* outPath, int frames, int scale)
+{
+    auto all = scenarios();
+    const Scenario* sc = findScenario(all, name);
+    if (!sc) {
+        fprintf(stderr, "Unknown scenario '%s' (try: list)\n", name);
+        return 2;
+    }
+
+    std::string out = outPath ? outPath : std::string(name) + ".png";
+    LEDMatrix matrix(geometry(sc->width, sc->height, sc->tiles));
+    matrix.begin();
+
+    ApngWriter anim;
+    if (!anim.open(out.c_str(), sc->width, sc->height, 60, scale)) {
+        fprintf(stderr, "Cannot write %s\n", out.c_str());
+        return 1;
+    }
+
+    runScenario(*sc, matrix, frames > 0 ? frames : sc->frames, [&](int, const LEDMatrix& m) {
+        anim.addFrame(m.shownPixels());
+    });
+    anim.close();
+
+    std::string last = out.substr(0, out.rfind('.')) + ".ppm";
+    write_ppm(last.c_str(), matrix.shownPixels(), sc->width, sc->height);
+
+    printf("Wrote %s and %s\n", out.c_str(), last.c_str());
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s list | test [--update] [--golden DIR] [--actual DIR] | "
+                        "bench [--frames N] | particles [--frames N] | colors | dither [--frames N] | radar [--frames N] | history [--frames N] | blend [--frames N] | sprites [--frames N] | anim <clip.lma> [--reference raw] [--frames N] | fft [--frames N] | q15 [--frames N] | dsp [in.wav...] [--update] [--frames N] | spectrum [--frames N] | audio [--frames N] | onset [in.wav...] [--truth onsets.txt] | memory [--frames N] | dump <scenario> [out.png] [--frames N] [--scale N]\n", argv[0]);
+        return 2;
+    }
+
+    std::string goldenDir = SIM_GOLDEN_DIR;
+    std::string actualDir = ".";
+    bool update = false;
+    int frames = 0;
+    int scale = 4;
+    const char* reference = nullptr;
+    const char* truth = nullptr;
+    std::vector<const char*> positional;
+
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--update") == 0) update = true;
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) goldenDir = argv[++i];
+        else if (strcmp(argv[i], "--actual") == 0 && i + 1 < argc) actualDir = argv[++i];
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) scale = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--reference") == 0 && i + 1 < argc) reference = argv[++i];
+        else if (strcmp(argv[i], "--truth") == 0 && i + 1 < argc) truth = argv[++i];
+        else positional.push_back(argv[i]);
+    }
+
+    std::string cmd = argv[1];
+    if (cmd == "list")  return cmdList();
+    if (cmd == "test")  return cmdTest(goldenDir, actualDir, update);
+    if (cmd == "bench") return cmdBench(frames > 0 ? frames : 2000);
+    if (cmd == "particles") return cmdParticles(frames > 0 ? frames : 600);
+    if (cmd == "colors") return color_bench_run(frames > 0 ? frames : 10000000);
+    if (cmd == "dither") return dither_bench_run(frames > 0 ? frames : 240);
+    if (cmd == "radar") return cmdRadar(frames > 0 ? frames : 3600);
+    if (cmd == "history") return history_bench_run(frames > 0 ? frames : 200);
+    if (cmd == "blend") return blend_bench_run(frames > 0 ? frames : 2000);
+    if (cmd == "sprites") return sprite_bench_run(frames > 0 ? frames : 20000);
+    if (cmd == "fft") return fft_bench_run(frames > 0 ? frames : 20000);
+    if (cmd == "q15") return q15_bench_run(frames > 0 ? frames : 20000);
+    if (cmd == "dsp") return dsp_bench_run(positional, goldenDir, update, frames > 0 ? frames : 2000);
+    if (cmd == "spectrum") return spectrum_bench_run(frames > 0 ? frames : 20000);
+    if (cmd == "audio") return audio_bench_run(frames > 0 ? frames : 180);
+    if (cmd == "onset") return onset_bench_run(positional, truth);
+    if (cmd == "anim" && !positional.empty())
+        return anim_bench_run(positional[0], reference, frames > 0 ? frames : 3600);
+    if (cmd == "memory") return cmdMemory(frames > 0 ? frames : 90);
+    if (cmd == "dump" && !positional.empty())
+        return cmdDump(positional[0], positional.size() > 1 ? positional[1] : nullptr, frames,
+                       scale > 0 ? scale : 1);
+
+    fprintf(stderr, "Unknown command '%s'\n", argv[1]);
+    return 2;
+}
@@ -0,0 +1,239 @@
+#include "spectrum_bench.h"
+#include "fft.h"
+#include "microphone.h"
+#include "spectrum_bands.h"
+#include "xorshift.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+static const int SAMPLE_RATE = 44100;
+
+// Packed spectrum of a Hann-windowed sine, `dbfs` below full scale
+static void toneSpectrum(RealFFT& fft, float hz, float dbfs, std::vector<float>& out, float fullScale)
+{
+    const int n = fft.size();
+    out.resize(n);
+    const float amp = fullScale * powf(10.0f, dbfs / 20.0f);
+    for (int i = 0; i < n; ++i) {
+        float w = 0.5f * (1.0f - cosf(2.0f * (float)M_PI * i / (n - 1)));
+        out[i] = amp * sinf(2.0f * (float)M_PI * hz * i / SAMPLE_RATE) * w;
+    }
+    fft.forward(out.data());
+}
+
+// Edges strictly increasing, tiling firstBin..lastBin, table agreeing
+static bool mapIsValid(const SpectrumBands& bands)
+{
+    if (bands.edge(0) != bands.firstBin() || bands.edge(bands.count()) != bands.lastBin() + 1) return false;
+    for (int b = 0; b < bands.count(); ++b) {
+        if (bands.edge(b + 1) <= bands.edge(b)) return false;
+        for (int k = bands.edge(b); k < bands.edge(b + 1); ++k)
+            if (bands.bandOf(k) != b) return false;
+    }
+    return true;
+}
+
+static int bandsBelow(const SpectrumBands& bands, float hz, int fftSize)
+{
+    int n = 0;
+    for (int b = 0; b < bands.count(); ++b)
+        if (bands.edge(b + 1) * (float)SAMPLE_RATE / fftSize <= hz) n++;
+    return n;
+}
+
+static void checkMaps()
+{
+    bool valid = true, columns = true;
+    const int widths[] = {32, 64, 128, 192, 256};
+    const int sizes[] = {256, 512, 1024, 2048};
+    for (int fftSize : sizes) {
+        for (int w : widths) {
+            for (int s = 0; s < 2; ++s) {
+                SpectrumBands bands;
+                int want = mic_bars_for_width(w);
+                int got = bands.configure(want, fftSize, SAMPLE_RATE, (BandScale)s);
+                valid &= mapIsValid(bands);
+                int bins = bands.lastBin() - bands.firstBin() + 1;
+                columns &= got == (want < bins ? want : bins);
+            }
+        }
+    }
+    check(valid, "every map tiles its bins with at least one bin per band");
+    check(columns && mic_bars_for_width(128) == 128 && mic_bars_for_width(64) == 32,
+          "one bar per column from 128 columns, as many as the FFT resolves");
+
+    // Where the bars go: share of bars below 500 Hz and 2 kHz
+    printf("\n%-28s %6s %8s %8s %8s\n", "bars (1024-point FFT)", "bars", "<500 Hz", "<2 kHz", ">=2 kHz");
+    const int fftSize = 1024;
+    int linearBass = 0;
+    {
+        // The old layout: equal bins per bar from DC
+        const int count = 32, per = fftSize / 2 / count;
+        int b500 = 0, b2k = 0;
+        for (int b = 0; b < count; ++b) {
+            float top = (b + 1) * per * (float)SAMPLE_RATE / fftSize;
+            b500 += top <= 500.0f;
+            b2k += top <= 2000.0f;
+        }
+        linearBass = b500;
+        printf("%-28s %6d %8d %8d %8d\n", "linear (before)", count, b500, b2k, count - b2k);
+    }
+    int logBass = 0;
+    const char* names[] = {"log", "mel"};
+    for (int s = 0; s < 2; ++s) {
+        SpectrumBands bands;
+        bands.configure(32, fftSize, SAMPLE_RATE, (BandScale)s);
+        int b500 = bandsBelow(bands, 500.0f, fftSize), b2k = bandsBelow(bands, 2000.0f, fftSize);
+        if (s == 0) logBass = b500;
+        printf("%-28s %6d %8d %8d %8d\n", names[s], bands.count(), b500, b2k, bands.count() - b2k);
+    }
+    printf("\n");
+    check(logBass >= 4 * (linearBass > 0 ? linearBass : 1), "log bands give the bass at least four times the bars");
+}
+
+static void checkLevels()
+{
+    RealFFT fft;
+    fft.init(1024);
+    SpectrumBands bands;
+    bands.configure(32, 1024, SAMPLE_RATE);
+    std::vector<float> spectrum;
+    float db[SpectrumBands::MAX_BANDS];
+
+    bool placed = true, fullScale = true;
+    const float tones[] = {100.0f, 440.0f, 1000.0f, 3500.0f, 12000.0f};
+    for (float hz : tones) {
+        toneSpectrum(fft, hz, 0.0f, spectrum, bands.fullScale);
+        bands.process(spectrum.data(), db);
+        int loudest = 0;
+        double total = 0.0;
+        for (int b = 0; b < bands.count(); ++b) {
+            if (db[b] > db[loudest]) loudest = b;
+            total += pow(10.0, db[b] / 10.0);
+        }
+        int bin = (int)lroundf(hz * 1024 / SAMPLE_RATE);
+        placed &= bands.bandOf(bin) == loudest || bands.bandOf(bin) == loudest + 1 || bands.bandOf(bin) == loudest - 1;
+        fullScale &= fabs(10.0 * log10(total)) < 0.5;
+    }
+    check(placed, "a tone is loudest in the band holding its bin");
+    check(fullScale, "a full-scale sine totals 0 dBFS across the bands");
+}
+
+// Reference after `seconds` of a constant level, stepped at dt
+static float agcAfter(AutoGain& agc, float level, float seconds, float dt)
+{
+    float levels[1];
+    for (float t = 0.0f; t < seconds - dt * 0.5f; t += dt) {
+        levels[0] = level;
+        agc.process(levels, 1, dt);
+    }
+    return agc.referenceDb();
+}
+
+static void checkAgc()
+{
+    AutoGain agc;
+    agc.reset();
+
+    // Quiet room: the reference stays at the floor, bars stay low
+    agcAfter(agc, -75.0f, 5.0f, 1.0f / 172.0f);
+    float quiet[1] = {-75.0f};
+    agc.process(quiet, 1, 1.0f / 172.0f);
+    check(agc.referenceDb() == agc.floorDb && quiet[0] < 0.4f, "a quiet room is not amplified to full scale");
+
+    // Loud: the reference reaches the level within a few attack times
+    float ref = agcAfter(agc, -12.0f, agc.attackS * 5, 1.0f / 172.0f);
+    check(fabsf(ref + 12.0f) < 0.5f, "attack follows a loud passage within five time constants");
+
+    // Release: one time constant later, 63% of the way down
+    float start = agc.referenceDb();
+    ref = agcAfter(agc, -40.0f, agc.releaseS, 1.0f / 172.0f);
+    float fraction = (start - ref) / (start + 40.0f);
+    check(fabsf(fraction - 0.632f) < 0.02f, "release takes its time constant to fall 63%");
+
+    // The same step gives the same envelope at any hop or frame rate
+    AutoGain a, b;
+    a.reset();
+    b.reset();
+    float ra = agcAfter(a, -20.0f, 0.1f, 1.0f / 172.0f);
+    float rb = agcAfter(b, -20.0f, 0.1f, 1.0f / 60.0f);
+    check(fabsf(ra - rb) < 0.5f, "attack and release are independent of dt");
+}
+
+// The band stage the microphone used before: magnitudes, peak, equal
+// bins per band, per-frame peak normalization and a log per band
+static void linearBands(const float* spectrum, int half, int count, float* out)
+{
+    int binsPerBand = half / count;
+    float sums[SpectrumBands::MAX_BANDS] = {0};
+    float maxMag = 1.0f;
+    for (int k = 0; k < binsPerBand * count; ++k) {
+        float m = RealFFT::magnitude(spectrum, k);
+        if (m > maxMag) maxMag = m;
+        sums[k / binsPerBand] += m;
+    }
+    for (int b = 0; b < count; ++b) {
+        float level = sums[b] / binsPerBand * 2.0f / maxMag;
+        if (b == 0 || b == 1) level *= 0.25f;
+        out[b] = log10f(1.0f + level * 9.0f);
+    }
+}
+
+static void benchCost(int iterations)
+{
+    printf("\n%-8s %6s %14s %14s\n", "FFT", "bars", "linear us", "table+AGC us");
+    RealFFT fft;
+    XorShift32 rng(43);
+    const int sizes[] = {256, 1024};
+    const int bars[] = {16, 64, 128};
+    float out[SpectrumBands::MAX_BANDS];
+    volatile float sink = 0.0f;
+    for (int n : sizes) {
+        fft.init(n);
+        std::vector<float> spectrum(n);
+        for (float& v : spectrum) v = (float)(rng.next() % 20000) - 10000.0f;
+        for (int count : bars) {
+            if (count > n / 2) continue;
+            auto t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                linearBands(spectrum.data(), n / 2, count, out);
+                sink = sink + out[0];
+            }
+            double linearUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / iterations;
+
+            SpectrumBands bands;
+            AutoGain agc;
+            int used = bands.configure(count, n, SAMPLE_RATE);
+            t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                bands.process(spectrum.data(), out);
+                agc.process(out, used, (float)n / SAMPLE_RATE);
+                sink = sink + out[0];
+            }
+            double tableUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / iterations;
+            printf("%-8d %6d %14.2f %14.2f\n", n, used, linearUs, tableUs);
+        }
+    }
+    printf("\n");
+}
+
+int spectrum_bench_run(int iterations)
+{
+    checkMaps();
+    checkLevels();
+    checkAgc();
+    benchCost(iterations);
+
+    printf("%s\n", failures ? "FAILED" : "All spectrum checks passed");
+    return failures ? 1 : 0;
+}
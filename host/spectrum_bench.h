@@ -0,0 +1,6 @@
+#pragma once
+
+// Checks the spectrum's bin-to-band maps (log and mel, every panel width)
+// and automatic gain, and reports the band stage's cost per hop next to
+// the linear bands it replaced
+int spectrum_bench_run(int iterations);
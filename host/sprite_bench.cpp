@@ -0,0 +1,177 @@
+#include "sprite_bench.h"
+#include "assets.h"
+#include "led_matrix.h"
+#include "xorshift.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("[ %s ] %s\n", ok ? " OK " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+// Straightforward decode of one frame: RGB565 per pixel, -1 = transparent.
+// Returns false if the runs do not tile the frame row by row.
+static bool decodeReference(const RleSprite& s, int frame, std::vector<int32_t>& out)
+{
+    out.assign((size_t)s.width * s.height, -1);
+    const uint16_t* p = s.rle + s.frames[frame];
+    const uint16_t* end = s.rle + s.frames[frame + 1];
+
+    for (int y = 0; y < s.height; ++y) {
+        int x = 0;
+        while (x < s.width) {
+            if (p >= end) return false;
+            int op = *p >> RLE_OP_SHIFT;
+            int len = *p++ & RLE_LENGTH_MASK;
+            if (len == 0 || x + len > s.width) return false;
+            for (int i = 0; i < len; ++i, ++x) {
+                if (op == RLE_FILL) out[y * s.width + x] = p[0];
+                else if (op == RLE_COPY) out[y * s.width + x] = p[i];
+            }
+            if (op == RLE_FILL) p += 1;
+            else if (op == RLE_COPY) p += len;
+            else if (op != RLE_SKIP) return false;
+        }
+    }
+    return p == end;
+}
+
+static void fillBackground(LEDMatrix& matrix, uint32_t seed)
+{
+    XorShift32 rng(seed);
+    FrameBuffer* fb = matrix.gfx();
+    for (size_t i = 0; i < fb->sizeBytes(); ++i)
+        fb->pixels()[i] = (uint8_t)rng.next();
+}
+
+// Blit at (x, y) over a random background and compare every canvas pixel
+// with the reference composite
+static bool blitMatches(LEDMatrix& matrix, const RleSprite& s, int frame,
+                        const std::vector<int32_t>& ref, int x, int y)
+{
+    const int w = matrix.width(), h = matrix.height();
+    fillBackground(matrix, 99);
+    std::vector<uint8_t> expect(matrix.gfx()->pixels(), matrix.gfx()->pixels() + matrix.gfx()->sizeBytes());
+
+    for (int sy = 0; sy < s.height; ++sy)
+        for (int sx = 0; sx < s.width; ++sx) {
+            int px = x + sx, py = y + sy;
+            int32_t c = ref[sy * s.width + sx];
+            if (c < 0 || px < 0 || py < 0 || px >= w || py >= h) continue;
+            uint8_t* d = &expect[((size_t)py * w + px) * 3];
+            FrameBuffer::unpack565((uint16_t)c, d[0], d[1], d[2]);
+        }
+
+    matrix.drawSprite(s, x, y, frame);
+    return memcmp(expect.data(), matrix.gfx()->pixels(), expect.size()) == 0;
+}
+
+static void checkSprites(LEDMatrix& matrix)
+{
+    const int w = matrix.width(), h = matrix.height();
+    bool wellFormed = true, onCanvas = true, clipped = true;
+
+    for (int i = 0; i < ASSET_SPRITE_COUNT; ++i) {
+        const RleSprite& s = *ASSET_SPRITES[i];
+        for (int f = 0; f < s.frameCount; ++f) {
+            std::vector<int32_t> ref;
+            if (!decodeReference(s, f, ref)) {
+                printf("  %s frame %d: runs do not tile the frame\n", s.name, f);
+                wellFormed = false;
+                continue;
+            }
+            onCanvas &= blitMatches(matrix, s, f, ref, (w - s.width) / 2, (h - s.height) / 2);
+
+            // Straddling each edge and corner, and entirely off canvas
+            const int xs[] = {-s.width, -s.width + 1, -s.width / 2, 0, w - s.width, w - s.width / 2, w - 1, w};
+            const int ys[] = {-s.height, -s.height + 1, -s.height / 2, 0, h - s.height, h - s.height / 2, h - 1, h};
+            for (int x : xs)
+                for (int y : ys)
+                    clipped &= blitMatches(matrix, s, f, ref, x, y);
+        }
+    }
+
+    check(ASSET_SPRITE_COUNT > 0, "sprites were generated");
+    check(wellFormed, "every frame's runs tile it row by row");
+    check(onCanvas, "blit matches the reference decode (transparent runs keep the background)");
+    check(clipped, "blits across every edge and corner clip exactly");
+
+    bool found = ASSET_SPRITE_COUNT == 0 || asset_find(ASSET_SPRITES[0]->name) == ASSET_SPRITES[0];
+    check(found && !asset_find("no-such-sprite"), "sprites are found by name");
+
+    // Out-of-range frames draw nothing
+    if (ASSET_SPRITE_COUNT > 0) {
+        const RleSprite& s = *ASSET_SPRITES[0];
+        fillBackground(matrix, 5);
+        std::vector<uint8_t> before(matrix.gfx()->pixels(), matrix.gfx()->pixels() + matrix.gfx()->sizeBytes());
+        matrix.drawSprite(s, 0, 0, s.frameCount);
+        matrix.drawSprite(s, 0, 0, -1);
+        check(memcmp(before.data(), matrix.gfx()->pixels(), before.size()) == 0, "frames out of range are ignored");
+    }
+}
+
+// Per sprite: flash footprint, and the blit against plotting the same
+// frame pixel by pixel from an unpacked RGB565 + mask copy
+static void benchSprites(LEDMatrix& matrix, int frames)
+{
+    printf("\n%-14s %7s %6s %8s %8s %6s %9s %9s %8s\n", "sprite", "size", "frames", "raw B", "flash B",
+           "ratio", "rle us", "pixel us", "Mpix/s");
+    size_t totalFlash = 0, totalRaw = 0;
+    for (int i = 0; i < ASSET_SPRITE_COUNT; ++i) {
+        const RleSprite& s = *ASSET_SPRITES[i];
+        std::vector<std::vector<int32_t>> unpacked(s.frameCount);
+        for (int f = 0; f < s.frameCount; ++f) decodeReference(s, f, unpacked[f]);
+
+        const int x = (matrix.width() - s.width) / 2, y = (matrix.height() - s.height) / 2;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int n = 0; n < frames; ++n)
+            matrix.drawSprite(s, x, y, n % s.frameCount);
+        auto t1 = std::chrono::steady_clock::now();
+        for (int n = 0; n < frames; ++n) {
+            const std::vector<int32_t>& px = unpacked[n % s.frameCount];
+            for (int sy = 0; sy < s.height; ++sy)
+                for (int sx = 0; sx < s.width; ++sx) {
+                    int32_t c = px[sy * s.width + sx];
+                    if (c < 0) continue;
+                    uint8_t r, g, b;
+                    FrameBuffer::unpack565((uint16_t)c, r, g, b);
+                    matrix.drawPixelRGB(x + sx, y + sy, r, g, b);
+                }
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        double rleUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / frames;
+        double pixelUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / frames;
+        char size[16];
+        snprintf(size, sizeof(size), "%dx%d", s.width, s.height);
+        printf("%-14s %7s %6d %8zu %8zu %5.0f%% %9.3f %9.3f %8.1f\n", s.name, size, s.frameCount,
+               s.rawBytes(), s.flashBytes(), 100.0 * s.flashBytes() / s.rawBytes(), rleUs, pixelUs,
+               rleUs > 0 ? s.width * s.height / rleUs : 0.0);
+        totalFlash += s.flashBytes();
+        totalRaw += s.rawBytes();
+    }
+    printf("%-14s %7s %6s %8zu %8zu %5.0f%%\n", "total", "", "", totalRaw, totalFlash,
+           totalRaw ? 100.0 * totalFlash / totalRaw : 0.0);
+}
+
+int sprite_bench_run(int frames)
+{
+    DisplayConfig dc;
+    dc.panel_width = 64;
+    dc.panel_height = 32;
+    LEDMatrix matrix(dc);
+    matrix.begin();
+
+    checkSprites(matrix);
+    benchSprites(matrix, frames);
+
+    printf("\n%s\n", failures ? "FAILED" : "All sprite checks passed");
+    return failures ? 1 : 0;
+}
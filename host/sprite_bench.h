@@ -0,0 +1,6 @@
+#pragma once
+
+// Checks the RLE sprite blitter against a reference decoder (every
+// sprite and frame, on and across every canvas edge) and reports flash
+// footprint and blit cost per sprite
+int sprite_bench_run(int frames);
@@ -0,0 +1,127 @@
+#include "wav_io.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t le32(const uint8_t* p)
+{
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t le16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+bool read_wav(const char* path, std::vector<float>& samples, int& sampleRate)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) || memcmp(data.data() + 8, "WAVE", 4)) return false;
+
+    int format = 0, channels = 0, bits = 0;
+    sampleRate = 0;
+    const uint8_t* pcm = nullptr;
+    size_t pcmBytes = 0;
+    for (size_t at = 12; at + 8 <= data.size();) {
+        const uint8_t* chunk = data.data() + at;
+        size_t size = le32(chunk + 4);
+        if (size > data.size() - at - 8) size = data.size() - at - 8;
+        if (!memcmp(chunk, "fmt ", 4) && size >= 16) {
+            format = le16(chunk + 8);
+            channels = le16(chunk + 10);
+            sampleRate = (int)le32(chunk + 12);
+            bits = le16(chunk + 22);
+            if (format == 0xFFFE && size >= 40) format = le16(chunk + 32);    // WAVE_FORMAT_EXTENSIBLE
+        } else if (!memcmp(chunk, "data", 4)) {
+            pcm = chunk + 8;
+            pcmBytes = size;
+        }
+        at += 8 + size + (size & 1);
+    }
+
+    const bool pcmOk = format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32);
+    const bool floatOk = format == 3 && bits == 32;
+    if (!pcm || channels < 1 || sampleRate <= 0 || !(pcmOk || floatOk)) return false;
+
+    const int bytes = bits / 8;
+    const size_t frames = pcmBytes / (bytes * channels);
+    samples.assign(frames, 0.0f);
+    for (size_t i = 0; i < frames; ++i) {
+        float sum = 0.0f;
+        for (int c = 0; c < channels; ++c) {
+            const uint8_t* p = pcm + (i * channels + c) * bytes;
+            float v;
+            if (floatOk) {
+                memcpy(&v, p, 4);
+            } else if (bits == 8) {
+                v = (p[0] - 128) / 128.0f;
+            } else if (bits == 16) {
+                v = (int16_t)le16(p) / 32768.0f;
+            } else if (bits == 24) {
+                v = (int32_t)((uint32_t)(p[0] << 8 | p[1] << 16 | (uint32_t)p[2] << 24)) / 2147483648.0f;
+            } else {
+                v = (int32_t)le32(p) / 2147483648.0f;
+            }
+            sum += v;
+        }
+        samples[i] = sum / channels;
+    }
+    return true;
+}
+
+bool write_wav(const char* path, const std::vector<float>& samples, int sampleRate)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    const uint32_t dataBytes = (uint32_t)samples.size() * 2;
+    uint8_t header[44];
+    memcpy(header, "RIFF", 4);
+    const uint32_t riff = 36 + dataBytes;
+    const uint32_t fmtSize = 16, byteRate = sampleRate * 2;
+    const uint16_t pcm = 1, mono = 1, align = 2, bits = 16;
+    memcpy(header + 4, &riff, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    memcpy(header + 16, &fmtSize, 4);
+    memcpy(header + 20, &pcm, 2);
+    memcpy(header + 22, &mono, 2);
+    memcpy(header + 24, &sampleRate, 4);
+    memcpy(header + 28, &byteRate, 4);
+    memcpy(header + 32, &align, 2);
+    memcpy(header + 34, &bits, 2);
+    memcpy(header + 36, "data", 4);
+    memcpy(header + 40, &dataBytes, 4);
+    bool ok = fwrite(header, 1, sizeof(header), f) == sizeof(header);
+
+    std::vector<int16_t> pcm16(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        float v = samples[i] * 32767.0f;
+        pcm16[i] = (int16_t)(v > 32767.0f ? 32767 : (v < -32768.0f ? -32768 : v));
+    }
+    ok &= fwrite(pcm16.data(), 2, pcm16.size(), f) == pcm16.size();
+    return fclose(f) == 0 && ok;
+}
+
+std::vector<float> resample_linear(const std::vector<float>& in, int fromRate, int toRate)
+{
+    if (fromRate == toRate || in.empty()) return in;
+    const size_t count = (size_t)((double)in.size() * toRate / fromRate);
+    std::vector<float> out(count);
+    const double step = (double)fromRate / toRate;
+    for (size_t i = 0; i < count; ++i) {
+        double pos = i * step;
+        size_t k = (size_t)pos;
+        float frac = (float)(pos - k);
+        float a = in[k];
+        float b = k + 1 < in.size() ? in[k + 1] : a;
+        out[i] = a + (b - a) * frac;
+    }
+    return out;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+
+// Small WAV I/O for the audio benches. Reads PCM (8, 16, 24 or 32 bit)
+// and IEEE float files, mixes channels down to mono in -1..1. Writes mono
+// 16-bit PCM.
+
+bool read_wav(const char* path, std::vector<float>& samples, int& sampleRate);
+bool write_wav(const char* path, const std::vector<float>& samples, int sampleRate);
+
+// Linear interpolation to another rate; enough for onset timing
+std::vector<float> resample_linear(const std::vector<float>& in, int fromRate, int toRate);
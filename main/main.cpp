@@ -3,25 +3,40 @@
 
 #include "Arduino.h"
 #include "esp_wifi.h"
+#include "esp_system.h"
 
 #include "led_matrix.h"
 #include "screen_manager.h"
 #include "button.h"
 #include "info_screen.h"
 #include "spectrum_screen.h"
+#include "spectrogram_screen.h"
 #include "fireworks_screen.h"
 #include "clock_screen.h"
 #include "flight_screen.h"
+#include "radar_screen.h"
+#include "animation_screen.h"
+#include "anim_partition.h"
 #include "wifi_manager.h"
 #include "app_config.h"
 #include "web_server.h"
 #include "time_sync.h"
 #include "flight_api.h"
+#include "display_bench.h"
+#include "sensor_bench.h"
+#include "audio_capture.h"
+#include "frame_profiler.h"
+#include "frame_time_overlay.h"
 
 #define BUTTON_PIN GPIO_NUM_38   // your button pin
+#define DISPLAY_BENCH 0          // 1 = log render/blit timings for every screen at boot
+#define SENSOR_BENCH 0           // 1 = log FFT timings, accuracy and audio latency at boot
+#define FRAME_OVERLAY 0          // 1 = start with the frame-time graph shown (toggle via /profiler)
 
 static const int FRAME_RATE = 60;
 static const TickType_t FRAME_DELAY = pdMS_TO_TICKS(1000 / FRAME_RATE);
+static const float SCREEN_TRANSITION_S = 0.35f;
+static const size_t MIC_DRIVER_BYTES = 2 * 1024;      // I2S channel, DMA descriptors, interrupt
 
 extern "C" void app_main(void)
 {
@@ -52,21 +67,52 @@ extern "C" void app_main(void)
         time_sync_start();
     }
 
-    LEDMatrix matrix(64, 32, 1);
+    // Panel geometry (single, chained or tiled modules) comes from AppConfig
+    LEDMatrix matrix(AppConfig::instance().getDisplayConfig());
     matrix.begin();
-
-    // Screen Manager - order: Flight Tracker -> Clock -> Spectrum -> Fireworks -> Info
+    AppConfig::instance().setDisplayStatus(matrix.status());
+
+    // Screen Manager - order: Flight Tracker -> Radar -> Clock -> Spectrum -> Spectrogram -> Fireworks -> Info
+    // (-> Animation when the anim partition holds one)
+    // Screens are built on first use; budgets are the heap each takes once
+    // running (screens without buffers cost just their object)
+    const int w = matrix.width();
+    const int h = matrix.height();
+    // The microphone runs while the spectrum, spectrogram or fireworks show:
+    // capture task, analysis buffers and DMA buffers for the configured
+    // window and hop
+    const AudioConfig ac = AppConfig::instance().getAudioConfig();
+    const size_t micBytes = AudioCapture::TASK_STACK + AudioCapture::analysisBytes(ac.window, ac.hop()) +
+                            AudioCapture::dmaPlan(ac.hop()).bytes + MIC_DRIVER_BYTES;
     ScreenManager manager(matrix);
-    manager.addScreen(new FlightScreen());
-    manager.addScreen(new ClockScreen());
-    manager.addScreen(new SpectrumScreen());
-    manager.addScreen(new FireworksScreen());
-    manager.addScreen(new InfoScreen());
+    manager.addScreen("Flight", []() -> BaseScreen* { return new FlightScreen(); }, sizeof(FlightScreen));
+    manager.addScreen("Radar", []() -> BaseScreen* { return new RadarScreen(); }, RadarScreen::memoryBudget(w, h));
+    manager.addScreen("Clock", []() -> BaseScreen* { return new ClockScreen(); }, sizeof(ClockScreen));
+    manager.addScreen("Spectrum", []() -> BaseScreen* { return new SpectrumScreen(); }, sizeof(SpectrumScreen) + micBytes);
+    manager.addScreen("Spectrogram", []() -> BaseScreen* { return new SpectrogramScreen(); },
+                      SpectrogramScreen::memoryBudget(w, h) + micBytes);
+    manager.addScreen("Fireworks", []() -> BaseScreen* { return new FireworksScreen(); }, FireworksScreen::memoryBudget(w, h) + micBytes);
+    manager.addScreen("Info", []() -> BaseScreen* { return new InfoScreen(); }, sizeof(InfoScreen));
+    // Frames come straight from the mapped flash partition, no buffers
+    if (AnimPartition::instance().map())
+        manager.addScreen("Animation", []() -> BaseScreen* { return new AnimationScreen(); }, sizeof(AnimationScreen));
+    manager.setTransition(Transition::CROSSFADE, SCREEN_TRANSITION_S);
+
+#if DISPLAY_BENCH
+    display_bench_run_all(matrix, manager);
+#endif
+#if SENSOR_BENCH
+    sensor_bench_run_all();
+#endif
 
     // Button
     Button button(BUTTON_PIN, true); // active low with pull-up
     button.begin();
 
+    // Frame-time profiler (histograms served as JSON on /profiler)
+    FrameProfiler& profiler = FrameProfiler::instance();
+    profiler.setOverlay(FRAME_OVERLAY);
+
     uint32_t lastTick = xTaskGetTickCount();
     WiFiState lastWiFiState = WiFiManager::instance().getState();
 
@@ -76,6 +122,9 @@ extern "C" void app_main(void)
         float dt = (now - lastTick) / 1000.0f;
         lastTick = now;
 
+        profiler.beginFrame(manager.currentIndex(), manager.screenName(manager.currentIndex()));
+        profiler.begin(ProfileStage::NETWORK);
+
         // Check if WiFi reconnection is needed after configuration
         if (WebServer::instance().shouldReconnect()) {
             WebServer::instance().clearReconnectFlag();
@@ -89,6 +138,21 @@ extern "C" void app_main(void)
             WiFiManager::instance().begin();
         }
 
+        // Panel layout changed from the web UI - buffers and DMA are sized at boot
+        if (WebServer::instance().shouldRestartForDisplay()) {
+            printf("Display layout changed, restarting...\n");
+            vTaskDelay(pdMS_TO_TICKS(1000)); // Let the HTTP response go out
+            esp_restart();
+        }
+
+        // Quality profile changed - restart the DMA engine between frames
+        if (WebServer::instance().shouldApplyDisplayProfile()) {
+            WebServer::instance().clearDisplayProfileFlag();
+            matrix.reconfigure(AppConfig::instance().getDisplayConfig());
+            AppConfig::instance().setDisplayStatus(matrix.status());
+            profiler.reset();   // frame times before the switch no longer apply
+        }
+
         // Monitor WiFi state and manage web server + SNTP
         WiFiState currentWiFiState = WiFiManager::instance().getState();
         if (currentWiFiState != lastWiFiState) {
@@ -136,7 +200,10 @@ extern "C" void app_main(void)
             }
         }
 
+        profiler.end(ProfileStage::NETWORK);
+
         // Update button
+        profiler.begin(ProfileStage::INPUT);
         button.update();
 
         // Check for long press (5 seconds) - factory reset WiFi credentials
@@ -157,10 +224,14 @@ extern "C" void app_main(void)
         if (button.wasPressed())
         {
             printf("BUTTON PRESSED!\n");
+            uint32_t pressed = timer_cycles();
             manager.nextScreen();
+            profiler.screenSwitched(manager.currentIndex(), pressed);
         }
+        profiler.end(ProfileStage::INPUT);
 
         // Periodic flight data fetch (every 5 minutes when WiFi connected)
+        profiler.begin(ProfileStage::NETWORK);
         if (currentWiFiState == WiFiState::CONNECTED) {
             if (FlightAPI::instance().canFetch()) {
                 LocationConfig loc = AppConfig::instance().getLocation();
@@ -182,10 +253,24 @@ extern "C" void app_main(void)
             }
         }
 
+        profiler.end(ProfileStage::NETWORK);
+
         // Update + render active screen
-        manager.update(dt);
-        manager.render();
-        matrix.show();
+        {
+            ProfileScope scope(ProfileStage::UPDATE);
+            manager.update(dt);
+        }
+        {
+            ProfileScope scope(ProfileStage::RENDER);
+            manager.render();
+            if (profiler.overlay())
+                frame_time_overlay_draw(matrix);
+        }
+        {
+            ProfileScope scope(ProfileStage::BLIT);
+            matrix.show();
+        }
+        profiler.endFrame();
 
         vTaskDelay(FRAME_DELAY);
     }